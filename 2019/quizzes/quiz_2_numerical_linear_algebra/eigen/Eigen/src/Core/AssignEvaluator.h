@@ -321,7 +321,13 @@ struct dense_assignment_loop<Kernel, DefaultTraversal, NoUnrolling>
 {
   EIGEN_DEVICE_FUNC static void EIGEN_STRONG_INLINE run(Kernel &kernel)
   {
-    for(Index outer = 0; outer < kernel.outerSize(); ++outer) {
+    run(kernel, 0, kernel.outerSize());
+  }
+
+  // assigns the outer vectors [outerStart, outerEnd)
+  EIGEN_DEVICE_FUNC static void EIGEN_STRONG_INLINE run(Kernel &kernel, Index outerStart, Index outerEnd)
+  {
+    for(Index outer = outerStart; outer < outerEnd; ++outer) {
       for(Index inner = 0; inner < kernel.innerSize(); ++inner) {
         kernel.assignCoeffByOuterInner(outer, inner);
       }
@@ -396,7 +402,12 @@ struct dense_assignment_loop<Kernel, LinearVectorizedTraversal, NoUnrolling>
 {
   EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel)
   {
-    const Index size = kernel.size();
+    run(kernel, 0, kernel.size());
+  }
+
+  // assigns the coefficients [start, end), start must be a multiple of the packet size
+  EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel, Index start, Index end)
+  {
     typedef typename Kernel::Scalar Scalar;
     typedef typename Kernel::PacketType PacketType;
     enum {
@@ -407,15 +418,15 @@ struct dense_assignment_loop<Kernel, LinearVectorizedTraversal, NoUnrolling>
                                                             : int(Kernel::AssignmentTraits::DstAlignment),
       srcAlignment = Kernel::AssignmentTraits::JointAlignment
     };
-    const Index alignedStart = dstIsAligned ? 0 : internal::first_aligned<requestedAlignment>(kernel.dstDataPtr(), size);
-    const Index alignedEnd = alignedStart + ((size-alignedStart)/packetSize)*packetSize;
+    const Index alignedStart = dstIsAligned ? start : start + internal::first_aligned<requestedAlignment>(kernel.dstDataPtr()+start, end-start);
+    const Index alignedEnd = alignedStart + ((end-alignedStart)/packetSize)*packetSize;
 
-    unaligned_dense_assignment_loop<dstIsAligned!=0>::run(kernel, 0, alignedStart);
+    unaligned_dense_assignment_loop<dstIsAligned!=0>::run(kernel, start, alignedStart);
 
     for(Index index = alignedStart; index < alignedEnd; index += packetSize)
       kernel.template assignPacket<dstAlignment, srcAlignment, PacketType>(index);
 
-    unaligned_dense_assignment_loop<>::run(kernel, alignedEnd, size);
+    unaligned_dense_assignment_loop<>::run(kernel, alignedEnd, end);
   }
 };
 
@@ -449,11 +460,16 @@ struct dense_assignment_loop<Kernel, InnerVectorizedTraversal, NoUnrolling>
     DstAlignment = Kernel::AssignmentTraits::DstAlignment
   };
   EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel)
+  {
+    run(kernel, 0, kernel.outerSize());
+  }
+
+  // assigns the outer vectors [outerStart, outerEnd)
+  EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel, Index outerStart, Index outerEnd)
   {
     const Index innerSize = kernel.innerSize();
-    const Index outerSize = kernel.outerSize();
     const Index packetSize = unpacket_traits<PacketType>::size;
-    for(Index outer = 0; outer < outerSize; ++outer)
+    for(Index outer = outerStart; outer < outerEnd; ++outer)
       for(Index inner = 0; inner < innerSize; inner+=packetSize)
         kernel.template assignPacketByOuterInner<DstAlignment, SrcAlignment, PacketType>(outer, inner);
   }
@@ -492,8 +508,13 @@ struct dense_assignment_loop<Kernel, LinearTraversal, NoUnrolling>
 {
   EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel)
   {
-    const Index size = kernel.size();
-    for(Index i = 0; i < size; ++i)
+    run(kernel, 0, kernel.size());
+  }
+
+  // assigns the coefficients [start, end)
+  EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel, Index start, Index end)
+  {
+    for(Index i = start; i < end; ++i)
       kernel.assignCoeff(i);
   }
 };
@@ -516,6 +537,12 @@ template<typename Kernel>
 struct dense_assignment_loop<Kernel, SliceVectorizedTraversal, NoUnrolling>
 {
   EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel)
+  {
+    run(kernel, 0, kernel.outerSize());
+  }
+
+  // assigns the outer vectors [outerStart, outerEnd)
+  EIGEN_DEVICE_FUNC static EIGEN_STRONG_INLINE void run(Kernel &kernel, Index outerStart, Index outerEnd)
   {
     typedef typename Kernel::Scalar Scalar;
     typedef typename Kernel::PacketType PacketType;
@@ -531,15 +558,15 @@ struct dense_assignment_loop<Kernel, SliceVectorizedTraversal, NoUnrolling>
     if((!bool(dstIsAligned)) && (UIntPtr(dst_ptr) % sizeof(Scalar))>0)
     {
       // the pointer is not aligend-on scalar, so alignment is not possible
-      return dense_assignment_loop<Kernel,DefaultTraversal,NoUnrolling>::run(kernel);
+      return dense_assignment_loop<Kernel,DefaultTraversal,NoUnrolling>::run(kernel, outerStart, outerEnd);
     }
     const Index packetAlignedMask = packetSize - 1;
     const Index innerSize = kernel.innerSize();
-    const Index outerSize = kernel.outerSize();
     const Index alignedStep = alignable ? (packetSize - kernel.outerStride() % packetSize) & packetAlignedMask : 0;
-    Index alignedStart = ((!alignable) || bool(dstIsAligned)) ? 0 : internal::first_aligned<requestedAlignment>(dst_ptr, innerSize);
+    Index alignedStart = ((!alignable) || (bool(dstIsAligned) && outerStart==0)) ? 0
+                       : internal::first_aligned<requestedAlignment>(dst_ptr + outerStart*kernel.outerStride(), innerSize);
 
-    for(Index outer = 0; outer < outerSize; ++outer)
+    for(Index outer = outerStart; outer < outerEnd; ++outer)
     {
       const Index alignedEnd = alignedStart + ((innerSize-alignedStart) & ~packetAlignedMask);
       // do the non-vectorizable part of the assignment
@@ -701,6 +728,12 @@ protected:
 * Part 5 : Entry point for dense rectangular assignment
 ***************************************************************************/
 
+#if defined(EIGEN_PARALLELIZE_ASSIGNMENT) && defined(EIGEN_HAS_OPENMP) && !defined(__CUDA_ARCH__)
+// defined in products/Parallelizer.h
+template<typename Kernel, bool Parallelizable> struct parallel_dense_assignment_loop;
+template<typename Xpr> struct thread_safe_evaluation;
+#endif
+
 template<typename DstXprType,typename SrcXprType, typename Functor>
 EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
 void resize_if_allowed(DstXprType &dst, const SrcXprType& src, const Functor &/*func*/)
@@ -738,7 +771,12 @@ EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void call_dense_assignment_loop(DstXprType
   typedef generic_dense_assignment_kernel<DstEvaluatorType,SrcEvaluatorType,Functor> Kernel;
   Kernel kernel(dstEvaluator, srcEvaluator, func, dst.const_cast_derived());
 
+#if defined(EIGEN_PARALLELIZE_ASSIGNMENT) && defined(EIGEN_HAS_OPENMP) && !defined(__CUDA_ARCH__)
+  parallel_dense_assignment_loop<Kernel, int(Kernel::AssignmentTraits::Unrolling)==int(NoUnrolling)
+                                        && bool(thread_safe_evaluation<SrcXprType>::value)>::run(kernel);
+#else
   dense_assignment_loop<Kernel>::run(kernel);
+#endif
 }
 
 template<typename DstXprType, typename SrcXprType>
@@ -56,6 +56,7 @@ struct default_packet_traits
     HasConj   = 1,
     HasSetLinear = 1,
     HasBlend  = 0,
+    HasCmp    = 0,
 
     HasDiv    = 0,
     HasSqrt   = 0,
@@ -81,6 +82,7 @@ struct default_packet_traits
     HasPolygamma = 0,
     HasErf = 0,
     HasErfc = 0,
+    HasNdtri = 0,
     HasIGamma = 0,
     HasIGammac = 0,
     HasBetaInc = 0,
@@ -209,6 +211,42 @@ pxor(const Packet& a, const Packet& b) { return a ^ b; }
 template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
 pandnot(const Packet& a, const Packet& b) { return a & (!b); }
 
+/** \internal \returns a packet with all bits set to one */
+template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
+ptrue(const Packet& /*a*/) { Packet b; std::memset(static_cast<void*>(&b), 0xff, sizeof(b)); return b; }
+
+/** \internal \returns a packet with all bits set to zero */
+template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
+pzero(const Packet& /*a*/) { Packet b; std::memset(static_cast<void*>(&b), 0, sizeof(b)); return b; }
+
+/** \internal \returns a mask with all bits set in the words where \a a <= \a b, and zero elsewhere */
+template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
+pcmp_le(const Packet& a, const Packet& b) { return a<=b ? ptrue(a) : pzero(a); }
+
+/** \internal \returns a mask with all bits set in the words where \a a < \a b, and zero elsewhere */
+template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
+pcmp_lt(const Packet& a, const Packet& b) { return a<b ? ptrue(a) : pzero(a); }
+
+/** \internal \returns a mask with all bits set in the words where \a a == \a b, and zero elsewhere */
+template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
+pcmp_eq(const Packet& a, const Packet& b) { return numext::equal_strict(a,b) ? ptrue(a) : pzero(a); }
+
+/** \internal \returns the words of \a a where \a mask is set, and the words of \a b elsewhere.
+  * The mask is expected to be the result of one of the pcmp_* functions. */
+template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
+pselect(const Packet& mask, const Packet& a, const Packet& b)
+{
+  // (mask & a) | (~mask & b), computed on the bytes such that it also applies to the scalar types
+  Packet res;
+  const unsigned char* m  = reinterpret_cast<const unsigned char*>(&mask);
+  const unsigned char* pa = reinterpret_cast<const unsigned char*>(&a);
+  const unsigned char* pb = reinterpret_cast<const unsigned char*>(&b);
+  unsigned char* r = reinterpret_cast<unsigned char*>(&res);
+  for(std::size_t i=0; i<sizeof(Packet); ++i)
+    r[i] = static_cast<unsigned char>((m[i] & pa[i]) | (~m[i] & pb[i]));
+  return res;
+}
+
 /** \internal \returns a packet version of \a *from, from must be 16 bytes aligned */
 template<typename Packet> EIGEN_DEVICE_FUNC inline Packet
 pload(const typename unpacket_traits<Packet>::type* from) { return *from; }
@@ -128,6 +128,91 @@ protected:
   PlainObject m_result;
 };
 
+// Helper class reassociating the products of three dense factors to minimize the number of operations,
+// e.g., A*B*x is evaluated as A*(B*x). Any other product is forwarded to generic_product_impl.
+template<typename Xpr> struct product_chain_factor { enum { value = 0 }; };
+template<typename Lhs, typename Rhs> struct product_chain_factor<Product<Lhs,Rhs,DefaultProduct> >
+{
+  enum { value = is_same<typename evaluator_traits<Lhs>::Shape,DenseShape>::value
+              && is_same<typename evaluator_traits<Rhs>::Shape,DenseShape>::value };
+};
+
+template< typename Lhs, typename Rhs,
+          int Chain = !is_same<typename evaluator_traits<Lhs>::Shape,DenseShape>::value
+                   || !is_same<typename evaluator_traits<Rhs>::Shape,DenseShape>::value ? 0
+                    : product_chain_factor<Lhs>::value ? 1
+                    : product_chain_factor<Rhs>::value ? 2 : 0>
+struct product_chain_impl
+{
+  template<typename Dst> static EIGEN_STRONG_INLINE void evalTo(Dst& dst, const Lhs& lhs, const Rhs& rhs)
+  { generic_product_impl<Lhs, Rhs>::evalTo(dst, lhs, rhs); }
+  template<typename Dst> static EIGEN_STRONG_INLINE void addTo(Dst& dst, const Lhs& lhs, const Rhs& rhs)
+  { generic_product_impl<Lhs, Rhs>::addTo(dst, lhs, rhs); }
+  template<typename Dst> static EIGEN_STRONG_INLINE void subTo(Dst& dst, const Lhs& lhs, const Rhs& rhs)
+  { generic_product_impl<Lhs, Rhs>::subTo(dst, lhs, rhs); }
+};
+
+// (A*B)*C, with A of size m x k, B of size k x n, and C of size n x p.
+// It costs m*k*n + m*n*p multiplications, while A*(B*C) costs k*n*p + m*k*p.
+template<typename A, typename B, typename C>
+struct product_chain_impl<Product<A,B,DefaultProduct>, C, 1>
+{
+  typedef Product<A,B,DefaultProduct> Lhs;
+  typedef typename Product<B,C,DefaultProduct>::PlainObject Tmp;
+
+  static bool reassociate(const Lhs& lhs, const C& rhs)
+  {
+    double m = double(lhs.rows()), k = double(lhs.lhs().cols()), n = double(lhs.cols()), p = double(rhs.cols());
+    return k*n*p + m*k*p < m*k*n + m*n*p;
+  }
+
+  template<typename Dst> static void evalTo(Dst& dst, const Lhs& lhs, const C& rhs)
+  {
+    if(reassociate(lhs, rhs)) { Tmp tmp(lhs.rhs() * rhs); generic_product_impl<A, Tmp>::evalTo(dst, lhs.lhs(), tmp); }
+    else generic_product_impl<Lhs, C>::evalTo(dst, lhs, rhs);
+  }
+  template<typename Dst> static void addTo(Dst& dst, const Lhs& lhs, const C& rhs)
+  {
+    if(reassociate(lhs, rhs)) { Tmp tmp(lhs.rhs() * rhs); generic_product_impl<A, Tmp>::addTo(dst, lhs.lhs(), tmp); }
+    else generic_product_impl<Lhs, C>::addTo(dst, lhs, rhs);
+  }
+  template<typename Dst> static void subTo(Dst& dst, const Lhs& lhs, const C& rhs)
+  {
+    if(reassociate(lhs, rhs)) { Tmp tmp(lhs.rhs() * rhs); generic_product_impl<A, Tmp>::subTo(dst, lhs.lhs(), tmp); }
+    else generic_product_impl<Lhs, C>::subTo(dst, lhs, rhs);
+  }
+};
+
+// A*(B*C), see above
+template<typename A, typename B, typename C>
+struct product_chain_impl<A, Product<B,C,DefaultProduct>, 2>
+{
+  typedef Product<B,C,DefaultProduct> Rhs;
+  typedef typename Product<A,B,DefaultProduct>::PlainObject Tmp;
+
+  static bool reassociate(const A& lhs, const Rhs& rhs)
+  {
+    double m = double(lhs.rows()), k = double(lhs.cols()), n = double(rhs.lhs().cols()), p = double(rhs.cols());
+    return m*k*n + m*n*p < k*n*p + m*k*p;
+  }
+
+  template<typename Dst> static void evalTo(Dst& dst, const A& lhs, const Rhs& rhs)
+  {
+    if(reassociate(lhs, rhs)) { Tmp tmp(lhs * rhs.lhs()); generic_product_impl<Tmp, C>::evalTo(dst, tmp, rhs.rhs()); }
+    else generic_product_impl<A, Rhs>::evalTo(dst, lhs, rhs);
+  }
+  template<typename Dst> static void addTo(Dst& dst, const A& lhs, const Rhs& rhs)
+  {
+    if(reassociate(lhs, rhs)) { Tmp tmp(lhs * rhs.lhs()); generic_product_impl<Tmp, C>::addTo(dst, tmp, rhs.rhs()); }
+    else generic_product_impl<A, Rhs>::addTo(dst, lhs, rhs);
+  }
+  template<typename Dst> static void subTo(Dst& dst, const A& lhs, const Rhs& rhs)
+  {
+    if(reassociate(lhs, rhs)) { Tmp tmp(lhs * rhs.lhs()); generic_product_impl<Tmp, C>::subTo(dst, tmp, rhs.rhs()); }
+    else generic_product_impl<A, Rhs>::subTo(dst, lhs, rhs);
+  }
+};
+
 // The following three shortcuts are enabled only if the scalar types match excatly.
 // TODO: we could enable them for different scalar types when the product is not vectorized.
 
@@ -145,7 +230,7 @@ struct Assignment<DstXprType, Product<Lhs,Rhs,Options>, internal::assign_op<Scal
     if((dst.rows()!=dstRows) || (dst.cols()!=dstCols))
       dst.resize(dstRows, dstCols);
     // FIXME shall we handle nested_eval here?
-    generic_product_impl<Lhs, Rhs>::evalTo(dst, src.lhs(), src.rhs());
+    product_chain_impl<Lhs, Rhs>::evalTo(dst, src.lhs(), src.rhs());
   }
 };
 
@@ -160,7 +245,7 @@ struct Assignment<DstXprType, Product<Lhs,Rhs,Options>, internal::add_assign_op<
   {
     eigen_assert(dst.rows() == src.rows() && dst.cols() == src.cols());
     // FIXME shall we handle nested_eval here?
-    generic_product_impl<Lhs, Rhs>::addTo(dst, src.lhs(), src.rhs());
+    product_chain_impl<Lhs, Rhs>::addTo(dst, src.lhs(), src.rhs());
   }
 };
 
@@ -175,7 +260,7 @@ struct Assignment<DstXprType, Product<Lhs,Rhs,Options>, internal::sub_assign_op<
   {
     eigen_assert(dst.rows() == src.rows() && dst.cols() == src.cols());
     // FIXME shall we handle nested_eval here?
-    generic_product_impl<Lhs, Rhs>::subTo(dst, src.lhs(), src.rhs());
+    product_chain_impl<Lhs, Rhs>::subTo(dst, src.lhs(), src.rhs());
   }
 };
 
@@ -240,6 +325,329 @@ EIGEN_CATCH_ASSIGN_XPR_OP_PRODUCT(assign_op,    scalar_difference_op,sub_assign_
 EIGEN_CATCH_ASSIGN_XPR_OP_PRODUCT(add_assign_op,scalar_difference_op,sub_assign_op);
 EIGEN_CATCH_ASSIGN_XPR_OP_PRODUCT(sub_assign_op,scalar_difference_op,add_assign_op);
 
+//----------------------------------------
+// Catch "Dense = f(Product, xpr...)" expressions, where f is made of coefficient-wise operations applied
+// to a large matrix product, e.g.: C.noalias() = ((A*B).rowwise() + bias).cwiseMax(0);
+// Such an epilogue is evaluated by the GEMM kernel on each block of the destination as soon as it is complete,
+// instead of in a second pass over the whole result.
+// The product is found by following the first operand of the coefficient-wise expressions.
+
+template<typename Xpr> struct product_epilogue_fusable
+{
+  enum { value = 0 };
+  typedef void ProductScalar;
+};
+
+template<typename Lhs, typename Rhs>
+struct product_epilogue_fusable<Product<Lhs,Rhs,DefaultProduct> >
+{
+  enum {
+#if defined(EIGEN_USE_BLAS) || defined(EIGEN_USE_MKL_VML)
+    value = 0
+#else
+    value = int(product_type<Lhs,Rhs>::value)==int(GemmProduct)
+         && is_same<typename evaluator_traits<Lhs>::Shape,DenseShape>::value
+         && is_same<typename evaluator_traits<Rhs>::Shape,DenseShape>::value
+#endif
+  };
+  typedef typename Product<Lhs,Rhs,DefaultProduct>::Scalar ProductScalar;
+};
+
+// the other operands must be cheap to evaluate by blocks
+template<typename Xpr, bool Check> struct product_epilogue_operand
+{ enum { value = !(int(evaluator<Xpr>::Flags) & EvalBeforeNestingBit) }; };
+template<typename Xpr> struct product_epilogue_operand<Xpr,false> { enum { value = 1 }; };
+// "Product + Product" is handled by the rules above
+template<typename Lhs, typename Rhs> struct product_epilogue_operand<Product<Lhs,Rhs,DefaultProduct>,true> { enum { value = 0 }; };
+
+template<typename Xpr, typename Nested> struct product_epilogue_fusable_nested
+{
+  enum { value = Nested::value && is_same<typename traits<Xpr>::Scalar, typename Nested::ProductScalar>::value };
+  typedef typename Nested::ProductScalar ProductScalar;
+};
+
+template<typename UnaryOp, typename XprType>
+struct product_epilogue_fusable<CwiseUnaryOp<UnaryOp, const XprType> >
+  : product_epilogue_fusable_nested<CwiseUnaryOp<UnaryOp, const XprType>, product_epilogue_fusable<XprType> >
+{};
+
+template<typename XprType>
+struct product_epilogue_fusable<ArrayWrapper<const XprType> >
+  : product_epilogue_fusable_nested<ArrayWrapper<const XprType>, product_epilogue_fusable<XprType> >
+{};
+
+template<typename XprType>
+struct product_epilogue_fusable<MatrixWrapper<const XprType> >
+  : product_epilogue_fusable_nested<MatrixWrapper<const XprType>, product_epilogue_fusable<XprType> >
+{};
+
+template<typename BinaryOp, typename LhsXpr, typename RhsXpr>
+struct product_epilogue_fusable<CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr> >
+{
+  typedef product_epilogue_fusable_nested<CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr>, product_epilogue_fusable<LhsXpr> > Nested;
+  enum { value = Nested::value && product_epilogue_operand<RhsXpr,bool(Nested::value)>::value };
+  typedef typename Nested::ProductScalar ProductScalar;
+};
+
+// product_epilogue_operand_aliasing<Xpr>::run(xpr, begin, end) tells whether the operand xpr of an epilogue may read
+// the memory range [begin, end). Unknown expressions without direct access are conservatively assumed to alias it.
+template<typename Xpr, bool HasDirectAccess = bool(int(traits<Xpr>::Flags) & DirectAccessBit)>
+struct product_epilogue_operand_aliasing
+{
+  static bool run(const Xpr&, const void*, const void*) { return true; }
+};
+
+template<typename Xpr>
+struct product_epilogue_operand_aliasing<Xpr, true>
+{
+  static bool run(const Xpr& xpr, const void* begin, const void* end)
+  {
+    if(xpr.size()==0)
+      return false;
+    const typename Xpr::Scalar* data = xpr.data();
+    const void* xprEnd = data + (xpr.outerSize()-1)*xpr.outerStride() + (xpr.innerSize()-1)*xpr.innerStride() + 1;
+    return std::less<const void*>()(data, end) && std::less<const void*>()(begin, xprEnd);
+  }
+};
+
+template<typename NullaryOp, typename PlainObjectType>
+struct product_epilogue_operand_aliasing<CwiseNullaryOp<NullaryOp,PlainObjectType>, false>
+{
+  static bool run(const CwiseNullaryOp<NullaryOp,PlainObjectType>&, const void*, const void*) { return false; }
+};
+
+template<typename XprType, typename NestedXpr>
+struct product_epilogue_nested_operand_aliasing
+{
+  static bool run(const XprType& xpr, const void* begin, const void* end)
+  { return product_epilogue_operand_aliasing<typename remove_all<NestedXpr>::type>::run(xpr.nestedExpression(), begin, end); }
+};
+
+template<typename UnaryOp, typename XprType>
+struct product_epilogue_operand_aliasing<CwiseUnaryOp<UnaryOp,XprType>, false>
+  : product_epilogue_nested_operand_aliasing<CwiseUnaryOp<UnaryOp,XprType>, XprType> {};
+
+template<typename XprType, int RowFactor, int ColFactor>
+struct product_epilogue_operand_aliasing<Replicate<XprType,RowFactor,ColFactor>, false>
+  : product_epilogue_nested_operand_aliasing<Replicate<XprType,RowFactor,ColFactor>, XprType> {};
+
+template<typename XprType>
+struct product_epilogue_operand_aliasing<Transpose<XprType>, false>
+  : product_epilogue_nested_operand_aliasing<Transpose<XprType>, XprType> {};
+
+template<typename XprType, int BlockRows, int BlockCols, bool InnerPanel>
+struct product_epilogue_operand_aliasing<Block<XprType,BlockRows,BlockCols,InnerPanel>, false>
+  : product_epilogue_nested_operand_aliasing<Block<XprType,BlockRows,BlockCols,InnerPanel>, XprType> {};
+
+template<typename XprType>
+struct product_epilogue_operand_aliasing<ArrayWrapper<XprType>, false>
+  : product_epilogue_nested_operand_aliasing<ArrayWrapper<XprType>, XprType> {};
+
+template<typename XprType>
+struct product_epilogue_operand_aliasing<MatrixWrapper<XprType>, false>
+  : product_epilogue_nested_operand_aliasing<MatrixWrapper<XprType>, XprType> {};
+
+template<typename BinaryOp, typename LhsXpr, typename RhsXpr>
+struct product_epilogue_operand_aliasing<CwiseBinaryOp<BinaryOp,LhsXpr,RhsXpr>, false>
+{
+  static bool run(const CwiseBinaryOp<BinaryOp,LhsXpr,RhsXpr>& xpr, const void* begin, const void* end)
+  {
+    return product_epilogue_operand_aliasing<typename remove_all<LhsXpr>::type>::run(xpr.lhs(), begin, end)
+        || product_epilogue_operand_aliasing<typename remove_all<RhsXpr>::type>::run(xpr.rhs(), begin, end);
+  }
+};
+
+// product_epilogue_traits<Xpr>::make(xpr, dstBlock, i, j, rows, cols) builds the expression Xpr in which the product
+// is replaced by the block of the destination, and the other operands by their blocks (i, j, rows, cols).
+template<typename Xpr> struct product_epilogue_traits;
+
+template<typename Lhs, typename Rhs>
+struct product_epilogue_traits<Product<Lhs,Rhs,DefaultProduct> >
+{
+  typedef Product<Lhs,Rhs,DefaultProduct> XprType;
+  typedef XprType ProductType;
+  static const ProductType& product(const XprType& xpr) { return xpr; }
+  // the operands of the product may not alias the destination, as for any product assigned with noalias()
+  static bool aliases(const XprType&, const void*, const void*) { return false; }
+
+  // the block of the destination is seen as a matrix
+  template<typename DstBlock> struct block_xpr
+  {
+    typedef typename conditional<is_same<typename traits<DstBlock>::XprKind,ArrayXpr>::value,
+                                 MatrixWrapper<DstBlock>, DstBlock>::type type;
+  };
+  template<typename DstBlock>
+  static typename block_xpr<DstBlock>::type make(const XprType&, DstBlock& dst, Index, Index, Index, Index)
+  { return typename block_xpr<DstBlock>::type(dst); }
+};
+
+template<typename UnaryOp, typename NestedXpr>
+struct product_epilogue_traits<CwiseUnaryOp<UnaryOp, const NestedXpr> >
+{
+  typedef CwiseUnaryOp<UnaryOp, const NestedXpr> XprType;
+  typedef product_epilogue_traits<NestedXpr> Nested;
+  typedef typename Nested::ProductType ProductType;
+  static const ProductType& product(const XprType& xpr) { return Nested::product(xpr.nestedExpression()); }
+  static bool aliases(const XprType& xpr, const void* begin, const void* end) { return Nested::aliases(xpr.nestedExpression(), begin, end); }
+
+  template<typename DstBlock> struct block_xpr
+  { typedef CwiseUnaryOp<UnaryOp, const typename Nested::template block_xpr<DstBlock>::type> type; };
+  template<typename DstBlock>
+  static typename block_xpr<DstBlock>::type make(const XprType& xpr, DstBlock& dst, Index i, Index j, Index rows, Index cols)
+  { return typename block_xpr<DstBlock>::type(Nested::make(xpr.nestedExpression(), dst, i, j, rows, cols), xpr.functor()); }
+};
+
+template<template<typename> class Wrapper, typename NestedXpr>
+struct product_epilogue_wrapper_traits
+{
+  typedef Wrapper<const NestedXpr> XprType;
+  typedef product_epilogue_traits<NestedXpr> Nested;
+  typedef typename Nested::ProductType ProductType;
+  static const ProductType& product(const XprType& xpr) { return Nested::product(xpr.nestedExpression()); }
+  static bool aliases(const XprType& xpr, const void* begin, const void* end) { return Nested::aliases(xpr.nestedExpression(), begin, end); }
+
+  template<typename DstBlock> struct block_xpr
+  { typedef Wrapper<const typename Nested::template block_xpr<DstBlock>::type> type; };
+  template<typename DstBlock>
+  static typename block_xpr<DstBlock>::type make(const XprType& xpr, DstBlock& dst, Index i, Index j, Index rows, Index cols)
+  { return typename block_xpr<DstBlock>::type(Nested::make(xpr.nestedExpression(), dst, i, j, rows, cols)); }
+};
+
+template<typename NestedXpr>
+struct product_epilogue_traits<ArrayWrapper<const NestedXpr> > : product_epilogue_wrapper_traits<ArrayWrapper, NestedXpr> {};
+
+template<typename NestedXpr>
+struct product_epilogue_traits<MatrixWrapper<const NestedXpr> > : product_epilogue_wrapper_traits<MatrixWrapper, NestedXpr> {};
+
+template<typename BinaryOp, typename LhsXpr, typename RhsXpr>
+struct product_epilogue_traits<CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr> >
+{
+  typedef CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr> XprType;
+  typedef product_epilogue_traits<LhsXpr> Nested;
+  typedef typename Nested::ProductType ProductType;
+  static const ProductType& product(const XprType& xpr) { return Nested::product(xpr.lhs()); }
+  static bool aliases(const XprType& xpr, const void* begin, const void* end)
+  { return Nested::aliases(xpr.lhs(), begin, end) || product_epilogue_operand_aliasing<RhsXpr>::run(xpr.rhs(), begin, end); }
+
+  template<typename DstBlock> struct block_xpr
+  { typedef CwiseBinaryOp<BinaryOp, const typename Nested::template block_xpr<DstBlock>::type, const Block<const RhsXpr> > type; };
+  template<typename DstBlock>
+  static typename block_xpr<DstBlock>::type make(const XprType& xpr, DstBlock& dst, Index i, Index j, Index rows, Index cols)
+  {
+    return typename block_xpr<DstBlock>::type(Nested::make(xpr.lhs(), dst, i, j, rows, cols),
+                                              Block<const RhsXpr>(xpr.rhs(), i, j, rows, cols), xpr.functor());
+  }
+};
+
+// The epilogue evaluated by the GEMM kernel
+template<typename DstXprType, typename SrcXprType>
+struct product_epilogue
+{
+  typedef typename DstXprType::Scalar Scalar;
+  product_epilogue(DstXprType& dst, const SrcXprType& src) : m_dst(dst), m_src(src) {}
+
+  void operator()(Index i, Index j, Index rows, Index cols) const
+  {
+    Block<DstXprType> block(m_dst, i, j, rows, cols);
+    call_assignment_no_alias(block, product_epilogue_traits<SrcXprType>::make(m_src, block, i, j, rows, cols),
+                             assign_op<Scalar,Scalar>());
+  }
+
+  DstXprType& m_dst;
+  const SrcXprType& m_src;
+};
+
+// The fused expressions are evaluated into the destination directly, hence they must assume aliasing.
+// The shape is only matched for fusable expressions, so that these rules do not conflict with the ones above.
+template<typename UnaryOp, typename XprType>
+struct evaluator_assume_aliasing<CwiseUnaryOp<UnaryOp, const XprType>,
+                                 typename enable_if<bool(product_epilogue_fusable<CwiseUnaryOp<UnaryOp, const XprType> >::value), DenseShape>::type>
+{
+  static const bool value = true;
+};
+
+template<typename BinaryOp, typename LhsXpr, typename RhsXpr>
+struct evaluator_assume_aliasing<CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr>,
+                                 typename enable_if<bool(product_epilogue_fusable<CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr> >::value), DenseShape>::type>
+{
+  static const bool value = true;
+};
+
+template<typename XprType>
+struct evaluator_assume_aliasing<ArrayWrapper<const XprType>,
+                                 typename enable_if<bool(product_epilogue_fusable<ArrayWrapper<const XprType> >::value), DenseShape>::type>
+{
+  static const bool value = true;
+};
+
+template<typename XprType>
+struct evaluator_assume_aliasing<MatrixWrapper<const XprType>,
+                                 typename enable_if<bool(product_epilogue_fusable<MatrixWrapper<const XprType> >::value), DenseShape>::type>
+{
+  static const bool value = true;
+};
+
+template<typename DstXprType, typename SrcXprType, typename Scalar>
+struct assignment_from_product_epilogue
+{
+  static void run(DstXprType &dst, const SrcXprType &src, const assign_op<Scalar,Scalar>& func)
+  {
+    typedef typename product_epilogue_traits<SrcXprType>::ProductType ProductType;
+    typedef generic_product_impl<typename ProductType::Lhs, typename ProductType::Rhs,DenseShape,DenseShape,GemmProduct> GemmImpl;
+    const ProductType& prod = product_epilogue_traits<SrcXprType>::product(src);
+
+    resize_if_allowed(dst, src, func);
+    // Small products are evaluated by the coefficient based product, see GemmImpl::evalTo.
+    // If the epilogue reads the destination, e.g., C.noalias() = (A*B).cwiseProduct(C), it cannot be evaluated
+    // within the product since the blocks of the destination are overwritten by the product before the epilogue
+    // reads them. The product is then evaluated into a temporary by its evaluator, as without fusion.
+    const Scalar* dstBegin = dst.data();
+    const Scalar* dstEnd = dst.size()==0 ? dstBegin
+                         : dstBegin + (dst.outerSize()-1)*dst.outerStride() + (dst.innerSize()-1)*dst.innerStride() + 1;
+    if(((prod.rhs().rows()+dst.rows()+dst.cols())<20 && prod.rhs().rows()>0)
+       || product_epilogue_traits<SrcXprType>::aliases(src, dstBegin, dstEnd))
+    {
+      call_dense_assignment_loop(dst, src, func);
+    }
+    else
+    {
+      dst.setZero();
+      GemmImpl::scaleAndAddTo(dst, prod.lhs(), prod.rhs(), Scalar(1), product_epilogue<DstXprType,SrcXprType>(dst, src));
+    }
+  }
+};
+
+template<typename SrcXprType, typename Scalar> struct product_epilogue_assignable
+{
+  enum { value = product_epilogue_fusable<SrcXprType>::value
+              && is_same<Scalar,typename product_epilogue_fusable<SrcXprType>::ProductScalar>::value };
+};
+
+template<typename DstXprType, typename UnaryOp, typename XprType, typename Scalar>
+struct Assignment<DstXprType, CwiseUnaryOp<UnaryOp, const XprType>, assign_op<Scalar,Scalar>, Dense2Dense,
+  typename enable_if<product_epilogue_assignable<CwiseUnaryOp<UnaryOp, const XprType>, Scalar>::value>::type>
+  : assignment_from_product_epilogue<DstXprType, CwiseUnaryOp<UnaryOp, const XprType>, Scalar>
+{};
+
+template<typename DstXprType, typename BinaryOp, typename LhsXpr, typename RhsXpr, typename Scalar>
+struct Assignment<DstXprType, CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr>, assign_op<Scalar,Scalar>, Dense2Dense,
+  typename enable_if<product_epilogue_assignable<CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr>, Scalar>::value>::type>
+  : assignment_from_product_epilogue<DstXprType, CwiseBinaryOp<BinaryOp, const LhsXpr, const RhsXpr>, Scalar>
+{};
+
+template<typename DstXprType, typename XprType, typename Scalar>
+struct Assignment<DstXprType, ArrayWrapper<const XprType>, assign_op<Scalar,Scalar>, Dense2Dense,
+  typename enable_if<product_epilogue_assignable<ArrayWrapper<const XprType>, Scalar>::value>::type>
+  : assignment_from_product_epilogue<DstXprType, ArrayWrapper<const XprType>, Scalar>
+{};
+
+template<typename DstXprType, typename XprType, typename Scalar>
+struct Assignment<DstXprType, MatrixWrapper<const XprType>, assign_op<Scalar,Scalar>, Dense2Dense,
+  typename enable_if<product_epilogue_assignable<MatrixWrapper<const XprType>, Scalar>::value>::type>
+  : assignment_from_product_epilogue<DstXprType, MatrixWrapper<const XprType>, Scalar>
+{};
+
+
 //----------------------------------------
 
 template<typename Lhs, typename Rhs>
@@ -190,11 +190,18 @@ struct redux_impl<Func, Derived, DefaultTraversal, NoUnrolling>
   static EIGEN_STRONG_INLINE Scalar run(const Derived &mat, const Func& func)
   {
     eigen_assert(mat.rows()>0 && mat.cols()>0 && "you are using an empty matrix");
+    return run(mat, func, 0, mat.outerSize());
+  }
+
+  // reduces the outer vectors [outerStart, outerEnd)
+  EIGEN_DEVICE_FUNC
+  static EIGEN_STRONG_INLINE Scalar run(const Derived &mat, const Func& func, Index outerStart, Index outerEnd)
+  {
     Scalar res;
-    res = mat.coeffByOuterInner(0, 0);
+    res = mat.coeffByOuterInner(outerStart, 0);
     for(Index i = 1; i < mat.innerSize(); ++i)
-      res = func(res, mat.coeffByOuterInner(0, i));
-    for(Index i = 1; i < mat.outerSize(); ++i)
+      res = func(res, mat.coeffByOuterInner(outerStart, i));
+    for(Index i = outerStart+1; i < outerEnd; ++i)
       for(Index j = 0; j < mat.innerSize(); ++j)
         res = func(res, mat.coeffByOuterInner(i, j));
     return res;
@@ -211,52 +218,69 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, NoUnrolling>
 {
   typedef typename Derived::Scalar Scalar;
   typedef typename redux_traits<Func, Derived>::PacketType PacketScalar;
+  enum {
+    packetSize = redux_traits<Func, Derived>::PacketSize,
+    packetAlignment = unpacket_traits<PacketScalar>::alignment,
+    alignment0 = (bool(Derived::Flags & DirectAccessBit) && bool(packet_traits<Scalar>::AlignedOnScalar)) ? int(packetAlignment) : int(Unaligned),
+    alignment = EIGEN_PLAIN_ENUM_MAX(alignment0, Derived::Alignment)
+  };
 
   static Scalar run(const Derived &mat, const Func& func)
   {
-    const Index size = mat.size();
-    
-    const Index packetSize = redux_traits<Func, Derived>::PacketSize;
-    const int packetAlignment = unpacket_traits<PacketScalar>::alignment;
-    enum {
-      alignment0 = (bool(Derived::Flags & DirectAccessBit) && bool(packet_traits<Scalar>::AlignedOnScalar)) ? int(packetAlignment) : int(Unaligned),
-      alignment = EIGEN_PLAIN_ENUM_MAX(alignment0, Derived::Alignment)
-    };
-    const Index alignedStart = internal::first_default_aligned(mat.nestedExpression());
-    const Index alignedSize2 = ((size-alignedStart)/(2*packetSize))*(2*packetSize);
-    const Index alignedSize = ((size-alignedStart)/(packetSize))*(packetSize);
+    return run<alignment>(mat, func, 0, internal::first_default_aligned(mat.nestedExpression()), mat.size());
+  }
+
+  // reduces the coefficients [start, end)
+  static Scalar run(const Derived &mat, const Func& func, Index start, Index end)
+  {
+#ifdef EIGEN_REDUX_FIXED_TREE
+    // the packets are loaded from start whatever the alignment of the data is, so that the result is reproducible
+    return run<Unaligned>(mat, func, start, start, end);
+#else
+    const Index offset = internal::first_default_aligned(mat.nestedExpression());
+    const Index alignedStart = offset >= start ? offset : start + (packetSize - (start-offset)%packetSize)%packetSize;
+    return run<alignment>(mat, func, start, numext::mini(alignedStart, end), end);
+#endif
+  }
+
+  // reduces the coefficients [start, end), the packets being loaded from alignedStart with the given alignment
+  template<int LoadMode>
+  static Scalar run(const Derived &mat, const Func& func, Index start, Index alignedStart, Index end)
+  {
+    const Index alignedSize2 = ((end-alignedStart)/(2*packetSize))*(2*packetSize);
+    const Index alignedSize = ((end-alignedStart)/(packetSize))*(packetSize);
     const Index alignedEnd2 = alignedStart + alignedSize2;
     const Index alignedEnd  = alignedStart + alignedSize;
     Scalar res;
     if(alignedSize)
     {
-      PacketScalar packet_res0 = mat.template packet<alignment,PacketScalar>(alignedStart);
+      PacketScalar packet_res0 = mat.template packet<LoadMode,PacketScalar>(alignedStart);
       if(alignedSize>packetSize) // we have at least two packets to partly unroll the loop
       {
-        PacketScalar packet_res1 = mat.template packet<alignment,PacketScalar>(alignedStart+packetSize);
+        PacketScalar packet_res1 = mat.template packet<LoadMode,PacketScalar>(alignedStart+packetSize);
         for(Index index = alignedStart + 2*packetSize; index < alignedEnd2; index += 2*packetSize)
         {
-          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment,PacketScalar>(index));
-          packet_res1 = func.packetOp(packet_res1, mat.template packet<alignment,PacketScalar>(index+packetSize));
+          packet_res0 = func.packetOp(packet_res0, mat.template packet<LoadMode,PacketScalar>(index));
+          packet_res1 = func.packetOp(packet_res1, mat.template packet<LoadMode,PacketScalar>(index+packetSize));
         }
 
         packet_res0 = func.packetOp(packet_res0,packet_res1);
         if(alignedEnd>alignedEnd2)
-          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment,PacketScalar>(alignedEnd2));
+          packet_res0 = func.packetOp(packet_res0, mat.template packet<LoadMode,PacketScalar>(alignedEnd2));
       }
       res = func.predux(packet_res0);
 
-      for(Index index = 0; index < alignedStart; ++index)
+      for(Index index = start; index < alignedStart; ++index)
         res = func(res,mat.coeff(index));
 
-      for(Index index = alignedEnd; index < size; ++index)
+      for(Index index = alignedEnd; index < end; ++index)
         res = func(res,mat.coeff(index));
     }
     else // too small to vectorize anything.
          // since this is dynamic-size hence inefficient anyway for such small sizes, don't try to optimize.
     {
-      res = mat.coeff(0);
-      for(Index index = 1; index < size; ++index)
+      res = mat.coeff(start);
+      for(Index index = start+1; index < end; ++index)
         res = func(res,mat.coeff(index));
     }
 
@@ -274,8 +298,13 @@ struct redux_impl<Func, Derived, SliceVectorizedTraversal, Unrolling>
   EIGEN_DEVICE_FUNC static Scalar run(const Derived &mat, const Func& func)
   {
     eigen_assert(mat.rows()>0 && mat.cols()>0 && "you are using an empty matrix");
+    return run(mat, func, 0, mat.outerSize());
+  }
+
+  // reduces the outer vectors [outerStart, outerEnd)
+  EIGEN_DEVICE_FUNC static Scalar run(const Derived &mat, const Func& func, Index outerStart, Index outerEnd)
+  {
     const Index innerSize = mat.innerSize();
-    const Index outerSize = mat.outerSize();
     enum {
       packetSize = redux_traits<Func, Derived>::PacketSize
     };
@@ -283,20 +312,20 @@ struct redux_impl<Func, Derived, SliceVectorizedTraversal, Unrolling>
     Scalar res;
     if(packetedInnerSize)
     {
-      PacketType packet_res = mat.template packet<Unaligned,PacketType>(0,0);
-      for(Index j=0; j<outerSize; ++j)
-        for(Index i=(j==0?packetSize:0); i<packetedInnerSize; i+=Index(packetSize))
+      PacketType packet_res = mat.template packetByOuterInner<Unaligned,PacketType>(outerStart,0);
+      for(Index j=outerStart; j<outerEnd; ++j)
+        for(Index i=(j==outerStart?packetSize:0); i<packetedInnerSize; i+=Index(packetSize))
           packet_res = func.packetOp(packet_res, mat.template packetByOuterInner<Unaligned,PacketType>(j,i));
 
       res = func.predux(packet_res);
-      for(Index j=0; j<outerSize; ++j)
+      for(Index j=outerStart; j<outerEnd; ++j)
         for(Index i=packetedInnerSize; i<innerSize; ++i)
           res = func(res, mat.coeffByOuterInner(j,i));
     }
     else // too small to vectorize anything.
          // since this is dynamic-size hence inefficient anyway for such small sizes, don't try to optimize.
     {
-      res = redux_impl<Func, Derived, DefaultTraversal, NoUnrolling>::run(mat, func);
+      res = redux_impl<Func, Derived, DefaultTraversal, NoUnrolling>::run(mat, func, outerStart, outerEnd);
     }
 
     return res;
@@ -329,6 +358,13 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, CompleteUnrolling>
   }
 };
 
+#ifdef EIGEN_REDUX_BY_CHUNKS
+// defined in products/Parallelizer.h
+template<typename Func, typename Derived,
+         bool Chunked = int(redux_traits<Func, Derived>::Unrolling)==int(NoUnrolling)>
+struct chunked_redux_impl;
+#endif
+
 // evaluator adaptor
 template<typename _XprType>
 class redux_evaluator
@@ -415,7 +451,11 @@ DenseBase<Derived>::redux(const Func& func) const
   typedef typename internal::redux_evaluator<Derived> ThisEvaluator;
   ThisEvaluator thisEval(derived());
   
+#ifdef EIGEN_REDUX_BY_CHUNKS
+  return internal::chunked_redux_impl<Func, ThisEvaluator>::run(thisEval, func);
+#else
   return internal::redux_impl<Func, ThisEvaluator>::run(thisEval, func);
+#endif
 }
 
 /** \returns the minimum of all coefficients of \c *this.
@@ -14,7 +14,7 @@ namespace Eigen {
 
 namespace internal {
 
-template<typename Visitor, typename Derived, int UnrollCount>
+template<typename Visitor, typename Derived, int UnrollCount, bool Vectorize = false>
 struct visitor_impl
 {
   enum {
@@ -55,6 +55,77 @@ struct visitor_impl<Visitor, Derived, Dynamic>
   }
 };
 
+// Vectorized linear traversal for the visitors searching the best coefficient according to a strict ordering,
+// i.e., min_coeff_visitor and max_coeff_visitor. Each lane keeps the best value strictly better than the best one
+// found so far, along with the index of the packet it comes from, such that the first of the best coefficients is
+// found as with the scalar path. In particular, NaN coefficients are never selected, unless the first coefficient
+// is NaN, in which case it is the result.
+template<typename Visitor, typename Derived>
+struct visitor_impl<Visitor, Derived, Dynamic, true>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    PacketSize = unpacket_traits<Packet>::size,
+    // the packet indices are stored as scalars, which must represent them exactly
+    BlockSize = PacketSize << 20
+  };
+
+  static inline void run(const Derived& mat, Visitor& visitor)
+  {
+    const Index size = mat.size();
+    const Index packetEnd = (size/PacketSize)*PacketSize;
+    // the coefficients are visited in column-major order, which must match the storage order to find the same one
+    if(packetEnd==0 || (Derived::IsRowMajor && mat.rows()>1 && mat.cols()>1))
+      return visitor_impl<Visitor, Derived, Dynamic, false>::run(mat, visitor);
+
+    Scalar best = mat.coeff(0);
+    Index bestIndex = 0;
+    EIGEN_ALIGN_MAX Scalar values[PacketSize];
+    EIGEN_ALIGN_MAX Scalar indices[PacketSize];
+    const Packet one = pset1<Packet>(Scalar(1));
+    for(Index blockStart = 0; blockStart < packetEnd; blockStart += BlockSize)
+    {
+      const Index blockEnd = numext::mini<Index>(packetEnd, blockStart+BlockSize);
+      // a lane without a better coefficient keeps the index -1
+      Packet pbest = pset1<Packet>(best);
+      Packet pindex = pset1<Packet>(Scalar(-1));
+      Packet pcurrent = pindex;
+      for(Index i = blockStart; i < blockEnd; i += PacketSize)
+      {
+        Packet p = mat.template packet<Unaligned,Packet>(i);
+        Packet mask = Visitor::pbetter(p, pbest);
+        pcurrent = padd(pcurrent, one);
+        pbest = pselect(mask, p, pbest);
+        pindex = pselect(mask, pcurrent, pindex);
+      }
+      pstore(values, pbest);
+      pstore(indices, pindex);
+      for(Index k = 0; k < PacketSize; ++k)
+      {
+        if(indices[k] < Scalar(0))
+          continue;
+        Index index = blockStart + Index(indices[k])*PacketSize + k;
+        if(Visitor::better(values[k], best) || (!Visitor::better(best, values[k]) && index < bestIndex))
+        {
+          best = values[k];
+          bestIndex = index;
+        }
+      }
+    }
+    for(Index i = packetEnd; i < size; ++i)
+    {
+      if(Visitor::better(mat.coeff(i), best))
+      {
+        best = mat.coeff(i);
+        bestIndex = i;
+      }
+    }
+
+    visitor.init(best, bestIndex % mat.rows(), bestIndex / mat.rows());
+  }
+};
+
 // evaluator adaptor
 template<typename XprType>
 class visitor_evaluator
@@ -68,6 +139,8 @@ public:
   
   enum {
     RowsAtCompileTime = XprType::RowsAtCompileTime,
+    IsRowMajor = XprType::IsRowMajor,
+    Flags = internal::evaluator<XprType>::Flags,
     CoeffReadCost = internal::evaluator<XprType>::CoeffReadCost
   };
   
@@ -77,6 +150,13 @@ public:
 
   EIGEN_DEVICE_FUNC CoeffReturnType coeff(Index row, Index col) const
   { return m_evaluator.coeff(row, col); }
+
+  EIGEN_DEVICE_FUNC CoeffReturnType coeff(Index index) const
+  { return m_evaluator.coeff(index); }
+
+  template<int LoadMode, typename PacketType>
+  PacketType packet(Index index) const
+  { return m_evaluator.template packet<LoadMode,PacketType>(index); }
   
 protected:
   internal::evaluator<XprType> m_evaluator;
@@ -111,9 +191,11 @@ void DenseBase<Derived>::visit(Visitor& visitor) const
   
   enum {
     unroll =  SizeAtCompileTime != Dynamic
-           && SizeAtCompileTime * ThisEvaluator::CoeffReadCost + (SizeAtCompileTime-1) * internal::functor_traits<Visitor>::Cost <= EIGEN_UNROLLING_LIMIT
+           && SizeAtCompileTime * ThisEvaluator::CoeffReadCost + (SizeAtCompileTime-1) * internal::functor_traits<Visitor>::Cost <= EIGEN_UNROLLING_LIMIT,
+    vectorize = (!unroll) && bool(internal::functor_traits<Visitor>::PacketAccess)
+             && (int(ThisEvaluator::Flags) & ActualPacketAccessBit) && (int(ThisEvaluator::Flags) & LinearAccessBit)
   };
-  return internal::visitor_impl<Visitor, ThisEvaluator, unroll ? int(SizeAtCompileTime) : Dynamic>::run(thisEval, visitor);
+  return internal::visitor_impl<Visitor, ThisEvaluator, unroll ? int(SizeAtCompileTime) : Dynamic, vectorize>::run(thisEval, visitor);
 }
 
 namespace internal {
@@ -155,12 +237,19 @@ struct min_coeff_visitor : coeff_visitor<Derived>
       this->col = j;
     }
   }
+
+  EIGEN_DEVICE_FUNC
+  static inline bool better(const Scalar& a, const Scalar& b) { return a < b; }
+  template<typename Packet>
+  static inline Packet pbetter(const Packet& a, const Packet& b) { return pcmp_lt(a, b); }
 };
 
-template<typename Scalar>
-struct functor_traits<min_coeff_visitor<Scalar> > {
+template<typename Derived>
+struct functor_traits<min_coeff_visitor<Derived> > {
+  typedef typename Derived::Scalar Scalar;
   enum {
-    Cost = NumTraits<Scalar>::AddCost
+    Cost = NumTraits<Scalar>::AddCost,
+    PacketAccess = packet_traits<Scalar>::Vectorizable && packet_traits<Scalar>::HasCmp
   };
 };
 
@@ -183,12 +272,19 @@ struct max_coeff_visitor : coeff_visitor<Derived>
       this->col = j;
     }
   }
+
+  EIGEN_DEVICE_FUNC
+  static inline bool better(const Scalar& a, const Scalar& b) { return a > b; }
+  template<typename Packet>
+  static inline Packet pbetter(const Packet& a, const Packet& b) { return pcmp_lt(b, a); }
 };
 
-template<typename Scalar>
-struct functor_traits<max_coeff_visitor<Scalar> > {
+template<typename Derived>
+struct functor_traits<max_coeff_visitor<Derived> > {
+  typedef typename Derived::Scalar Scalar;
   enum {
-    Cost = NumTraits<Scalar>::AddCost
+    Cost = NumTraits<Scalar>::AddCost,
+    PacketAccess = packet_traits<Scalar>::Vectorizable && packet_traits<Scalar>::HasCmp
   };
 };
 
@@ -62,7 +62,8 @@ template<> struct packet_traits<float>  : default_packet_traits
     HasSqrt = 1,
     HasRsqrt = 1,
 #endif
-    HasDiv = 1
+    HasDiv = 1,
+    HasCmp = 1
   };
  };
 template<> struct packet_traits<double> : default_packet_traits
@@ -78,7 +79,8 @@ template<> struct packet_traits<double> : default_packet_traits
     HasSqrt = 1,
     HasRsqrt = EIGEN_FAST_MATH,
 #endif
-    HasDiv = 1
+    HasDiv = 1,
+    HasCmp = 1
   };
 };
 
@@ -384,6 +386,69 @@ EIGEN_STRONG_INLINE Packet8d pxor<Packet8d>(const Packet8d& a,
 #endif
 }
 
+template <>
+EIGEN_STRONG_INLINE Packet16f ptrue<Packet16f>(const Packet16f& /*a*/) {
+  return _mm512_castsi512_ps(_mm512_set1_epi32(-1));
+}
+template <>
+EIGEN_STRONG_INLINE Packet8d ptrue<Packet8d>(const Packet8d& /*a*/) {
+  return _mm512_castsi512_pd(_mm512_set1_epi64(-1));
+}
+
+template <>
+EIGEN_STRONG_INLINE Packet16f pzero<Packet16f>(const Packet16f& /*a*/) {
+  return _mm512_setzero_ps();
+}
+template <>
+EIGEN_STRONG_INLINE Packet8d pzero<Packet8d>(const Packet8d& /*a*/) {
+  return _mm512_setzero_pd();
+}
+
+// AVX512 comparisons produce bit masks; they are expanded to full-width
+// packets so that the results can be consumed by the generic mask functions.
+EIGEN_STRONG_INLINE Packet16f avx512_mask_to_packet(__mmask16 m) {
+  return _mm512_castsi512_ps(_mm512_mask_set1_epi32(_mm512_setzero_si512(), m, -1));
+}
+EIGEN_STRONG_INLINE Packet8d avx512_mask_to_packet(__mmask8 m) {
+  return _mm512_castsi512_pd(_mm512_mask_set1_epi64(_mm512_setzero_si512(), m, -1));
+}
+
+template <>
+EIGEN_STRONG_INLINE Packet16f pcmp_le<Packet16f>(const Packet16f& a, const Packet16f& b) {
+  return avx512_mask_to_packet(_mm512_cmp_ps_mask(a, b, _CMP_LE_OQ));
+}
+template <>
+EIGEN_STRONG_INLINE Packet16f pcmp_lt<Packet16f>(const Packet16f& a, const Packet16f& b) {
+  return avx512_mask_to_packet(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ));
+}
+template <>
+EIGEN_STRONG_INLINE Packet16f pcmp_eq<Packet16f>(const Packet16f& a, const Packet16f& b) {
+  return avx512_mask_to_packet(_mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ));
+}
+template <>
+EIGEN_STRONG_INLINE Packet8d pcmp_le<Packet8d>(const Packet8d& a, const Packet8d& b) {
+  return avx512_mask_to_packet(_mm512_cmp_pd_mask(a, b, _CMP_LE_OQ));
+}
+template <>
+EIGEN_STRONG_INLINE Packet8d pcmp_lt<Packet8d>(const Packet8d& a, const Packet8d& b) {
+  return avx512_mask_to_packet(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ));
+}
+template <>
+EIGEN_STRONG_INLINE Packet8d pcmp_eq<Packet8d>(const Packet8d& a, const Packet8d& b) {
+  return avx512_mask_to_packet(_mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ));
+}
+
+template <>
+EIGEN_STRONG_INLINE Packet16f pselect<Packet16f>(const Packet16f& mask, const Packet16f& a, const Packet16f& b) {
+  __mmask16 m = _mm512_test_epi32_mask(_mm512_castps_si512(mask), _mm512_castps_si512(mask));
+  return _mm512_mask_blend_ps(m, b, a);
+}
+template <>
+EIGEN_STRONG_INLINE Packet8d pselect<Packet8d>(const Packet8d& mask, const Packet8d& a, const Packet8d& b) {
+  __mmask8 m = _mm512_test_epi64_mask(_mm512_castpd_si512(mask), _mm512_castpd_si512(mask));
+  return _mm512_mask_blend_pd(m, b, a);
+}
+
 template <>
 EIGEN_STRONG_INLINE Packet16f pandnot<Packet16f>(const Packet16f& a,
                                                  const Packet16f& b) {
@@ -110,7 +110,13 @@ template<> struct packet_traits<float>  : default_packet_traits
     HasSqrt = 1,
     HasRsqrt = 1,
     HasTanh  = EIGEN_FAST_MATH,
-    HasBlend = 1
+    HasLGamma = 1,
+    HasDiGamma = 1,
+    HasErf = 1,
+    HasErfc = 1,
+    HasNdtri = 1,
+    HasBlend = 1,
+    HasCmp   = 1
 
 #ifdef EIGEN_VECTORIZE_SSE4_1
     ,
@@ -134,7 +140,8 @@ template<> struct packet_traits<double> : default_packet_traits
     HasExp  = 1,
     HasSqrt = 1,
     HasRsqrt = 1,
-    HasBlend = 1
+    HasBlend = 1,
+    HasCmp   = 1
 
 #ifdef EIGEN_VECTORIZE_SSE4_1
     ,
@@ -154,7 +161,8 @@ template<> struct packet_traits<int>    : default_packet_traits
     AlignedOnScalar = 1,
     size=4,
 
-    HasBlend = 1
+    HasBlend = 1,
+    HasCmp   = 1
   };
 };
 
@@ -303,6 +311,34 @@ template<> EIGEN_STRONG_INLINE Packet4f pandnot<Packet4f>(const Packet4f& a, con
 template<> EIGEN_STRONG_INLINE Packet2d pandnot<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_andnot_pd(a,b); }
 template<> EIGEN_STRONG_INLINE Packet4i pandnot<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_andnot_si128(a,b); }
 
+template<> EIGEN_STRONG_INLINE Packet4f ptrue<Packet4f>(const Packet4f& a) { return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_castps_si128(a),_mm_castps_si128(a))); }
+template<> EIGEN_STRONG_INLINE Packet2d ptrue<Packet2d>(const Packet2d& a) { return _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_castpd_si128(a),_mm_castpd_si128(a))); }
+template<> EIGEN_STRONG_INLINE Packet4i ptrue<Packet4i>(const Packet4i& a) { return _mm_cmpeq_epi32(a,a); }
+
+template<> EIGEN_STRONG_INLINE Packet4f pzero<Packet4f>(const Packet4f& /*a*/) { return _mm_setzero_ps(); }
+template<> EIGEN_STRONG_INLINE Packet2d pzero<Packet2d>(const Packet2d& /*a*/) { return _mm_setzero_pd(); }
+template<> EIGEN_STRONG_INLINE Packet4i pzero<Packet4i>(const Packet4i& /*a*/) { return _mm_setzero_si128(); }
+
+template<> EIGEN_STRONG_INLINE Packet4f pcmp_le<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_cmple_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4f pcmp_lt<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_cmplt_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4f pcmp_eq<Packet4f>(const Packet4f& a, const Packet4f& b) { return _mm_cmpeq_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_le<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_cmple_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_lt<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_cmplt_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet2d pcmp_eq<Packet2d>(const Packet2d& a, const Packet2d& b) { return _mm_cmpeq_pd(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4i pcmp_lt<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_cmplt_epi32(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4i pcmp_eq<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_cmpeq_epi32(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4i pcmp_le<Packet4i>(const Packet4i& a, const Packet4i& b) { return _mm_or_si128(_mm_cmplt_epi32(a,b), _mm_cmpeq_epi32(a,b)); }
+
+#ifdef EIGEN_VECTORIZE_SSE4_1
+template<> EIGEN_STRONG_INLINE Packet4f pselect<Packet4f>(const Packet4f& mask, const Packet4f& a, const Packet4f& b) { return _mm_blendv_ps(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet2d pselect<Packet2d>(const Packet2d& mask, const Packet2d& a, const Packet2d& b) { return _mm_blendv_pd(b,a,mask); }
+template<> EIGEN_STRONG_INLINE Packet4i pselect<Packet4i>(const Packet4i& mask, const Packet4i& a, const Packet4i& b) { return _mm_blendv_epi8(b,a,mask); }
+#else
+template<> EIGEN_STRONG_INLINE Packet4f pselect<Packet4f>(const Packet4f& mask, const Packet4f& a, const Packet4f& b) { return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b)); }
+template<> EIGEN_STRONG_INLINE Packet2d pselect<Packet2d>(const Packet2d& mask, const Packet2d& a, const Packet2d& b) { return _mm_or_pd(_mm_and_pd(mask,a),_mm_andnot_pd(mask,b)); }
+template<> EIGEN_STRONG_INLINE Packet4i pselect<Packet4i>(const Packet4i& mask, const Packet4i& a, const Packet4i& b) { return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b)); }
+#endif
+
 template<> EIGEN_STRONG_INLINE Packet4f pload<Packet4f>(const float*   from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_ps(from); }
 template<> EIGEN_STRONG_INLINE Packet2d pload<Packet2d>(const double*  from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_pd(from); }
 template<> EIGEN_STRONG_INLINE Packet4i pload<Packet4i>(const int*     from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm_load_si128(reinterpret_cast<const __m128i*>(from)); }
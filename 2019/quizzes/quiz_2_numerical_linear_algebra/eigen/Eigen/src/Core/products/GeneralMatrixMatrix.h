@@ -16,6 +16,33 @@ namespace internal {
 
 template<typename _LhsScalar, typename _RhsScalar> class level3_blocking;
 
+/* An epilogue is a functor called as epilogue(i, j, rows, cols) on each block of the result
+ * as soon as its final value has been computed, i.e., while it is still in cache.
+ * The coordinates are relative to the destination passed to the product kernel. */
+struct gemm_no_epilogue
+{
+  template<typename Index> void operator()(Index, Index, Index, Index) const {}
+};
+
+template<typename Epilogue>
+struct gemm_transposed_epilogue
+{
+  gemm_transposed_epilogue(const Epilogue& epilogue) : m_epilogue(epilogue) {}
+  template<typename Index> void operator()(Index i, Index j, Index rows, Index cols) const
+  { m_epilogue(j, i, cols, rows); }
+  const Epilogue& m_epilogue;
+};
+
+template<typename Epilogue, typename Index>
+struct gemm_shifted_epilogue
+{
+  gemm_shifted_epilogue(const Epilogue& epilogue, Index row, Index col) : m_epilogue(epilogue), m_row(row), m_col(col) {}
+  void operator()(Index i, Index j, Index rows, Index cols) const
+  { m_epilogue(m_row+i, m_col+j, rows, cols); }
+  const Epilogue& m_epilogue;
+  Index m_row, m_col;
+};
+
 /* Specialization for a row-major destination matrix => simple transposition of the product */
 template<
   typename Index,
@@ -42,6 +69,25 @@ struct general_matrix_matrix_product<Index,LhsScalar,LhsStorageOrder,ConjugateLh
       ColMajor>
     ::run(cols,rows,depth,rhs,rhsStride,lhs,lhsStride,res,resStride,alpha,blocking,info);
   }
+
+  template<typename Epilogue>
+  static EIGEN_STRONG_INLINE void run(
+    Index rows, Index cols, Index depth,
+    const LhsScalar* lhs, Index lhsStride,
+    const RhsScalar* rhs, Index rhsStride,
+    ResScalar* res, Index resStride,
+    ResScalar alpha,
+    level3_blocking<RhsScalar,LhsScalar>& blocking,
+    GemmParallelInfo<Index>* info,
+    const Epilogue& epilogue)
+  {
+    general_matrix_matrix_product<Index,
+      RhsScalar, RhsStorageOrder==RowMajor ? ColMajor : RowMajor, ConjugateRhs,
+      LhsScalar, LhsStorageOrder==RowMajor ? ColMajor : RowMajor, ConjugateLhs,
+      ColMajor>
+    ::run(cols,rows,depth,rhs,rhsStride,lhs,lhsStride,res,resStride,alpha,blocking,info,
+          gemm_transposed_epilogue<Epilogue>(epilogue));
+  }
 };
 
 /*  Specialization for a col-major destination matrix
@@ -63,6 +109,19 @@ static void run(Index rows, Index cols, Index depth,
   ResScalar alpha,
   level3_blocking<LhsScalar,RhsScalar>& blocking,
   GemmParallelInfo<Index>* info = 0)
+{
+  run(rows, cols, depth, _lhs, lhsStride, _rhs, rhsStride, _res, resStride, alpha, blocking, info, gemm_no_epilogue());
+}
+
+template<typename Epilogue>
+static void run(Index rows, Index cols, Index depth,
+  const LhsScalar* _lhs, Index lhsStride,
+  const RhsScalar* _rhs, Index rhsStride,
+  ResScalar* _res, Index resStride,
+  ResScalar alpha,
+  level3_blocking<LhsScalar,RhsScalar>& blocking,
+  GemmParallelInfo<Index>* info,
+  const Epilogue& epilogue)
 {
   typedef const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> LhsMapper;
   typedef const_blas_data_mapper<RhsScalar, Index, RhsStorageOrder> RhsMapper;
@@ -129,6 +188,8 @@ static void run(Index rows, Index cols, Index depth,
         }
 
         gebp(res.getSubMapper(info[i].lhs_start, 0), blockA+info[i].lhs_start*actual_kc, blockB, info[i].lhs_length, actual_kc, nc, alpha);
+        if(k+actual_kc==depth)
+          epilogue(info[i].lhs_start, Index(0), info[i].lhs_length, nc);
       }
 
       // Then keep going as usual with the remaining B'
@@ -141,6 +202,8 @@ static void run(Index rows, Index cols, Index depth,
 
         // C_j += A' * B'
         gebp(res.getSubMapper(0, j), blockA, blockB, rows, actual_kc, actual_nc, alpha);
+        if(k+actual_kc==depth)
+          epilogue(Index(0), j, rows, actual_nc);
       }
 
       // Release all the sub blocks A'_i of A' for the current thread,
@@ -192,6 +255,10 @@ static void run(Index rows, Index cols, Index depth,
 
           // Everything is packed, we can now call the panel * block kernel:
           gebp(res.getSubMapper(i2, j2), blockA, blockB, actual_mc, actual_kc, actual_nc, alpha);
+
+          // The block is complete after the last panel of the depth
+          if(k2+actual_kc==depth)
+            epilogue(i2, j2, actual_mc, actual_nc);
         }
       }
     }
@@ -205,11 +272,13 @@ static void run(Index rows, Index cols, Index depth,
 *  implementation of the high level wrapper to general_matrix_matrix_product
 **********************************************************************************/
 
-template<typename Scalar, typename Index, typename Gemm, typename Lhs, typename Rhs, typename Dest, typename BlockingType>
+template<typename Scalar, typename Index, typename Gemm, typename Lhs, typename Rhs, typename Dest, typename BlockingType,
+         typename Epilogue = gemm_no_epilogue>
 struct gemm_functor
 {
-  gemm_functor(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& actualAlpha, BlockingType& blocking)
-    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_actualAlpha(actualAlpha), m_blocking(blocking)
+  gemm_functor(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& actualAlpha, BlockingType& blocking,
+               const Epilogue& epilogue = Epilogue())
+    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_actualAlpha(actualAlpha), m_blocking(blocking), m_epilogue(epilogue)
   {}
 
   void initParallelSession(Index num_threads) const
@@ -223,11 +292,7 @@ struct gemm_functor
     if(cols==-1)
       cols = m_rhs.cols();
 
-    Gemm::run(rows, cols, m_lhs.cols(),
-              &m_lhs.coeffRef(row,0), m_lhs.outerStride(),
-              &m_rhs.coeffRef(0,col), m_rhs.outerStride(),
-              (Scalar*)&(m_dest.coeffRef(row,col)), m_dest.outerStride(),
-              m_actualAlpha, m_blocking, info);
+    run(row, rows, col, cols, info, m_epilogue);
   }
 
   typedef typename Gemm::Traits Traits;
@@ -238,6 +303,27 @@ struct gemm_functor
     Dest& m_dest;
     Scalar m_actualAlpha;
     BlockingType& m_blocking;
+    Epilogue m_epilogue;
+
+    template<typename E>
+    void run(Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info, const E& epilogue) const
+    {
+      // in the row-major case, Gemm transposes the coordinates of the blocks back
+      Gemm::run(rows, cols, m_lhs.cols(),
+                &m_lhs.coeffRef(row,0), m_lhs.outerStride(),
+                &m_rhs.coeffRef(0,col), m_rhs.outerStride(),
+                (Scalar*)&(m_dest.coeffRef(row,col)), m_dest.outerStride(),
+                m_actualAlpha, m_blocking, info, gemm_shifted_epilogue<E,Index>(epilogue, row, col));
+    }
+
+    void run(Index row, Index rows, Index col, Index cols, GemmParallelInfo<Index>* info, const gemm_no_epilogue&) const
+    {
+      Gemm::run(rows, cols, m_lhs.cols(),
+                &m_lhs.coeffRef(row,0), m_lhs.outerStride(),
+                &m_rhs.coeffRef(0,col), m_rhs.outerStride(),
+                (Scalar*)&(m_dest.coeffRef(row,col)), m_dest.outerStride(),
+                m_actualAlpha, m_blocking, info);
+    }
 };
 
 template<int StorageOrder, typename LhsScalar, typename RhsScalar, int MaxRows, int MaxCols, int MaxDepth, int KcFactor=1,
@@ -456,10 +542,20 @@ struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
 
   template<typename Dest>
   static void scaleAndAddTo(Dest& dst, const Lhs& a_lhs, const Rhs& a_rhs, const Scalar& alpha)
+  {
+    scaleAndAddTo(dst, a_lhs, a_rhs, alpha, gemm_no_epilogue());
+  }
+
+  // Computes dst += alpha * lhs * rhs, and calls \a epilogue on each block of dst as soon as it is complete
+  template<typename Dest, typename Epilogue>
+  static void scaleAndAddTo(Dest& dst, const Lhs& a_lhs, const Rhs& a_rhs, const Scalar& alpha, const Epilogue& epilogue)
   {
     eigen_assert(dst.rows()==a_lhs.rows() && dst.cols()==a_rhs.cols());
     if(a_lhs.cols()==0 || a_lhs.rows()==0 || a_rhs.cols()==0)
+    {
+      epilogue(Index(0), Index(0), dst.rows(), dst.cols());
       return;
+    }
 
     typename internal::add_const_on_value_type<ActualLhsType>::type lhs = LhsBlasTraits::extract(a_lhs);
     typename internal::add_const_on_value_type<ActualRhsType>::type rhs = RhsBlasTraits::extract(a_rhs);
@@ -477,11 +573,11 @@ struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
         LhsScalar, (ActualLhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor, bool(LhsBlasTraits::NeedToConjugate),
         RhsScalar, (ActualRhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor, bool(RhsBlasTraits::NeedToConjugate),
         (Dest::Flags&RowMajorBit) ? RowMajor : ColMajor>,
-      ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, BlockingType> GemmFunctor;
+      ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, BlockingType, Epilogue> GemmFunctor;
 
     BlockingType blocking(dst.rows(), dst.cols(), lhs.cols(), 1, true);
     internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime>32 || Dest::MaxRowsAtCompileTime==Dynamic)>
-        (GemmFunctor(lhs, rhs, dst, actualAlpha, blocking), a_lhs.rows(), a_rhs.cols(), a_lhs.cols(), Dest::Flags&RowMajorBit);
+        (GemmFunctor(lhs, rhs, dst, actualAlpha, blocking, epilogue), a_lhs.rows(), a_rhs.cols(), a_lhs.cols(), Dest::Flags&RowMajorBit);
   }
 };
 
@@ -71,6 +71,17 @@ inline void setNbThreads(int v)
 
 namespace internal {
 
+// minimal amount of work, counted in multiply-adds or in coefficient costs, worth giving to a thread
+const double parallel_min_task_work = 50000;
+
+/** \internal \returns the number of threads worth using for an amount of \a work which can be split into
+  * at most \a max_tasks independent parts, given nbThreads() */
+inline Index parallel_threads(Index max_tasks, double work)
+{
+  Index pb_max_threads = std::max<Index>(1, std::min<Index>(max_tasks, Index(work / parallel_min_task_work)));
+  return std::min<Index>(nbThreads(), pb_max_threads);
+}
+
 template<typename Index> struct GemmParallelInfo
 {
   GemmParallelInfo() : sync(-1), users(0), lhs_start(0), lhs_length(0) {}
@@ -106,16 +117,11 @@ void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth,
   // compute the maximal number of threads from the size of the product:
   // This first heuristic takes into account that the product kernel is fully optimized when working with nr columns at once.
   Index size = transpose ? rows : cols;
-  Index pb_max_threads = std::max<Index>(1,size / Functor::Traits::nr);
 
-  // compute the maximal number of threads from the total amount of work:
+  // compute the number of threads we are going to use from the total amount of work:
   double work = static_cast<double>(rows) * static_cast<double>(cols) *
       static_cast<double>(depth);
-  double kMinTaskSize = 50000;  // FIXME improve this heuristic.
-  pb_max_threads = std::max<Index>(1, std::min<Index>(pb_max_threads, work / kMinTaskSize));
-
-  // compute the number of threads we are going to use
-  Index threads = std::min<Index>(nbThreads(), pb_max_threads);
+  Index threads = static_cast<Index>(parallel_threads(size / Functor::Traits::nr, work));
 
   // if multi-threading is explicitely disabled, not useful, or if we already are in a parallel session,
   // then abort multi-threading
@@ -156,6 +162,217 @@ void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth,
 #endif
 }
 
+#if defined(EIGEN_PARALLELIZE_ASSIGNMENT) && defined(EIGEN_HAS_OPENMP) && !defined(__CUDA_ARCH__)
+
+/** \internal Tells whether the coefficients of the expression \a Xpr can be evaluated concurrently and in any order.
+  * This is not the case of the nullary expressions whose functor is not repeatable, such as Random(),
+  * which calls std::rand and whose result must only depend on the seed. */
+template<typename Xpr> struct thread_safe_evaluation { enum { value = true }; };
+
+template<typename Xpr> struct thread_safe_evaluation<const Xpr> : thread_safe_evaluation<Xpr> {};
+
+template<typename NullaryOp, typename PlainObjectType>
+struct thread_safe_evaluation<CwiseNullaryOp<NullaryOp,PlainObjectType> >
+{ enum { value = functor_traits<NullaryOp>::IsRepeatable }; };
+
+template<typename UnaryOp, typename XprType>
+struct thread_safe_evaluation<CwiseUnaryOp<UnaryOp,XprType> > : thread_safe_evaluation<XprType> {};
+
+template<typename ViewOp, typename XprType>
+struct thread_safe_evaluation<CwiseUnaryView<ViewOp,XprType> > : thread_safe_evaluation<XprType> {};
+
+template<typename BinaryOp, typename Lhs, typename Rhs>
+struct thread_safe_evaluation<CwiseBinaryOp<BinaryOp,Lhs,Rhs> >
+{ enum { value = thread_safe_evaluation<Lhs>::value && thread_safe_evaluation<Rhs>::value }; };
+
+template<typename TernaryOp, typename Arg1, typename Arg2, typename Arg3>
+struct thread_safe_evaluation<CwiseTernaryOp<TernaryOp,Arg1,Arg2,Arg3> >
+{ enum { value = thread_safe_evaluation<Arg1>::value && thread_safe_evaluation<Arg2>::value
+               && thread_safe_evaluation<Arg3>::value }; };
+
+template<typename ConditionMatrixType, typename ThenMatrixType, typename ElseMatrixType>
+struct thread_safe_evaluation<Select<ConditionMatrixType,ThenMatrixType,ElseMatrixType> >
+{ enum { value = thread_safe_evaluation<ConditionMatrixType>::value && thread_safe_evaluation<ThenMatrixType>::value
+               && thread_safe_evaluation<ElseMatrixType>::value }; };
+
+template<typename Lhs, typename Rhs, int Option>
+struct thread_safe_evaluation<Product<Lhs,Rhs,Option> >
+{ enum { value = thread_safe_evaluation<Lhs>::value && thread_safe_evaluation<Rhs>::value }; };
+
+template<typename XprType, int BlockRows, int BlockCols, bool InnerPanel>
+struct thread_safe_evaluation<Block<XprType,BlockRows,BlockCols,InnerPanel> > : thread_safe_evaluation<XprType> {};
+
+template<typename XprType>
+struct thread_safe_evaluation<Transpose<XprType> > : thread_safe_evaluation<XprType> {};
+
+template<typename XprType, int Direction>
+struct thread_safe_evaluation<Reverse<XprType,Direction> > : thread_safe_evaluation<XprType> {};
+
+template<typename XprType, int RowFactor, int ColFactor>
+struct thread_safe_evaluation<Replicate<XprType,RowFactor,ColFactor> > : thread_safe_evaluation<XprType> {};
+
+template<typename XprType, int DiagIndex>
+struct thread_safe_evaluation<Diagonal<XprType,DiagIndex> > : thread_safe_evaluation<XprType> {};
+
+template<typename XprType>
+struct thread_safe_evaluation<ArrayWrapper<XprType> > : thread_safe_evaluation<XprType> {};
+
+template<typename XprType>
+struct thread_safe_evaluation<MatrixWrapper<XprType> > : thread_safe_evaluation<XprType> {};
+
+/** \internal Evaluates a dense assignment \a kernel with multiple threads when it is not unrolled,
+  * when its source can be evaluated concurrently, and when the amount of work is large enough.
+  * The linear range, or the range of outer vectors, is split into one contiguous chunk per thread.
+  * This path is enabled by defining EIGEN_PARALLELIZE_ASSIGNMENT. */
+template<typename Kernel, bool Parallelizable>
+struct parallel_dense_assignment_loop
+{
+  static EIGEN_STRONG_INLINE void run(Kernel &kernel)
+  {
+    dense_assignment_loop<Kernel>::run(kernel);
+  }
+};
+
+template<typename Kernel>
+struct parallel_dense_assignment_loop<Kernel, true>
+{
+  static void run(Kernel &kernel)
+  {
+    typedef typename Kernel::AssignmentTraits Traits;
+    enum {
+      LinearRange = int(Traits::Traversal)==int(LinearVectorizedTraversal) || int(Traits::Traversal)==int(LinearTraversal),
+      // linear chunks must start on a packet boundary to preserve the alignment of the destination
+      Granularity = int(Traits::Traversal)==int(LinearVectorizedTraversal) ? unpacket_traits<typename Kernel::PacketType>::size : 1,
+      CoeffCost = int(Kernel::DstEvaluatorType::CoeffReadCost) + int(Kernel::SrcEvaluatorType::CoeffReadCost)
+    };
+
+    // Dynamically check whether we should enable or disable OpenMP, following parallelize_gemm.
+    const Index size = LinearRange ? kernel.size() : kernel.outerSize();
+    double work = static_cast<double>(kernel.size()) * static_cast<double>(CoeffCost);
+    Index threads = parallel_threads(size / Granularity, work);
+
+    if((threads==1) || (omp_get_num_threads()>1))
+      return dense_assignment_loop<Kernel>::run(kernel, 0, size);
+
+    Eigen::initParallel();
+
+    #pragma omp parallel num_threads(threads)
+    {
+      Index i = omp_get_thread_num();
+      // Note that the actual number of threads might be lower than the number of request ones.
+      Index actual_threads = omp_get_num_threads();
+
+      Index blockSize = ((size / actual_threads) / Granularity) * Granularity;
+      Index start = i*blockSize;
+      Index end = (i+1==actual_threads) ? size : start+blockSize;
+
+      dense_assignment_loop<Kernel>::run(kernel, start, end);
+    }
+  }
+};
+
+#endif
+
+#ifdef EIGEN_REDUX_BY_CHUNKS
+
+/** \internal Evaluates a full reduction of \a mat by chunks when it is not unrolled.
+  * The chunks are either the linear range, or the range of outer vectors, split into contiguous parts.
+  * Their partial results are always combined in the same order, so that the result does not depend on the
+  * scheduling of the threads:
+  *  - by default, there is one chunk per thread, and the chunks are combined from the first to the last one.
+  *    The result only depends on the number of threads, which is computed from the size and cost of the reduction.
+  *  - if EIGEN_REDUX_FIXED_TREE is defined, the chunks have a fixed size and are combined as a balanced binary tree.
+  *    The result is then reproducible whatever the number of threads and the alignment of the data are.
+  * The chunks are evaluated in parallel if EIGEN_PARALLELIZE_REDUX is defined and OpenMP is enabled. */
+template<typename Func, typename Derived, bool Chunked>
+struct chunked_redux_impl
+{
+  typedef typename Derived::Scalar Scalar;
+  static EIGEN_STRONG_INLINE Scalar run(const Derived &mat, const Func& func)
+  {
+    return redux_impl<Func, Derived>::run(mat, func);
+  }
+};
+
+template<typename Func, typename Derived>
+struct chunked_redux_impl<Func, Derived, true>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef redux_traits<Func, Derived> Traits;
+  typedef redux_impl<Func, Derived, Traits::Traversal, NoUnrolling> Impl;
+  enum {
+    LinearRange = int(Traits::Traversal)==int(LinearVectorizedTraversal),
+    Granularity = LinearRange ? int(Traits::PacketSize) : 1,
+    CoeffCost = int(Derived::CoeffReadCost) + int(functor_traits<Func>::Cost),
+    // number of coefficients of the chunks when EIGEN_REDUX_FIXED_TREE is defined
+    FixedChunkSize = 4096
+  };
+
+  static Scalar run(const Derived &mat, const Func& func)
+  {
+    eigen_assert(mat.rows()>0 && mat.cols()>0 && "you are using an empty matrix");
+    const Index size = LinearRange ? mat.size() : mat.outerSize();
+
+#if defined(EIGEN_PARALLELIZE_REDUX) && defined(EIGEN_HAS_OPENMP)
+    double work = static_cast<double>(mat.size()) * static_cast<double>(CoeffCost);
+    Index threads = (omp_get_num_threads()>1) ? 1 : parallel_threads(size / Granularity, work);
+#endif
+
+#ifdef EIGEN_REDUX_FIXED_TREE
+    const Index chunkSize = LinearRange ? Index(FixedChunkSize) : numext::maxi<Index>(1, FixedChunkSize / mat.innerSize());
+    const Index chunks = (size + chunkSize - 1) / chunkSize;
+#else
+    // without EIGEN_REDUX_FIXED_TREE, the reduction is split only if it is parallelized
+    if(threads==1)
+      return Impl::run(mat, func);
+    const Index chunks = threads;
+    const Index chunkSize = ((size / chunks) / Granularity) * Granularity;
+#endif
+    if(chunks==1)
+      return Impl::run(mat, func, 0, size);
+
+    ei_declare_aligned_stack_constructed_variable(Scalar, partial, chunks, 0);
+
+#if defined(EIGEN_PARALLELIZE_REDUX) && defined(EIGEN_HAS_OPENMP)
+    if(threads>1)
+    {
+      Eigen::initParallel();
+      #pragma omp parallel num_threads(threads)
+      {
+        // Note that the actual number of threads might be lower than the number of request ones.
+        Index actual_threads = omp_get_num_threads();
+        for(Index c = omp_get_thread_num(); c < chunks; c += actual_threads)
+          partial[c] = run_chunk(mat, func, c, chunks, chunkSize, size);
+      }
+    }
+    else
+#endif
+    {
+      for(Index c = 0; c < chunks; ++c)
+        partial[c] = run_chunk(mat, func, c, chunks, chunkSize, size);
+    }
+
+#ifdef EIGEN_REDUX_FIXED_TREE
+    for(Index step = 1; step < chunks; step *= 2)
+      for(Index c = 0; c+step < chunks; c += 2*step)
+        partial[c] = func(partial[c], partial[c+step]);
+    return partial[0];
+#else
+    Scalar res = partial[0];
+    for(Index c = 1; c < chunks; ++c)
+      res = func(res, partial[c]);
+    return res;
+#endif
+  }
+
+  static EIGEN_STRONG_INLINE Scalar run_chunk(const Derived &mat, const Func& func, Index c, Index chunks, Index chunkSize, Index size)
+  {
+    return Impl::run(mat, func, c*chunkSize, (c+1==chunks) ? size : (c+1)*chunkSize);
+  }
+};
+
+#endif // EIGEN_REDUX_BY_CHUNKS
+
 } // end namespace internal
 
 } // end namespace Eigen
@@ -147,13 +147,11 @@ EIGEN_DEVICE_FUNC inline void check_that_malloc_is_allowed()
 {}
 #endif
 
-/** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 or 32 bytes alignment depending on the requirements.
-  * On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
+/** \internal Allocates \a size bytes from the system. The returned pointer is guaranteed to have 16 or 32 bytes alignment
+  * depending on the requirements. On allocation error, the returned pointer is null. Does not throw any exception.
   */
-EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
+EIGEN_DEVICE_FUNC inline void* system_aligned_malloc(std::size_t size)
 {
-  check_that_malloc_is_allowed();
-
   void *result;
   #if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
     result = std::malloc(size);
@@ -163,6 +161,405 @@ EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
   #else
     result = handmade_aligned_malloc(size);
   #endif
+  return result;
+}
+
+/** \internal Frees memory allocated with system_aligned_malloc. */
+EIGEN_DEVICE_FUNC inline void system_aligned_free(void *ptr)
+{
+  #if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
+    std::free(ptr);
+  #else
+    handmade_aligned_free(ptr);
+  #endif
+}
+
+/** \internal Reallocates memory allocated with system_aligned_malloc. On allocation error, the returned pointer is null. */
+inline void* system_aligned_realloc(void *ptr, std::size_t new_size, std::size_t old_size)
+{
+  EIGEN_UNUSED_VARIABLE(old_size);
+#if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
+  return std::realloc(ptr,new_size);
+#else
+  return handmade_aligned_realloc(ptr,new_size,old_size);
+#endif
+}
+
+} // end namespace internal
+
+#ifdef EIGEN_ALLOCATOR_HOOKS
+
+/*****************************************************************************
+*** Pluggable memory resources                                             ***
+*****************************************************************************/
+
+#if EIGEN_HAS_CXX11
+  #define EIGEN_MEMORY_RESOURCE_TLS thread_local
+#elif EIGEN_COMP_MSVC
+  #define EIGEN_MEMORY_RESOURCE_TLS __declspec(thread)
+#else
+  #define EIGEN_MEMORY_RESOURCE_TLS __thread
+#endif
+
+/** \class MemoryResource
+  * \ingroup Core_Module
+  *
+  * \brief Base class of the memory resources which can serve the heap allocations of %Eigen
+  *
+  * When \c EIGEN_ALLOCATOR_HOOKS is defined, all the dynamic allocations performed by %Eigen, i.e., the storage of
+  * dynamic-size objects, the temporaries of products and decompositions, and the objects allocated through
+  * aligned_allocator or \c EIGEN_MAKE_ALIGNED_OPERATOR_NEW, are served by the memory resource of the calling thread
+  * if there is one, and by the system otherwise. The memory resource of a thread is selected by setMemoryResource(),
+  * or more conveniently within a scope with ScopedMemoryResource.
+  *
+  * Each block records the resource it comes from, so that it can be freed after the resource has been uninstalled,
+  * or by a thread using another resource. The resource must however outlive all the blocks it has allocated.
+  *
+  * A new resource is implemented by overriding doAllocate() and doDeallocate(). Blocks must be aligned as the ones
+  * returned by \c std::malloc and on \c EIGEN_MAX_ALIGN_BYTES. In addition, this class maintains counters of the
+  * allocations, which permit for instance to check that a steady-state loop does not allocate anymore:
+  * \code
+  * MallocResource counter;
+  * {
+  *   ScopedMemoryResource guard(counter);
+  *   x = lu.solve(b);
+  * }
+  * std::cout << counter.allocations() << " allocations, peak " << counter.peakBytes() << " bytes\n";
+  * \endcode
+  * The reported sizes include a small bookkeeping header per block.
+  *
+  * The counters are not atomic: a resource must not be used by several threads at the same time unless
+  * it is synchronized, and the usual way is to give a resource to each thread.
+  *
+  * \sa MallocResource, ArenaResource, ScopedMemoryResource
+  */
+class MemoryResource
+{
+  public:
+    MemoryResource()
+      : m_allocations(0), m_deallocations(0), m_totalBytes(0), m_bytesInUse(0), m_peakBytes(0)
+    {}
+
+    virtual ~MemoryResource() {}
+
+    /** \returns a block of \a size bytes, or a null pointer on allocation error */
+    void* allocate(std::size_t size)
+    {
+      void* ptr = doAllocate(size);
+      if(ptr)
+      {
+        ++m_allocations;
+        m_totalBytes += size;
+        m_bytesInUse += size;
+        m_peakBytes = (std::max)(m_peakBytes, m_bytesInUse);
+      }
+      return ptr;
+    }
+
+    /** Frees the block \a ptr of \a size bytes previously returned by allocate() */
+    void deallocate(void* ptr, std::size_t size)
+    {
+      if(ptr==0) return;
+      doDeallocate(ptr, size);
+      ++m_deallocations;
+      m_bytesInUse -= size;
+    }
+
+    /** \returns the number of allocations served by this resource */
+    std::size_t allocations() const { return m_allocations; }
+    /** \returns the number of blocks freed by this resource */
+    std::size_t deallocations() const { return m_deallocations; }
+    /** \returns the total number of bytes allocated by this resource */
+    std::size_t totalBytes() const { return m_totalBytes; }
+    /** \returns the number of bytes of the blocks which have not been freed yet */
+    std::size_t bytesInUse() const { return m_bytesInUse; }
+    /** \returns the maximal value of bytesInUse() since the creation of the resource or the last call to resetCounters() */
+    std::size_t peakBytes() const { return m_peakBytes; }
+
+    /** Resets all the counters but bytesInUse() */
+    void resetCounters()
+    {
+      m_allocations = m_deallocations = m_totalBytes = 0;
+      m_peakBytes = m_bytesInUse;
+    }
+
+  protected:
+    /** Allocates \a size bytes, and returns a null pointer on allocation error. */
+    virtual void* doAllocate(std::size_t size) = 0;
+    /** Frees the block \a ptr of \a size bytes */
+    virtual void doDeallocate(void* ptr, std::size_t size) = 0;
+
+  private:
+    MemoryResource(const MemoryResource&);
+    MemoryResource& operator=(const MemoryResource&);
+
+    std::size_t m_allocations;
+    std::size_t m_deallocations;
+    std::size_t m_totalBytes;
+    std::size_t m_bytesInUse;
+    std::size_t m_peakBytes;
+};
+
+/** \class MallocResource
+  * \ingroup Core_Module
+  *
+  * \brief A memory resource forwarding to the system allocator
+  *
+  * This resource behaves as the default allocation path of %Eigen, and is useful to count the allocations.
+  *
+  * \sa MemoryResource
+  */
+class MallocResource : public MemoryResource
+{
+  protected:
+    virtual void* doAllocate(std::size_t size) { return internal::system_aligned_malloc(size); }
+    virtual void doDeallocate(void* ptr, std::size_t) { internal::system_aligned_free(ptr); }
+};
+
+/** \class ArenaResource
+  * \ingroup Core_Module
+  *
+  * \brief A memory resource serving the allocations from a preallocated buffer
+  *
+  * The blocks are allocated by bumping an offset in a buffer of fixed capacity, and the memory is reclaimed as soon as
+  * the most recent blocks are freed. Since the temporaries of %Eigen are mostly freed in the reverse order of their
+  * allocation, a loop running within the scope of an arena of sufficient capacity does not hit the system allocator
+  * once its first iteration completed. When the buffer is exhausted, the allocations fall back to the system allocator,
+  * and overflows() counts them. highWaterMark() tells how large the buffer should have been.
+  *
+  * An arena is not synchronized, which makes it a fast thread-local allocator:
+  * \code
+  * #pragma omp parallel
+  * {
+  *   ArenaResource arena(1<<20);
+  *   ScopedMemoryResource guard(arena);
+  *   #pragma omp for
+  *   for(int i=0; i<n; ++i)
+  *     x.col(i) = A[i].ldlt().solve(b.col(i));
+  * }
+  * \endcode
+  * The blocks allocated in an arena must not be freed by another thread while the arena is used.
+  *
+  * \sa MemoryResource, ScopedMemoryResource
+  */
+class ArenaResource : public MemoryResource
+{
+  public:
+    /** Creates an arena of \a capacity bytes.
+      * \throws std::bad_alloc if the buffer cannot be allocated
+      */
+    explicit ArenaResource(std::size_t capacity)
+      : m_buffer(static_cast<char*>(internal::system_aligned_malloc(capacity))),
+        m_capacity(capacity), m_offset(0), m_top(0), m_highWaterMark(0), m_overflows(0)
+    {
+      if(m_buffer==0 && capacity)
+        internal::throw_std_bad_alloc();
+    }
+
+    virtual ~ArenaResource()
+    {
+      eigen_assert(m_offset==0 && "ArenaResource destroyed while some of its blocks are in use");
+      internal::system_aligned_free(m_buffer);
+    }
+
+    /** \returns the size of the buffer in bytes */
+    std::size_t capacity() const { return m_capacity; }
+    /** \returns the number of bytes of the buffer currently reserved */
+    std::size_t used() const { return m_offset; }
+    /** \returns the maximal value of used() */
+    std::size_t highWaterMark() const { return m_highWaterMark; }
+    /** \returns the number of allocations which did not fit in the buffer and were served by the system allocator */
+    std::size_t overflows() const { return m_overflows; }
+
+  protected:
+    enum { Alignment = EIGEN_DEFAULT_ALIGN_BYTES > 16 ? EIGEN_DEFAULT_ALIGN_BYTES : 16 };
+
+    // each block is preceded by the offset of the previous block, and a flag telling whether it has been freed
+    struct BlockInfo
+    {
+      std::size_t previous;
+      std::size_t freed;
+    };
+
+    BlockInfo* blockInfo(std::size_t offset) const { return reinterpret_cast<BlockInfo*>(m_buffer + offset); }
+
+    virtual void* doAllocate(std::size_t size)
+    {
+      std::size_t bytes = Alignment + (size + Alignment - 1) / Alignment * Alignment;
+      if(bytes < size || bytes > m_capacity - m_offset)
+      {
+        ++m_overflows;
+        return internal::system_aligned_malloc(size);
+      }
+      BlockInfo* info = blockInfo(m_offset);
+      info->previous = m_top;
+      info->freed = 0;
+      m_top = m_offset;
+      m_offset += bytes;
+      m_highWaterMark = (std::max)(m_highWaterMark, m_offset);
+      return m_buffer + m_top + Alignment;
+    }
+
+    virtual void doDeallocate(void* ptr, std::size_t)
+    {
+      char* block = static_cast<char*>(ptr);
+      if(block < m_buffer || block >= m_buffer + m_capacity)
+      {
+        internal::system_aligned_free(ptr);
+        return;
+      }
+      reinterpret_cast<BlockInfo*>(block - Alignment)->freed = 1;
+      // pop the freed blocks from the top of the stack
+      while(m_offset!=0 && blockInfo(m_top)->freed)
+      {
+        m_offset = m_top;
+        m_top = blockInfo(m_top)->previous;
+      }
+    }
+
+  private:
+    char* m_buffer;
+    std::size_t m_capacity;
+    std::size_t m_offset;
+    std::size_t m_top;
+    std::size_t m_highWaterMark;
+    std::size_t m_overflows;
+};
+
+namespace internal {
+
+inline MemoryResource* memory_resource_impl(bool update, MemoryResource* new_value = 0)
+{
+  static EIGEN_MEMORY_RESOURCE_TLS MemoryResource* value = 0;
+  MemoryResource* previous = value;
+  if(update)
+    value = new_value;
+  return previous;
+}
+
+} // end namespace internal
+
+/** \returns the memory resource serving the allocations of the calling thread, or a null pointer if %Eigen uses the system allocator
+  * \sa setMemoryResource(), ScopedMemoryResource */
+inline MemoryResource* memoryResource() { return internal::memory_resource_impl(false); }
+
+/** Sets the memory resource serving the allocations of the calling thread. A null pointer restores the system allocator.
+  * \returns the previous memory resource
+  * \sa memoryResource(), ScopedMemoryResource */
+inline MemoryResource* setMemoryResource(MemoryResource* resource) { return internal::memory_resource_impl(true, resource); }
+
+/** \class ScopedMemoryResource
+  * \ingroup Core_Module
+  *
+  * \brief Installs a memory resource for the calling thread during its lifetime
+  *
+  * The previous memory resource of the thread is restored by the destructor, so that guards can be nested.
+  *
+  * \sa MemoryResource, setMemoryResource()
+  */
+class ScopedMemoryResource
+{
+  public:
+    explicit ScopedMemoryResource(MemoryResource& resource) : m_previous(setMemoryResource(&resource)) {}
+    ~ScopedMemoryResource() { setMemoryResource(m_previous); }
+
+  private:
+    ScopedMemoryResource(const ScopedMemoryResource&);
+    ScopedMemoryResource& operator=(const ScopedMemoryResource&);
+
+    MemoryResource* m_previous;
+};
+
+namespace internal {
+
+// Every block starts with a header storing its resource and its size, padded to preserve the alignment.
+struct memory_resource_header
+{
+  MemoryResource* resource;
+  std::size_t size;
+};
+
+enum { memory_resource_header_size = EIGEN_DEFAULT_ALIGN_BYTES > 16 ? EIGEN_DEFAULT_ALIGN_BYTES : 16 };
+
+inline memory_resource_header* memory_resource_header_of(void* ptr)
+{
+  return reinterpret_cast<memory_resource_header*>(ptr) - 1;
+}
+
+/** \internal Allocates \a size bytes from the memory resource of the calling thread. Returns a null pointer on allocation error. */
+inline void* memory_resource_malloc(std::size_t size)
+{
+  MemoryResource* resource = memory_resource_impl(false);
+  std::size_t bytes = size + memory_resource_header_size;
+  if(bytes < size)
+    return 0;
+  void* block = resource ? resource->allocate(bytes) : system_aligned_malloc(bytes);
+  if(block==0)
+    return 0;
+  void* result = static_cast<char*>(block) + memory_resource_header_size;
+  memory_resource_header_of(result)->resource = resource;
+  memory_resource_header_of(result)->size = bytes;
+  return result;
+}
+
+/** \internal Frees memory allocated with memory_resource_malloc, possibly by another resource than the current one */
+inline void memory_resource_free(void* ptr)
+{
+  if(ptr==0) return;
+  memory_resource_header header = *memory_resource_header_of(ptr);
+  void* block = static_cast<char*>(ptr) - memory_resource_header_size;
+  if(header.resource)
+    header.resource->deallocate(block, header.size);
+  else
+    system_aligned_free(block);
+}
+
+/** \internal Reallocates memory allocated with memory_resource_malloc. Returns a null pointer on allocation error. */
+inline void* memory_resource_realloc(void* ptr, std::size_t new_size)
+{
+  if(ptr==0)
+    return memory_resource_malloc(new_size);
+  memory_resource_header header = *memory_resource_header_of(ptr);
+  if(header.resource==0 && memory_resource_impl(false)==0)
+  {
+    // both the old and new blocks belong to the system allocator
+    std::size_t bytes = new_size + memory_resource_header_size;
+    if(bytes < new_size)
+      return 0;
+    void* block = system_aligned_realloc(static_cast<char*>(ptr) - memory_resource_header_size, bytes, header.size);
+    if(block==0)
+      return 0;
+    void* result = static_cast<char*>(block) + memory_resource_header_size;
+    memory_resource_header_of(result)->size = bytes;
+    return result;
+  }
+  void* result = memory_resource_malloc(new_size);
+  if(result==0)
+    return 0;
+  std::memcpy(result, ptr, (std::min)(new_size, header.size - std::size_t(memory_resource_header_size)));
+  memory_resource_free(ptr);
+  return result;
+}
+
+#else // EIGEN_ALLOCATOR_HOOKS
+
+namespace internal {
+
+#endif // EIGEN_ALLOCATOR_HOOKS
+
+/** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 or 32 bytes alignment depending on the requirements.
+  * On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
+  */
+EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
+{
+  check_that_malloc_is_allowed();
+
+  void *result;
+  #if defined(EIGEN_ALLOCATOR_HOOKS) && !defined(__CUDA_ARCH__)
+    result = memory_resource_malloc(size);
+  #else
+    result = system_aligned_malloc(size);
+  #endif
 
   if(!result && size)
     throw_std_bad_alloc();
@@ -173,10 +570,10 @@ EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
 /** \internal Frees memory allocated with aligned_malloc. */
 EIGEN_DEVICE_FUNC inline void aligned_free(void *ptr)
 {
-  #if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
-    std::free(ptr);
+  #if defined(EIGEN_ALLOCATOR_HOOKS) && !defined(__CUDA_ARCH__)
+    memory_resource_free(ptr);
   #else
-    handmade_aligned_free(ptr);
+    system_aligned_free(ptr);
   #endif
 }
 
@@ -187,13 +584,12 @@ EIGEN_DEVICE_FUNC inline void aligned_free(void *ptr)
   */
 inline void* aligned_realloc(void *ptr, std::size_t new_size, std::size_t old_size)
 {
-  EIGEN_UNUSED_VARIABLE(old_size);
-
   void *result;
-#if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
-  result = std::realloc(ptr,new_size);
+#ifdef EIGEN_ALLOCATOR_HOOKS
+  EIGEN_UNUSED_VARIABLE(old_size);
+  result = memory_resource_realloc(ptr,new_size);
 #else
-  result = handmade_aligned_realloc(ptr,new_size,old_size);
+  result = system_aligned_realloc(ptr,new_size,old_size);
 #endif
 
   if (!result && new_size)
@@ -214,6 +610,9 @@ template<bool Align> EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc(s
   return aligned_malloc(size);
 }
 
+// With EIGEN_ALLOCATOR_HOOKS, the unaligned versions use the aligned ones so that they go through the memory resources
+#ifndef EIGEN_ALLOCATOR_HOOKS
+
 template<> EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc<false>(std::size_t size)
 {
   check_that_malloc_is_allowed();
@@ -224,27 +623,37 @@ template<> EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc<false>(std:
   return result;
 }
 
+#endif
+
 /** \internal Frees memory allocated with conditional_aligned_malloc */
 template<bool Align> EIGEN_DEVICE_FUNC inline void conditional_aligned_free(void *ptr)
 {
   aligned_free(ptr);
 }
 
+#ifndef EIGEN_ALLOCATOR_HOOKS
+
 template<> EIGEN_DEVICE_FUNC inline void conditional_aligned_free<false>(void *ptr)
 {
   std::free(ptr);
 }
 
+#endif
+
 template<bool Align> inline void* conditional_aligned_realloc(void* ptr, std::size_t new_size, std::size_t old_size)
 {
   return aligned_realloc(ptr, new_size, old_size);
 }
 
+#ifndef EIGEN_ALLOCATOR_HOOKS
+
 template<> inline void* conditional_aligned_realloc<false>(void* ptr, std::size_t new_size, std::size_t)
 {
   return std::realloc(ptr, new_size);
 }
 
+#endif
+
 /*****************************************************************************
 *** Construction/destruction of array elements                             ***
 *****************************************************************************/
@@ -24,7 +24,7 @@ namespace Eigen {
   *
   * This class represents an axis aligned box as a pair of the minimal and maximal corners.
   * \warning The result of most methods is undefined when applied to an empty box. You can check for empty boxes using isEmpty().
-  * \sa alignedboxtypedefs
+  * \sa alignedboxtypedefs, batchRayBoxIntersection()
   */
 template <typename _Scalar, int _AmbientDim>
 class AlignedBox
@@ -0,0 +1,228 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_ALIGNEDBOX_RAY_H
+#define EIGEN_ALIGNEDBOX_RAY_H
+
+namespace Eigen {
+
+/** \geometry_module \ingroup Geometry_Module
+  *
+  * \name Ray and axis aligned box intersections
+  *
+  * The following functions intersect rays with axis aligned boxes using the slab method: the parameters at which a ray
+  * enters and exits the box are the largest entry and the smallest exit parameters over the slabs bounded by the faces
+  * of the box along each axis. A ray \c origin \c + \c t \c * \c direction hits a box if its entry parameter is not larger
+  * than its exit parameter, the parameter \c t being restricted to the range [0, \a tMax].
+  *
+  * The sets of rays and of boxes are stored as structures of arrays: the columns of a \c Dim \c x \c N matrix are the origins
+  * or the inverse directions of \c N rays, or the minimal or maximal corners of \c N boxes. They are processed by blocks
+  * transposed such that each SIMD instruction operates on several rays or boxes.
+  *
+  * Rays parallel to an axis are handled robustly: the inverse directions computed by rayInverseDirections() are clamped to
+  * finite values, such that no NaN is generated, and the slab of an axis parallel to a ray is tested by comparing the origin
+  * of the ray to the faces of the slab, inclusive. Empty boxes and rays with NaN coordinates are never hit.
+  *
+  * @{
+  */
+
+namespace internal {
+
+template<typename Scalar> struct scalar_ray_inverse_direction_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_ray_inverse_direction_op)
+  EIGEN_DEVICE_FUNC inline Scalar operator() (const Scalar& a) const
+  {
+    Scalar inv = Scalar(1) / a;
+    if((numext::isinf)(inv))
+      return (inv > Scalar(0)) ? NumTraits<Scalar>::highest() : NumTraits<Scalar>::lowest();
+    return inv;
+  }
+};
+
+template<typename Scalar, int Dim>
+struct ray_box_batch
+{
+  enum { BlockSize = 128 };
+  typedef Array<Scalar,Dim,Dynamic,RowMajor,Dim,BlockSize> Block;
+  typedef Array<Scalar,1,Dynamic,RowMajor,1,BlockSize> RowType;
+  typedef Array<bool,1,Dynamic,RowMajor,1,BlockSize> MaskType;
+
+  template<typename EntryType, typename ExitType, typename HitsType>
+  static void resize(Index size, EntryType& tEntry, ExitType& tExit, HitsType& hits)
+  {
+    tEntry.resize(size);
+    tExit.resize(size);
+    hits.resize(size);
+  }
+
+  template<typename EntryType, typename ExitType, typename HitsType>
+  static void miss(EntryType& tEntry, ExitType& tExit, HitsType& hits)
+  {
+    tEntry.setConstant(NumTraits<Scalar>::quiet_NaN());
+    tExit.setConstant(NumTraits<Scalar>::quiet_NaN());
+    hits.setConstant(false);
+  }
+};
+
+} // end namespace internal
+
+/** Computes the inverses of the columns of the \c Dim \c x \c N matrix \a directions, to be passed to batchRayBoxIntersection().
+  * The components of the directions which are zero or too small to be inverted are mapped to the largest finite values of the
+  * same sign, such that the slabs of the axes parallel to the rays do not generate NaN.
+  */
+template<typename DirectionsType, typename ResultType>
+void rayInverseDirections(const MatrixBase<DirectionsType>& directions, const MatrixBase<ResultType>& result)
+{
+  typedef typename DirectionsType::Scalar Scalar;
+  result.const_cast_derived() = directions.unaryExpr(internal::scalar_ray_inverse_direction_op<Scalar>());
+}
+
+/** Intersects the ray \a ray with the boxes whose minimal and maximal corners are the columns of \a mins and \a maxs.
+  *
+  * On output, \a tEntry and \a tExit are the vectors of the parameters at which the ray enters and exits each box, and
+  * \a hits is the boolean vector telling whether each box is hit. The parameters are meaningless for the boxes which are
+  * not hit. Storing \a mins and \a maxs in row major order avoids the transposition of the boxes.
+  *
+  * \returns the number of boxes hit by the ray
+  *
+  * \sa AlignedBox
+  */
+template<typename Scalar, int Dim, int Options, typename MinsType, typename MaxsType, typename EntryType, typename ExitType, typename HitsType>
+Index batchRayBoxIntersection(const ParametrizedLine<Scalar,Dim,Options>& ray, const MatrixBase<MinsType>& mins, const MatrixBase<MaxsType>& maxs,
+                              const MatrixBase<EntryType>& tEntry, const MatrixBase<ExitType>& tExit, const ArrayBase<HitsType>& hits,
+                              const Scalar& tMax = NumTraits<Scalar>::infinity())
+{
+  typedef internal::ray_box_batch<Scalar,Dim> Impl;
+  typedef typename Impl::RowType RowType;
+  EIGEN_STATIC_ASSERT((internal::is_same<Scalar,typename MinsType::Scalar>::value && internal::is_same<Scalar,typename MaxsType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(mins.rows()==ray.dim() && maxs.rows()==ray.dim() && mins.cols()==maxs.cols());
+
+  EntryType& entry = tEntry.const_cast_derived();
+  ExitType& exit = tExit.const_cast_derived();
+  HitsType& hit = hits.const_cast_derived();
+  const Index size = mins.cols();
+  Impl::resize(size, entry, exit, hit);
+
+  typedef Matrix<Scalar,Dim,1> VectorType;
+  VectorType invDirection(ray.dim());
+  rayInverseDirections(ray.direction(), invDirection);
+  if(ray.origin().hasNaN() || invDirection.hasNaN()) {
+    Impl::miss(entry, exit, hit);
+    return 0;
+  }
+
+  typename Impl::Block lower, upper;
+  RowType t0, t1;
+  Index count = 0;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    lower = mins.middleCols(j,n).array();
+    upper = maxs.middleCols(j,n).array();
+    t0.setConstant(n, Scalar(0));
+    t1.setConstant(n, tMax);
+    for(Index k = 0; k < ray.dim(); ++k)
+    {
+      const Scalar o = ray.origin()[k], inv = invDirection[k];
+      if(numext::abs(inv) == NumTraits<Scalar>::highest())
+      {
+        // the ray is parallel to the slab
+        t0 = (lower.row(k) <= o && upper.row(k) >= o).select(t0, NumTraits<Scalar>::infinity());
+        continue;
+      }
+      // the slab is entered through its lower face if the ray goes in the positive direction, which keeps empty boxes empty
+      const typename Impl::Block& nearFaces = inv >= Scalar(0) ? lower : upper;
+      const typename Impl::Block& farFaces = inv >= Scalar(0) ? upper : lower;
+      t0 = t0.cwiseMax((nearFaces.row(k) - o) * inv);
+      t1 = t1.cwiseMin((farFaces.row(k) - o) * inv);
+    }
+    entry.segment(j,n) = t0.matrix();
+    exit.segment(j,n) = t1.matrix();
+    hit.segment(j,n) = t0 <= t1;
+    count += hit.segment(j,n).count();
+  }
+  return count;
+}
+
+/** Intersects the rays whose origins and inverse directions are the columns of \a origins and \a invDirections with the box \a box.
+  * The inverse directions must be computed by rayInverseDirections(), such that they can be reused for several boxes.
+  *
+  * On output, \a tEntry and \a tExit are the vectors of the parameters at which each ray enters and exits the box, and
+  * \a hits is the boolean vector telling whether each ray hits the box. The parameters are meaningless for the rays which
+  * do not hit the box.
+  *
+  * \returns the number of rays hitting the box
+  *
+  * \sa rayInverseDirections(), AlignedBox
+  */
+template<typename OriginsType, typename InvDirectionsType, typename Scalar, int Dim, typename EntryType, typename ExitType, typename HitsType>
+Index batchRayBoxIntersection(const MatrixBase<OriginsType>& origins, const MatrixBase<InvDirectionsType>& invDirections, const AlignedBox<Scalar,Dim>& box,
+                              const MatrixBase<EntryType>& tEntry, const MatrixBase<ExitType>& tExit, const ArrayBase<HitsType>& hits,
+                              const Scalar& tMax = NumTraits<Scalar>::infinity())
+{
+  typedef internal::ray_box_batch<Scalar,Dim> Impl;
+  typedef typename Impl::RowType RowType;
+  EIGEN_STATIC_ASSERT((internal::is_same<Scalar,typename OriginsType::Scalar>::value && internal::is_same<Scalar,typename InvDirectionsType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(origins.rows()==box.dim() && invDirections.rows()==box.dim() && origins.cols()==invDirections.cols());
+
+  EntryType& entry = tEntry.const_cast_derived();
+  ExitType& exit = tExit.const_cast_derived();
+  HitsType& hit = hits.const_cast_derived();
+  const Index size = origins.cols();
+  Impl::resize(size, entry, exit, hit);
+  if(box.isEmpty()) {
+    Impl::miss(entry, exit, hit);
+    return 0;
+  }
+
+  typename Impl::Block o, inv;
+  RowType t0, t1, nanProbe, lowerT, upperT, nearT, farT;
+  Index count = 0;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    o = origins.middleCols(j,n).array();
+    inv = invDirections.middleCols(j,n).array();
+    t0.setConstant(n, Scalar(0));
+    t1.setConstant(n, tMax);
+    nanProbe.setZero(n);
+    for(Index k = 0; k < box.dim(); ++k)
+    {
+      lowerT = ((box.min)()[k] - o.row(k)) * inv.row(k);
+      upperT = ((box.max)()[k] - o.row(k)) * inv.row(k);
+      nearT = lowerT.cwiseMin(upperT);
+      farT = lowerT.cwiseMax(upperT);
+      if(inv.row(k).abs().maxCoeff() == NumTraits<Scalar>::highest())
+      {
+        // the rays parallel to the slab are either inside or outside of it
+        const Scalar inf = NumTraits<Scalar>::infinity();
+        const typename Impl::MaskType parallel = inv.row(k).abs() == NumTraits<Scalar>::highest();
+        const typename Impl::MaskType inside = o.row(k) >= (box.min)()[k] && o.row(k) <= (box.max)()[k];
+        nearT = parallel.select(inside.select(RowType::Constant(n, -inf), inf), nearT);
+        farT = parallel.select(RowType::Constant(n, inf), farT);
+      }
+      t0 = t0.cwiseMax(nearT);
+      t1 = t1.cwiseMin(farT);
+      // the packet and scalar min/max do not agree on NaN, so NaN rays are tracked separately
+      nanProbe += o.row(k) * Scalar(0) + inv.row(k) * Scalar(0);
+    }
+    t0 += nanProbe;
+    entry.segment(j,n) = t0.matrix();
+    exit.segment(j,n) = t1.matrix();
+    hit.segment(j,n) = t0 <= t1;
+    count += hit.segment(j,n).count();
+  }
+  return count;
+}
+
+/** @} */
+
+} // end namespace Eigen
+
+#endif // EIGEN_ALIGNEDBOX_RAY_H
@@ -0,0 +1,237 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_QUATERNION_BATCH_H
+#define EIGEN_QUATERNION_BATCH_H
+
+namespace Eigen {
+
+/** \geometry_module \ingroup Geometry_Module
+  *
+  * \name Batched quaternion operations
+  *
+  * The following functions apply the operations of the Quaternion class to sets of quaternions
+  * stored as the columns of a 4 x N matrix, in the order of Quaternion::coeffs(), i.e., (x, y, z, w).
+  * An array of N quaternions can therefore be processed through a Map:
+  * \code
+  * std::vector<Quaternionf, aligned_allocator<Quaternionf> > q(n);
+  * Map<Matrix4Xf> qs(q[0].coeffs().data(), 4, n);
+  * \endcode
+  *
+  * The quaternions are processed by blocks transposed to a structure of arrays layout, such that each
+  * SIMD instruction operates on several quaternions. The result can be the same as one of the arguments.
+  *
+  * @{
+  */
+
+namespace internal {
+
+template<typename Scalar>
+struct quaternion_batch
+{
+  enum { BlockSize = 128 };
+  typedef Array<Scalar,4,Dynamic,RowMajor,4,BlockSize> QuatBlock;
+  typedef Array<Scalar,3,Dynamic,RowMajor,3,BlockSize> VecBlock;
+  typedef Array<Scalar,1,Dynamic,RowMajor,1,BlockSize> RowType;
+
+  template<typename Lhs, typename Rhs>
+  static void check(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs, Index lhsRows, Index rhsRows)
+  {
+    EIGEN_STATIC_ASSERT((is_same<Scalar,typename Lhs::Scalar>::value && is_same<Scalar,typename Rhs::Scalar>::value),
+                        YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+    EIGEN_ONLY_USED_FOR_DEBUG(lhsRows);
+    EIGEN_ONLY_USED_FOR_DEBUG(rhsRows);
+    eigen_assert(lhs.rows()==lhsRows && rhs.rows()==rhsRows && lhs.cols()==rhs.cols());
+  }
+
+  // res = a * b
+  static void product(const QuatBlock& a, const QuatBlock& b, QuatBlock& res)
+  {
+    res.resize(4, a.cols());
+    res.row(0) = a.row(3) * b.row(0) + a.row(0) * b.row(3) + a.row(1) * b.row(2) - a.row(2) * b.row(1);
+    res.row(1) = a.row(3) * b.row(1) + a.row(1) * b.row(3) + a.row(2) * b.row(0) - a.row(0) * b.row(2);
+    res.row(2) = a.row(3) * b.row(2) + a.row(2) * b.row(3) + a.row(0) * b.row(1) - a.row(1) * b.row(0);
+    res.row(3) = a.row(3) * b.row(3) - a.row(0) * b.row(0) - a.row(1) * b.row(1) - a.row(2) * b.row(2);
+  }
+
+  // res = q.vec() x v
+  static void cross(const QuatBlock& q, const VecBlock& v, VecBlock& res)
+  {
+    res.resize(3, q.cols());
+    res.row(0) = q.row(1) * v.row(2) - q.row(2) * v.row(1);
+    res.row(1) = q.row(2) * v.row(0) - q.row(0) * v.row(2);
+    res.row(2) = q.row(0) * v.row(1) - q.row(1) * v.row(0);
+  }
+
+  // res = q * v, following Quaternion::_transformVector()
+  static void rotate(const QuatBlock& q, const VecBlock& v, VecBlock& res)
+  {
+    VecBlock uv, uv2;
+    cross(q, v, uv);
+    uv += uv;
+    cross(q, uv, uv2);
+    res = v + uv.rowwise() * q.row(3) + uv2;
+  }
+
+  // res = a.slerp(t, b)
+  static void slerp(const RowType& t, const QuatBlock& a, const QuatBlock& b, QuatBlock& res)
+  {
+    const Scalar one = Scalar(1) - NumTraits<Scalar>::epsilon();
+    RowType d = (a * b).colwise().sum();
+    RowType absD = d.abs();
+    // theta is the angle between the 2 quaternions, the nearly parallel ones use a linear interpolation
+    RowType theta = absD.cwiseMin(one).acos();
+    RowType sinTheta = theta.sin();
+    RowType scale0 = (absD>=one).select(Scalar(1) - t, ((Scalar(1) - t) * theta).sin() / sinTheta);
+    RowType scale1 = (absD>=one).select(t, (t * theta).sin() / sinTheta);
+    scale1 = (d<Scalar(0)).select(-scale1, scale1);
+    res = a.rowwise() * scale0 + b.rowwise() * scale1;
+  }
+
+  // res = ((1-t) * a + t * b).normalized(), b being flipped to the hemisphere of a
+  static void nlerp(const RowType& t, const QuatBlock& a, const QuatBlock& b, QuatBlock& res)
+  {
+    RowType d = (a * b).colwise().sum();
+    RowType scale1 = (d<Scalar(0)).select(-t, t);
+    res = a.rowwise() * (Scalar(1) - t) + b.rowwise() * scale1;
+    RowType invNorm = res.square().colwise().sum().rsqrt();
+    res.rowwise() *= invNorm;
+  }
+};
+
+template<typename Scalar, typename Weights, typename LhsType, typename RhsType, typename ResultType>
+void quaternion_batch_interpolate(bool spherical, const Weights& t, const MatrixBase<LhsType>& a,
+                                  const MatrixBase<RhsType>& b, const MatrixBase<ResultType>& result)
+{
+  typedef quaternion_batch<Scalar> Impl;
+  Impl::check(a, b, 4, 4);
+  eigen_assert(t.size()==a.cols());
+  ResultType& res = result.const_cast_derived();
+  const Index size = a.cols();
+  res.resize(4, size);
+  typename Impl::QuatBlock qa, qb, qr;
+  typename Impl::RowType w;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    qa = a.middleCols(j,n).array();
+    qb = b.middleCols(j,n).array();
+    w = t.segment(j,n).array();
+    if(spherical)
+      Impl::slerp(w, qa, qb, qr);
+    else
+      Impl::nlerp(w, qa, qb, qr);
+    res.middleCols(j,n) = qr.matrix();
+  }
+}
+
+} // end namespace internal
+
+/** Computes the products \c lhs[i] \c * \c rhs[i] of two sets of quaternions stored as 4 x N matrices.
+  *
+  * \sa Quaternion::operator*(const QuaternionBase<OtherDerived>&) const */
+template<typename LhsType, typename RhsType, typename ResultType>
+void batchQuaternionProduct(const MatrixBase<LhsType>& lhs, const MatrixBase<RhsType>& rhs, const MatrixBase<ResultType>& result)
+{
+  typedef internal::quaternion_batch<typename LhsType::Scalar> Impl;
+  Impl::check(lhs, rhs, 4, 4);
+  ResultType& res = result.const_cast_derived();
+  const Index size = lhs.cols();
+  res.resize(4, size);
+  typename Impl::QuatBlock a, b, r;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    a = lhs.middleCols(j,n).array();
+    b = rhs.middleCols(j,n).array();
+    Impl::product(a, b, r);
+    res.middleCols(j,n) = r.matrix();
+  }
+}
+
+/** Computes the conjugates of a set of quaternions stored as a 4 x N matrix.
+  *
+  * \sa Quaternion::conjugate() */
+template<typename QuatsType, typename ResultType>
+void batchQuaternionConjugate(const MatrixBase<QuatsType>& quats, const MatrixBase<ResultType>& result)
+{
+  eigen_assert(quats.rows()==4);
+  ResultType& res = result.const_cast_derived();
+  res = quats;
+  res.topRows(3) = -res.topRows(3);
+}
+
+/** Rotates the columns of the 3 x N matrix \a vectors by the respective quaternions of \a quats.
+  *
+  * \sa Quaternion::_transformVector() */
+template<typename QuatsType, typename VectorsType, typename ResultType>
+void batchQuaternionRotate(const MatrixBase<QuatsType>& quats, const MatrixBase<VectorsType>& vectors, const MatrixBase<ResultType>& result)
+{
+  typedef internal::quaternion_batch<typename QuatsType::Scalar> Impl;
+  Impl::check(quats, vectors, 4, 3);
+  ResultType& res = result.const_cast_derived();
+  const Index size = quats.cols();
+  res.resize(3, size);
+  typename Impl::QuatBlock q;
+  typename Impl::VecBlock v, r;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    q = quats.middleCols(j,n).array();
+    v = vectors.middleCols(j,n).array();
+    Impl::rotate(q, v, r);
+    res.middleCols(j,n) = r.matrix();
+  }
+}
+
+/** Computes the spherical linear interpolations \c a[i].slerp(t[i], \c b[i]) of two sets of quaternions,
+  * \a t being a vector of N interpolation parameters.
+  *
+  * \sa Quaternion::slerp() */
+template<typename WeightsType, typename LhsType, typename RhsType, typename ResultType>
+void batchQuaternionSlerp(const MatrixBase<WeightsType>& t, const MatrixBase<LhsType>& a, const MatrixBase<RhsType>& b,
+                          const MatrixBase<ResultType>& result)
+{
+  internal::quaternion_batch_interpolate<typename LhsType::Scalar>(true, t.derived(), a, b, result);
+}
+
+/** \overload with the same interpolation parameter \a t for all the quaternions */
+template<typename LhsType, typename RhsType, typename ResultType>
+void batchQuaternionSlerp(const typename LhsType::Scalar& t, const MatrixBase<LhsType>& a, const MatrixBase<RhsType>& b,
+                          const MatrixBase<ResultType>& result)
+{
+  typedef Matrix<typename LhsType::Scalar,1,Dynamic> RowVectorType;
+  internal::quaternion_batch_interpolate<typename LhsType::Scalar>(true, RowVectorType::Constant(a.cols(), t), a, b, result);
+}
+
+/** Computes the normalized linear interpolations of two sets of quaternions, \a t being a vector of N
+  * interpolation parameters. Each quaternion of \a b is negated if needed to interpolate along the shortest path,
+  * and the result is normalized using the fast reciprocal square root of the packet math when available.
+  * This is cheaper than batchQuaternionSlerp(), at the price of a non constant angular velocity.
+  *
+  * \sa batchQuaternionSlerp() */
+template<typename WeightsType, typename LhsType, typename RhsType, typename ResultType>
+void batchQuaternionNlerp(const MatrixBase<WeightsType>& t, const MatrixBase<LhsType>& a, const MatrixBase<RhsType>& b,
+                          const MatrixBase<ResultType>& result)
+{
+  internal::quaternion_batch_interpolate<typename LhsType::Scalar>(false, t.derived(), a, b, result);
+}
+
+/** \overload with the same interpolation parameter \a t for all the quaternions */
+template<typename LhsType, typename RhsType, typename ResultType>
+void batchQuaternionNlerp(const typename LhsType::Scalar& t, const MatrixBase<LhsType>& a, const MatrixBase<RhsType>& b,
+                          const MatrixBase<ResultType>& result)
+{
+  typedef Matrix<typename LhsType::Scalar,1,Dynamic> RowVectorType;
+  internal::quaternion_batch_interpolate<typename LhsType::Scalar>(false, RowVectorType::Constant(a.cols(), t), a, b, result);
+}
+
+/** @} */
+
+} // end namespace Eigen
+
+#endif // EIGEN_QUATERNION_BATCH_H
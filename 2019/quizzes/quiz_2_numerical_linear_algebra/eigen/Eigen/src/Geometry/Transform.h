@@ -618,6 +618,13 @@ public:
   EIGEN_DEVICE_FUNC
   inline Transform inverse(TransformTraits traits = (TransformTraits)Mode) const;
 
+  template<typename PointsType, typename ResultType>
+  void transformPoints(const MatrixBase<PointsType>& points, const MatrixBase<ResultType>& result) const;
+  template<typename VectorsType, typename ResultType>
+  void transformVectors(const MatrixBase<VectorsType>& vectors, const MatrixBase<ResultType>& result) const;
+  template<typename NormalsType, typename ResultType>
+  void transformNormals(const MatrixBase<NormalsType>& normals, const MatrixBase<ResultType>& result) const;
+
   /** \returns a const pointer to the column major internal matrix */
   EIGEN_DEVICE_FUNC const Scalar* data() const { return m_matrix.data(); }
   /** \returns a non-const pointer to the column major internal matrix */
@@ -1230,6 +1237,154 @@ Transform<Scalar,Dim,Mode,Options>::inverse(TransformTraits hint) const
 
 namespace internal {
 
+/*****************************************************
+*** Batched transformation of points and vectors   ***
+*****************************************************/
+
+// Computes dst = m.topLeftCorner(Dim,Dim) * src + m.topRightCorner(Dim,1), and divides the columns of the result
+// by the projective coordinate given by the last row of m if Project is true.
+// The columns are processed by blocks copied to a row-major buffer. This way the operations are vectorized along
+// the points for both interleaved and structure of arrays storages, and dst can be the same as src.
+template<typename Scalar, int Dim, bool Project>
+struct transform_batch_kernel
+{
+  enum { BlockSize = 128 };
+  typedef Matrix<Scalar,Dim+1,Dim+1> CoeffsType;
+  typedef Matrix<Scalar,Dim,Dynamic,RowMajor,Dim,BlockSize> BlockType;
+  typedef Array<Scalar,1,Dynamic,RowMajor,1,BlockSize> RowType;
+
+  template<typename Src, typename Dst>
+  static void run(const CoeffsType& m, const MatrixBase<Src>& src, const MatrixBase<Dst>& dst)
+  {
+    EIGEN_STATIC_ASSERT(int(Src::RowsAtCompileTime)==Dynamic || int(Src::RowsAtCompileTime)==Dim, YOU_MADE_A_PROGRAMMING_MISTAKE)
+    EIGEN_STATIC_ASSERT((is_same<Scalar,typename Src::Scalar>::value && is_same<Scalar,typename Dst::Scalar>::value),
+                        YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+    eigen_assert(src.rows()==Dim && "the points must be stored as the columns of a Dim x N matrix");
+
+    Dst& res = dst.const_cast_derived();
+    const Index size = src.cols();
+    res.resize(Dim, size);
+
+#ifdef EIGEN_HAS_OPENMP
+    // each thread processes a contiguous range of blocks
+    Index threads = numext::mini<Index>(nbThreads(), size / (8*BlockSize));
+    if(threads>1 && omp_get_num_threads()==1)
+    {
+      Eigen::initParallel();
+      #pragma omp parallel num_threads(threads)
+      {
+        Index i = omp_get_thread_num();
+        // Note that the actual number of threads might be lower than the number of request ones.
+        Index actual_threads = omp_get_num_threads();
+        Index blockSize = ((size / actual_threads) / BlockSize) * BlockSize;
+        Index start = i*blockSize;
+        Index end = (i+1==actual_threads) ? size : start+blockSize;
+        run(m, src.derived(), res, start, end);
+      }
+      return;
+    }
+#endif
+
+    run(m, src.derived(), res, 0, size);
+  }
+
+  // transforms the columns [start, end)
+  template<typename Src, typename Dst>
+  static void run(const CoeffsType& m, const Src& src, Dst& dst, Index start, Index end)
+  {
+    BlockType in, out;
+    RowType w;
+    for(Index j = start; j < end; j += BlockSize)
+    {
+      const Index n = numext::mini<Index>(BlockSize, end-j);
+      in = src.middleCols(j,n);
+      out.resize(Dim,n);
+      for(Index i = 0; i < Dim; ++i)
+      {
+        out.row(i).array() = in.row(0).array() * m(i,0) + m(i,Dim);
+        for(Index k = 1; k < Dim; ++k)
+          out.row(i) += in.row(k) * m(i,k);
+      }
+      if(Project)
+      {
+        w = in.row(0).array() * m(Dim,0) + m(Dim,Dim);
+        for(Index k = 1; k < Dim; ++k)
+          w += in.row(k).array() * m(Dim,k);
+        out.array().rowwise() /= w;
+      }
+      dst.middleCols(j,n) = out;
+    }
+  }
+};
+
+} // end namespace internal
+
+/** Applies \c *this to a set of points, that is, computes
+  * \code result = (this->linear() * points).colwise() + this->translation(); \endcode
+  * for affine transformations, and performs the perspective divide for projective transformations:
+  * \code result = ((*this) * points.colwise().homogeneous()).colwise().hnormalized(); \endcode
+  *
+  * \a points is a Dim x N matrix storing one point per column. Both the interleaved storage of a column-major matrix
+  * (e.g., a Matrix3Xf) and the structure of arrays storage of a row-major matrix are vectorized along the points.
+  * A N x Dim column-major set of points can be passed as \c points.transpose().
+  * \a result is resized if needed, and can be \a points itself. Large sets are split among several threads when
+  * OpenMP is enabled.
+  *
+  * \sa transformVectors(), transformNormals()
+  */
+template<typename Scalar, int Dim, int Mode, int Options>
+template<typename PointsType, typename ResultType>
+void Transform<Scalar,Dim,Mode,Options>::transformPoints(const MatrixBase<PointsType>& points, const MatrixBase<ResultType>& result) const
+{
+  typedef internal::transform_batch_kernel<Scalar,Dim,int(Mode)==int(Projective)> Kernel;
+  typename Kernel::CoeffsType m;
+  m.template topRows<Dim>() = affine();
+  if(int(Mode)==int(Projective))
+    m.row(Dim) = m_matrix.row(Dim);
+  Kernel::run(m, points, result);
+}
+
+/** Applies the linear part of \c *this to a set of vectors, that is, computes \code result = this->linear() * vectors; \endcode
+  *
+  * The layout of \a vectors and \a result follows transformPoints().
+  *
+  * \sa transformPoints(), transformNormals()
+  */
+template<typename Scalar, int Dim, int Mode, int Options>
+template<typename VectorsType, typename ResultType>
+void Transform<Scalar,Dim,Mode,Options>::transformVectors(const MatrixBase<VectorsType>& vectors, const MatrixBase<ResultType>& result) const
+{
+  typedef internal::transform_batch_kernel<Scalar,Dim,false> Kernel;
+  typename Kernel::CoeffsType m;
+  m.template topLeftCorner<Dim,Dim>() = linear();
+  m.template topRightCorner<Dim,1>().setZero();
+  Kernel::run(m, vectors, result);
+}
+
+/** Applies \c *this to a set of normals, that is, computes
+  * \code result = this->linear().inverse().transpose() * normals; \endcode
+  * The inverse is skipped for isometries. The transformed normals are not normalized.
+  *
+  * The layout of \a normals and \a result follows transformPoints().
+  *
+  * \sa transformPoints(), transformVectors()
+  */
+template<typename Scalar, int Dim, int Mode, int Options>
+template<typename NormalsType, typename ResultType>
+void Transform<Scalar,Dim,Mode,Options>::transformNormals(const MatrixBase<NormalsType>& normals, const MatrixBase<ResultType>& result) const
+{
+  typedef internal::transform_batch_kernel<Scalar,Dim,false> Kernel;
+  typename Kernel::CoeffsType m;
+  if(int(Mode)==int(Isometry))
+    m.template topLeftCorner<Dim,Dim>() = linear();
+  else
+    m.template topLeftCorner<Dim,Dim>() = linear().inverse().transpose();
+  m.template topRightCorner<Dim,1>().setZero();
+  Kernel::run(m, normals, result);
+}
+
+namespace internal {
+
 /*****************************************************
 *** Specializations of take affine part            ***
 *****************************************************/
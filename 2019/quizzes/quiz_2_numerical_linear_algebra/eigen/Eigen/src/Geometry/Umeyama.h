@@ -48,6 +48,81 @@ struct umeyama_transform_matrix_type
   > type;
 };
 
+// Computes the means of src and dst, the variance of src and the covariance of dst and src, i.e., Eq. (34)-(38).
+// When OpenMP is enabled, large point sets are split into one chunk of columns per thread, and the partial sums
+// are combined in chunk order such that the result only depends on the number of threads.
+template<typename Derived, typename OtherDerived, typename VectorType, typename MatrixType>
+void umeyama_moments(const MatrixBase<Derived>& src, const MatrixBase<OtherDerived>& dst,
+                     VectorType& src_mean, VectorType& dst_mean, MatrixType& sigma, typename VectorType::Scalar& src_var)
+{
+  typedef typename VectorType::Scalar Scalar;
+  typedef typename plain_matrix_type_row_major<Derived>::type RowMajorMatrixType;
+
+  const Index n = src.cols(); // number of measurements
+  const Scalar one_over_n = Scalar(1) / static_cast<Scalar>(n);
+
+  Index threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(n >= 2*4096 && omp_get_num_threads() == 1)
+    threads = (std::min<Index>)(nbThreads(), n / 4096);
+#endif
+
+  if(threads <= 1)
+  {
+    // computation of mean
+    src_mean = src.rowwise().sum() * one_over_n;
+    dst_mean = dst.rowwise().sum() * one_over_n;
+
+    // demeaning of src and dst points
+    const RowMajorMatrixType src_demean = src.colwise() - src_mean;
+    const RowMajorMatrixType dst_demean = dst.colwise() - dst_mean;
+
+    // Eq. (36)-(37)
+    src_var = src_demean.rowwise().squaredNorm().sum() * one_over_n;
+
+    // Eq. (38)
+    sigma = one_over_n * dst_demean * src_demean.transpose();
+    return;
+  }
+
+#ifdef EIGEN_HAS_OPENMP
+  Eigen::initParallel();
+  const Index m = src.rows(); // dimension
+  typedef Matrix<Scalar, VectorType::RowsAtCompileTime, Dynamic> PartialType;
+  PartialType src_sums = PartialType::Zero(m, threads), dst_sums = PartialType::Zero(m, threads), sigma_sums = PartialType::Zero(m, m*threads);
+  Matrix<Scalar, Dynamic, 1> var_sums = Matrix<Scalar, Dynamic, 1>::Zero(threads);
+
+  #pragma omp parallel num_threads(threads)
+  {
+    const Index i = omp_get_thread_num();
+    const Index actual_threads = omp_get_num_threads();
+    const Index chunk = n / actual_threads;
+    const Index start = i * chunk;
+    const Index size = i + 1 == actual_threads ? n - start : chunk;
+
+    src_sums.col(i) = src.middleCols(start, size).rowwise().sum();
+    dst_sums.col(i) = dst.middleCols(start, size).rowwise().sum();
+    #pragma omp barrier
+    #pragma omp single
+    {
+      src_mean = src_sums.rowwise().sum() * one_over_n;
+      dst_mean = dst_sums.rowwise().sum() * one_over_n;
+    }
+
+    const RowMajorMatrixType src_demean = src.middleCols(start, size).colwise() - src_mean;
+    const RowMajorMatrixType dst_demean = dst.middleCols(start, size).colwise() - dst_mean;
+    var_sums(i) = src_demean.rowwise().squaredNorm().sum();
+    sigma_sums.middleCols(i*m, m).noalias() = dst_demean * src_demean.transpose();
+  }
+
+  src_var = var_sums.sum() * one_over_n;
+  sigma = sigma_sums.leftCols(m);
+  for(Index i = 1; i < threads; ++i)
+    sigma += sigma_sums.middleCols(i*m, m);
+  sigma *= one_over_n;
+#endif
+}
+
 }
 
 #endif
@@ -74,7 +149,8 @@ struct umeyama_transform_matrix_type
 * The analysis is involving the SVD having a complexity of \f$O(d^3)\f$
 * though the actual computational effort lies in the covariance
 * matrix computation which has an asymptotic lower bound of \f$O(dm)\f$ when 
-* the input point sets have dimension \f$d \times m\f$.
+* the input point sets have dimension \f$d \times m\f$. When OpenMP is enabled,
+* the covariance matrix of large point sets is computed with multiple threads.
 *
 * Currently the method is working only for floating point matrices.
 *
@@ -96,7 +172,6 @@ umeyama(const MatrixBase<Derived>& src, const MatrixBase<OtherDerived>& dst, boo
 {
   typedef typename internal::umeyama_transform_matrix_type<Derived, OtherDerived>::type TransformationMatrixType;
   typedef typename internal::traits<TransformationMatrixType>::Scalar Scalar;
-  typedef typename NumTraits<Scalar>::Real RealScalar;
 
   EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL)
   EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename internal::traits<OtherDerived>::Scalar>::value),
@@ -106,27 +181,14 @@ umeyama(const MatrixBase<Derived>& src, const MatrixBase<OtherDerived>& dst, boo
 
   typedef Matrix<Scalar, Dimension, 1> VectorType;
   typedef Matrix<Scalar, Dimension, Dimension> MatrixType;
-  typedef typename internal::plain_matrix_type_row_major<Derived>::type RowMajorMatrixType;
 
   const Index m = src.rows(); // dimension
-  const Index n = src.cols(); // number of measurements
-
-  // required for demeaning ...
-  const RealScalar one_over_n = RealScalar(1) / static_cast<RealScalar>(n);
-
-  // computation of mean
-  const VectorType src_mean = src.rowwise().sum() * one_over_n;
-  const VectorType dst_mean = dst.rowwise().sum() * one_over_n;
-
-  // demeaning of src and dst points
-  const RowMajorMatrixType src_demean = src.colwise() - src_mean;
-  const RowMajorMatrixType dst_demean = dst.colwise() - dst_mean;
-
-  // Eq. (36)-(37)
-  const Scalar src_var = src_demean.rowwise().squaredNorm().sum() * one_over_n;
 
-  // Eq. (38)
-  const MatrixType sigma = one_over_n * dst_demean * src_demean.transpose();
+  // Eq. (34)-(38)
+  VectorType src_mean, dst_mean;
+  MatrixType sigma;
+  Scalar src_var;
+  internal::umeyama_moments(src, dst, src_mean, dst_mean, sigma, src_var);
 
   JacobiSVD<MatrixType> svd(sigma, ComputeFullU | ComputeFullV);
 
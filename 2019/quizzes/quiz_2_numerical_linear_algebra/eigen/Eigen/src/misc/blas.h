@@ -351,6 +351,16 @@ int BLASFUNC(cgemm)(const char *, const char *, const int *, const int *, const
 int BLASFUNC(zgemm)(const char *, const char *, const int *, const int *, const int *, const double *, const double *, const int *, const double *, const int *, const double *, double *, const int *);
 int BLASFUNC(xgemm)(const char *, const char *, const int *, const int *, const int *, const double *, const double *, const int *, const double *, const int *, const double *, double *, const int *);
 
+int BLASFUNC(sgemm_batch)(const char *, const char *, const int *, const int *, const int *, const float  *, const float  **, const int *, const float  **, const int *, const float  *, float  **, const int *, const int *, const int *);
+int BLASFUNC(dgemm_batch)(const char *, const char *, const int *, const int *, const int *, const double *, const double **, const int *, const double **, const int *, const double *, double **, const int *, const int *, const int *);
+int BLASFUNC(cgemm_batch)(const char *, const char *, const int *, const int *, const int *, const float  *, const float  **, const int *, const float  **, const int *, const float  *, float  **, const int *, const int *, const int *);
+int BLASFUNC(zgemm_batch)(const char *, const char *, const int *, const int *, const int *, const double *, const double **, const int *, const double **, const int *, const double *, double **, const int *, const int *, const int *);
+
+int BLASFUNC(sgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const float  *, const float  *, const int *, const int *, const float  *, const int *, const int *, const float  *, float  *, const int *, const int *, const int *);
+int BLASFUNC(dgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const double *, const double *, const int *, const int *, const double *, const int *, const int *, const double *, double *, const int *, const int *, const int *);
+int BLASFUNC(cgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const float  *, const float  *, const int *, const int *, const float  *, const int *, const int *, const float  *, float  *, const int *, const int *, const int *);
+int BLASFUNC(zgemm_batch_strided)(const char *, const char *, const int *, const int *, const int *, const double *, const double *, const int *, const int *, const double *, const int *, const int *, const double *, double *, const int *, const int *, const int *);
+
 int BLASFUNC(cgemm3m)(char *, char *, int *, int *, int *, float *,
 	   float  *, int *, float  *, int *, float  *, float  *, int *);
 int BLASFUNC(zgemm3m)(char *, char *, int *, int *, int *, double *,
@@ -158,6 +158,55 @@ T* copy_back(T* x_cpy, T* x, int n, int incx)
   return x_cpy;
 }
 
+// Multi-threading of the level 2 and level 3 routines. The work is split into one
+// independent task per thread when the library is compiled with OpenMP.
+
+// returns the number of threads to use for a routine of 'work' flops which can be
+// split into at most 'max_tasks' independent parts, following parallelize_gemm
+inline int blas_threads(DenseIndex max_tasks, double work)
+{
+#ifdef EIGEN_HAS_OPENMP
+  // do not nest parallel regions, e.g. within ?gemm_batch
+  if(omp_get_num_threads()>1)
+    return 1;
+  return int(internal::parallel_threads(max_tasks, work));
+#else
+  EIGEN_UNUSED_VARIABLE(max_tasks);
+  EIGEN_UNUSED_VARIABLE(work);
+  return 1;
+#endif
+}
+
+// calls task(i,count) for each i in [0,count), with count threads if possible
+template<typename Task>
+void blas_parallel_run(const Task& task, int threads)
+{
+#ifdef EIGEN_HAS_OPENMP
+  if(threads>1)
+  {
+    Eigen::initParallel();
+    #pragma omp parallel num_threads(threads)
+    {
+      // Note that the actual number of threads might be lower than the number of request ones.
+      task(omp_get_thread_num(), omp_get_num_threads());
+    }
+    return;
+  }
+#else
+  EIGEN_UNUSED_VARIABLE(threads);
+#endif
+  task(0,1);
+}
+
+// splits [0,size) into count contiguous chunks starting at multiples of granularity,
+// and returns the i-th one
+inline void blas_chunk(DenseIndex size, int i, int count, DenseIndex granularity, DenseIndex& start, DenseIndex& length)
+{
+  DenseIndex block = ((size / count) / granularity) * granularity;
+  start  = i*block;
+  length = (i+1==count) ? size-start : block;
+}
+
 #define EIGEN_BLAS_FUNC(X) EIGEN_CAT(SCALAR_SUFFIX,X##_)
 
 #endif // EIGEN_BLAS_COMMON_H
@@ -23,6 +23,40 @@ struct general_matrix_vector_product_wrapper
   }
 };
 
+// Computes res += alpha*op(lhs)*rhs on a band of rows of res per thread.
+template<typename Scalar>
+struct gemv_task
+{
+  typedef void (*functype)(int, int, const Scalar *, int, const Scalar *, int , Scalar *, int, Scalar);
+  enum { Granularity = 4*internal::packet_traits<Scalar>::size };
+
+  gemv_task(functype func, bool trans, int rows, int cols, const Scalar* lhs, int lhsStride, const Scalar* rhs, Scalar* res, Scalar alpha)
+    : m_func(func), m_trans(trans), m_rows(rows), m_cols(cols), m_lhs(lhs), m_lhsStride(lhsStride), m_rhs(rhs), m_res(res), m_alpha(alpha)
+  {}
+
+  int threads() const
+  {
+    return blas_threads(m_rows/Granularity, double(m_rows)*double(m_cols));
+  }
+
+  void operator()(int i, int count) const
+  {
+    DenseIndex start, length;
+    blas_chunk(m_rows, i, count, Granularity, start, length);
+    if(length==0)
+      return;
+    m_func(int(length), m_cols, m_lhs + (m_trans ? start*m_lhsStride : start), m_lhsStride, m_rhs, 1, m_res + start, 1, m_alpha);
+  }
+
+  functype m_func;
+  bool m_trans;
+  int m_rows, m_cols;
+  const Scalar* m_lhs; int m_lhsStride;
+  const Scalar* m_rhs;
+  Scalar* m_res;
+  Scalar m_alpha;
+};
+
 int EIGEN_BLAS_FUNC(gemv)(const char *opa, const int *m, const int *n, const RealScalar *palpha,
                           const RealScalar *pa, const int *lda, const RealScalar *pb, const int *incb, const RealScalar *pbeta, RealScalar *pc, const int *incc)
 {
@@ -75,7 +109,8 @@ int EIGEN_BLAS_FUNC(gemv)(const char *opa, const int *m, const int *n, const Rea
   if(code>=4 || func[code]==0)
     return 0;
 
-  func[code](actual_m, actual_n, a, *lda, actual_b, 1, actual_c, 1, alpha);
+  gemv_task<Scalar> task(func[code], code!=NOTR, actual_m, actual_n, a, *lda, actual_b, actual_c, alpha);
+  blas_parallel_run(task, task.threads());
 
   if(actual_b!=b) delete[] actual_b;
   if(actual_c!=c) delete[] copy_back(actual_c,c,actual_m,*incc);
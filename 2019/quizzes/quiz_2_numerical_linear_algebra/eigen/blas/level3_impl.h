@@ -7,37 +7,106 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #include <iostream>
+#include <vector>
 #include "common.h"
 
+// Computes c = alpha*op(a)*op(b) + beta*c on a band of rows or columns of c per thread.
+// The arguments must have been checked.
+template<typename Scalar>
+struct gemm_task
+{
+  typedef void (*functype)(DenseIndex, DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *, DenseIndex, Scalar, internal::level3_blocking<Scalar,Scalar>&, Eigen::internal::GemmParallelInfo<DenseIndex>*);
+  typedef internal::gebp_traits<Scalar,Scalar> Traits;
+  enum { Conj = NumTraits<Scalar>::IsComplex };
+
+  static functype kernel(int code)
+  {
+    static const functype func[12] = {
+      // array index: NOTR  | (NOTR << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,ColMajor,false,Scalar,ColMajor,false,ColMajor>::run),
+      // array index: TR    | (NOTR << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,false,Scalar,ColMajor,false,ColMajor>::run),
+      // array index: ADJ   | (NOTR << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,Conj, Scalar,ColMajor,false,ColMajor>::run),
+      0,
+      // array index: NOTR  | (TR   << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,ColMajor,false,Scalar,RowMajor,false,ColMajor>::run),
+      // array index: TR    | (TR   << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,false,Scalar,RowMajor,false,ColMajor>::run),
+      // array index: ADJ   | (TR   << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,Conj, Scalar,RowMajor,false,ColMajor>::run),
+      0,
+      // array index: NOTR  | (ADJ  << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,ColMajor,false,Scalar,RowMajor,Conj, ColMajor>::run),
+      // array index: TR    | (ADJ  << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,false,Scalar,RowMajor,Conj, ColMajor>::run),
+      // array index: ADJ   | (ADJ  << 2)
+      (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,Conj, Scalar,RowMajor,Conj, ColMajor>::run),
+      0
+    };
+    return func[code];
+  }
+
+  gemm_task(int opa, int opb, int m, int n, int k, Scalar alpha, const Scalar* a, int lda, const Scalar* b, int ldb, Scalar beta, Scalar* c, int ldc)
+    : m_opa(opa), m_opb(opb), m_m(m), m_n(n), m_k(k), m_alpha(alpha), m_a(a), m_lda(lda), m_b(b), m_ldb(ldb),
+      m_beta(beta), m_c(c), m_ldc(ldc), m_split_rows(m>n)
+  {}
+
+  // the number of threads worth using
+  int threads() const
+  {
+    return blas_threads(m_split_rows ? m_m/Traits::mr : m_n/Traits::nr, double(m_m)*double(m_n)*double(m_k));
+  }
+
+  void operator()(int i, int count) const
+  {
+    DenseIndex start, length;
+    const Scalar *ai = m_a, *bi = m_b;
+    Scalar* ci;
+    DenseIndex rows = m_m, cols = m_n;
+    if(m_split_rows)
+    {
+      blas_chunk(m_m, i, count, Traits::mr, start, length);
+      ai = m_a + (m_opa==NOTR ? start : start*m_lda);
+      ci = m_c + start;
+      rows = length;
+    }
+    else
+    {
+      blas_chunk(m_n, i, count, Traits::nr, start, length);
+      bi = m_b + (m_opb==NOTR ? start*m_ldb : start);
+      ci = m_c + start*m_ldc;
+      cols = length;
+    }
+    if(rows==0 || cols==0)
+      return;
+
+    if(m_beta!=Scalar(1))
+    {
+      if(m_beta==Scalar(0)) matrix(ci, rows, cols, m_ldc).setZero();
+      else                  matrix(ci, rows, cols, m_ldc) *= m_beta;
+    }
+
+    if(m_k==0)
+      return;
+
+    internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic> blocking(rows,cols,m_k,1,true);
+    kernel(m_opa | (m_opb << 2))(rows, cols, m_k, ai, m_lda, bi, m_ldb, ci, m_ldc, m_alpha, blocking, 0);
+  }
+
+  int m_opa, m_opb, m_m, m_n, m_k;
+  Scalar m_alpha;
+  const Scalar* m_a; int m_lda;
+  const Scalar* m_b; int m_ldb;
+  Scalar m_beta;
+  Scalar* m_c; int m_ldc;
+  bool m_split_rows;
+};
+
 int EIGEN_BLAS_FUNC(gemm)(const char *opa, const char *opb, const int *m, const int *n, const int *k, const RealScalar *palpha,
                           const RealScalar *pa, const int *lda, const RealScalar *pb, const int *ldb, const RealScalar *pbeta, RealScalar *pc, const int *ldc)
 {
 //   std::cerr << "in gemm " << *opa << " " << *opb << " " << *m << " " << *n << " " << *k << " " << *lda << " " << *ldb << " " << *ldc << " " << *palpha << " " << *pbeta << "\n";
-  typedef void (*functype)(DenseIndex, DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *, DenseIndex, Scalar, internal::level3_blocking<Scalar,Scalar>&, Eigen::internal::GemmParallelInfo<DenseIndex>*);
-  static const functype func[12] = {
-    // array index: NOTR  | (NOTR << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,ColMajor,false,Scalar,ColMajor,false,ColMajor>::run),
-    // array index: TR    | (NOTR << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,false,Scalar,ColMajor,false,ColMajor>::run),
-    // array index: ADJ   | (NOTR << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,Conj, Scalar,ColMajor,false,ColMajor>::run),
-    0,
-    // array index: NOTR  | (TR   << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,ColMajor,false,Scalar,RowMajor,false,ColMajor>::run),
-    // array index: TR    | (TR   << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,false,Scalar,RowMajor,false,ColMajor>::run),
-    // array index: ADJ   | (TR   << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,Conj, Scalar,RowMajor,false,ColMajor>::run),
-    0,
-    // array index: NOTR  | (ADJ  << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,ColMajor,false,Scalar,RowMajor,Conj, ColMajor>::run),
-    // array index: TR    | (ADJ  << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,false,Scalar,RowMajor,Conj, ColMajor>::run),
-    // array index: ADJ   | (ADJ  << 2)
-    (internal::general_matrix_matrix_product<DenseIndex,Scalar,RowMajor,Conj, Scalar,RowMajor,Conj, ColMajor>::run),
-    0
-  };
-
   const Scalar* a = reinterpret_cast<const Scalar*>(pa);
   const Scalar* b = reinterpret_cast<const Scalar*>(pb);
   Scalar* c = reinterpret_cast<Scalar*>(pc);
@@ -59,22 +128,178 @@ int EIGEN_BLAS_FUNC(gemm)(const char *opa, const char *opb, const int *m, const
   if (*m == 0 || *n == 0)
     return 0;
 
-  if(beta!=Scalar(1))
+  gemm_task<Scalar> task(OP(*opa), OP(*opb), *m, *n, *k, alpha, a, *lda, b, *ldb, beta, c, *ldc);
+  blas_parallel_run(task, task.threads());
+  return 0;
+}
+
+// Distributes whole products i, i+count, ... of a batch over the threads.
+template<typename Scalar>
+struct gemm_batch_task
+{
+  gemm_batch_task(const std::vector<gemm_task<Scalar> >& tasks) : m_tasks(tasks) {}
+
+  void operator()(int i, int count) const
   {
-    if(beta==Scalar(0)) matrix(c, *m, *n, *ldc).setZero();
-    else                matrix(c, *m, *n, *ldc) *= beta;
+    for(std::size_t j=i; j<m_tasks.size(); j+=count)
+      m_tasks[j](0,1);
+  }
+
+  const std::vector<gemm_task<Scalar> >& m_tasks;
+};
+
+// Runs a batch of products, threading each product instead when there are fewer products
+// than threads and the products are large enough.
+template<typename Scalar>
+void gemm_batch_run(const std::vector<gemm_task<Scalar> >& tasks, double work)
+{
+  const int threads = blas_threads(DenseIndex(tasks.size()), work);
+  if(threads>1 && (DenseIndex(tasks.size())>=nbThreads() || tasks.front().threads()==1))
+    blas_parallel_run(gemm_batch_task<Scalar>(tasks), threads);
+  else
+    for(std::size_t j=0; j<tasks.size(); ++j)
+      blas_parallel_run(tasks[j], tasks[j].threads());
+}
+
+// c_i = alpha_g*op_g(a_i)*op_g(b_i) + beta_g*c_i for the group_size[g] products i of each group g,
+// following the interface of MKL
+int EIGEN_BLAS_FUNC(gemm_batch)(const char *opa_array, const char *opb_array, const int *m_array, const int *n_array, const int *k_array,
+                                const RealScalar *palpha_array, const RealScalar **pa_array, const int *lda_array,
+                                const RealScalar **pb_array, const int *ldb_array, const RealScalar *pbeta_array,
+                                RealScalar **pc_array, const int *ldc_array, const int *group_count, const int *group_size)
+{
+  int info = 0;
+  if(*group_count<0)                                                  info = 14;
+  for(int g=0; g<*group_count && info==0; ++g)
+  {
+    if(OP(opa_array[g])==INVALID)                                     info = 1;
+    else if(OP(opb_array[g])==INVALID)                                info = 2;
+    else if(m_array[g]<0)                                             info = 3;
+    else if(n_array[g]<0)                                             info = 4;
+    else if(k_array[g]<0)                                             info = 5;
+    else if(lda_array[g]<std::max(1,(OP(opa_array[g])==NOTR)?m_array[g]:k_array[g])) info = 8;
+    else if(ldb_array[g]<std::max(1,(OP(opb_array[g])==NOTR)?k_array[g]:n_array[g])) info = 10;
+    else if(ldc_array[g]<std::max(1,m_array[g]))                      info = 13;
+    else if(group_size[g]<0)                                          info = 15;
+  }
+  if(info)
+    return xerbla_(SCALAR_SUFFIX_UP"GEMM_BATCH ",&info,12);
+
+  std::vector<gemm_task<Scalar> > tasks;
+  double work = 0;
+  for(int g=0, i=0; g<*group_count; ++g)
+  {
+    const Scalar alpha = reinterpret_cast<const Scalar*>(palpha_array)[g];
+    const Scalar beta  = reinterpret_cast<const Scalar*>(pbeta_array)[g];
+    for(int j=0; j<group_size[g]; ++j, ++i)
+    {
+      if(m_array[g]==0 || n_array[g]==0)
+        continue;
+      tasks.push_back(gemm_task<Scalar>(OP(opa_array[g]), OP(opb_array[g]), m_array[g], n_array[g], k_array[g],
+                                        alpha, reinterpret_cast<const Scalar*>(pa_array[i]), lda_array[g],
+                                        reinterpret_cast<const Scalar*>(pb_array[i]), ldb_array[g],
+                                        beta, reinterpret_cast<Scalar*>(pc_array[i]), ldc_array[g]));
+      work += double(m_array[g])*double(n_array[g])*double(std::max(1,k_array[g]));
+    }
   }
 
-  if(*k == 0)
+  gemm_batch_run(tasks, work);
+  return 0;
+}
+
+// c + i*stridec = alpha*op(a + i*stridea)*op(b + i*strideb) + beta*(c + i*stridec) for i in [0,batch_size)
+int EIGEN_BLAS_FUNC(gemm_batch_strided)(const char *opa, const char *opb, const int *m, const int *n, const int *k, const RealScalar *palpha,
+                                        const RealScalar *pa, const int *lda, const int *stridea, const RealScalar *pb, const int *ldb, const int *strideb,
+                                        const RealScalar *pbeta, RealScalar *pc, const int *ldc, const int *stridec, const int *batch_size)
+{
+  const Scalar* a = reinterpret_cast<const Scalar*>(pa);
+  const Scalar* b = reinterpret_cast<const Scalar*>(pb);
+  Scalar* c = reinterpret_cast<Scalar*>(pc);
+  Scalar alpha  = *reinterpret_cast<const Scalar*>(palpha);
+  Scalar beta   = *reinterpret_cast<const Scalar*>(pbeta);
+
+  int info = 0;
+  if(OP(*opa)==INVALID)                                               info = 1;
+  else if(OP(*opb)==INVALID)                                          info = 2;
+  else if(*m<0)                                                       info = 3;
+  else if(*n<0)                                                       info = 4;
+  else if(*k<0)                                                       info = 5;
+  else if(*lda<std::max(1,(OP(*opa)==NOTR)?*m:*k))                    info = 8;
+  else if(*ldb<std::max(1,(OP(*opb)==NOTR)?*k:*n))                    info = 11;
+  else if(*ldc<std::max(1,*m))                                        info = 15;
+  else if(*stridec<(*ldc)*(*n))                                       info = 16;
+  else if(*batch_size<0)                                              info = 17;
+  if(info)
+    return xerbla_(SCALAR_SUFFIX_UP"GEMM_BATCH_STRIDED ",&info,20);
+
+  if(*m==0 || *n==0)
     return 0;
 
-  internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic> blocking(*m,*n,*k,1,true);
+  std::vector<gemm_task<Scalar> > tasks;
+  tasks.reserve(*batch_size);
+  for(int i=0; i<*batch_size; ++i)
+    tasks.push_back(gemm_task<Scalar>(OP(*opa), OP(*opb), *m, *n, *k, alpha, a + DenseIndex(i)*(*stridea), *lda,
+                                      b + DenseIndex(i)*(*strideb), *ldb, beta, c + DenseIndex(i)*(*stridec), *ldc));
 
-  int code = OP(*opa) | (OP(*opb) << 2);
-  func[code](*m, *n, *k, a, *lda, b, *ldb, c, *ldc, alpha, blocking, 0);
+  gemm_batch_run(tasks, double(*m)*double(*n)*double(std::max(1,*k))*double(*batch_size));
   return 0;
 }
 
+// Solves op(a)*x = alpha*b or x*op(a) = alpha*b in place on a band of columns, respectively
+// of rows, of b per thread.
+template<typename Scalar>
+struct trsm_task
+{
+  typedef void (*functype)(DenseIndex, DenseIndex, const Scalar *, DenseIndex, Scalar *, DenseIndex, internal::level3_blocking<Scalar,Scalar>&);
+  typedef internal::gebp_traits<Scalar,Scalar> Traits;
+
+  trsm_task(functype func, bool left, int m, int n, Scalar alpha, const Scalar* a, int lda, Scalar* b, int ldb)
+    : m_func(func), m_left(left), m_m(m), m_n(n), m_alpha(alpha), m_a(a), m_lda(lda), m_b(b), m_ldb(ldb)
+  {}
+
+  int threads() const
+  {
+    const double size = m_left ? m_m : m_n;
+    return blas_threads(m_left ? m_n/Traits::nr : m_m/Traits::mr, double(m_m)*double(m_n)*size);
+  }
+
+  void operator()(int i, int count) const
+  {
+    DenseIndex start, length;
+    if(m_left)
+    {
+      // the columns of b are independent
+      blas_chunk(m_n, i, count, Traits::nr, start, length);
+      if(length==0)
+        return;
+      Scalar* bi = m_b + start*m_ldb;
+      internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(m_m,length,m_m,1,false);
+      m_func(m_m, length, m_a, m_lda, bi, m_ldb, blocking);
+      if(m_alpha!=Scalar(1))
+        matrix(bi,m_m,length,m_ldb) *= m_alpha;
+    }
+    else
+    {
+      // the rows of b are independent
+      blas_chunk(m_m, i, count, Traits::mr, start, length);
+      if(length==0)
+        return;
+      Scalar* bi = m_b + start;
+      internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(length,m_n,m_n,1,false);
+      m_func(m_n, length, m_a, m_lda, bi, m_ldb, blocking);
+      if(m_alpha!=Scalar(1))
+        matrix(bi,length,m_n,m_ldb) *= m_alpha;
+    }
+  }
+
+  functype m_func;
+  bool m_left;
+  int m_m, m_n;
+  Scalar m_alpha;
+  const Scalar* m_a; int m_lda;
+  Scalar* m_b; int m_ldb;
+};
+
 int EIGEN_BLAS_FUNC(trsm)(const char *side, const char *uplo, const char *opa, const char *diag, const int *m, const int *n,
                           const RealScalar *palpha,  const RealScalar *pa, const int *lda, RealScalar *pb, const int *ldb)
 {
@@ -160,23 +385,67 @@ int EIGEN_BLAS_FUNC(trsm)(const char *side, const char *uplo, const char *opa, c
 
   int code = OP(*opa) | (SIDE(*side) << 2) | (UPLO(*uplo) << 3) | (DIAG(*diag) << 4);
 
-  if(SIDE(*side)==LEFT)
+  trsm_task<Scalar> task(func[code], SIDE(*side)==LEFT, *m, *n, alpha, a, *lda, b, *ldb);
+  blas_parallel_run(task, task.threads());
+
+  return 0;
+}
+
+
+// Computes b = alpha*op(a)*b or b = alpha*b*op(a) on a band of columns, respectively of rows,
+// of b per thread.
+template<typename Scalar>
+struct trmm_task
+{
+  typedef void (*functype)(DenseIndex, DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *, DenseIndex, const Scalar&, internal::level3_blocking<Scalar,Scalar>&);
+  typedef internal::gebp_traits<Scalar,Scalar> Traits;
+
+  trmm_task(functype func, bool left, int m, int n, Scalar alpha, const Scalar* a, int lda, Scalar* b, int ldb)
+    : m_func(func), m_left(left), m_m(m), m_n(n), m_alpha(alpha), m_a(a), m_lda(lda), m_b(b), m_ldb(ldb)
+  {}
+
+  int threads() const
   {
-    internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(*m,*n,*m,1,false);
-    func[code](*m, *n, a, *lda, b, *ldb, blocking);
+    const double size = m_left ? m_m : m_n;
+    return blas_threads(m_left ? m_n/Traits::nr : m_m/Traits::mr, double(m_m)*double(m_n)*size);
   }
-  else
+
+  void operator()(int i, int count) const
   {
-    internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(*m,*n,*n,1,false);
-    func[code](*n, *m, a, *lda, b, *ldb, blocking);
+    DenseIndex start, length;
+    if(m_left)
+    {
+      // the columns of b are independent
+      blas_chunk(m_n, i, count, Traits::nr, start, length);
+      if(length==0)
+        return;
+      Scalar* bi = m_b + start*m_ldb;
+      Matrix<Scalar,Dynamic,Dynamic,ColMajor> tmp = matrix(bi,m_m,length,m_ldb);
+      matrix(bi,m_m,length,m_ldb).setZero();
+      internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(m_m,length,m_m,1,false);
+      m_func(m_m, length, m_m, m_a, m_lda, tmp.data(), tmp.outerStride(), bi, m_ldb, m_alpha, blocking);
+    }
+    else
+    {
+      // the rows of b are independent
+      blas_chunk(m_m, i, count, Traits::mr, start, length);
+      if(length==0)
+        return;
+      Scalar* bi = m_b + start;
+      Matrix<Scalar,Dynamic,Dynamic,ColMajor> tmp = matrix(bi,length,m_n,m_ldb);
+      matrix(bi,length,m_n,m_ldb).setZero();
+      internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(length,m_n,m_n,1,false);
+      m_func(length, m_n, m_n, tmp.data(), tmp.outerStride(), m_a, m_lda, bi, m_ldb, m_alpha, blocking);
+    }
   }
 
-  if(alpha!=Scalar(1))
-    matrix(b,*m,*n,*ldb) *= alpha;
-
-  return 0;
-}
-
+  functype m_func;
+  bool m_left;
+  int m_m, m_n;
+  Scalar m_alpha;
+  const Scalar* m_a; int m_lda;
+  Scalar* m_b; int m_ldb;
+};
 
 // b = alpha*op(a)*b  for side = 'L'or'l'
 // b = alpha*b*op(a)  for side = 'R'or'r'
@@ -265,20 +534,8 @@ int EIGEN_BLAS_FUNC(trmm)(const char *side, const char *uplo, const char *opa, c
   if(*m==0 || *n==0)
     return 1;
 
-  // FIXME find a way to avoid this copy
-  Matrix<Scalar,Dynamic,Dynamic,ColMajor> tmp = matrix(b,*m,*n,*ldb);
-  matrix(b,*m,*n,*ldb).setZero();
-
-  if(SIDE(*side)==LEFT)
-  {
-    internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(*m,*n,*m,1,false);
-    func[code](*m, *n, *m, a, *lda, tmp.data(), tmp.outerStride(), b, *ldb, alpha, blocking);
-  }
-  else
-  {
-    internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> blocking(*m,*n,*n,1,false);
-    func[code](*m, *n, *n, tmp.data(), tmp.outerStride(), a, *lda, b, *ldb, alpha, blocking);
-  }
+  trmm_task<Scalar> task(func[code], SIDE(*side)==LEFT, *m, *n, alpha, a, *lda, b, *ldb);
+  blas_parallel_run(task, task.threads());
   return 1;
 }
 
@@ -352,6 +609,66 @@ int EIGEN_BLAS_FUNC(symm)(const char *side, const char *uplo, const int *m, cons
   return 0;
 }
 
+// Computes the triangular part of c += alpha*op(a)*op(a)^T on a band of columns of c per thread.
+// Each band is made of a triangular block on the diagonal and of a rectangular block above
+// or below it, the bands being chosen so that they have about the same area.
+template<typename Scalar>
+struct syrk_task
+{
+  typedef void (*functype)(DenseIndex, DenseIndex, const Scalar *, DenseIndex, const Scalar *, DenseIndex, Scalar *, DenseIndex, const Scalar&, internal::level3_blocking<Scalar,Scalar>&);
+  typedef internal::gebp_traits<Scalar,Scalar> Traits;
+
+  syrk_task(functype func, int op, bool upper, int n, int k, Scalar alpha, const Scalar* a, int lda, Scalar* c, int ldc)
+    : m_func(func), m_op(op), m_upper(upper), m_n(n), m_k(k), m_alpha(alpha), m_a(a), m_lda(lda), m_c(c), m_ldc(ldc)
+  {}
+
+  int threads() const
+  {
+    return blas_threads(m_n/Traits::nr, 0.5*double(m_n)*double(m_n)*double(m_k));
+  }
+
+  // first column of the i-th band
+  DenseIndex bound(int i, int count) const
+  {
+    if(i>=count)
+      return m_n;
+    const double f = double(i)/double(count);
+    const double x = m_upper ? std::sqrt(f) : 1.-std::sqrt(1.-f);
+    return (DenseIndex(x*m_n) / Traits::nr) * Traits::nr;
+  }
+
+  // pointer to the row j of op(a)
+  const Scalar* row(DenseIndex j) const
+  {
+    return m_a + (m_op==NOTR ? j : j*m_lda);
+  }
+
+  void operator()(int i, int count) const
+  {
+    const DenseIndex j0 = bound(i,count), j1 = bound(i+1,count), size = j1-j0;
+    if(size<=0)
+      return;
+
+    internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic> blocking(size,size,m_k,1,false);
+    m_func(size, m_k, row(j0), m_lda, row(j0), m_lda, m_c + j0 + j0*m_ldc, m_ldc, m_alpha, blocking);
+
+    // c(r0:r1,j0:j1) += alpha*op(a)(r0:r1,:)*op(a)(j0:j1,:)^T
+    const int opb = m_op==NOTR ? TR : NOTR;
+    const DenseIndex r0 = m_upper ? 0 : j1, r1 = m_upper ? j0 : m_n;
+    if(r1>r0)
+      gemm_task<Scalar>(m_op, opb, int(r1-r0), int(size), m_k, m_alpha, row(r0), m_lda, row(j0), m_lda,
+                        Scalar(1), m_c + r0 + j0*m_ldc, m_ldc)(0,1);
+  }
+
+  functype m_func;
+  int m_op;
+  bool m_upper;
+  int m_n, m_k;
+  Scalar m_alpha;
+  const Scalar* m_a; int m_lda;
+  Scalar* m_c; int m_ldc;
+};
+
 // c = alpha*a*a' + beta*c  for op = 'N'or'n'
 // c = alpha*a'*a + beta*c  for op = 'T'or't','C'or'c'
 int EIGEN_BLAS_FUNC(syrk)(const char *uplo, const char *op, const int *n, const int *k,
@@ -423,10 +740,9 @@ int EIGEN_BLAS_FUNC(syrk)(const char *uplo, const char *op, const int *n, const
       matrix(c, *n, *n, *ldc).triangularView<Lower>() += alpha * matrix(a,*k,*n,*lda).transpose() * matrix(a,*k,*n,*lda);
   }
   #else
-  internal::gemm_blocking_space<ColMajor,Scalar,Scalar,Dynamic,Dynamic,Dynamic> blocking(*n,*n,*k,1,false);
-
   int code = OP(*op) | (UPLO(*uplo) << 2);
-  func[code](*n, *k, a, *lda, a, *lda, c, *ldc, alpha, blocking);
+  syrk_task<Scalar> task(func[code], OP(*op), UPLO(*uplo)==UP, *n, *k, alpha, a, *lda, c, *ldc);
+  blas_parallel_run(task, task.threads());
   #endif
 
   return 0;
@@ -0,0 +1,162 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Checks the level 2 and level 3 routines on sizes large enough to be multi-threaded,
+// and the batched products, against Eigen. The reference testers only use small sizes.
+
+#include <Eigen/Core>
+#include <iostream>
+#include <vector>
+#include "../../Eigen/src/misc/blas.h"
+
+using namespace Eigen;
+
+static int failures = 0;
+
+template<typename Derived, typename OtherDerived>
+void check(const char* what, const MatrixBase<Derived>& res, const MatrixBase<OtherDerived>& ref)
+{
+  double err = (res - ref).norm() / (std::max)(1., ref.norm());
+  if(!(err < 1e-12))
+  {
+    std::cerr << what << " failed: relative error " << err << "\n";
+    ++failures;
+  }
+}
+
+// op(A) for op = 'N' or 'T'
+template<typename MatrixType>
+MatrixType apply_op(const MatrixType& A, char op)
+{
+  return op=='N' ? A : MatrixType(A.transpose());
+}
+
+void check_gemm(int m, int n, int k, char opa, char opb)
+{
+  MatrixXd A = opa=='N' ? MatrixXd::Random(m,k) : MatrixXd::Random(k,m);
+  MatrixXd B = opb=='N' ? MatrixXd::Random(k,n) : MatrixXd::Random(n,k);
+  MatrixXd C = MatrixXd::Random(m+3,n);
+  double alpha = 0.5, beta = -2;
+  int lda = (std::max)(1,int(A.rows())), ldb = (std::max)(1,int(B.rows())), ldc = m+3;
+  MatrixXd ref = C;
+  ref.topRows(m) = alpha * apply_op(A, opa) * apply_op(B, opb) + beta * C.topRows(m);
+  dgemm_(&opa, &opb, &m, &n, &k, &alpha, A.data(), &lda, B.data(), &ldb, &beta, C.data(), &ldc);
+  check("dgemm", C, ref);
+}
+
+void check_gemv(int m, int n, char opa)
+{
+  MatrixXd A = MatrixXd::Random(m,n);
+  int rows = opa=='N' ? m : n, cols = opa=='N' ? n : m;
+  VectorXd x = VectorXd::Random(2*cols), y = VectorXd::Random(rows);
+  double alpha = 1.5, beta = 0.25;
+  int incx = 2, incy = 1;
+  VectorXd ref = alpha * apply_op(A, opa) * Map<VectorXd,0,InnerStride<2> >(x.data(), cols) + beta * y;
+  dgemv_(&opa, &m, &n, &alpha, A.data(), &m, x.data(), &incx, &beta, y.data(), &incy);
+  check("dgemv", y, ref);
+}
+
+void check_trsm_trmm(int m, int n, char side, char uplo, char opa)
+{
+  int size = side=='L' ? m : n;
+  MatrixXd A = MatrixXd::Random(size,size) + 4*size*MatrixXd::Identity(size,size);
+  MatrixXd B = MatrixXd::Random(m,n);
+  double alpha = 2;
+  char diag = 'N';
+  MatrixXd T = uplo=='U' ? MatrixXd(A.triangularView<Upper>()) : MatrixXd(A.triangularView<Lower>());
+  if(opa!='N') T.transposeInPlace();
+
+  MatrixXd X = B;
+  dtrsm_(&side, &uplo, &opa, &diag, &m, &n, &alpha, A.data(), &size, X.data(), &m);
+  check("dtrsm", side=='L' ? MatrixXd(T*X) : MatrixXd(X*T), alpha*B);
+
+  MatrixXd Y = B;
+  dtrmm_(&side, &uplo, &opa, &diag, &m, &n, &alpha, A.data(), &size, Y.data(), &m);
+  check("dtrmm", Y, side=='L' ? MatrixXd(alpha*T*B) : MatrixXd(alpha*B*T));
+}
+
+void check_syrk(int n, int k, char uplo, char op)
+{
+  MatrixXd A = op=='N' ? MatrixXd::Random(n,k) : MatrixXd::Random(k,n);
+  MatrixXd C = MatrixXd::Random(n,n);
+  double alpha = -1, beta = 0.5;
+  int lda = int(A.rows());
+  MatrixXd opA = apply_op(A, op);
+  MatrixXd full = alpha * opA * opA.transpose() + beta * C;
+  MatrixXd ref = C;
+  if(uplo=='U') ref.triangularView<Upper>() = full;
+  else          ref.triangularView<Lower>() = full;
+  dsyrk_(&uplo, &op, &n, &k, &alpha, A.data(), &lda, &beta, C.data(), &n);
+  check("dsyrk", C, ref);
+}
+
+void check_gemm_batch()
+{
+  // two groups, with small and large products
+  char opa[2] = {'N','T'}, opb[2] = {'T','N'};
+  int m[2] = {7, 120}, n[2] = {5, 90}, k[2] = {9, 70}, size[2] = {40, 3}, count = 2;
+  int lda[2] = {7, 70}, ldb[2] = {5, 70}, ldc[2] = {7, 120};
+  std::complex<double> alpha[2] = {std::complex<double>(1,2), 0.5}, beta[2] = {0., std::complex<double>(0,-1)};
+  std::vector<MatrixXcd> A, B, C, ref;
+  std::vector<const double*> pa, pb;
+  std::vector<double*> pc;
+  for(int g=0; g<count; ++g)
+    for(int i=0; i<size[g]; ++i)
+    {
+      A.push_back(opa[g]=='N' ? MatrixXcd::Random(m[g],k[g]) : MatrixXcd::Random(k[g],m[g]));
+      B.push_back(opb[g]=='N' ? MatrixXcd::Random(k[g],n[g]) : MatrixXcd::Random(n[g],k[g]));
+      C.push_back(MatrixXcd::Random(m[g],n[g]));
+      ref.push_back(alpha[g] * apply_op(A.back(), opa[g])
+                             * apply_op(B.back(), opb[g]) + beta[g] * C.back());
+    }
+  for(std::size_t i=0; i<A.size(); ++i)
+  {
+    pa.push_back(reinterpret_cast<const double*>(A[i].data()));
+    pb.push_back(reinterpret_cast<const double*>(B[i].data()));
+    pc.push_back(reinterpret_cast<double*>(C[i].data()));
+  }
+  zgemm_batch_(opa, opb, m, n, k, reinterpret_cast<const double*>(alpha), &pa[0], lda, &pb[0], ldb,
+               reinterpret_cast<const double*>(beta), &pc[0], ldc, &count, size);
+  for(std::size_t i=0; i<C.size(); ++i)
+    check("zgemm_batch", C[i], ref[i]);
+}
+
+void check_gemm_batch_strided(int m, int n, int k, int batch)
+{
+  // A is shared by all the products
+  char opa = 'N', opb = 'N';
+  int lda = m, ldb = k, ldc = m, stridea = 0, strideb = k*n, stridec = m*n;
+  MatrixXd A = MatrixXd::Random(m,k), B = MatrixXd::Random(k,n*batch), C = MatrixXd::Random(m,n*batch);
+  double alpha = 1, beta = 1;
+  MatrixXd ref = A*B + C;
+  dgemm_batch_strided_(&opa, &opb, &m, &n, &k, &alpha, A.data(), &lda, &stridea, B.data(), &ldb, &strideb,
+                       &beta, C.data(), &ldc, &stridec, &batch);
+  check("dgemm_batch_strided", C, ref);
+}
+
+int main()
+{
+  const char ops[2] = {'N','T'}, sides[2] = {'L','R'}, uplos[2] = {'U','L'};
+  for(int i=0; i<2; ++i)
+    for(int j=0; j<2; ++j)
+    {
+      check_gemm(301, 157, 203, ops[i], ops[j]);
+      check_gemm(61, 403, 97, ops[i], ops[j]);
+      check_gemv(701, 503, ops[i]);
+      check_syrk(311, 123, uplos[i], ops[j]);
+      for(int s=0; s<2; ++s)
+        check_trsm_trmm(213, 187, sides[s], uplos[i], ops[j]);
+    }
+  check_gemm(3, 2, 0, 'N', 'N');
+  check_gemm_batch();
+  check_gemm_batch_strided(17, 13, 11, 100);
+  check_gemm_batch_strided(150, 130, 110, 3);
+
+  if(failures)
+    std::cerr << failures << " failures\n";
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BAND_TRIDIAGONALIZATION_H
+#define EIGEN_BAND_TRIDIAGONALIZATION_H
+
+namespace internal {
+
+/* Two-stage reduction of a selfadjoint matrix to tridiagonal form.
+ *
+ * The first stage reduces the matrix to a band matrix by blocks of reflectors. Each block
+ * comes from the QR factorization of a panel of b columns, and the trailing matrix is updated
+ * by matrix-matrix products only, which is where most of the flops are spent.
+ * The second stage reduces the band matrix to tridiagonal form by chasing the bulges created
+ * by small reflectors down the band, for only O(n^2 b) operations.
+ */
+
+/* Reduces the selfadjoint matrix mat, whose both triangular parts are referenced, to a band matrix
+ * of bandwidth b such that Q^* mat Q is the band matrix, with
+ *   Q = householderSequence(mat,hCoeffs).setLength(n-b).setShift(b).
+ * On output, the lower band of mat holds the band matrix and the reflectors are stored below it.
+ * The strictly upper part of mat is not meaningful.
+ */
+template<typename MatrixType, typename CoeffVectorType>
+void selfadjoint_band_reduction_inplace(MatrixType& mat, Index b, CoeffVectorType& hCoeffs)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  typedef Block<MatrixType,Dynamic,Dynamic> BlockType;
+  const Index n = mat.rows();
+  eigen_assert(mat.cols()==n && b>0 && b<n);
+  hCoeffs.resize(n-b);
+
+  DenseMatrixType V, T, Y, W, VtY;
+  Matrix<Scalar,Dynamic,1> temp(b);
+  for(Index k=0; k<n-b; k+=b)
+  {
+    Index rs = n-b-k;                 // size of the trailing matrix
+    Index bs = (std::min)(b, rs);     // number of reflectors of the panel
+
+    // factorize the b columns below the band: panel = Q R, R being the next block of the band
+    BlockType panel = mat.block(k+b, k, rs, b);
+    VectorBlock<CoeffVectorType> hCoeffsSegment = hCoeffs.segment(k, bs);
+    householder_qr_inplace_unblocked(panel, hCoeffsSegment, temp.data());
+
+    // Q = I - V T V^*
+    V = panel.leftCols(bs).template triangularView<UnitLower>();
+    T.setZero(bs, bs);
+    make_block_householder_triangular_factor(T, V, hCoeffsSegment);
+
+    // A22 = Q^* A22 Q = A22 - V W^* - W V^* with W = Y - 1/2 V T^* V^* Y and Y = A22 V T
+    BlockType A22 = mat.bottomRightCorner(rs, rs);
+    W.noalias() = V * T.template triangularView<Upper>();
+    Y.noalias() = A22 * W;
+    VtY.noalias() = V.adjoint() * Y;
+    W = Y;
+    W.noalias() -= Scalar(0.5) * V * (T.template triangularView<Upper>().adjoint() * VtY);
+    // both triangular parts are updated such that these are plain matrix products
+    A22.noalias() -= V * W.adjoint();
+    A22.noalias() -= W * V.adjoint();
+  }
+}
+
+/* The reflectors of the band to tridiagonal reduction, in the order of their generation.
+ * The i-th reflector acts on the rows start(i) to start(i)+size(i)-1, and the essential part
+ * of its vector is stored at the top of the i-th column of vectors.
+ */
+template<typename Scalar>
+struct band_reflectors
+{
+  Matrix<Scalar,Dynamic,Dynamic> vectors;
+  Matrix<Scalar,Dynamic,1> coeffs;
+  Matrix<Index,Dynamic,1> start, size;
+};
+
+/* Reduces the band matrix of bandwidth b stored in the lower part of mat to the tridiagonal
+ * matrix (diag,subdiag) as H_k^* ... H_1^* mat H_1 ... H_k, where the H_i are stored into reflectors.
+ * Entries of the lower part of mat outside of the band must be zero on input, and mat is destroyed.
+ *
+ * The sweep j annihilates the column j below its subdiagonal. The reflector making the column j
+ * tridiagonal creates a bulge of b rows below the next diagonal block, whose first column is
+ * then annihilated by the next reflector, and so on down to the bottom of the matrix. The remaining
+ * part of each bulge lies in the columns reduced by the next sweeps.
+ */
+template<typename MatrixType, typename RealVectorType, typename Scalar>
+void band_tridiagonalization_inplace(MatrixType& mat, Index b, RealVectorType& diag, RealVectorType& subdiag,
+                                     band_reflectors<Scalar>& reflectors)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Block<MatrixType,Dynamic,Dynamic> BlockType;
+  typedef Block<Matrix<Scalar,Dynamic,Dynamic>,Dynamic,1> EssentialType;
+  const Index n = mat.rows();
+  eigen_assert(mat.cols()==n && b>0);
+
+  Index count = 0;
+  for(Index j=0; j<n-2; ++j)
+    count += (n-j-3)/b + 1;
+  reflectors.vectors.resize((std::max)(Index(1),b-1), count);
+  reflectors.coeffs.resize(count);
+  reflectors.start.resize(count);
+  reflectors.size.resize(count);
+
+  VectorType v(b), p(b), workspace(b);
+  Index id = 0;
+  for(Index j=0; j<n-2; ++j)
+  {
+    Index c = j;
+    for(Index s=j+1; n-s>=2; s+=b)
+    {
+      Index bs = (std::min)(b, n-s);
+      EssentialType essential(reflectors.vectors, 0, id, bs-1, 1);
+      Scalar tau;
+      typename NumTraits<Scalar>::Real beta;
+
+      // annihilate the column c below the row s
+      mat.col(c).segment(s,bs).makeHouseholder(essential, tau, beta);
+      mat.coeffRef(s,c) = beta;
+      mat.col(c).segment(s+1,bs-1).setZero();
+      if(s-c>1)
+        mat.block(s, c+1, bs, s-c-1).applyHouseholderOnTheLeft(essential, tau, workspace.data());
+
+      // two-sided update of the diagonal block, as in tridiagonalization_inplace
+      BlockType D = mat.block(s, s, bs, bs);
+      v(0) = Scalar(1);
+      v.segment(1,bs-1) = essential;
+      p.head(bs).noalias() = D.template selfadjointView<Lower>() * (numext::conj(tau) * v.head(bs));
+      p.head(bs) += (numext::conj(tau) * Scalar(-0.5) * p.head(bs).dot(v.head(bs))) * v.head(bs);
+      D.template selfadjointView<Lower>().rankUpdate(v.head(bs), p.head(bs), Scalar(-1));
+
+      // the update of the rows below creates the next bulge
+      Index rs = (std::min)(b, n-s-bs);
+      if(rs>0)
+        mat.block(s+bs, s, rs, bs).applyHouseholderOnTheRight(essential, tau, workspace.data());
+
+      reflectors.coeffs(id) = tau;
+      reflectors.start(id) = s;
+      reflectors.size(id) = bs;
+      ++id;
+      c = s;
+    }
+  }
+
+  diag = mat.diagonal().real();
+  subdiag = mat.template diagonal<-1>().real();
+}
+
+/* Performs dst = H_1 ... H_k dst for the columns of dst, one panel of columns at a time
+ * to apply all the reflectors while the panel is in cache. */
+template<typename Scalar, typename Dest>
+void apply_band_reflectors_on_the_left(const band_reflectors<Scalar>& reflectors, Dest& dst)
+{
+  typedef Block<const Matrix<Scalar,Dynamic,Dynamic>,Dynamic,1> EssentialType;
+  const Index PanelSize = 32;
+  const Index count = reflectors.coeffs.size();
+  Matrix<Scalar,Dynamic,1> workspace(PanelSize);
+  for(Index j=0; j<dst.cols(); j+=PanelSize)
+  {
+    Index cols = (std::min)(PanelSize, dst.cols()-j);
+    for(Index i=count-1; i>=0; --i)
+    {
+      Index bs = reflectors.size(i);
+      EssentialType essential(reflectors.vectors, 0, i, bs-1, 1);
+      dst.block(reflectors.start(i), j, bs, cols).applyHouseholderOnTheLeft(essential, reflectors.coeffs(i), workspace.data());
+    }
+  }
+}
+
+} // end namespace internal
+
+#endif // EIGEN_BAND_TRIDIAGONALIZATION_H
@@ -0,0 +1,296 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TRIDIAGONAL_DIVIDE_AND_CONQUER_H
+#define EIGEN_TRIDIAGONAL_DIVIDE_AND_CONQUER_H
+
+namespace internal {
+
+/* Cuppen's divide-and-conquer method for the symmetric tridiagonal eigenvalue problem.
+ *
+ * The tridiagonal matrix is split in two halves coupled by a rank-one modification, which are
+ * solved recursively. The eigenvectors are then obtained from the eigenvectors of the halves
+ * and of a diagonal plus rank-one matrix. The roots of its secular equation are computed as in
+ * LAPACK's laed4 from the closest pole, and the eigenvectors are made orthogonal by the method
+ * of Gu and Eisenstat. Almost all the flops are spent in one matrix product per merge.
+ */
+
+template<typename VectorType> struct dc_index_less
+{
+  dc_index_less(const VectorType& values) : m_values(values) {}
+  bool operator()(Index i, Index j) const { return m_values(i) < m_values(j); }
+  const VectorType& m_values;
+};
+
+/* returns the root of a x^2 + b x + c in [lo,hi] if any */
+template<typename RealScalar>
+RealScalar dc_quadratic_root(RealScalar a, RealScalar b, RealScalar c, RealScalar lo, RealScalar hi)
+{
+  using std::sqrt;
+  if(a==RealScalar(0))
+    return -c/b;
+  RealScalar disc = (std::max)(RealScalar(0), b*b - RealScalar(4)*a*c);
+  RealScalar t = b<0 ? (sqrt(disc)-b)/RealScalar(2) : -(sqrt(disc)+b)/RealScalar(2);
+  RealScalar r = t/a;
+  return (r>=lo && r<=hi) || t==RealScalar(0) ? r : c/t;
+}
+
+/* Computes the k-th root lambda = d(origin) + mu of the secular equation
+ *   1/rho + sum_i z_i^2/(d_i - lambda) = 0
+ * where d is strictly increasing and rho > 0. The root is searched relatively to the closest
+ * pole, and each step solves a rational interpolation of the two sums of the poles on each side.
+ */
+template<typename VectorType>
+void dc_secular_root(const VectorType& d, const VectorType& z, typename VectorType::Scalar rho,
+                     Index k, Index& origin, typename VectorType::Scalar& mu)
+{
+  typedef typename VectorType::Scalar RealScalar;
+  using std::abs;
+  const Index n = d.size();
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const bool last = k==n-1;
+  const RealScalar gap = last ? RealScalar(0) : d(k+1)-d(k);
+
+  // the root lies in [lo,hi] relatively to d(origin)
+  RealScalar lo, hi;
+  if(last)
+  {
+    origin = k;
+    lo = 0;
+    hi = rho * z.squaredNorm();
+  }
+  else
+  {
+    RealScalar mid = gap/RealScalar(2);
+    RealScalar f = RealScalar(1)/rho + (z.array().square() / ((d.array()-d(k)) - mid)).sum();
+    origin = f>=0 ? k : k+1;
+    lo = f>=0 ? RealScalar(0) : -mid;
+    hi = f>=0 ? mid : RealScalar(0);
+  }
+  VectorType delta = d.array() - d(origin);
+
+  mu = (lo+hi)/RealScalar(2);
+  for(int iter=0; iter<100; ++iter)
+  {
+    // the poles at the left and at the right of the root
+    RealScalar psi = 0, dpsi = 0, phi = 0, dphi = 0;
+    for(Index i=0; i<=k; ++i)
+    {
+      RealScalar t = z(i) / (delta(i)-mu);
+      psi += z(i)*t;
+      dpsi += t*t;
+    }
+    for(Index i=k+1; i<n; ++i)
+    {
+      RealScalar t = z(i) / (delta(i)-mu);
+      phi += z(i)*t;
+      dphi += t*t;
+    }
+    RealScalar f = RealScalar(1)/rho + psi + phi;
+    if(abs(f) <= eps * RealScalar(8*n) * (RealScalar(1)/rho - psi + phi))
+      break;
+    if(f<0) lo = mu;
+    else    hi = mu;
+    if(hi-lo <= eps * (abs(lo)+abs(hi)))
+      break;
+
+    // psi ~ a1 + b1/(delta(k)-x) and phi ~ a2 + b2/(delta(k+1)-x)
+    RealScalar pk = delta(k)-mu;
+    RealScalar b1 = dpsi*pk*pk, a1 = psi - dpsi*pk;
+    RealScalar next;
+    if(last)
+    {
+      RealScalar c = RealScalar(1)/rho + a1;
+      next = c>0 ? delta(k) + b1/c : hi;
+    }
+    else
+    {
+      RealScalar pk1 = delta(k+1)-mu;
+      RealScalar b2 = dphi*pk1*pk1, a2 = phi - dphi*pk1;
+      RealScalar c = RealScalar(1)/rho + a1 + a2;
+      // solve for the distance to the origin to keep the relative accuracy
+      if(origin==k) next = -dc_quadratic_root(c, c*gap + b1 + b2, b1*gap, -gap, RealScalar(0));
+      else          next = -dc_quadratic_root(c, b1 + b2 - c*gap, -b2*gap, RealScalar(0), gap);
+    }
+    if(!(next>=lo && next<=hi) || next==RealScalar(0))
+      next = (lo+hi)/RealScalar(2);
+    if(next==mu)
+      break;
+    mu = next;
+  }
+}
+
+/* Computes the eigen decomposition of diag(d) + rho z z^T in the basis eivec, where d holds
+ * the eigenvalues of the two halves of size m and n-m, and stores it into (d,eivec). */
+template<typename RealScalar>
+void tridiagonal_dc_merge(Ref<Matrix<RealScalar,Dynamic,1> > diag, Ref<Matrix<RealScalar,Dynamic,Dynamic> > eivec,
+                          Index m, RealScalar rho)
+{
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  typedef Matrix<RealScalar,Dynamic,Dynamic> MatrixType;
+  using std::abs;
+  using std::sqrt;
+  const Index n = diag.size();
+
+  // normalize z and make rho positive, the eigenvalues being negated if needed
+  VectorType z(n);
+  z.head(m) = eivec.row(m-1).head(m).transpose();
+  z.tail(n-m) = eivec.row(m).tail(n-m).transpose();
+  z /= sqrt(RealScalar(2));
+  RealScalar sign = rho<0 ? RealScalar(-1) : RealScalar(1);
+  rho = RealScalar(2)*abs(rho);
+  VectorType d = sign * diag;
+
+  std::vector<Index> perm(n);
+  for(Index i=0; i<n; ++i)
+    perm[i] = i;
+  std::sort(perm.begin(), perm.end(), dc_index_less<VectorType>(d));
+
+  // deflation of the negligible components of z, and of the close eigenvalues, as in LAPACK's laed2
+  RealScalar tol = RealScalar(8) * NumTraits<RealScalar>::epsilon()
+                 * (std::max)(d.cwiseAbs().maxCoeff(), rho*z.cwiseAbs().maxCoeff());
+  std::vector<Index> kept, deflated;
+  Index last = -1;
+  for(Index p=0; p<n; ++p)
+  {
+    Index i = perm[p];
+    if(rho*abs(z(i)) <= tol)
+    {
+      deflated.push_back(i);
+      continue;
+    }
+    if(last>=0)
+    {
+      RealScalar t = sqrt(z(last)*z(last) + z(i)*z(i));
+      RealScalar c = z(i)/t, s = z(last)/t;
+      if(abs(c*s*(d(i)-d(last))) <= tol)
+      {
+        // rotate the two eigenvectors such that z(last) vanishes
+        eivec.applyOnTheRight(last, i, JacobiRotation<RealScalar>(c,s));
+        RealScalar dl = d(last);
+        d(last) = c*c*dl + s*s*d(i);
+        d(i) = s*s*dl + c*c*d(i);
+        z(i) = t;
+        z(last) = 0;
+        deflated.push_back(last);
+      }
+      else
+        kept.push_back(last);
+    }
+    last = i;
+  }
+  if(last>=0)
+    kept.push_back(last);
+
+  const Index K = Index(kept.size());
+  VectorType dk(K), zk(K), mu(K), zhat(K);
+  Matrix<Index,Dynamic,1> origin(K);
+  for(Index k=0; k<K; ++k)
+  {
+    dk(k) = d(kept[k]);
+    zk(k) = z(kept[k]);
+  }
+
+#ifdef EIGEN_HAS_OPENMP
+  Eigen::initParallel();
+  Index threads = K>64 ? Index(Eigen::nbThreads()) : Index(1);
+  #pragma omp parallel for schedule(dynamic,(K+threads*4-1)/(threads*4)) num_threads(threads) if(threads>1)
+#endif
+  for(Index k=0; k<K; ++k)
+    dc_secular_root(dk, zk, rho, k, origin(k), mu(k));
+
+  // recompute z from the computed roots (Gu and Eisenstat) such that the eigenvectors are orthogonal
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic,(K+threads*4-1)/(threads*4)) num_threads(threads) if(threads>1)
+#endif
+  for(Index i=0; i<K; ++i)
+  {
+    RealScalar w = ((dk(origin(i))-dk(i)) + mu(i)) / rho;
+    for(Index j=0; j<K; ++j)
+      if(j!=i)
+        w *= ((dk(origin(j))-dk(i)) + mu(j)) / (dk(j)-dk(i));
+    zhat(i) = zk(i)<0 ? -sqrt(abs(w)) : sqrt(abs(w));
+  }
+
+  MatrixType U(K,K);
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(dynamic,(K+threads*4-1)/(threads*4)) num_threads(threads) if(threads>1)
+#endif
+  for(Index k=0; k<K; ++k)
+  {
+    U.col(k) = zhat.array() / ((dk.array()-dk(origin(k))) - mu(k));
+    U.col(k).normalize();
+  }
+
+  // eigenvectors of the rank-one modification in the basis eivec
+  MatrixType Q(n,K), res(n,n);
+  VectorType values(n);
+  for(Index k=0; k<K; ++k)
+  {
+    Q.col(k) = eivec.col(kept[k]);
+    values(k) = sign * (dk(origin(k)) + mu(k));
+  }
+  res.leftCols(K).noalias() = Q * U;
+  for(Index k=K; k<n; ++k)
+  {
+    res.col(k) = eivec.col(deflated[k-K]);
+    values(k) = sign * d(deflated[k-K]);
+  }
+
+  for(Index i=0; i<n; ++i)
+    perm[i] = i;
+  std::sort(perm.begin(), perm.end(), dc_index_less<VectorType>(values));
+  for(Index i=0; i<n; ++i)
+  {
+    diag(i) = values(perm[i]);
+    eivec.col(i) = res.col(perm[i]);
+  }
+}
+
+/* Computes the eigenvalues, sorted in increasing order, and the eigenvectors of the symmetric
+ * tridiagonal matrix (diag,subdiag). On output, diag holds the eigenvalues and subdiag is destroyed.
+ * Small matrices are solved by the implicit symmetric QR algorithm.
+ */
+template<typename RealScalar>
+ComputationInfo tridiagonal_divide_and_conquer(Ref<Matrix<RealScalar,Dynamic,1> > diag, Ref<Matrix<RealScalar,Dynamic,1> > subdiag,
+                                               Ref<Matrix<RealScalar,Dynamic,Dynamic> > eivec)
+{
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  typedef Matrix<RealScalar,Dynamic,Dynamic> MatrixType;
+  const Index SmallSize = 25;
+  const Index n = diag.size();
+
+  if(n<=SmallSize)
+  {
+    VectorType d = diag, e = subdiag;
+    MatrixType q = MatrixType::Identity(n,n);
+    ComputationInfo info = computeFromTridiagonal_impl(d, e, 30, true, q);
+    diag = d;
+    eivec = q;
+    return info;
+  }
+
+  // T = diag(T1 - rho e_m e_m^T, T2 - rho e_1 e_1^T) + rho v v^T with v = e_m + e_{m+1}
+  Index m = n/2;
+  RealScalar rho = subdiag(m-1);
+  diag(m-1) -= rho;
+  diag(m) -= rho;
+  eivec.topRightCorner(m, n-m).setZero();
+  eivec.bottomLeftCorner(n-m, m).setZero();
+  ComputationInfo info = tridiagonal_divide_and_conquer<RealScalar>(diag.head(m), subdiag.head(m-1), eivec.topLeftCorner(m,m));
+  if(info==Success)
+    info = tridiagonal_divide_and_conquer<RealScalar>(diag.tail(n-m), subdiag.tail(n-m-1), eivec.bottomRightCorner(n-m,n-m));
+  if(info!=Success)
+    return info;
+
+  tridiagonal_dc_merge<RealScalar>(diag, eivec, m, rho);
+  return Success;
+}
+
+} // end namespace internal
+
+#endif // EIGEN_TRIDIAGONAL_DIVIDE_AND_CONQUER_H
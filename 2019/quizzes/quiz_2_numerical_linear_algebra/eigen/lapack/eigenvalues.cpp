@@ -9,6 +9,14 @@
 
 #include "lapack_common.h"
 #include <Eigen/Eigenvalues>
+#include <Eigen/QR>
+#include <algorithm>
+#include <vector>
+
+namespace Eigen {
+#include "BandTridiagonalization.h"
+#include "TridiagonalDivideAndConquer.h"
+}
 
 // computes eigen values and vectors of a general N-by-N matrix A
 EIGEN_LAPACK_FUNC(syev,(char *jobz, char *uplo, int* n, Scalar* a, int *lda, Scalar* w, Scalar* /*work*/, int* lwork, int *info))
@@ -60,3 +68,132 @@ EIGEN_LAPACK_FUNC(syev,(char *jobz, char *uplo, int* n, Scalar* a, int *lda, Sca
   
   return 0;
 }
+
+// applies the reflectors of the band to tridiagonal reduction to independent panels of columns
+template<typename Scalar>
+struct band_reflectors_task
+{
+  band_reflectors_task(const internal::band_reflectors<Scalar>& reflectors, Matrix<Scalar,Dynamic,Dynamic>& dst)
+    : m_reflectors(reflectors), m_dst(dst)
+  {}
+
+  int threads() const
+  {
+    double work = 4. * double(m_reflectors.vectors.size()) * double(m_dst.cols());
+    return blas_threads(m_dst.cols()/32, work);
+  }
+
+  void operator()(int i, int count) const
+  {
+    DenseIndex start, length;
+    blas_chunk(m_dst.cols(), i, count, 32, start, length);
+    Block<Matrix<Scalar,Dynamic,Dynamic> > dst(m_dst, 0, start, m_dst.rows(), length);
+    internal::apply_band_reflectors_on_the_left(m_reflectors, dst);
+  }
+
+  const internal::band_reflectors<Scalar>& m_reflectors;
+  Matrix<Scalar,Dynamic,Dynamic>& m_dst;
+};
+
+// computes eigen values and vectors of a symmetric N-by-N matrix A using divide-and-conquer
+EIGEN_LAPACK_FUNC(syevd,(char *jobz, char *uplo, int* n, Scalar* a, int *lda, Scalar* w, Scalar* work, int* lwork, int* iwork, int* liwork, int *info))
+{
+  bool query_size = *lwork==-1 || *liwork==-1;
+  bool computeVectors = *jobz=='V' || *jobz=='v';
+  int lwmin  = *n<=1 ? 1 : computeVectors ? 1+6**n+2**n**n : 2**n+1;
+  int liwmin = (*n<=1 || !computeVectors) ? 1 : 3+5**n;
+
+  *info = 0;
+        if(*jobz!='N' && *jobz!='n' && !computeVectors) *info = -1;
+  else  if(UPLO(*uplo)==INVALID)                        *info = -2;
+  else  if(*n<0)                                        *info = -3;
+  else  if(*lda<std::max(1,*n))                         *info = -5;
+  else  if((!query_size) && *lwork<lwmin)               *info = -8;
+  else  if((!query_size) && *liwork<liwmin)             *info = -10;
+
+  if(*info!=0)
+  {
+    int e = -*info;
+    return xerbla_(SCALAR_SUFFIX_UP"SYEVD", &e, 6);
+  }
+
+  work[0] = Scalar(lwmin);
+  iwork[0] = liwmin;
+  if(query_size || *n==0)
+    return 0;
+
+  // Large matrices are reduced to a band matrix first, such that most of the flops of the
+  // tridiagonalization are spent in (multi-threaded) matrix products.
+  const Index BandWidth = 32;
+  const bool twoStage = *n > 4*BandWidth;
+
+  PlainMatrixType mat(*n,*n);
+  if(UPLO(*uplo)==UP) mat = matrix(a,*n,*n,*lda).adjoint();
+  else                mat = matrix(a,*n,*n,*lda);
+  mat.triangularView<StrictlyUpper>() = mat.adjoint();
+
+  // scale the matrix to avoid over and underflows, as SelfAdjointEigenSolver
+  RealScalar scale = mat.cwiseAbs().maxCoeff();
+  if(scale==RealScalar(0)) scale = RealScalar(1);
+  mat /= scale;
+
+  Matrix<RealScalar,Dynamic,1> diag(*n), subdiag(*n-1);
+  Matrix<Scalar,Dynamic,1> hCoeffs;
+  internal::band_reflectors<Scalar> reflectors;
+  if(twoStage)
+  {
+    internal::selfadjoint_band_reduction_inplace(mat, BandWidth, hCoeffs);
+    PlainMatrixType band = PlainMatrixType::Zero(*n,*n);
+    for(Index j=0; j<*n; ++j)
+    {
+      Index size = (std::min)(BandWidth+1, *n-j);
+      band.col(j).segment(j,size) = mat.col(j).segment(j,size);
+    }
+    internal::band_tridiagonalization_inplace(band, BandWidth, diag, subdiag, reflectors);
+  }
+  else
+  {
+    hCoeffs.resize(*n-1);
+    internal::tridiagonalization_inplace(mat, hCoeffs);
+    diag = mat.diagonal();
+    subdiag = mat.diagonal<-1>();
+  }
+
+  ComputationInfo result;
+  PlainMatrixType eivec;
+  if(computeVectors)
+  {
+    eivec.resize(*n,*n);
+    result = internal::tridiagonal_divide_and_conquer<RealScalar>(diag, subdiag, eivec);
+  }
+  else
+  {
+    result = internal::computeFromTridiagonal_impl(diag, subdiag, 30, false, eivec);
+  }
+
+  // the QR iterations on a tridiagonal block did not converge
+  if(result==NoConvergence)
+  {
+    *info = 1;
+    return 0;
+  }
+
+  make_vector(w,*n) = diag * scale;
+  if(computeVectors)
+  {
+    // back-transformation, by blocks of reflectors for the first stage
+    if(twoStage)
+    {
+      band_reflectors_task<Scalar> task(reflectors, eivec);
+      blas_parallel_run(task, task.threads());
+      eivec.applyOnTheLeft(householderSequence(mat, hCoeffs).setLength(*n-BandWidth).setShift(BandWidth));
+    }
+    else
+    {
+      eivec.applyOnTheLeft(householderSequence(mat, hCoeffs).setLength(*n-1).setShift(1));
+    }
+    matrix(a,*n,*n,*lda) = eivec;
+  }
+
+  return 0;
+}
@@ -0,0 +1,155 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+// Checks ?syevd against SelfAdjointEigenSolver on sizes large enough to run the two-stage
+// tridiagonalization and the divide-and-conquer merges. The reference testers only use small sizes.
+
+#include <Eigen/Dense>
+#include <cctype>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+int ssyevd_(char *jobz, char *uplo, int *n, float *a, int *lda, float *w, float *work, int *lwork,
+            int *iwork, int *liwork, int *info);
+int dsyevd_(char *jobz, char *uplo, int *n, double *a, int *lda, double *w, double *work, int *lwork,
+            int *iwork, int *liwork, int *info);
+}
+
+using namespace Eigen;
+
+static int failures = 0;
+
+inline void syevd(char *jobz, char *uplo, int *n, float *a, int *lda, float *w, float *work, int *lwork,
+                  int *iwork, int *liwork, int *info)
+{ ssyevd_(jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info); }
+
+inline void syevd(char *jobz, char *uplo, int *n, double *a, int *lda, double *w, double *work, int *lwork,
+                  int *iwork, int *liwork, int *info)
+{ dsyevd_(jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info); }
+
+void check(const char* what, int n, char jobz, char uplo, double err, double tol)
+{
+  if(!(err < tol))
+  {
+    std::cerr << what << " failed for n=" << n << ", jobz=" << jobz << ", uplo=" << uplo
+              << ": relative error " << err << "\n";
+    ++failures;
+  }
+}
+
+bool check_info(const char* what, int n, char jobz, char uplo, int info)
+{
+  if(info!=0)
+  {
+    std::cerr << what << " failed for n=" << n << ", jobz=" << jobz << ", uplo=" << uplo
+              << ": info=" << info << "\n";
+    ++failures;
+  }
+  return info==0;
+}
+
+template<typename MatrixType>
+void check_syevd(const MatrixType& A, char jobz, char uplo)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  int n = int(A.rows()), lda = n+3;
+  const bool vectors = std::toupper(jobz)=='V', upper = std::toupper(uplo)=='U';
+
+  // the other triangular part and the padding rows must not be referenced
+  MatrixType a = MatrixType::Constant(lda, n, Scalar(1234));
+  if(upper) a.topRows(n).template triangularView<Upper>() = A;
+  else      a.topRows(n).template triangularView<Lower>() = A;
+  VectorType w(n);
+
+  // workspace query
+  int lwork = -1, liwork = -1, info = 0, iwork_query = 0;
+  Scalar work_query = 0;
+  syevd(&jobz, &uplo, &n, a.data(), &lda, w.data(), &work_query, &lwork, &iwork_query, &liwork, &info);
+  if(!check_info("?syevd workspace query", n, jobz, uplo, info))
+    return;
+  lwork = int(work_query);
+  liwork = iwork_query;
+  std::vector<Scalar> work(lwork);
+  std::vector<int> iwork(liwork);
+
+  syevd(&jobz, &uplo, &n, a.data(), &lda, w.data(), &work[0], &lwork, &iwork[0], &liwork, &info);
+  if(!check_info("?syevd", n, jobz, uplo, info))
+    return;
+
+  // nor written, the eigenvectors only overwriting the n first rows
+  bool untouched = (a.bottomRows(lda-n).array()==Scalar(1234)).all();
+  if(!vectors)
+    for(int j=0; j<n; ++j)
+      for(int i=0; i<n; ++i)
+        if(upper ? i>j : i<j)
+          untouched = untouched && a(i,j)==Scalar(1234);
+  if(!untouched)
+  {
+    std::cerr << "?syevd wrote outside of its triangle for n=" << n << ", jobz=" << jobz << ", uplo=" << uplo << "\n";
+    ++failures;
+  }
+
+  const double tol = 100 * n * double(NumTraits<Scalar>::epsilon());
+  const double norm = (std::max)(double(1), double(A.norm()));
+  SelfAdjointEigenSolver<MatrixType> ref(A, EigenvaluesOnly);
+  check("?syevd eigenvalues", n, jobz, uplo, double((w - ref.eigenvalues()).norm()) / norm, tol);
+
+  if(vectors)
+  {
+    MatrixType X = a.topRows(n);
+    check("?syevd residual", n, jobz, uplo, double((A*X - X*w.asDiagonal()).norm()) / norm, tol);
+    check("?syevd orthogonality", n, jobz, uplo, double((X.adjoint()*X - MatrixType::Identity(n,n)).norm()), tol);
+  }
+}
+
+template<typename MatrixType>
+void check_syevd_sizes()
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  // n=30 only uses the divide-and-conquer merges, n=200 and n=1000 also use the two-stage reduction
+  const int sizes[3] = {30, 200, 1000};
+  const char jobzs[2] = {'N','V'}, uplos[2] = {'U','L'};
+  for(int s=0; s<3; ++s)
+  {
+    int n = sizes[s];
+    MatrixType R = MatrixType::Random(n,n);
+    MatrixType A = R + R.adjoint();
+
+    // clustered eigenvalues, which are deflated by the merges
+    MatrixType Q = HouseholderQR<MatrixType>(MatrixType::Random(n,n)).householderQ();
+    VectorType ev = VectorType::Ones(n);
+    for(int k=0; k<n; k+=3)
+      ev(k) = Scalar(-1);
+    MatrixType C = Q * ev.asDiagonal() * Q.adjoint();
+    C = (C + C.adjoint()) / Scalar(2);
+
+    for(int i=0; i<2; ++i)
+      for(int j=0; j<2; ++j)
+      {
+        check_syevd(A, jobzs[i], uplos[j]);
+        check_syevd(C, jobzs[i], uplos[j]);
+      }
+  }
+
+  // the options are case insensitive
+  MatrixType R = MatrixType::Random(30,30);
+  check_syevd(MatrixType(R + R.adjoint()), 'v', 'l');
+  check_syevd(MatrixType(R + R.adjoint()), 'n', 'u');
+}
+
+int main()
+{
+  check_syevd_sizes<MatrixXd>();
+  check_syevd_sizes<MatrixXf>();
+
+  if(failures)
+    std::cerr << failures << " failures\n";
+  return failures ? 1 : 0;
+}
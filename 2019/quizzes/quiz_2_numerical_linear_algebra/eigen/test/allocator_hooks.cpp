@@ -0,0 +1,200 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_ALLOCATOR_HOOKS
+#include "main.h"
+#include <Eigen/LU>
+#include <Eigen/SparseCore>
+#include <vector>
+
+#if EIGEN_MAX_ALIGN_BYTES>0
+#define ALIGNMENT EIGEN_MAX_ALIGN_BYTES
+#else
+#define ALIGNMENT 1
+#endif
+
+// a user resource tracking the blocks it has allocated
+class TrackingResource : public MallocResource
+{
+  public:
+    std::vector<void*> blocks;
+  protected:
+    virtual void* doAllocate(std::size_t size)
+    {
+      void* ptr = MallocResource::doAllocate(size);
+      blocks.push_back(ptr);
+      return ptr;
+    }
+    virtual void doDeallocate(void* ptr, std::size_t size)
+    {
+      std::vector<void*>::iterator it = std::find(blocks.begin(), blocks.end(), ptr);
+      VERIFY(it != blocks.end());
+      blocks.erase(it);
+      MallocResource::doDeallocate(ptr, size);
+    }
+};
+
+void check_resource_alignment()
+{
+  MallocResource counter;
+  ArenaResource arena(1<<16);
+  MemoryResource* resources[3] = { 0, &counter, &arena };
+  for(int k = 0; k < 3; ++k)
+  {
+    setMemoryResource(resources[k]);
+    VERIFY(memoryResource() == resources[k]);
+    for(int i = 1; i < 300; i++)
+    {
+      char *p = (char*)internal::aligned_malloc(i);
+      VERIFY(internal::UIntPtr(p)%ALIGNMENT==0);
+      for(int j = 0; j < i; j++) p[j]=char(j);
+      p = (char*)internal::aligned_realloc(p, 2*i, i);
+      VERIFY(internal::UIntPtr(p)%ALIGNMENT==0);
+      for(int j = 0; j < i; j++) VERIFY(p[j]==char(j));
+      internal::aligned_free(p);
+    }
+    setMemoryResource(0);
+  }
+  VERIFY_IS_EQUAL(counter.allocations(), counter.deallocations());
+  VERIFY_IS_EQUAL(counter.bytesInUse(), std::size_t(0));
+  VERIFY_IS_EQUAL(arena.used(), std::size_t(0));
+  VERIFY_IS_EQUAL(arena.overflows(), std::size_t(0));
+}
+
+template<typename MatrixType> void check_counters(Index n)
+{
+  MatrixType a = MatrixType::Random(n,n), b = MatrixType::Random(n,n), c(n,n);
+  MatrixType ref = a*b + a.inverse();
+
+  MallocResource counter;
+  {
+    ScopedMemoryResource guard(counter);
+    c.noalias() = a*b;
+    c += a.inverse();
+  }
+  VERIFY_IS_APPROX(c, ref);
+  VERIFY(counter.allocations() > 0);
+  VERIFY_IS_EQUAL(counter.allocations(), counter.deallocations());
+  VERIFY_IS_EQUAL(counter.bytesInUse(), std::size_t(0));
+  VERIFY(counter.peakBytes() >= std::size_t(n*n)*sizeof(typename MatrixType::Scalar));
+  VERIFY(counter.totalBytes() >= counter.peakBytes());
+
+  // the guard is restored, and nested guards are allowed
+  VERIFY(memoryResource() == 0);
+  TrackingResource tracker;
+  counter.resetCounters();
+  c.resize(0,0);
+  {
+    ScopedMemoryResource guard1(counter);
+    MatrixType tmp = a;
+    {
+      ScopedMemoryResource guard2(tracker);
+      VERIFY(memoryResource() == &tracker);
+      c = tmp.inverse();
+    }
+    VERIFY(memoryResource() == &counter);
+  }
+  VERIFY(memoryResource() == 0);
+  VERIFY_IS_EQUAL(counter.allocations(), std::size_t(1));
+  VERIFY(tracker.allocations() > 0);
+
+  // c has been allocated by the tracker, and is freed by the tracker after its guard went out of scope
+  VERIFY_IS_EQUAL(tracker.blocks.size(), std::size_t(1));
+  c.resize(0,0);
+  VERIFY_IS_EQUAL(tracker.blocks.size(), std::size_t(0));
+  VERIFY_IS_EQUAL(tracker.bytesInUse(), std::size_t(0));
+}
+
+template<typename MatrixType> void check_arena(Index n)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  MatrixType a = MatrixType::Random(n,n) + MatrixType::Identity(n,n) * Scalar(n);
+  VectorType b = VectorType::Random(n);
+  MatrixType c(n,n);
+  VectorType x(n);
+
+  ArenaResource arena(std::size_t(16*n*n)*sizeof(Scalar) + (1<<16));
+  {
+    ScopedMemoryResource guard(arena);
+    for(int k = 0; k < 4; ++k)
+    {
+      c.noalias() = a*a.transpose();
+      x = c.partialPivLu().solve(b);
+      if(k==0) arena.resetCounters();
+    }
+  }
+  VERIFY_IS_APPROX(c*x, b);
+  // the steady state loop runs in the arena, and the blocks are reclaimed
+  VERIFY_IS_EQUAL(arena.overflows(), std::size_t(0));
+  VERIFY_IS_EQUAL(arena.used(), std::size_t(0));
+  VERIFY(arena.highWaterMark() <= arena.capacity());
+  VERIFY_IS_EQUAL(arena.allocations(), arena.deallocations());
+
+  // holes are reclaimed once the blocks on top of them are freed
+  {
+    ScopedMemoryResource guard(arena);
+    MatrixType* m1 = new MatrixType(n,n);
+    MatrixType* m2 = new MatrixType(n,n);
+    std::size_t used = arena.used();
+    delete m1;
+    VERIFY_IS_EQUAL(arena.used(), used);
+    delete m2;
+    VERIFY_IS_EQUAL(arena.used(), std::size_t(0));
+  }
+
+  // a too small arena falls back to the system allocator
+  ArenaResource small(64);
+  {
+    ScopedMemoryResource guard(small);
+    c = a*a;
+  }
+  VERIFY(small.overflows() > 0);
+  VERIFY_IS_APPROX(c, (a*a).eval());
+  c.resize(0,0);
+  VERIFY_IS_EQUAL(small.bytesInUse(), std::size_t(0));
+}
+
+template<typename SparseMatrixType> void check_sparse(Index n)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  TrackingResource tracker;
+  {
+    ScopedMemoryResource guard(tracker);
+    // the outer index is allocated by the resource
+    SparseMatrixType m(n,n);
+    VERIFY_IS_EQUAL(tracker.allocations(), std::size_t(1));
+
+    // the uncompressed mode allocates the inner non zeros, and reallocates the outer index
+    m.reserve(VectorXi::Constant(n,3));
+    for(Index j = 0; j < n; ++j)
+      m.insert(internal::random<Index>(0,n-1), j) = Scalar(1);
+    m.conservativeResize(n+5, n+7);
+    m.conservativeResize(n-1, n-2);
+    m.makeCompressed();
+    VERIFY(m.isCompressed());
+    m.coeffRef(0,0) += Scalar(2);
+    m.resize(2*n, 2*n);
+  }
+  VERIFY(tracker.allocations() > 1);
+  VERIFY_IS_EQUAL(tracker.allocations(), tracker.deallocations());
+  VERIFY_IS_EQUAL(tracker.blocks.size(), std::size_t(0));
+  VERIFY_IS_EQUAL(tracker.bytesInUse(), std::size_t(0));
+}
+
+void test_allocator_hooks()
+{
+  CALL_SUBTEST_1( check_resource_alignment() );
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_2( check_counters<MatrixXf>(internal::random<Index>(10,100)) );
+    CALL_SUBTEST_3( check_counters<MatrixXcd>(internal::random<Index>(10,100)) );
+    CALL_SUBTEST_4( check_arena<MatrixXd>(internal::random<Index>(10,100)) );
+    CALL_SUBTEST_4( check_arena<MatrixXd>(internal::random<Index>(200,300)) );
+    CALL_SUBTEST_5( (check_sparse<SparseMatrix<double> >(internal::random<Index>(10,100))) );
+    CALL_SUBTEST_5( (check_sparse<SparseMatrix<float,RowMajor> >(internal::random<Index>(10,100))) );
+  }
+}
@@ -106,6 +106,116 @@ void alignedboxCastTests(const BoxType& _box)
   VERIFY_IS_APPROX(hp1d.template cast<Scalar>(),b0);
 }
 
+// reference slab test dividing by the direction, with an explicit handling of the axis parallel rays
+template<typename VectorType, typename Scalar>
+bool ray_box_reference(const VectorType& o, const VectorType& d, const VectorType& m, const VectorType& M, Scalar tMax, Scalar& t0, Scalar& t1)
+{
+  t0 = Scalar(0);
+  t1 = tMax;
+  for(Index k = 0; k < o.size(); ++k)
+  {
+    if(d[k] == Scalar(0)) {
+      if(o[k] < m[k] || o[k] > M[k])
+        return false;
+      continue;
+    }
+    Scalar a = (m[k] - o[k]) / d[k], b = (M[k] - o[k]) / d[k];
+    if(a > b)
+      std::swap(a, b);
+    t0 = (std::max)(t0, a);
+    t1 = (std::min)(t1, b);
+  }
+  return t0 <= t1;
+}
+
+template<typename BoxType> void alignedboxRay(const BoxType& _box)
+{
+  /* this test covers the following files:
+     AlignedBoxRay.h
+  */
+  typedef typename BoxType::Scalar Scalar;
+  typedef Matrix<Scalar, BoxType::AmbientDimAtCompileTime, 1> VectorType;
+  typedef Matrix<Scalar, BoxType::AmbientDimAtCompileTime, Dynamic> MatrixType;
+  typedef Matrix<Scalar, BoxType::AmbientDimAtCompileTime, Dynamic, RowMajor> RowMajorMatrixType;
+  typedef Matrix<Scalar, Dynamic, 1> ParamType;
+  typedef ParametrizedLine<Scalar, BoxType::AmbientDimAtCompileTime> LineType;
+
+  const Index dim = _box.dim();
+  const Index n = internal::random<Index>(2, 600);
+  const Scalar tMax = internal::random<Scalar>(1, 4);
+  const Scalar tol = test_precision<Scalar>();
+
+  // rays, some of them parallel to an axis and starting on the faces of the box
+  BoxType box(VectorType::Random(dim));
+  box.extend(VectorType::Random(dim));
+  MatrixType origins = MatrixType::Random(dim, n) * Scalar(2), directions = MatrixType::Random(dim, n), invDirections;
+  for(Index i = 0; i < n; i += 3)
+  {
+    Index k = internal::random<Index>(0, dim-1);
+    directions(k, i) = internal::random<bool>() ? Scalar(0) : -Scalar(0);
+    if(internal::random<bool>())
+      origins(k, i) = internal::random<bool>() ? (box.min)()[k] : (box.max)()[k];
+  }
+  rayInverseDirections(directions, invDirections);
+  VERIFY(!invDirections.hasNaN());
+
+  ParamType tEntry, tExit;
+  Array<bool, Dynamic, 1> hits;
+  Index count = batchRayBoxIntersection(origins, invDirections, box, tEntry, tExit, hits, tMax);
+  VERIFY_IS_EQUAL(count, hits.count());
+  for(Index i = 0; i < n; ++i)
+  {
+    Scalar t0, t1;
+    bool ref = ray_box_reference(VectorType(origins.col(i)), VectorType(directions.col(i)), (box.min)(), (box.max)(), tMax, t0, t1);
+    if(numext::abs(t1 - t0) <= tol)
+      continue; // grazing rays are sensitive to roundoff errors
+    VERIFY_IS_EQUAL(hits(i), ref);
+    if(ref)
+    {
+      VERIFY(numext::abs(tEntry(i) - t0) <= tol * (Scalar(1) + numext::abs(t0)));
+      VERIFY(numext::abs(tExit(i) - t1) <= tol * (Scalar(1) + numext::abs(t1)));
+    }
+  }
+
+  // one ray against many boxes stored in row major order
+  MatrixType corners0 = MatrixType::Random(dim, n), corners1 = MatrixType::Random(dim, n);
+  RowMajorMatrixType mins = corners0.cwiseMin(corners1), maxs = corners0.cwiseMax(corners1);
+  VectorType direction = VectorType::Random(dim);
+  direction[0] = Scalar(0);
+  LineType ray(VectorType::Random(dim), direction);
+  ray.origin()[0] = mins(0, 0);
+  mins.col(1).swap(maxs.col(1)); // an empty box
+  count = batchRayBoxIntersection(ray, mins, maxs, tEntry, tExit, hits, tMax);
+  VERIFY_IS_EQUAL(count, hits.count());
+  VERIFY(!hits(1));
+  for(Index i = 0; i < n; ++i)
+  {
+    Scalar t0, t1;
+    bool ref = ray_box_reference(ray.origin(), ray.direction(), VectorType(mins.col(i)), VectorType(maxs.col(i)), tMax, t0, t1);
+    if(i != 1 && numext::abs(t1 - t0) > tol)
+      VERIFY_IS_EQUAL(hits(i), ref);
+    if(hits(i))
+    {
+      VERIFY(tEntry(i) >= Scalar(0) && tExit(i) <= tMax);
+      VERIFY(BoxType(mins.col(i), maxs.col(i)).extend(ray.pointAt(tEntry(i))).sizes().isApprox((maxs.col(i) - mins.col(i)).eval()));
+    }
+  }
+
+  // rays with NaN never hit
+  ray.origin()[0] = NumTraits<Scalar>::quiet_NaN();
+  VERIFY_IS_EQUAL(batchRayBoxIntersection(ray, mins, maxs, tEntry, tExit, hits), 0);
+  VERIFY(!hits.any());
+  origins.col(0).setConstant(NumTraits<Scalar>::quiet_NaN());
+  origins.col(1) = box.center();
+  rayInverseDirections(directions, invDirections);
+  batchRayBoxIntersection(origins.leftCols(2), invDirections.leftCols(2), box, tEntry, tExit, hits);
+  VERIFY(!hits(0));
+  VERIFY(hits(1) && tEntry(1) == Scalar(0));
+
+  // empty box
+  VERIFY_IS_EQUAL(batchRayBoxIntersection(origins, invDirections, BoxType(dim), tEntry, tExit, hits), 0);
+}
+
 
 void specificTest1()
 {
@@ -181,6 +291,10 @@ void test_geo_alignedbox()
     CALL_SUBTEST_11( alignedbox(AlignedBox3i()) );
 
     CALL_SUBTEST_14( alignedbox(AlignedBox<double,Dynamic>(4)) );
+
+    CALL_SUBTEST_15( alignedboxRay(AlignedBox2f()) );
+    CALL_SUBTEST_15( alignedboxRay(AlignedBox3d()) );
+    CALL_SUBTEST_16( alignedboxRay(AlignedBox<double,Dynamic>(internal::random<int>(1,5))) );
   }
   CALL_SUBTEST_12( specificTest1() );
   CALL_SUBTEST_13( specificTest2() );
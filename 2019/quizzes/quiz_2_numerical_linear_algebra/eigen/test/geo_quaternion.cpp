@@ -285,6 +285,63 @@ template<typename PlainObjectType> void check_const_correctness(const PlainObjec
   VERIFY( !(Map<ConstPlainObjectType, Aligned>::Flags & LvalueBit) );
 }
 
+template<typename Scalar> void quaternionBatch(Index n)
+{
+  typedef Quaternion<Scalar> Quaternionx;
+  typedef Matrix<Scalar,4,Dynamic> Matrix4X;
+  typedef Matrix<Scalar,3,Dynamic> Matrix3X;
+  typedef Matrix<Scalar,1,Dynamic> RowVectorX;
+
+  std::vector<Quaternionx, aligned_allocator<Quaternionx> > qa(n), qb(n), qr(n);
+  for(Index i = 0; i < n; ++i)
+  {
+    qa[i] = Quaternionx::UnitRandom();
+    qb[i] = Quaternionx::UnitRandom();
+  }
+  // nearly parallel and opposite quaternions
+  qb[0] = qa[0];
+  if(n>1) qb[1].coeffs() = -qa[1].coeffs();
+  Map<Matrix4X> a(qa[0].coeffs().data(), 4, n), b(qb[0].coeffs().data(), 4, n), r(qr[0].coeffs().data(), 4, n);
+  Matrix3X v = Matrix3X::Random(3, n), rv;
+  RowVectorX t = (RowVectorX::Random(n).array() + Scalar(1)) / Scalar(2);
+  Scalar s = internal::random<Scalar>(0,1);
+
+  batchQuaternionProduct(a, b, r);
+  for(Index i = 0; i < n; ++i)
+    VERIFY_IS_APPROX(qr[i].coeffs(), (qa[i]*qb[i]).coeffs());
+
+  batchQuaternionConjugate(a, r);
+  for(Index i = 0; i < n; ++i)
+    VERIFY_IS_APPROX(qr[i].coeffs(), qa[i].conjugate().coeffs());
+
+  batchQuaternionRotate(a, v, rv);
+  for(Index i = 0; i < n; ++i)
+    VERIFY_IS_APPROX(rv.col(i), qa[i]*v.col(i).eval());
+
+  batchQuaternionSlerp(t, a, b, r);
+  for(Index i = 0; i < n; ++i)
+    VERIFY_IS_APPROX(qr[i].coeffs(), qa[i].slerp(t(i), qb[i]).coeffs());
+  batchQuaternionSlerp(s, a, b, r);
+  for(Index i = 0; i < n; ++i)
+    VERIFY_IS_APPROX(qr[i].coeffs(), qa[i].slerp(s, qb[i]).coeffs());
+
+  batchQuaternionNlerp(t, a, b, r);
+  for(Index i = 0; i < n; ++i)
+  {
+    Scalar t1 = qa[i].dot(qb[i]) < Scalar(0) ? -t(i) : t(i);
+    VERIFY_IS_APPROX(qr[i].coeffs(), ((Scalar(1)-t(i))*qa[i].coeffs() + t1*qb[i].coeffs()).normalized());
+  }
+
+  // in place
+  Matrix4X c = a;
+  batchQuaternionSlerp(s, c, b, c);
+  for(Index i = 0; i < n; ++i)
+    VERIFY_IS_APPROX(Quaternionx(c.col(i)).coeffs(), qa[i].slerp(s, qb[i]).coeffs());
+  batchQuaternionProduct(c, c, c);
+  batchQuaternionRotate(a, v, v);
+  VERIFY_IS_APPROX(v, rv);
+}
+
 void test_geo_quaternion()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -298,5 +355,7 @@ void test_geo_quaternion()
     CALL_SUBTEST_6(( quaternionAlignment<double>() ));
     CALL_SUBTEST_1( mapQuaternion<float>() );
     CALL_SUBTEST_2( mapQuaternion<double>() );
+    CALL_SUBTEST_7( quaternionBatch<float>(internal::random<Index>(1,1000)) );
+    CALL_SUBTEST_8( quaternionBatch<double>(internal::random<Index>(1,1000)) );
   }
 }
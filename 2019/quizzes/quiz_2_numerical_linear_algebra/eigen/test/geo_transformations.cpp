@@ -612,6 +612,61 @@ template<typename Scalar, int Dim, int Options> void transform_products()
   VERIFY_IS_APPROX((ac*p).matrix(), a_m*p_m);
 }
 
+template<typename Scalar, int Dim, int Mode, int Options> void transform_batch(Index n)
+{
+  typedef Transform<Scalar,Dim,Mode,Options> TransformType;
+  typedef Transform<Scalar,Dim,Projective> ProjectiveType;
+  typedef Matrix<Scalar,Dim,Dynamic> PointsType;
+  typedef Matrix<Scalar,Dim,Dynamic,RowMajor> SoAPointsType;
+  typedef Matrix<Scalar,Dynamic,Dim> ColumnsType;
+
+  ProjectiveType p;
+  p.matrix().setRandom();
+  p.linear() += Matrix<Scalar,Dim,Dim>::Identity() * Scalar(Dim);
+  // keep the points away from the plane at infinity
+  p.matrix().row(Dim) *= Scalar(0.1);
+  p.matrix()(Dim,Dim) = Scalar(1);
+  if(int(Mode)==int(Isometry))
+  {
+    p.linear() = p.linear().householderQr().householderQ();
+    p.makeAffine();
+  }
+  else if(int(Mode)!=int(Projective))
+    p.makeAffine();
+  TransformType t(p.matrix());
+
+  PointsType pts = PointsType::Random(Dim,n), res(Dim,n);
+  PointsType refPoints = (p * pts.colwise().homogeneous()).colwise().hnormalized();
+  PointsType refVectors = p.linear() * pts;
+  PointsType refNormals = p.linear().inverse().transpose() * pts;
+
+  // interleaved storage
+  t.transformPoints(pts, res);
+  VERIFY_IS_APPROX(res, refPoints);
+  t.transformVectors(pts, res);
+  VERIFY_IS_APPROX(res, refVectors);
+  t.transformNormals(pts, res);
+  VERIFY_IS_APPROX(res, refNormals);
+
+  // structure of arrays, in place
+  SoAPointsType soa = pts;
+  t.transformPoints(soa, soa);
+  VERIFY_IS_APPROX(soa, refPoints);
+  ColumnsType cols = pts.transpose();
+  t.transformNormals(cols.transpose(), cols.transpose());
+  VERIFY_IS_APPROX(cols.transpose(), refNormals);
+
+  // the result is resized, and the normals stay orthogonal to the transformed tangent vectors
+  PointsType tangents = PointsType::Random(Dim,n), normals = PointsType::Random(Dim,n), tn, nn;
+  for(Index j = 0; j < n; ++j)
+    normals.col(j) -= normals.col(j).dot(tangents.col(j)) / tangents.col(j).squaredNorm() * tangents.col(j);
+  t.transformVectors(tangents, tn);
+  t.transformNormals(normals, nn);
+  VERIFY_IS_EQUAL(nn.cols(), n);
+  for(Index j = 0; j < n; ++j)
+    VERIFY(numext::abs(tn.col(j).dot(nn.col(j))) <= test_precision<Scalar>() * tn.col(j).norm() * nn.col(j).norm());
+}
+
 void test_geo_transformations()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -641,5 +696,12 @@ void test_geo_transformations()
 
     CALL_SUBTEST_8(( transform_associativity<double,2,ColMajor>(Rotation2D<double>(internal::random<double>()*double(EIGEN_PI))) ));
     CALL_SUBTEST_8(( transform_associativity<double,3,ColMajor>(Quaterniond::UnitRandom()) ));
+
+    CALL_SUBTEST_9(( transform_batch<float,3,Isometry,AutoAlign>(internal::random<Index>(1,1000)) ));
+    CALL_SUBTEST_9(( transform_batch<float,3,Affine,AutoAlign>(internal::random<Index>(1,1000)) ));
+    CALL_SUBTEST_9(( transform_batch<float,3,AffineCompact,RowMajor>(internal::random<Index>(1000,5000)) ));
+    CALL_SUBTEST_9(( transform_batch<float,3,Projective,AutoAlign>(internal::random<Index>(1000,5000)) ));
+    CALL_SUBTEST_9(( transform_batch<double,2,Projective,DontAlign>(internal::random<Index>(1,1000)) ));
+    CALL_SUBTEST_9(( transform_batch<double,3,Affine,AutoAlign>(internal::random<Index>(1000,5000)) ));
   }
 }
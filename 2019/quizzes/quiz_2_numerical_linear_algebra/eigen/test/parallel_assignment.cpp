@@ -0,0 +1,125 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_PARALLELIZE_ASSIGNMENT
+#include "main.h"
+
+// a functor without packet access, leading to a non vectorized traversal
+template<typename Scalar> struct parallel_assignment_scalar_op
+{
+  Scalar operator()(const Scalar& x) const { return x*x + Scalar(1); }
+};
+
+// Evaluates \a assign serially and with several threads. The results might differ by roundoff errors
+// only, since the boundaries of the chunks change which coefficients are evaluated by the scalar path.
+template<typename Dst, typename Func>
+void check_parallel_assignment(Dst& dst, Func assign)
+{
+  Dst ref = dst;
+  setNbThreads(1);
+  assign(ref);
+  setNbThreads(4);
+  assign(dst);
+  setNbThreads(0);
+  VERIFY_IS_APPROX(dst.matrix(), ref.matrix());
+}
+
+template<typename ArrayType> struct exp_assign
+{
+  const ArrayType &a, &b;
+  exp_assign(const ArrayType& a_, const ArrayType& b_) : a(a_), b(b_) {}
+  template<typename Dst> void operator()(Dst& dst) const { dst = a * b + a.exp(); }
+};
+
+template<typename ArrayType> struct unaligned_assign
+{
+  const ArrayType &a, &b;
+  unaligned_assign(const ArrayType& a_, const ArrayType& b_) : a(a_), b(b_) {}
+  template<typename Dst> void operator()(Dst& dst) const
+  {
+    Index n = a.size()-3;
+    dst.segment(1,n) += a.segment(2,n).sin() * b.head(n);
+  }
+};
+
+template<typename ArrayType> struct scalar_op_assign
+{
+  const ArrayType &a;
+  scalar_op_assign(const ArrayType& a_) : a(a_) {}
+  template<typename Dst> void operator()(Dst& dst) const
+  {
+    dst = a.unaryExpr(parallel_assignment_scalar_op<typename ArrayType::Scalar>());
+  }
+};
+
+template<typename MatrixType> struct block_assign
+{
+  const MatrixType &a;
+  block_assign(const MatrixType& a_) : a(a_) {}
+  template<typename Dst> void operator()(Dst& dst) const
+  {
+    Index r = a.rows()-2, c = a.cols()-1;
+    dst.block(1,1,r,c) = a.block(0,1,r,c).array().cos().matrix() - a.block(2,0,r,c);
+  }
+};
+
+template<typename MatrixType> struct transposed_assign
+{
+  const MatrixType &a;
+  transposed_assign(const MatrixType& a_) : a(a_) {}
+  template<typename Dst> void operator()(Dst& dst) const { dst = a.transpose() * typename MatrixType::Scalar(2); }
+};
+
+template<typename Scalar> void parallel_assignment(Index n)
+{
+  typedef Array<Scalar,Dynamic,1> ArrayType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMajorMatrixType;
+
+  // the inputs are filled serially, so that they only depend on the seed
+  setNbThreads(1);
+  ArrayType a = ArrayType::Random(n), b = ArrayType::Random(n), dst = ArrayType::Random(n);
+  Index rows = internal::random<Index>(3,200), cols = n / rows + 2;
+  MatrixType m = MatrixType::Random(rows, cols), mdst = MatrixType::Random(rows, cols);
+  setNbThreads(0);
+
+  // Random() is not thread safe, and must be evaluated serially whatever the number of threads
+  {
+    unsigned int seed = internal::random<unsigned int>();
+    ArrayType r1, r2;
+    setNbThreads(4);
+    std::srand(seed);
+    r1 = ArrayType::Random(n) * b;
+    setNbThreads(1);
+    std::srand(seed);
+    r2 = ArrayType::Random(n) * b;
+    setNbThreads(0);
+    VERIFY((r1 == r2).all());
+  }
+
+  // linear (vectorized) traversals
+  check_parallel_assignment(dst, exp_assign<ArrayType>(a, b));
+  check_parallel_assignment(dst, unaligned_assign<ArrayType>(a, b));
+  check_parallel_assignment(dst, scalar_op_assign<ArrayType>(a));
+  VERIFY_IS_APPROX(dst.matrix(), a.unaryExpr(parallel_assignment_scalar_op<Scalar>()).matrix());
+
+  // slice vectorized and default traversals
+  check_parallel_assignment(mdst, block_assign<MatrixType>(m));
+  RowMajorMatrixType rdst(cols, rows);
+  check_parallel_assignment(rdst, transposed_assign<MatrixType>(m));
+  VERIFY_IS_APPROX(rdst, m.transpose() * Scalar(2));
+}
+
+void test_parallel_assignment()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( parallel_assignment<float>(internal::random<Index>(4,1000)) );
+    CALL_SUBTEST_1( parallel_assignment<float>(internal::random<Index>(100000,400000)) );
+    CALL_SUBTEST_2( parallel_assignment<double>(internal::random<Index>(100000,400000)) );
+    CALL_SUBTEST_3( parallel_assignment<std::complex<float> >(internal::random<Index>(50000,200000)) );
+  }
+}
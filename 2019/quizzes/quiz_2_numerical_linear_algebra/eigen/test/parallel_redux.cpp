@@ -0,0 +1,72 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_PARALLELIZE_REDUX
+#if defined(EIGEN_TEST_PART_3) || defined(EIGEN_TEST_PART_4)
+#define EIGEN_REDUX_FIXED_TREE
+#endif
+#include "main.h"
+
+template<typename Scalar> Scalar reference_sum(const Scalar* data, Index size)
+{
+  long double res = 0;
+  for(Index i = 0; i < size; ++i)
+    res += data[i];
+  return Scalar(res);
+}
+
+template<typename Scalar> void parallel_redux(Index n)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  const Scalar tol = test_precision<Scalar>();
+
+  VectorType v = VectorType::Random(n);
+  Scalar ref = reference_sum(v.data(), n);
+
+  // the result only depends on the number of threads
+  setNbThreads(4);
+  Scalar s4 = v.sum();
+  VERIFY(numext::abs(s4 - ref) <= tol * v.cwiseAbs().sum());
+  VERIFY_IS_EQUAL(v.sum(), s4);
+  VERIFY_IS_APPROX(v.squaredNorm(), v.cwiseAbs2().eval().sum());
+  VERIFY_IS_EQUAL(v.minCoeff(), v.cwiseMin(v(0)).minCoeff());
+  VERIFY_IS_EQUAL(v.maxCoeff(), v.cwiseMax(v(0)).maxCoeff());
+  setNbThreads(1);
+  Scalar s1 = v.sum();
+  VERIFY(numext::abs(s1 - ref) <= tol * v.cwiseAbs().sum());
+#ifdef EIGEN_REDUX_FIXED_TREE
+  // the result does not depend on the number of threads and on the alignment of the data either
+  VERIFY_IS_EQUAL(s1, s4);
+  setNbThreads(3);
+  VERIFY_IS_EQUAL(v.sum(), s4);
+  VectorType shifted(n+1);
+  shifted.tail(n) = v;
+  VERIFY_IS_EQUAL(shifted.tail(n).sum(), s4);
+#endif
+
+  // inner vector ranges
+  Index rows = internal::random<Index>(10,100);
+  MatrixType m = MatrixType::Random(rows, n/rows+1);
+  setNbThreads(4);
+  Scalar ms = m.block(1,0,rows-1,m.cols()).sum();
+  setNbThreads(1);
+  VERIFY_IS_APPROX(m.block(1,0,rows-1,m.cols()).sum(), ms);
+  VERIFY_IS_APPROX(m.bottomRows(rows-1).sum(), m.bottomRows(rows-1).eval().sum());
+  VERIFY_IS_EQUAL(m.minCoeff(), m.cwiseMin(m(0,0)).minCoeff());
+  setNbThreads(0);
+}
+
+void test_parallel_redux()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( parallel_redux<float>(internal::random<Index>(1,100000)) );
+    CALL_SUBTEST_2( parallel_redux<double>(internal::random<Index>(100000,500000)) );
+    CALL_SUBTEST_3( parallel_redux<float>(internal::random<Index>(1,100000)) );
+    CALL_SUBTEST_4( parallel_redux<double>(internal::random<Index>(100000,500000)) );
+  }
+}
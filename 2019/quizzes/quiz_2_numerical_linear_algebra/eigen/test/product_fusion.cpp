@@ -0,0 +1,154 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define TEST_ENABLE_TEMPORARY_TRACKING
+
+#include "main.h"
+
+template<typename Scalar> struct product_fusion_activation
+{
+  Scalar operator()(const Scalar& x) const { return x / (Scalar(1) + numext::abs(x)); }
+};
+
+template<typename MatrixType> void product_epilogue(Index rows, Index depth, Index cols)
+{
+  /* This test checks that the element-wise operations applied to a large product
+   * are evaluated within the product, without temporary */
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic, RowMajor> RowMajorMatrixType;
+  typedef Matrix<Scalar, 1, Dynamic> RowVectorType;
+  typedef Matrix<Scalar, Dynamic, 1> ColVectorType;
+
+  MatrixType a = MatrixType::Random(rows, depth),
+             b = MatrixType::Random(depth, cols),
+             c = MatrixType::Random(rows, cols),
+             d(rows, cols);
+  RowMajorMatrixType rd(rows, cols);
+  RowVectorType bias = RowVectorType::Random(cols);
+  ColVectorType colBias = ColVectorType::Random(rows);
+  Scalar s = internal::random<Scalar>();
+  MatrixType ab = a*b;
+
+  VERIFY_EVALUATION_COUNT( d.noalias() = (a*b).cwiseProduct(c), 0 );
+  VERIFY_IS_APPROX(d, ab.cwiseProduct(c));
+
+  VERIFY_EVALUATION_COUNT( d.noalias() = ((a*b).rowwise() + bias).cwiseQuotient(c), 0 );
+  VERIFY_IS_APPROX(d, (ab.rowwise() + bias).cwiseQuotient(c));
+
+  VERIFY_EVALUATION_COUNT( d.noalias() = ((a*b).colwise() - colBias) * s, 0 );
+  VERIFY_IS_APPROX(d, (ab.colwise() - colBias) * s);
+
+  VERIFY_EVALUATION_COUNT( d.noalias() = (a*b).unaryExpr(product_fusion_activation<Scalar>()), 0 );
+  VERIFY_IS_APPROX(d, ab.unaryExpr(product_fusion_activation<Scalar>()));
+
+  VERIFY_EVALUATION_COUNT( d.noalias() = (a*b).array().exp().matrix(), 0 );
+  VERIFY_IS_APPROX(d, ab.array().exp().matrix());
+
+  VERIFY_EVALUATION_COUNT( rd.noalias() = (a*b).cwiseProduct(c) + c, 0 );
+  VERIFY_IS_APPROX(rd, ab.cwiseProduct(c) + c);
+
+  VERIFY_EVALUATION_COUNT( d.block(1,1,rows-2,cols-1).noalias() = (a.middleRows(1,rows-2)*b.rightCols(cols-1)).conjugate(), 0 );
+  VERIFY_IS_APPROX(d.block(1,1,rows-2,cols-1), ab.block(1,1,rows-2,cols-1).conjugate());
+
+  // the destination may alias the operands
+  d = c;
+  VERIFY_EVALUATION_COUNT( c = (a*b).cwiseProduct(c), 1 );
+  VERIFY_IS_APPROX(c, ab.cwiseProduct(d));
+  d = ab;
+  VERIFY_EVALUATION_COUNT( d = (a*b).array().square().matrix(), 1 );
+  VERIFY_IS_APPROX(d, ab.cwiseProduct(ab));
+
+  // the epilogue may read the destination with noalias(), the product is then evaluated into a temporary
+  d = c;
+  VERIFY_EVALUATION_COUNT( c.noalias() = a*b + c, 1 );
+  VERIFY_IS_APPROX(c, ab + d);
+  c = d;
+  VERIFY_EVALUATION_COUNT( c.noalias() = ((a*b).array() * c.array()).matrix(), 1 );
+  VERIFY_IS_APPROX(c, ab.cwiseProduct(d));
+  c = d;
+  VERIFY_EVALUATION_COUNT( c.noalias() = ((a*b).rowwise() + bias).cwiseProduct(c) * s, 1 );
+  VERIFY_IS_APPROX(c, (ab.rowwise() + bias).cwiseProduct(d) * s);
+  c = d;
+  c.noalias() = (a*b).cwiseProduct(c.transpose().transpose()) - c.block(0,0,rows,cols).cwiseAbs();
+  VERIFY_IS_APPROX(c, ab.cwiseProduct(d) - d.cwiseAbs());
+
+  // operands which must be evaluated are not fused
+  c.setRandom();
+  d.noalias() = (a*b).cwiseProduct(c*MatrixType::Identity(cols,cols));
+  VERIFY_IS_APPROX(d, ab.cwiseProduct(c));
+
+  // array destination
+  Array<Scalar,Dynamic,Dynamic> ad(rows, cols);
+  VERIFY_EVALUATION_COUNT( ad = (a.array().matrix()*b).array().square(), 1 );
+  VERIFY_IS_APPROX(ad.matrix(), ab.cwiseProduct(ab));
+  VERIFY_EVALUATION_COUNT( ad.matrix().noalias() = (a*b).array().square().matrix(), 0 );
+  VERIFY_IS_APPROX(ad.matrix(), ab.cwiseProduct(ab));
+}
+
+template<typename MatrixType> void product_epilogue_relu(Index rows, Index depth, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType a = MatrixType::Random(rows, depth),
+             b = MatrixType::Random(depth, cols),
+             d(rows, cols);
+  Matrix<Scalar, 1, Dynamic> bias = Matrix<Scalar, 1, Dynamic>::Random(cols);
+
+  VERIFY_EVALUATION_COUNT( d.noalias() = ((a*b).rowwise() + bias).cwiseMax(Scalar(0)), 0 );
+  VERIFY_IS_APPROX(d, ((a*b).eval().rowwise() + bias).cwiseMax(Scalar(0)));
+  VERIFY_EVALUATION_COUNT( d.noalias() = ((a*b).array().rowwise() + bias.array()).cwiseMax(Scalar(0)).matrix(), 0 );
+  VERIFY_IS_APPROX(d, ((a*b).eval().rowwise() + bias).cwiseMax(Scalar(0)));
+}
+
+template<typename MatrixType> void product_chain(Index m, Index k, Index n, Index p)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+
+  MatrixType a = MatrixType::Random(m, k),
+             b = MatrixType::Random(k, n),
+             c = MatrixType::Random(n, p),
+             ref = (a*b).eval()*c,
+             d(m, p);
+  VectorType x = VectorType::Random(n), y(m);
+
+  d = a*b*c;
+  VERIFY_IS_APPROX(d, ref);
+  d = a*(b*c);
+  VERIFY_IS_APPROX(d, ref);
+  d.noalias() += a*b*c;
+  VERIFY_IS_APPROX(d, Scalar(2)*ref);
+  d.noalias() -= a*(b*c);
+  VERIFY_IS_APPROX(d, ref);
+  d.noalias() = (Scalar(2)*a)*b.transpose().transpose()*c;
+  VERIFY_IS_APPROX(d, Scalar(2)*ref);
+
+  // matrix-matrix-vector products are computed with two matrix-vector products
+  VERIFY_EVALUATION_COUNT( y.noalias() = a*b*x, 1 );
+  VERIFY_IS_APPROX(y, a*(b*x).eval());
+  y = a*b*x - a*(b*x);
+  VERIFY(y.norm() <= test_precision<Scalar>() * (a.norm()*b.norm()*x.norm()));
+
+  // fixed size factors
+  Matrix<Scalar,3,3> a3 = Matrix<Scalar,3,3>::Random(), b3 = Matrix<Scalar,3,3>::Random();
+  Matrix<Scalar,3,1> x3 = Matrix<Scalar,3,1>::Random();
+  VERIFY_IS_APPROX((a3*b3*x3).eval(), (a3*b3).eval()*x3);
+  VERIFY_IS_APPROX((x3.transpose()*a3*b3).eval(), x3.transpose()*(a3*b3).eval());
+}
+
+void test_product_fusion()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( product_epilogue<MatrixXf>(internal::random<Index>(20,300), internal::random<Index>(1,300), internal::random<Index>(20,300)) );
+    CALL_SUBTEST_1( product_epilogue_relu<MatrixXf>(internal::random<Index>(20,300), internal::random<Index>(1,300), internal::random<Index>(20,300)) );
+    CALL_SUBTEST_2( product_epilogue<MatrixXd>(internal::random<Index>(20,300), internal::random<Index>(1,300), internal::random<Index>(20,300)) );
+    CALL_SUBTEST_3( product_epilogue<MatrixXcf>(internal::random<Index>(20,200), internal::random<Index>(1,200), internal::random<Index>(20,200)) );
+    CALL_SUBTEST_4( product_chain<MatrixXd>(internal::random<Index>(1,100), internal::random<Index>(1,100),
+                                            internal::random<Index>(1,100), internal::random<Index>(1,100)) );
+    CALL_SUBTEST_5( product_chain<MatrixXcf>(internal::random<Index>(1,100), internal::random<Index>(1,100),
+                                             internal::random<Index>(1,100), internal::random<Index>(1,100)) );
+  }
+}
@@ -175,6 +175,9 @@ void test_umeyama()
     CALL_SUBTEST_6((run_fixed_size_test<double, 2>(num_elements)));
     CALL_SUBTEST_7((run_fixed_size_test<double, 3>(num_elements)));
     CALL_SUBTEST_8((run_fixed_size_test<double, 4>(num_elements)));
+
+    // large point sets, whose covariance is computed in parallel when OpenMP is enabled
+    CALL_SUBTEST_9(run_test<MatrixXd>(3, 100*num_elements));
   }
 
   // Those two calls don't compile and result in meaningful error messages!
@@ -113,6 +113,61 @@ template<typename VectorType> void vectorVisitor(const VectorType& w)
   VERIFY(eigen_maxidx == (std::min)(idx0,idx2));
 }
 
+// many ties, checks that the first of the min and max coefficients is found by the vectorized path
+template<typename MatrixType> void tiesVisitor(Index rows, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType m(rows, cols);
+  for(Index i = 0; i < m.size(); ++i)
+    m(i) = Scalar(internal::random<int>(-5,5));
+
+  Index minrow=0,mincol=0,maxrow=0,maxcol=0;
+  for(Index j = 0; j < cols; j++)
+  for(Index i = 0; i < rows; i++)
+  {
+    if(m(i,j) < m(minrow,mincol)) { minrow = i; mincol = j; }
+    if(m(i,j) > m(maxrow,maxcol)) { maxrow = i; maxcol = j; }
+  }
+  Index eigen_minrow, eigen_mincol, eigen_maxrow, eigen_maxcol;
+  VERIFY_IS_EQUAL(m.minCoeff(&eigen_minrow,&eigen_mincol), m(minrow,mincol));
+  VERIFY_IS_EQUAL(m.maxCoeff(&eigen_maxrow,&eigen_maxcol), m(maxrow,maxcol));
+  VERIFY(minrow == eigen_minrow && mincol == eigen_mincol);
+  VERIFY(maxrow == eigen_maxrow && maxcol == eigen_maxcol);
+
+  // expressions, and blocks without linear access
+  VERIFY_IS_EQUAL((m+m).minCoeff(&eigen_minrow,&eigen_mincol), Scalar(2)*m(minrow,mincol));
+  VERIFY(minrow == eigen_minrow && mincol == eigen_mincol);
+  Index r0 = internal::random<Index>(0,rows-1), c0 = internal::random<Index>(0,cols-1);
+  Index r, c;
+  m.bottomRightCorner(rows-r0,cols-c0).maxCoeff(&r,&c);
+  VERIFY_IS_EQUAL(m.bottomRightCorner(rows-r0,cols-c0).eval().maxCoeff(&eigen_maxrow,&eigen_maxcol), m(r0+r,c0+c));
+  VERIFY(r == eigen_maxrow && c == eigen_maxcol);
+}
+
+// NaN coefficients are skipped, unless the first one is NaN, by both the scalar and the vectorized paths
+template<typename MatrixType> void nanVisitor(Index rows, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType m = MatrixType::Random(rows, cols);
+  // the first NaN is in the first packet, which initializes the lanes of the vectorized path
+  m(internal::random<Index>(0,(std::min)(m.size()-1, Index(8)))) = NumTraits<Scalar>::quiet_NaN();
+  for(Index k = internal::random<Index>(0,3); k > 0; --k)
+    m(internal::random<Index>(0,m.size()-1)) = NumTraits<Scalar>::quiet_NaN();
+
+  Index minrow=0,mincol=0,maxrow=0,maxcol=0;
+  for(Index j = 0; j < cols; j++)
+  for(Index i = 0; i < rows; i++)
+  {
+    if(m(i,j) < m(minrow,mincol)) { minrow = i; mincol = j; }
+    if(m(i,j) > m(maxrow,maxcol)) { maxrow = i; maxcol = j; }
+  }
+  Index eigen_minrow, eigen_mincol, eigen_maxrow, eigen_maxcol;
+  m.minCoeff(&eigen_minrow,&eigen_mincol);
+  m.maxCoeff(&eigen_maxrow,&eigen_maxcol);
+  VERIFY(minrow == eigen_minrow && mincol == eigen_mincol);
+  VERIFY(maxrow == eigen_maxrow && maxcol == eigen_maxcol);
+}
+
 void test_visitor()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -130,4 +185,16 @@ void test_visitor()
     CALL_SUBTEST_9( vectorVisitor(RowVectorXd(10)) );
     CALL_SUBTEST_10( vectorVisitor(VectorXf(33)) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    Index rows = internal::random<Index>(1,100), cols = internal::random<Index>(1,100);
+    CALL_SUBTEST_11( tiesVisitor<MatrixXf>(rows, cols) );
+    CALL_SUBTEST_11( (tiesVisitor<Matrix<float,Dynamic,Dynamic,RowMajor> >(rows, cols)) );
+    CALL_SUBTEST_11( tiesVisitor<MatrixXd>(rows, cols) );
+    CALL_SUBTEST_11( tiesVisitor<MatrixXi>(rows, cols) );
+    CALL_SUBTEST_12( nanVisitor<MatrixXf>(rows, cols) );
+    CALL_SUBTEST_12( nanVisitor<MatrixXd>(rows, cols) );
+  }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_12( nanVisitor<VectorXf>(internal::random<Index>(1,200), 1) );
+  }
 }
@@ -13,7 +13,24 @@
 namespace Eigen
 {
 
-template<typename Functor> class AutoDiffJacobian : public Functor
+/** \class AutoDiffJacobian
+  * \brief Computes the Jacobian of a functor by forward automatic differentiation
+  *
+  * \tparam Functor the functor, whose call operator must be templated on the scalar type
+  * \tparam _MaxSeeds the maximal number of inputs differentiated per evaluation of the functor
+  *
+  * Each evaluation of the functor on AutoDiffScalar inputs propagates the derivatives with
+  * respect to several inputs, the seeds, at once. By default, all the inputs are seeded in a
+  * single evaluation, and the derivatives are stored in vectors of the size of the input,
+  * which are allocated on the heap if this size is Dynamic.
+  *
+  * When \a _MaxSeeds is fixed, the derivatives are stored in vectors of at most \a _MaxSeeds
+  * coefficients allocated in place, such that the arithmetic of the AutoDiffScalar performs
+  * no heap allocation and is vectorized. The inputs are then seeded by chunks of \a _MaxSeeds,
+  * with one evaluation of the functor per chunk. For instance, \c AutoDiffJacobian<Functor,32>
+  * computes the Jacobian of a functor with up to 32 inputs in a single evaluation.
+  */
+template<typename Functor, int _MaxSeeds = Dynamic> class AutoDiffJacobian : public Functor
 {
 public:
   AutoDiffJacobian() : Functor() {}
@@ -38,13 +55,16 @@ public:
 
   enum {
     InputsAtCompileTime = InputType::RowsAtCompileTime,
-    ValuesAtCompileTime = ValueType::RowsAtCompileTime
+    ValuesAtCompileTime = ValueType::RowsAtCompileTime,
+    MaxSeeds = _MaxSeeds==Dynamic ? int(InputsAtCompileTime)
+             : InputsAtCompileTime==Dynamic ? int(_MaxSeeds) : EIGEN_SIZE_MIN_PREFER_FIXED(int(_MaxSeeds), int(InputsAtCompileTime)),
+    SeedsAtCompileTime = InputsAtCompileTime!=Dynamic && int(MaxSeeds)==int(InputsAtCompileTime) ? int(InputsAtCompileTime) : Dynamic
   };
 
   typedef Matrix<Scalar, ValuesAtCompileTime, InputsAtCompileTime> JacobianType;
   typedef typename JacobianType::Index Index;
 
-  typedef Matrix<Scalar, InputsAtCompileTime, 1> DerivativeType;
+  typedef Matrix<Scalar, SeedsAtCompileTime, 1, 0, MaxSeeds, 1> DerivativeType;
   typedef AutoDiffScalar<DerivativeType> ActiveScalar;
 
   typedef Matrix<ActiveScalar, InputsAtCompileTime, 1> ActiveInput;
@@ -79,27 +99,42 @@ public:
 
     JacobianType& jac = *_jac;
 
-    ActiveInput ax = x.template cast<ActiveScalar>();
+    const Index n = x.rows();
+    const Index seeds = (std::max)(Index(1), MaxSeeds==Dynamic ? n : (std::min)(Index(MaxSeeds), n));
+    ActiveInput ax(n);
     ActiveValue av(jac.rows());
 
-    if(InputsAtCompileTime==Dynamic)
+    Index first = 0;
+    do
+    {
+      const Index size = (std::min)(seeds, n-first);
+      for (Index i=0; i<n; i++)
+      {
+        ax[i].value() = x[i];
+        ax[i].derivatives().setZero(size);
+        if (i>=first && i<first+size)
+          ax[i].derivatives().coeffRef(i-first) = Scalar(1);
+      }
       for (Index j=0; j<jac.rows(); j++)
-        av[j].derivatives().resize(x.rows());
-
-    for (Index i=0; i<jac.cols(); i++)
-      ax[i].derivatives() = DerivativeType::Unit(x.rows(),i);
+        av[j].derivatives().setZero(size);
 
 #if EIGEN_HAS_VARIADIC_TEMPLATES
-    Functor::operator()(ax, &av, Params...);
+      Functor::operator()(ax, &av, Params...);
 #else
-    Functor::operator()(ax, &av);
+      Functor::operator()(ax, &av);
 #endif
 
-    for (Index i=0; i<jac.rows(); i++)
-    {
-      (*v)[i] = av[i].value();
-      jac.row(i) = av[i].derivatives();
-    }
+      for (Index i=0; i<jac.rows(); i++)
+      {
+        (*v)[i] = av[i].value();
+        // the outputs set to constants may have no derivatives
+        if (av[i].derivatives().size()==size)
+          jac.row(i).segment(first,size) = av[i].derivatives().transpose();
+        else
+          jac.row(i).segment(first,size).setZero();
+      }
+      first += seeds;
+    } while (first<n);
   }
 };
 
@@ -44,7 +44,10 @@ inline AutoDiffScalar<NewDerType> MakeAutoDiffScalar(const typename NewDerType::
   *                 as well as the number of derivatives to compute are determined from this type.
   *                 Typical choices include, e.g., \c Vector4f for 4 derivatives, or \c VectorXf
   *                 if the number of derivatives is not known at compile time, and/or, the number
-  *                 of derivatives is large.
+  *                 of derivatives is large. When the number of derivatives is only bounded at compile
+  *                 time, a vector with a fixed maximal size, e.g., \c Matrix<float,Dynamic,1,0,32,1>,
+  *                 stores the derivatives in place: the temporaries then never allocate on the heap,
+  *                 and the operations on the derivatives are vectorized.
   *                 Note that _DerType can also be a reference (e.g., \c VectorXf&) to wrap a
   *                 existing vector into an AutoDiffScalar.
   *                 Finally, _DerType can also be any Eigen compatible expression.
@@ -619,12 +622,13 @@ pow(const Eigen::AutoDiffScalar<DerType> &x, const typename internal::traits<typ
 
 
 template<typename DerTypeA,typename DerTypeB>
-inline const AutoDiffScalar<Matrix<typename internal::traits<typename internal::remove_all<DerTypeA>::type>::Scalar,Dynamic,1> >
+inline const AutoDiffScalar<typename internal::remove_all<DerTypeA>::type::PlainObject>
 atan2(const AutoDiffScalar<DerTypeA>& a, const AutoDiffScalar<DerTypeB>& b)
 {
   using std::atan2;
   typedef typename internal::traits<typename internal::remove_all<DerTypeA>::type>::Scalar Scalar;
-  typedef AutoDiffScalar<Matrix<Scalar,Dynamic,1> > PlainADS;
+  // keep the storage of the derivatives, such that fixed or bounded sizes do not allocate
+  typedef AutoDiffScalar<typename internal::remove_all<DerTypeA>::type::PlainObject> PlainADS;
   PlainADS ret;
   ret.value() = atan2(a.value(), b.value());
   
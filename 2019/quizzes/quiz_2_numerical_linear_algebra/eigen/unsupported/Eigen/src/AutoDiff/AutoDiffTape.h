@@ -0,0 +1,961 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_AUTODIFF_TAPE_H
+#define EIGEN_AUTODIFF_TAPE_H
+
+namespace Eigen {
+
+template<typename _Scalar> class AutoDiffTape;
+template<typename _Scalar> class AutoDiffTapeScalar;
+template<typename _Scalar> class AutoDiffTapeArray;
+
+namespace internal {
+
+// the operations recorded onto an AutoDiffTape
+enum AutoDiffTapeOp {
+  TapeInput, TapeConstant,
+  TapeAdd, TapeSub, TapeMul, TapeDiv, TapePow, TapeAtan2, TapeMin, TapeMax,
+  TapeNeg, TapeAbs, TapeAbs2, TapeSqrt, TapeExp, TapeLog, TapeSin, TapeCos, TapeTan,
+  TapeAsin, TapeAcos, TapeAtan, TapeSinh, TapeCosh, TapeTanh,
+  TapeSum, TapeDot, TapeGather, TapeArray
+};
+
+// the kinds of the operands of the operations recorded on arrays
+enum AutoDiffTapeOperand {
+  TapeNoOperand, TapeArrayOperand, TapeScalarOperand, TapeIndexedOperand
+};
+
+// computes the value of an operation and its partial derivatives with respect to its operands,
+// both when the operation is recorded and when the tape is replayed
+template<typename Scalar>
+EIGEN_STRONG_INLINE void autodiff_tape_eval(int op, const Scalar& a, const Scalar& b, Scalar& value, Scalar& da, Scalar& db)
+{
+  using std::sqrt; using std::exp; using std::log; using std::pow; using std::atan2;
+  using std::sin; using std::cos; using std::tan; using std::asin; using std::acos; using std::atan;
+  using std::sinh; using std::cosh; using std::tanh;
+  db = Scalar(0);
+  switch(op)
+  {
+    case TapeAdd:   value = a + b; da = Scalar(1); db = Scalar(1); break;
+    case TapeSub:   value = a - b; da = Scalar(1); db = Scalar(-1); break;
+    case TapeMul:   value = a * b; da = b; db = a; break;
+    case TapeDiv:   value = a / b; da = Scalar(1) / b; db = -value / b; break;
+    case TapePow:
+      value = pow(a, b);
+      da = b * pow(a, b - Scalar(1));
+      // the derivative with respect to the exponent is only defined for positive bases
+      db = a > Scalar(0) ? value * log(a) : Scalar(0);
+      break;
+    case TapeAtan2:
+    {
+      const Scalar squared_hypot = a * a + b * b;
+      value = atan2(a, b); da = b / squared_hypot; db = -a / squared_hypot;
+      break;
+    }
+    case TapeMin:   da = a <= b ? Scalar(1) : Scalar(0); value = a <= b ? a : b; db = Scalar(1) - da; break;
+    case TapeMax:   da = a >= b ? Scalar(1) : Scalar(0); value = a >= b ? a : b; db = Scalar(1) - da; break;
+    case TapeNeg:   value = -a; da = Scalar(-1); break;
+    case TapeAbs:   value = numext::abs(a); da = a > Scalar(0) ? Scalar(1) : a < Scalar(0) ? Scalar(-1) : Scalar(0); break;
+    case TapeAbs2:  value = a * a; da = Scalar(2) * a; break;
+    case TapeSqrt:  value = sqrt(a); da = Scalar(0.5) / value; break;
+    case TapeExp:   value = exp(a); da = value; break;
+    case TapeLog:   value = log(a); da = Scalar(1) / a; break;
+    case TapeSin:   value = sin(a); da = cos(a); break;
+    case TapeCos:   value = cos(a); da = -sin(a); break;
+    case TapeTan:   value = tan(a); da = Scalar(1) + value * value; break;
+    case TapeAsin:  value = asin(a); da = Scalar(1) / sqrt(Scalar(1) - a * a); break;
+    case TapeAcos:  value = acos(a); da = Scalar(-1) / sqrt(Scalar(1) - a * a); break;
+    case TapeAtan:  value = atan(a); da = Scalar(1) / (Scalar(1) + a * a); break;
+    case TapeSinh:  value = sinh(a); da = cosh(a); break;
+    case TapeCosh:  value = cosh(a); da = sinh(a); break;
+    case TapeTanh:  value = tanh(a); da = Scalar(1) - value * value; break;
+    default:        eigen_assert(false && "not an operation of the tape");
+  }
+}
+
+// the counterpart of autodiff_tape_eval for the operations recorded on arrays, evaluating all the values
+// and partial derivatives by array expressions; the value of the reductions has a single coefficient
+template<typename Lhs, typename Rhs, typename Value, typename Derivative>
+void autodiff_tape_eval_array(int op, const ArrayBase<Lhs>& a, const ArrayBase<Rhs>& b, Value& value, Derivative& da, Derivative& db)
+{
+  typedef typename Lhs::Scalar Scalar;
+  switch(op)
+  {
+    case TapeAdd:   value = a + b; da.setOnes(); db.setOnes(); break;
+    case TapeSub:   value = a - b; da.setOnes(); db.setConstant(Scalar(-1)); break;
+    case TapeMul:   value = a * b; da = b; db = a; break;
+    case TapeDiv:   value = a / b; da = b.inverse(); db = -value / b; break;
+    case TapePow:
+      value = a.pow(b);
+      da = b * a.pow(b - Scalar(1));
+      db = (a > Scalar(0)).select(value * a.log(), Scalar(0));
+      break;
+    case TapeMin:   da = (a <= b).template cast<Scalar>(); value = (a <= b).select(a, b); db = Scalar(1) - da; break;
+    case TapeMax:   da = (a >= b).template cast<Scalar>(); value = (a >= b).select(a, b); db = Scalar(1) - da; break;
+    case TapeNeg:   value = -a; da.setConstant(Scalar(-1)); break;
+    case TapeAbs:   value = a.abs(); da = a.sign(); break;
+    case TapeAbs2:  value = a.square(); da = Scalar(2) * a; break;
+    case TapeSqrt:  value = a.sqrt(); da = Scalar(0.5) * value.inverse(); break;
+    case TapeExp:   value = a.exp(); da = value; break;
+    case TapeLog:   value = a.log(); da = a.inverse(); break;
+    case TapeSin:   value = a.sin(); da = a.cos(); break;
+    case TapeCos:   value = a.cos(); da = -a.sin(); break;
+    case TapeTan:   value = a.tan(); da = Scalar(1) + value.square(); break;
+    case TapeAsin:  value = a.asin(); da = (Scalar(1) - a.square()).rsqrt(); break;
+    case TapeAcos:  value = a.acos(); da = -(Scalar(1) - a.square()).rsqrt(); break;
+    case TapeAtan:  value = a.atan(); da = (Scalar(1) + a.square()).inverse(); break;
+    case TapeSinh:  value = a.sinh(); da = a.cosh(); break;
+    case TapeCosh:  value = a.cosh(); da = a.sinh(); break;
+    case TapeTanh:  value = a.tanh(); da = Scalar(1) - value.square(); break;
+    case TapeSum:   value.setConstant(a.sum()); da.setOnes(); break;
+    case TapeDot:   value.setConstant((a * b).sum()); da = b; db = a; break;
+    default:        eigen_assert(false && "not an operation on arrays");
+  }
+}
+
+} // end namespace internal
+
+/** \class AutoDiffTape
+  * \brief A tape recording the operations on AutoDiffTapeScalar for reverse automatic differentiation
+  *
+  * \tparam _Scalar the real scalar type of the values
+  *
+  * Each arithmetic operation or math function applied to AutoDiffTapeScalar objects appends a node to
+  * the tape, storing the indices of its operands and its partial derivatives with respect to them. The
+  * gradient of a scalar with respect to all the inputs is then computed by a single backward sweep over
+  * the nodes, whose cost is a small multiple of the cost of the function itself, whatever the number of
+  * inputs. This is the method of choice for the gradient of an energy depending on many parameters, when
+  * AutoDiffScalar would propagate as many derivatives as parameters through every operation.
+  *
+  * The nodes are stored contiguously in arrays whose capacity is kept by clear() and rewind(), such that
+  * recording the same function again does not allocate. When the control flow of the function does not
+  * depend on its inputs, the recorded operations can also be replayed with new input values by replay(),
+  * without evaluating the function through AutoDiffTapeScalar at all. A checkpoint() of the tape stores
+  * the number of operations recorded so far, e.g., the computations which do not change between
+  * iterations, together with the values of the inputs. rewind() drops all the operations recorded after
+  * it, and recomputes the ones before it if the inputs have been replayed with other values since.
+  *
+  * The operations on the AutoDiffTapeArray objects returned by array() are recorded as single array
+  * operations, storing the partial derivatives of all their coefficients contiguously. Their values and
+  * derivatives are evaluated by Eigen array expressions, and the backward sweep propagates their adjoints
+  * as packet operations, e.g., for the dot products and the coefficient-wise operations of an energy
+  * written in terms of arrays. The Jacobian of several outputs is computed by a single backward sweep
+  * propagating one adjoint per output, such that each node updates vectors of adjoints.
+  *
+  * Example:
+  * \code
+  * AutoDiffTape<double> tape;
+  * AutoDiffTape<double>::ActiveVector x = tape.variables(VectorXd::Random(1000));
+  * AutoDiffTapeArray<double> a = tape.array(x);
+  * AutoDiffTapeScalar<double> energy = (a.tail(999) - a.head(999)).squaredNorm() + sin(a).sum();
+  * VectorXd grad;
+  * tape.gradient(energy, grad);
+  * \endcode
+  *
+  * \warning A tape is not thread safe, and the active scalars refer to the tape which recorded them, which
+  * must outlive them.
+  *
+  * \sa AutoDiffTapeScalar, AutoDiffTapeArray, AutoDiffScalar
+  */
+template<typename _Scalar>
+class AutoDiffTape
+{
+public:
+  typedef _Scalar Scalar;
+  typedef AutoDiffTapeScalar<Scalar> ActiveScalar;
+  typedef AutoDiffTapeArray<Scalar> ActiveArray;
+  typedef Matrix<ActiveScalar, Dynamic, 1> ActiveVector;
+
+  /** \brief A checkpoint of the tape, see checkpoint() and rewind() */
+  struct Checkpoint
+  {
+    /** the number of operations */
+    Index size;
+    /** the sizes of the storage of the array operations */
+    Index arrayOps, partials, indices;
+    /** the values of the inputs, from which the operations are recomputed */
+    Matrix<Scalar, Dynamic, 1> inputValues;
+  };
+
+  /** Constructs an empty tape, with room for \a reserveSize operations. */
+  explicit AutoDiffTape(Index reserveSize = 0) : m_size(0)
+  {
+    EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex, NUMERIC_TYPE_MUST_BE_REAL)
+    reserve(reserveSize);
+    clear();
+  }
+
+  /** Reserves room for \a size operations. */
+  void reserve(Index size)
+  {
+    if (size + 1 > Index(m_nodes.size()))
+    {
+      m_nodes.resize(size + 1);
+      m_ops.resize(size + 1);
+      m_values.resize(size + 1);
+    }
+  }
+
+  /** Removes all the operations and inputs, but keeps the storage. */
+  void clear() { truncate(0, 0, 0, 0); }
+
+  /** \returns the number of recorded operations, including the inputs and the constants */
+  Index size() const { return m_size - 1; }
+
+  /** \returns the number of inputs */
+  Index inputs() const { return Index(m_inputs.size()); }
+
+  /** \returns a checkpoint of the tape, storing the number of recorded operations and the values of the
+    * inputs, to which rewind() goes back */
+  Checkpoint checkpoint() const
+  {
+    Checkpoint cp;
+    cp.size = size();
+    cp.arrayOps = Index(m_arrayOps.size());
+    cp.partials = Index(m_partials.size());
+    cp.indices = Index(m_indices.size());
+    cp.inputValues.resize(inputs());
+    for (Index k = 0; k < inputs(); ++k)
+      cp.inputValues[k] = m_values[m_inputs[k]];
+    return cp;
+  }
+
+  /** Drops the operations and inputs recorded after the checkpoint \a cp. If the inputs have been
+    * replayed with other values since \a cp, their values are restored and the operations recorded before
+    * \a cp are recomputed, such that value(), gradient() and jacobian() are back to the state of \a cp.
+    * The active scalars recorded after \a cp are invalidated, the ones recorded before can still be used. */
+  void rewind(const Checkpoint& cp)
+  {
+    eigen_assert(cp.size <= size() && cp.arrayOps <= Index(m_arrayOps.size()) && "the checkpoint has been rewound");
+    truncate(cp.size, cp.arrayOps, cp.partials, cp.indices);
+    eigen_assert(inputs() == cp.inputValues.size());
+    bool replayed = false;
+    for (Index k = 0; k < inputs(); ++k)
+    {
+      if (m_values[m_inputs[k]] != cp.inputValues[k])
+      {
+        m_values[m_inputs[k]] = cp.inputValues[k];
+        replayed = true;
+      }
+    }
+    if (replayed)
+      recompute();
+  }
+
+  /** \returns a new input with value \a value */
+  ActiveScalar variable(const Scalar& value)
+  {
+    ActiveScalar x(value, push(internal::TapeInput, 0, 0, value, Scalar(0), Scalar(0)), this);
+    m_inputs.push_back(x.index());
+    return x;
+  }
+
+  /** \returns a vector of new inputs with the values of \a values */
+  template<typename Derived>
+  ActiveVector variables(const DenseBase<Derived>& values)
+  {
+    ActiveVector x(values.size());
+    for (Index i = 0; i < values.size(); ++i)
+      x[i] = variable(values.derived().coeff(i));
+    return x;
+  }
+
+  /** \returns the active array of the coefficients of \a x, e.g., of inputs created by variables(). When
+    * they have been computed by consecutive operations, the array refers to them, otherwise they are
+    * gathered by an array operation. */
+  template<typename Derived>
+  ActiveArray array(const DenseBase<Derived>& x)
+  {
+    EIGEN_STATIC_ASSERT((internal::is_same<typename Derived::Scalar, ActiveScalar>::value),
+                        YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+    const Index n = x.size();
+    typename ActiveArray::ValueType values(n);
+    bool isConstant = true, consecutive = true;
+    for (Index i = 0; i < n; ++i)
+    {
+      const ActiveScalar& xi = x.derived().coeff(i);
+      eigen_assert((xi.tape() == this || xi.isConstant()) && "the scalar has been recorded onto another tape");
+      values[i] = xi.value();
+      isConstant = isConstant && xi.isConstant();
+      consecutive = consecutive && xi.tape() == this && xi.index() == x.derived().coeff(0).index() + i;
+    }
+    if (isConstant)
+      return ActiveArray(values);
+    if (consecutive)
+      return ActiveArray(values, x.derived().coeff(0).index(), this);
+    ArrayOp op;
+    op.op = internal::TapeGather;
+    op.size = op.operandSize = n;
+    op.lhs = Index(m_indices.size());
+    op.lhsKind = internal::TapeIndexedOperand;
+    op.rhs = 0;
+    op.rhsKind = internal::TapeNoOperand;
+    for (Index i = 0; i < n; ++i)
+    {
+      const ActiveScalar& xi = x.derived().coeff(i);
+      m_indices.push_back(xi.isConstant() ? constant(xi.value()) : xi.index());
+    }
+    op.partials = Index(m_partials.size());
+    m_partials.resize(op.partials + n, Scalar(1));
+    const Index first = record(op);
+    Map<typename ActiveArray::ValueType>(&m_values[first], n) = values;
+    return ActiveArray(values, first, this);
+  }
+
+  /** \returns the value of \a y, which is updated by replay() */
+  Scalar value(const ActiveScalar& y) const
+  {
+    return y.tape() == this ? m_values[y.index()] : y.value();
+  }
+
+  /** \returns the values of \a y, which are updated by replay() */
+  typename ActiveArray::ValueType value(const ActiveArray& y) const
+  {
+    if (y.tape() != this || y.size() == 0)
+      return y.value();
+    return Map<const typename ActiveArray::ValueType>(&m_values[y.index()], y.size());
+  }
+
+  /** Computes the gradient of \a y with respect to the inputs, in the order of their creation. */
+  template<typename Derived>
+  void gradient(const ActiveScalar& y, const MatrixBase<Derived>& grad) const
+  {
+    Derived& g = grad.const_cast_derived();
+    g.resize(inputs());
+    if (y.tape() != this)
+    {
+      eigen_assert(y.isConstant() && "the scalar has been recorded onto another tape");
+      g.setZero();
+      return;
+    }
+    const Index last = lastNode(y.index());
+    m_adjoints.setZero(last + 1);
+    m_adjoints[y.index()] = Scalar(1);
+    Scalar* adj = m_adjoints.data();
+    const Node* nodes = &m_nodes[0];
+    for (Index i = last; i > 0; --i)
+    {
+      if (m_ops[i] == internal::TapeArray)
+      {
+        const ArrayOp& op = m_arrayOps[nodes[i].lhs];
+        sweep(op, m_adjoints);
+        i = op.first;
+        continue;
+      }
+      const Node& node = nodes[i];
+      const Scalar a = adj[i];
+      adj[node.lhs] += node.dlhs * a;
+      adj[node.rhs] += node.drhs * a;
+    }
+    for (Index k = 0; k < inputs(); ++k)
+      g.coeffRef(k) = m_inputs[k] < m_adjoints.size() ? m_adjoints[m_inputs[k]] : Scalar(0);
+  }
+
+  /** Computes the Jacobian of the entries of \a y with respect to the inputs by a single backward sweep,
+    * the rows of \a jac corresponding to the entries of \a y. */
+  template<typename ActiveDerived, typename Derived>
+  void jacobian(const DenseBase<ActiveDerived>& y, const MatrixBase<Derived>& jac) const
+  {
+    EIGEN_STATIC_ASSERT((internal::is_same<typename ActiveDerived::Scalar, ActiveScalar>::value),
+                        YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+    Derived& J = jac.const_cast_derived();
+    const Index m = y.size();
+    J.resize(m, inputs());
+    Index last = 0;
+    for (Index k = 0; k < m; ++k)
+    {
+      const ActiveScalar& yk = y.derived().coeff(k);
+      eigen_assert((yk.tape() == this || yk.isConstant()) && "the scalar has been recorded onto another tape");
+      if (yk.tape() == this)
+        last = (std::max)(last, lastNode(yk.index()));
+    }
+    // the column i holds the adjoints of the node i for all the outputs
+    m_adjointsMatrix.setZero(m, last + 1);
+    for (Index k = 0; k < m; ++k)
+      if (y.derived().coeff(k).tape() == this)
+        m_adjointsMatrix(k, y.derived().coeff(k).index()) = Scalar(1);
+    for (Index i = last; i > 0; --i)
+    {
+      if (m_ops[i] == internal::TapeArray)
+      {
+        const ArrayOp& op = m_arrayOps[m_nodes[i].lhs];
+        sweep(op, m_adjointsMatrix);
+        i = op.first;
+        continue;
+      }
+      const Node& node = m_nodes[i];
+      m_adjointsMatrix.col(node.lhs) += node.dlhs * m_adjointsMatrix.col(i);
+      m_adjointsMatrix.col(node.rhs) += node.drhs * m_adjointsMatrix.col(i);
+    }
+    for (Index k = 0; k < inputs(); ++k)
+    {
+      if (m_inputs[k] <= last)
+        J.col(k) = m_adjointsMatrix.col(m_inputs[k]);
+      else
+        J.col(k).setZero();
+    }
+  }
+
+  /** Evaluates the recorded operations again with the input values \a x, which updates the values
+    * returned by value() and the derivatives computed by gradient() and jacobian(). The recorded
+    * operations must not depend on the inputs through the control flow, e.g., by branching on
+    * comparisons. The values of the active scalars and arrays themselves are not updated. */
+  template<typename Derived>
+  void replay(const DenseBase<Derived>& x)
+  {
+    eigen_assert(x.size() == inputs());
+    for (Index k = 0; k < inputs(); ++k)
+      m_values[m_inputs[k]] = x.derived().coeff(k);
+    recompute();
+  }
+
+  /** \internal \returns the scalar recorded by the operation \a op on \a a and, for binary operations, \a b */
+  template<int Op>
+  static ActiveScalar apply(const ActiveScalar& a, const ActiveScalar& b = ActiveScalar())
+  {
+    const bool binary = Op < internal::TapeNeg;
+    Scalar value, da, db;
+    internal::autodiff_tape_eval(Op, a.value(), b.value(), value, da, db);
+    AutoDiffTape* tape = a.isConstant() ? b.tape() : a.tape();
+    if (!tape)
+      return ActiveScalar(value);
+    eigen_assert((b.isConstant() || b.tape() == tape) && "the scalars have been recorded onto different tapes");
+    const Index lhs = a.isConstant() ? tape->constant(a.value()) : a.index();
+    const Index rhs = binary ? (b.isConstant() ? tape->constant(b.value()) : b.index()) : 0;
+    return ActiveScalar(value, tape->push(Op, lhs, rhs, value, da, binary ? db : Scalar(0)), tape);
+  }
+
+  /** \internal \returns the array recorded by the operation \a op on \a a and, for binary operations,
+    * \a b, one of which is an ActiveArray and the other one an ActiveArray or an ActiveScalar broadcast
+    * to all the coefficients. The reductions return an array of size one. */
+  template<int Op, typename Lhs, typename Rhs>
+  static ActiveArray applyArray(const Lhs& a, const Rhs& b)
+  {
+    typedef typename ActiveArray::ValueType ArrayType;
+    const bool binary = Op < internal::TapeNeg || Op == internal::TapeDot;
+    const Index n = operandKind(a) == internal::TapeArrayOperand ? operandSize(a) : operandSize(b);
+    eigen_assert((!binary || operandKind(a) != operandKind(b) || operandSize(a) == operandSize(b))
+                 && "the arrays have different sizes");
+    AutoDiffTape* tape = a.isConstant() ? b.tape() : a.tape();
+    if (!tape || n == 0)
+    {
+      ArrayType value(isReduction(Op) ? 1 : n), da(n), db(n);
+      internal::autodiff_tape_eval_array(Op, broadcast(a, n), broadcast(b, n), value, da, db);
+      return ActiveArray(value);
+    }
+    eigen_assert((a.isConstant() || a.tape() == tape) && (b.isConstant() || b.tape() == tape)
+                 && "the operands have been recorded onto different tapes");
+    ArrayOp op;
+    op.op = Op;
+    op.size = isReduction(Op) ? 1 : n;
+    op.operandSize = n;
+    op.lhs = tape->operandNode(a);
+    op.lhsKind = operandKind(a);
+    op.rhs = binary ? tape->operandNode(b) : 0;
+    op.rhsKind = binary ? operandKind(b) : int(internal::TapeNoOperand);
+    op.partials = Index(tape->m_partials.size());
+    tape->m_partials.resize(op.partials + (binary ? 2 : 1) * n);
+    // like the scalars, the operations are evaluated from the values of the operands when recorded
+    const Index first = tape->record(op);
+    Map<ArrayType> value(&tape->m_values[first], op.size), da(&tape->m_partials[op.partials], n);
+    Map<ArrayType> db(&tape->m_partials[0] + op.partials + (binary ? n : 0), n);
+    internal::autodiff_tape_eval_array(Op, broadcast(a, n), broadcast(b, n), value, da, db);
+    return ActiveArray(value, first, tape);
+  }
+
+  /** \internal \returns the array recorded by the unary operation \a op on \a a */
+  template<int Op>
+  static ActiveArray applyArray(const ActiveArray& a) { return applyArray<Op>(a, a); }
+
+protected:
+  struct Node
+  {
+    Index lhs, rhs;
+    Scalar dlhs, drhs;
+  };
+
+  // an operation recorded on arrays, whose values are the ones of the nodes first, ..., first + size - 1,
+  // which refer to it by their lhs. Its operands start at the nodes lhs and rhs for arrays, are the nodes
+  // lhs and rhs for broadcast scalars, and are listed in m_indices from the positions lhs and rhs for the
+  // gathered coefficients. Its partial derivatives with respect to the coefficients of its operands are
+  // stored contiguously in m_partials from the position partials.
+  struct ArrayOp
+  {
+    int op, lhsKind, rhsKind;
+    Index first, size, operandSize, lhs, rhs, partials;
+  };
+
+  EIGEN_STRONG_INLINE Index push(int op, Index lhs, Index rhs, const Scalar& value, const Scalar& dlhs, const Scalar& drhs)
+  {
+    if (m_size == Index(m_nodes.size()))
+      grow();
+    Node& node = m_nodes[m_size];
+    node.lhs = lhs;
+    node.rhs = rhs;
+    node.dlhs = dlhs;
+    node.drhs = drhs;
+    m_ops[m_size] = static_cast<unsigned char>(op);
+    m_values[m_size] = value;
+    return m_size++;
+  }
+
+  EIGEN_DONT_INLINE void grow() { reserve((std::max)(Index(2) * m_size, Index(256))); }
+
+  Index constant(const Scalar& value) { return push(internal::TapeConstant, 0, 0, value, Scalar(0), Scalar(0)); }
+
+  void truncate(Index size, Index arrayOps, Index partials, Index indices)
+  {
+    // the node 0 is a sink receiving the adjoints propagated to the missing operands, which saves
+    // tests in the backward sweep
+    reserve(size);
+    m_size = size + 1;
+    Node& sink = m_nodes[0];
+    sink.lhs = sink.rhs = 0;
+    sink.dlhs = sink.drhs = Scalar(0);
+    m_ops[0] = internal::TapeConstant;
+    m_values[0] = Scalar(0);
+    while (!m_inputs.empty() && m_inputs.back() > size)
+      m_inputs.pop_back();
+    m_arrayOps.resize(arrayOps);
+    m_partials.resize(partials);
+    m_indices.resize(indices);
+  }
+
+  // appends the nodes of the array operation op, whose values are set by the caller
+  Index record(ArrayOp& op)
+  {
+    if (m_size + op.size > Index(m_nodes.size()))
+      reserve((std::max)(Index(2) * (m_size + op.size), Index(256)));
+    op.first = m_size;
+    for (Index i = op.first; i < op.first + op.size; ++i)
+    {
+      m_nodes[i].lhs = Index(m_arrayOps.size());
+      m_ops[i] = internal::TapeArray;
+    }
+    m_size += op.size;
+    m_arrayOps.push_back(op);
+    return op.first;
+  }
+
+  void evaluate(const ArrayOp& op)
+  {
+    typedef typename ActiveArray::ValueType ArrayType;
+    const Index n = op.operandSize;
+    Map<ArrayType> value(&m_values[op.first], op.size), da(&m_partials[op.partials], n);
+    Map<ArrayType> db(&m_partials[0] + op.partials + (op.rhsKind ? n : 0), n);
+    const Scalar* values = &m_values[0];
+    if (op.op == internal::TapeGather)
+    {
+      for (Index i = 0; i < n; ++i)
+        value[i] = values[m_indices[op.lhs + i]];
+    }
+    else if (op.lhsKind == internal::TapeScalarOperand)
+      internal::autodiff_tape_eval_array(op.op, ArrayType::Constant(n, values[op.lhs]), Map<const ArrayType>(values + op.rhs, n), value, da, db);
+    else if (op.rhsKind == internal::TapeScalarOperand)
+      internal::autodiff_tape_eval_array(op.op, Map<const ArrayType>(values + op.lhs, n), ArrayType::Constant(n, values[op.rhs]), value, da, db);
+    else
+      internal::autodiff_tape_eval_array(op.op, Map<const ArrayType>(values + op.lhs, n),
+                                         Map<const ArrayType>(values + (op.rhsKind ? op.rhs : op.lhs), n), value, da, db);
+  }
+
+  void recompute()
+  {
+    for (Index i = 1; i <= size(); ++i)
+    {
+      const int op = m_ops[i];
+      if (op == internal::TapeInput || op == internal::TapeConstant)
+        continue;
+      if (op == internal::TapeArray)
+      {
+        const ArrayOp& arrayOp = m_arrayOps[m_nodes[i].lhs];
+        evaluate(arrayOp);
+        i = arrayOp.first + arrayOp.size - 1;
+        continue;
+      }
+      Node& node = m_nodes[i];
+      internal::autodiff_tape_eval(op, m_values[node.lhs], m_values[node.rhs], m_values[i], node.dlhs, node.drhs);
+    }
+  }
+
+  // the last node whose adjoint is needed by the backward sweep from the node i, all the adjoints of an
+  // array operation being propagated at once
+  Index lastNode(Index i) const
+  {
+    if (m_ops[i] != internal::TapeArray)
+      return i;
+    const ArrayOp& op = m_arrayOps[m_nodes[i].lhs];
+    return op.first + op.size - 1;
+  }
+
+  // propagates the adjoints of the array operation op to its operands by array expressions
+  void sweep(const ArrayOp& op, Matrix<Scalar, Dynamic, 1>& adjoints) const
+  {
+    typedef typename ActiveArray::ValueType ArrayType;
+    const Index n = op.operandSize;
+    const Map<const ArrayType> da(&m_partials[op.partials], n);
+    if (isReduction(op.op))
+    {
+      const Scalar a = adjoints[op.first];
+      accumulate(adjoints, op.lhs, op.lhsKind, da * a);
+      if (op.rhsKind != internal::TapeNoOperand)
+        accumulate(adjoints, op.rhs, op.rhsKind, Map<const ArrayType>(&m_partials[op.partials + n], n) * a);
+    }
+    else
+    {
+      accumulate(adjoints, op.lhs, op.lhsKind, da * adjoints.segment(op.first, n).array());
+      if (op.rhsKind != internal::TapeNoOperand)
+        accumulate(adjoints, op.rhs, op.rhsKind, Map<const ArrayType>(&m_partials[op.partials + n], n) * adjoints.segment(op.first, n).array());
+    }
+  }
+
+  template<typename Derived>
+  void accumulate(Matrix<Scalar, Dynamic, 1>& adjoints, Index operand, int kind, const ArrayBase<Derived>& adjoint) const
+  {
+    if (kind == internal::TapeArrayOperand)
+      adjoints.segment(operand, adjoint.size()).array() += adjoint;
+    else if (kind == internal::TapeScalarOperand)
+      adjoints[operand] += adjoint.sum();
+    else
+      for (Index i = 0; i < adjoint.size(); ++i)
+        adjoints[m_indices[operand + i]] += adjoint.coeff(i);
+  }
+
+  // propagates the adjoints of all the outputs of jacobian(), one column per coefficient
+  void sweep(const ArrayOp& op, Matrix<Scalar, Dynamic, Dynamic>& adjoints) const
+  {
+    accumulate(adjoints, op, op.lhs, op.lhsKind, &m_partials[op.partials]);
+    if (op.rhsKind != internal::TapeNoOperand)
+      accumulate(adjoints, op, op.rhs, op.rhsKind, &m_partials[op.partials + op.operandSize]);
+  }
+
+  void accumulate(Matrix<Scalar, Dynamic, Dynamic>& adjoints, const ArrayOp& op, Index operand, int kind, const Scalar* d) const
+  {
+    for (Index i = 0; i < op.operandSize; ++i)
+    {
+      const Index node = kind == internal::TapeArrayOperand ? operand + i
+                       : kind == internal::TapeScalarOperand ? operand : m_indices[operand + i];
+      adjoints.col(node) += d[i] * adjoints.col(isReduction(op.op) ? op.first : op.first + i);
+    }
+  }
+
+  static bool isReduction(int op) { return op == internal::TapeSum || op == internal::TapeDot; }
+
+  // the operands of applyArray()
+  static int operandKind(const ActiveArray&) { return internal::TapeArrayOperand; }
+  static int operandKind(const ActiveScalar&) { return internal::TapeScalarOperand; }
+  static Index operandSize(const ActiveArray& a) { return a.size(); }
+  static Index operandSize(const ActiveScalar&) { return 1; }
+  static const typename ActiveArray::ValueType& broadcast(const ActiveArray& a, Index) { return a.value(); }
+  static typename ActiveArray::ValueType::ConstantReturnType broadcast(const ActiveScalar& a, Index n)
+  { return ActiveArray::ValueType::Constant(n, a.value()); }
+
+  Index operandNode(const ActiveScalar& a) { return a.isConstant() ? constant(a.value()) : a.index(); }
+
+  Index operandNode(const ActiveArray& a)
+  {
+    if (!a.isConstant())
+      return a.index();
+    const Index first = m_size;
+    for (Index i = 0; i < a.size(); ++i)
+      constant(a.value()[i]);
+    return first;
+  }
+
+  // the arrays grow geometrically and are never shrunk, m_size being the number of nodes in use
+  Index m_size;
+  std::vector<Node> m_nodes;
+  std::vector<unsigned char> m_ops;
+  std::vector<Scalar> m_values;
+  std::vector<Index> m_inputs;
+  std::vector<ArrayOp> m_arrayOps;
+  std::vector<Scalar> m_partials;
+  std::vector<Index> m_indices;
+  mutable Matrix<Scalar, Dynamic, 1> m_adjoints;
+  mutable Matrix<Scalar, Dynamic, Dynamic> m_adjointsMatrix;
+};
+
+/** \class AutoDiffTapeScalar
+  * \brief A scalar type replacement recording its operations onto an AutoDiffTape
+  *
+  * \param _Scalar the real scalar type of the value
+  *
+  * This class represents a scalar value along with the index of the operation of an AutoDiffTape which
+  * computed it. The scalars constructed from a value are constants, which are not recorded. The inputs
+  * are created by AutoDiffTape::variable(), and all the operations involving them are recorded onto
+  * their tape. The derivatives are then computed by AutoDiffTape::gradient() or AutoDiffTape::jacobian().
+  *
+  * It supports the arithmetic and comparison operators, as well as the following global math functions:
+  * abs, abs2, sqrt, exp, log, pow, sin, cos, tan, asin, acos, atan, atan2, sinh, cosh, tanh, min and max.
+  *
+  * AutoDiffTapeScalar can be used as the scalar type of an Eigen::Matrix object, in which case the
+  * operations of the expressions are recorded coefficient-wise, one node per scalar operation. The
+  * operations on the AutoDiffTapeArray returned by AutoDiffTape::array() are recorded as a whole instead.
+  *
+  * \sa AutoDiffTape, AutoDiffTapeArray
+  */
+template<typename _Scalar>
+class AutoDiffTapeScalar
+{
+public:
+  typedef _Scalar Scalar;
+  typedef AutoDiffTape<Scalar> TapeType;
+
+  /** Default constructor, the value is zero. */
+  AutoDiffTapeScalar() : m_value(0), m_index(0), m_tape(0) {}
+
+  /** Constructs a constant of value \a value. */
+  AutoDiffTapeScalar(const Scalar& value) : m_value(value), m_index(0), m_tape(0) {}
+
+  /** \returns the value when the scalar has been recorded, see AutoDiffTape::value() */
+  inline const Scalar& value() const { return m_value; }
+
+  /** \returns the index of the operation which computed the scalar in its tape */
+  inline Index index() const { return m_index; }
+
+  /** \returns the tape which recorded the scalar, or a null pointer for a constant */
+  inline TapeType* tape() const { return m_tape; }
+
+  /** \returns whether the scalar is a constant, which does not depend on any input */
+  inline bool isConstant() const { return m_tape == 0; }
+
+  inline AutoDiffTapeScalar operator-() const { return TapeType::template apply<internal::TapeNeg>(*this); }
+
+  friend inline AutoDiffTapeScalar operator+(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b)
+  { return TapeType::template apply<internal::TapeAdd>(a, b); }
+  friend inline AutoDiffTapeScalar operator-(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b)
+  { return TapeType::template apply<internal::TapeSub>(a, b); }
+  friend inline AutoDiffTapeScalar operator*(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b)
+  { return TapeType::template apply<internal::TapeMul>(a, b); }
+  friend inline AutoDiffTapeScalar operator/(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b)
+  { return TapeType::template apply<internal::TapeDiv>(a, b); }
+
+  inline AutoDiffTapeScalar& operator+=(const AutoDiffTapeScalar& other) { return *this = *this + other; }
+  inline AutoDiffTapeScalar& operator-=(const AutoDiffTapeScalar& other) { return *this = *this - other; }
+  inline AutoDiffTapeScalar& operator*=(const AutoDiffTapeScalar& other) { return *this = *this * other; }
+  inline AutoDiffTapeScalar& operator/=(const AutoDiffTapeScalar& other) { return *this = *this / other; }
+
+  friend inline bool operator< (const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b) { return a.value() <  b.value(); }
+  friend inline bool operator<=(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b) { return a.value() <= b.value(); }
+  friend inline bool operator> (const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b) { return a.value() >  b.value(); }
+  friend inline bool operator>=(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b) { return a.value() >= b.value(); }
+  friend inline bool operator==(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b) { return a.value() == b.value(); }
+  friend inline bool operator!=(const AutoDiffTapeScalar& a, const AutoDiffTapeScalar& b) { return a.value() != b.value(); }
+
+protected:
+  friend class AutoDiffTape<Scalar>;
+  friend class AutoDiffTapeArray<Scalar>;
+  AutoDiffTapeScalar(const Scalar& value, Index index, TapeType* tape) : m_value(value), m_index(index), m_tape(tape) {}
+
+  Scalar m_value;
+  Index m_index;
+  TapeType* m_tape;
+};
+
+/** \class AutoDiffTapeArray
+  * \brief A one-dimensional array of active scalars whose operations are recorded as a whole onto an AutoDiffTape
+  *
+  * \param _Scalar the real scalar type of the values
+  *
+  * This class represents the values of consecutive operations of an AutoDiffTape, e.g., of inputs
+  * created by AutoDiffTape::variables(), as returned by AutoDiffTape::array(). The arrays constructed
+  * from values are constants, which are not recorded. Each coefficient-wise operation or reduction on
+  * arrays is recorded as a single array operation, see AutoDiffTape.
+  *
+  * It supports the coefficient-wise arithmetic operators between arrays and with AutoDiffTapeScalar
+  * objects, the coefficient-wise min() and max(), the reductions sum(), dot(), squaredNorm() and norm(),
+  * as well as the following global math functions: abs, abs2, sqrt, exp, log, pow, sin, cos, tan, asin,
+  * acos, atan, sinh, cosh and tanh. Its coefficients are AutoDiffTapeScalar objects, such that the
+  * operations on scalars and on arrays can be mixed.
+  *
+  * \sa AutoDiffTape, AutoDiffTapeScalar
+  */
+template<typename _Scalar>
+class AutoDiffTapeArray
+{
+public:
+  typedef _Scalar Scalar;
+  typedef AutoDiffTape<Scalar> TapeType;
+  typedef AutoDiffTapeScalar<Scalar> ActiveScalar;
+  typedef Array<Scalar, Dynamic, 1> ValueType;
+
+  /** Default constructor, the array is empty. */
+  AutoDiffTapeArray() : m_index(0), m_tape(0) {}
+
+  /** Constructs a constant array of values \a value. */
+  AutoDiffTapeArray(const ValueType& value) : m_value(value), m_index(0), m_tape(0) {}
+
+  /** \returns the number of coefficients */
+  inline Index size() const { return m_value.size(); }
+
+  /** \returns the values when the array has been recorded, see AutoDiffTape::value() */
+  inline const ValueType& value() const { return m_value; }
+
+  /** \returns the index of the operation which computed the first coefficient in its tape */
+  inline Index index() const { return m_index; }
+
+  /** \returns the tape which recorded the array, or a null pointer for a constant */
+  inline TapeType* tape() const { return m_tape; }
+
+  /** \returns whether the array is a constant, which does not depend on any input */
+  inline bool isConstant() const { return m_tape == 0; }
+
+  /** \returns the coefficient \a i */
+  inline ActiveScalar operator[](Index i) const
+  {
+    eigen_assert(i >= 0 && i < size());
+    return isConstant() ? ActiveScalar(m_value[i]) : ActiveScalar(m_value[i], m_index + i, m_tape);
+  }
+
+  /** \returns the \a n coefficients starting at \a start, without recording any operation */
+  inline AutoDiffTapeArray segment(Index start, Index n) const
+  {
+    eigen_assert(start >= 0 && n >= 0 && start + n <= size());
+    return AutoDiffTapeArray(ValueType(m_value.segment(start, n)), isConstant() ? 0 : m_index + start, m_tape);
+  }
+  inline AutoDiffTapeArray head(Index n) const { return segment(0, n); }
+  inline AutoDiffTapeArray tail(Index n) const { return segment(size() - n, n); }
+
+  inline ActiveScalar sum() const { return TapeType::template applyArray<internal::TapeSum>(*this)[0]; }
+  inline ActiveScalar dot(const AutoDiffTapeArray& other) const
+  { return TapeType::template applyArray<internal::TapeDot>(*this, other)[0]; }
+  inline ActiveScalar squaredNorm() const { return dot(*this); }
+  inline ActiveScalar norm() const { return TapeType::template apply<internal::TapeSqrt>(squaredNorm()); }
+
+  inline AutoDiffTapeArray (min)(const AutoDiffTapeArray& other) const
+  { return TapeType::template applyArray<internal::TapeMin>(*this, other); }
+  inline AutoDiffTapeArray (max)(const AutoDiffTapeArray& other) const
+  { return TapeType::template applyArray<internal::TapeMax>(*this, other); }
+
+  inline AutoDiffTapeArray operator-() const { return TapeType::template applyArray<internal::TapeNeg>(*this); }
+
+#define EIGEN_AUTODIFF_TAPE_ARRAY_OPERATOR(OP,TAPE_OP) \
+  friend inline AutoDiffTapeArray operator OP(const AutoDiffTapeArray& a, const AutoDiffTapeArray& b) \
+  { return TapeType::template applyArray<internal::TAPE_OP>(a, b); } \
+  friend inline AutoDiffTapeArray operator OP(const AutoDiffTapeArray& a, const ActiveScalar& b) \
+  { return TapeType::template applyArray<internal::TAPE_OP>(a, b); } \
+  friend inline AutoDiffTapeArray operator OP(const ActiveScalar& a, const AutoDiffTapeArray& b) \
+  { return TapeType::template applyArray<internal::TAPE_OP>(a, b); } \
+  inline AutoDiffTapeArray& operator OP##=(const AutoDiffTapeArray& other) { return *this = *this OP other; } \
+  inline AutoDiffTapeArray& operator OP##=(const ActiveScalar& other) { return *this = *this OP other; }
+
+  EIGEN_AUTODIFF_TAPE_ARRAY_OPERATOR(+, TapeAdd)
+  EIGEN_AUTODIFF_TAPE_ARRAY_OPERATOR(-, TapeSub)
+  EIGEN_AUTODIFF_TAPE_ARRAY_OPERATOR(*, TapeMul)
+  EIGEN_AUTODIFF_TAPE_ARRAY_OPERATOR(/, TapeDiv)
+
+#undef EIGEN_AUTODIFF_TAPE_ARRAY_OPERATOR
+
+protected:
+  friend class AutoDiffTape<Scalar>;
+  AutoDiffTapeArray(const ValueType& value, Index index, TapeType* tape) : m_value(value), m_index(index), m_tape(tape) {}
+
+  ValueType m_value;
+  Index m_index;
+  TapeType* m_tape;
+};
+
+#define EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(FUNC,OP) \
+  template<typename Scalar> \
+  inline AutoDiffTapeScalar<Scalar> FUNC(const AutoDiffTapeScalar<Scalar>& x) { \
+    return AutoDiffTape<Scalar>::template apply<internal::OP>(x); \
+  } \
+  template<typename Scalar> \
+  inline AutoDiffTapeArray<Scalar> FUNC(const AutoDiffTapeArray<Scalar>& x) { \
+    return AutoDiffTape<Scalar>::template applyArray<internal::OP>(x); \
+  }
+
+#define EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_BINARY(FUNC,OP) \
+  template<typename Scalar> \
+  inline AutoDiffTapeScalar<Scalar> FUNC(const AutoDiffTapeScalar<Scalar>& x, const AutoDiffTapeScalar<Scalar>& y) { \
+    return AutoDiffTape<Scalar>::template apply<internal::OP>(x, y); \
+  } \
+  template<typename Scalar> \
+  inline AutoDiffTapeScalar<Scalar> FUNC(const AutoDiffTapeScalar<Scalar>& x, const Scalar& y) { \
+    return AutoDiffTape<Scalar>::template apply<internal::OP>(x, y); \
+  } \
+  template<typename Scalar> \
+  inline AutoDiffTapeScalar<Scalar> FUNC(const Scalar& x, const AutoDiffTapeScalar<Scalar>& y) { \
+    return AutoDiffTape<Scalar>::template apply<internal::OP>(x, y); \
+  }
+
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(abs, TapeAbs)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(abs2, TapeAbs2)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(sqrt, TapeSqrt)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(exp, TapeExp)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(log, TapeLog)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(sin, TapeSin)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(cos, TapeCos)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(tan, TapeTan)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(asin, TapeAsin)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(acos, TapeAcos)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(atan, TapeAtan)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(sinh, TapeSinh)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(cosh, TapeCosh)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY(tanh, TapeTanh)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_BINARY(pow, TapePow)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_BINARY(atan2, TapeAtan2)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_BINARY((min), TapeMin)
+EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_BINARY((max), TapeMax)
+
+template<typename Scalar>
+inline AutoDiffTapeArray<Scalar> pow(const AutoDiffTapeArray<Scalar>& x, const AutoDiffTapeArray<Scalar>& y)
+{ return AutoDiffTape<Scalar>::template applyArray<internal::TapePow>(x, y); }
+template<typename Scalar>
+inline AutoDiffTapeArray<Scalar> pow(const AutoDiffTapeArray<Scalar>& x, const AutoDiffTapeScalar<Scalar>& y)
+{ return AutoDiffTape<Scalar>::template applyArray<internal::TapePow>(x, y); }
+template<typename Scalar>
+inline AutoDiffTapeArray<Scalar> pow(const AutoDiffTapeArray<Scalar>& x, const Scalar& y)
+{ return AutoDiffTape<Scalar>::template applyArray<internal::TapePow>(x, AutoDiffTapeScalar<Scalar>(y)); }
+
+#undef EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_UNARY
+#undef EIGEN_AUTODIFF_TAPE_DECLARE_GLOBAL_BINARY
+
+template<typename Scalar>
+inline const AutoDiffTapeScalar<Scalar>& conj(const AutoDiffTapeScalar<Scalar>& x) { return x; }
+template<typename Scalar>
+inline const AutoDiffTapeScalar<Scalar>& real(const AutoDiffTapeScalar<Scalar>& x) { return x; }
+template<typename Scalar>
+inline AutoDiffTapeScalar<Scalar> imag(const AutoDiffTapeScalar<Scalar>&) { return AutoDiffTapeScalar<Scalar>(0); }
+
+template<typename Scalar, typename BinOp>
+struct ScalarBinaryOpTraits<AutoDiffTapeScalar<Scalar>, Scalar, BinOp>
+{
+  typedef AutoDiffTapeScalar<Scalar> ReturnType;
+};
+
+template<typename Scalar, typename BinOp>
+struct ScalarBinaryOpTraits<Scalar, AutoDiffTapeScalar<Scalar>, BinOp>
+{
+  typedef AutoDiffTapeScalar<Scalar> ReturnType;
+};
+
+template<typename _Scalar> struct NumTraits<AutoDiffTapeScalar<_Scalar> >
+  : NumTraits<_Scalar>
+{
+  typedef AutoDiffTapeScalar<_Scalar> Real;
+  typedef AutoDiffTapeScalar<_Scalar> NonInteger;
+  typedef AutoDiffTapeScalar<_Scalar> Nested;
+  typedef _Scalar Literal;
+  enum {
+    RequireInitialization = 1,
+    ReadCost = 3 * NumTraits<_Scalar>::ReadCost,
+    AddCost = 4 * NumTraits<_Scalar>::AddCost,
+    MulCost = 4 * NumTraits<_Scalar>::MulCost
+  };
+};
+
+}
+
+namespace std {
+template <typename T>
+class numeric_limits<Eigen::AutoDiffTapeScalar<T> >
+  : public numeric_limits<T> {};
+
+}  // namespace std
+
+#endif // EIGEN_AUTODIFF_TAPE_H
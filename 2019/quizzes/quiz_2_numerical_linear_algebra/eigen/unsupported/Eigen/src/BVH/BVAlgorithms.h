@@ -67,6 +67,13 @@ private:
   intersector_helper2& operator=(const intersector_helper2&);
 };
 
+//the size of a volume used to choose which node to descend during the tandem traversal of two BVH's
+template<typename Scalar, int Dim>
+Scalar bv_size(const AlignedBox<Scalar, Dim> &box) { return box.isEmpty() ? Scalar(0) : box.diagonal().squaredNorm(); }
+
+template<typename Volume>
+int bv_size(const Volume &) { return 0; } //unknown volume types: always descend the first tree
+
 } // end namespace internal
 
 /**  Given a BVH, runs the query encapsulated by \a intersector.
@@ -88,9 +95,11 @@ void BVIntersect(const BVH &tree, Intersector &intersector)
      bool intersectObjectVolume(const BVH1::Object &o1, const BVH2::Volume &v2) //returns true if the volume-object product intersects the query
      bool intersectObjectObject(const BVH1::Object &o1, const BVH2::Object &o2) //returns true if the search should terminate immediately
   \endcode
+  *  The two trees are traversed in tandem: of each pair of intersecting volumes, the larger one is split, which keeps the
+  *  volumes of the pairs of similar sizes and culls the pairs of small volumes much faster than splitting both nodes.
   */
 template<typename BVH1, typename BVH2, typename Intersector>
-void BVIntersect(const BVH1 &tree1, const BVH2 &tree2, Intersector &intersector) //TODO: tandem descent when it makes sense
+void BVIntersect(const BVH1 &tree1, const BVH2 &tree2, Intersector &intersector)
 {
   typedef typename BVH1::Index Index1;
   typedef typename BVH2::Index Index2;
@@ -106,36 +115,70 @@ void BVIntersect(const BVH1 &tree1, const BVH2 &tree2, Intersector &intersector)
   VolIter2 vBegin2 = VolIter2(), vEnd2 = VolIter2(), vCur2 = VolIter2();
   ObjIter2 oBegin2 = ObjIter2(), oEnd2 = ObjIter2(), oCur2 = ObjIter2();
 
-  std::vector<std::pair<Index1, Index2> > todo(1, std::make_pair(tree1.getRootIndex(), tree2.getRootIndex()));
+  std::vector<std::pair<Index1, Index2> > todo;
+
+  //the roots may have no volume, so their children are paired
+  tree1.getChildren(tree1.getRootIndex(), vBegin1, vEnd1, oBegin1, oEnd1);
+  tree2.getChildren(tree2.getRootIndex(), vBegin2, vEnd2, oBegin2, oEnd2);
+
+  for(; vBegin1 != vEnd1; ++vBegin1) { //go through child volumes of first tree
+    const typename BVH1::Volume &vol1 = tree1.getVolume(*vBegin1);
+    for(vCur2 = vBegin2; vCur2 != vEnd2; ++vCur2) { //go through child volumes of second tree
+      if(intersector.intersectVolumeVolume(vol1, tree2.getVolume(*vCur2)))
+        todo.push_back(std::make_pair(*vBegin1, *vCur2));
+    }
+
+    for(oCur2 = oBegin2; oCur2 != oEnd2; ++oCur2) {//go through child objects of second tree
+      Helper1 helper(*oCur2, intersector);
+      if(intersector.intersectVolumeObject(vol1, *oCur2) && internal::intersect_helper(tree1, helper, *vBegin1))
+        return; //intersector said to stop query
+    }
+  }
+
+  for(; oBegin1 != oEnd1; ++oBegin1) { //go through child objects of first tree
+    for(vCur2 = vBegin2; vCur2 != vEnd2; ++vCur2) { //go through child volumes of second tree
+      Helper2 helper(*oBegin1, intersector);
+      if(intersector.intersectObjectVolume(*oBegin1, tree2.getVolume(*vCur2)) && internal::intersect_helper(tree2, helper, *vCur2))
+        return; //intersector said to stop query
+    }
+
+    for(oCur2 = oBegin2; oCur2 != oEnd2; ++oCur2) {//go through child objects of second tree
+      if(intersector.intersectObjectObject(*oBegin1, *oCur2))
+        return; //intersector said to stop query
+    }
+  }
 
+  //tandem descent: only the node with the larger volume of each pair is opened, the other one is paired with its children
   while(!todo.empty()) {
-    tree1.getChildren(todo.back().first, vBegin1, vEnd1, oBegin1, oEnd1);
-    tree2.getChildren(todo.back().second, vBegin2, vEnd2, oBegin2, oEnd2);
+    Index1 index1 = todo.back().first;
+    Index2 index2 = todo.back().second;
     todo.pop_back();
+    const typename BVH1::Volume &vol1 = tree1.getVolume(index1);
+    const typename BVH2::Volume &vol2 = tree2.getVolume(index2);
 
-    for(; vBegin1 != vEnd1; ++vBegin1) { //go through child volumes of first tree
-      const typename BVH1::Volume &vol1 = tree1.getVolume(*vBegin1);
-      for(vCur2 = vBegin2; vCur2 != vEnd2; ++vCur2) { //go through child volumes of second tree
-        if(intersector.intersectVolumeVolume(vol1, tree2.getVolume(*vCur2)))
-          todo.push_back(std::make_pair(*vBegin1, *vCur2));
-      }
+    if(internal::bv_size(vol1) >= internal::bv_size(vol2)) {
+      tree1.getChildren(index1, vBegin1, vEnd1, oBegin1, oEnd1);
 
-      for(oCur2 = oBegin2; oCur2 != oEnd2; ++oCur2) {//go through child objects of second tree
-        Helper1 helper(*oCur2, intersector);
-        if(internal::intersect_helper(tree1, helper, *vBegin1))
-          return; //intersector said to stop query
-      }
-    }
+      for(; vBegin1 != vEnd1; ++vBegin1) //go through child volumes of first tree
+        if(intersector.intersectVolumeVolume(tree1.getVolume(*vBegin1), vol2))
+          todo.push_back(std::make_pair(*vBegin1, index2));
 
-    for(; oBegin1 != oEnd1; ++oBegin1) { //go through child objects of first tree
-      for(vCur2 = vBegin2; vCur2 != vEnd2; ++vCur2) { //go through child volumes of second tree
+      for(; oBegin1 != oEnd1; ++oBegin1) { //go through child objects of first tree
         Helper2 helper(*oBegin1, intersector);
-        if(internal::intersect_helper(tree2, helper, *vCur2))
+        if(intersector.intersectObjectVolume(*oBegin1, vol2) && internal::intersect_helper(tree2, helper, index2))
           return; //intersector said to stop query
       }
+    }
+    else {
+      tree2.getChildren(index2, vBegin2, vEnd2, oBegin2, oEnd2);
 
-      for(oCur2 = oBegin2; oCur2 != oEnd2; ++oCur2) {//go through child objects of second tree
-        if(intersector.intersectObjectObject(*oBegin1, *oCur2))
+      for(; vBegin2 != vEnd2; ++vBegin2) //go through child volumes of second tree
+        if(intersector.intersectVolumeVolume(vol1, tree2.getVolume(*vBegin2)))
+          todo.push_back(std::make_pair(index1, *vBegin2));
+
+      for(; oBegin2 != oEnd2; ++oBegin2) { //go through child objects of second tree
+        Helper1 helper(*oBegin2, intersector);
+        if(intersector.intersectVolumeObject(vol1, *oBegin2) && internal::intersect_helper(tree1, helper, index1))
           return; //intersector said to stop query
       }
     }
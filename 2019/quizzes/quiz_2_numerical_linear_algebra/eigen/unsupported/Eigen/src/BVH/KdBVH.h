@@ -49,6 +49,66 @@ struct get_boxes_helper<ObjectList, VolumeList, int> {
   }
 };
 
+//half of the surface of a box, or its equivalent in dimension Dim, which is used to estimate the cost of a hierarchy
+template<typename Scalar, int Dim>
+Scalar bv_half_area(const AlignedBox<Scalar, Dim> &box)
+{
+  if(box.isEmpty())
+    return Scalar(0);
+  Matrix<Scalar, Dim, 1> sizes = box.sizes();
+  if(Dim == 1)
+    return sizes[0];
+  Scalar area(0);
+  for(int i = 0; i < Dim; ++i) {
+    Scalar face(1);
+    for(int j = 0; j < Dim; ++j)
+      if(j != i)
+        face *= sizes[j];
+    area += face;
+  }
+  return area;
+}
+
+//Sorts the nodes by their height in the tree given in heights, such that the nodes of height h end at outNodes[outLevels[h]].
+//The bounds of the nodes of a level only depend on the nodes of the previous levels.
+inline void bvh_sort_levels(const std::vector<int> &heights, std::vector<int> &outNodes, std::vector<int> &outLevels)
+{
+  int numLevels = heights.empty() ? 0 : *std::max_element(heights.begin(), heights.end());
+  outLevels.assign(numLevels + 1, 0);
+  for(int i = 0; i < (int)heights.size(); ++i)
+    ++outLevels[heights[i]];
+  for(int h = 1; h <= numLevels; ++h)
+    outLevels[h] += outLevels[h - 1];
+  outNodes.resize(heights.size());
+  for(int i = (int)heights.size() - 1; i >= 0; --i)
+    outNodes[--outLevels[heights[i]]] = i;
+  outLevels.erase(outLevels.begin());
+  outLevels.push_back(static_cast<int>(heights.size()));
+}
+
+//Calls refitter(node) on the nodes sorted by bvh_sort_levels, level by level, the nodes of each level being processed in parallel.
+template<typename Refitter>
+void bvh_refit_levels(const std::vector<int> &nodes, const std::vector<int> &levels, const Refitter &refitter)
+{
+  int threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+  if(nodes.size() >= 4096 && omp_get_num_threads() == 1) {
+    Eigen::initParallel();
+    threads = nbThreads();
+  }
+#endif
+  int begin = 0;
+  for(int l = 0; l < (int)levels.size(); ++l) {
+    int end = levels[l];
+#ifdef EIGEN_HAS_OPENMP
+    #pragma omp parallel for num_threads(threads) if(threads > 1 && end - begin >= 256)
+#endif
+    for(int i = begin; i < end; ++i)
+      refitter(nodes[i]);
+    begin = end;
+  }
+}
+
 } // end namespace internal
 
 
@@ -64,6 +124,10 @@ struct get_boxes_helper<ObjectList, VolumeList, int> {
  *  Given a sequence of objects, it computes their bounding boxes, constructs a Kd-tree of their centers
  *  and builds a BVH with the structure of that Kd-tree.  When the elements of the tree are too expensive to be copied around,
  *  it is useful for _Object to be a pointer.
+ *
+ *  When the objects move, refit() updates the bounding boxes while keeping the structure of the tree, which is much cheaper
+ *  than building it again.  The queries get slower as the boxes grow and overlap, which is measured by quality(): refit()
+ *  rebuilds the tree when it drops below a given threshold.
  */
 template<typename _Scalar, int _Dim, typename _Object> class KdBVH
 {
@@ -78,7 +142,7 @@ public:
   typedef const int *VolumeIterator; //the iterators are just pointers into the tree's vectors
   typedef const Object *ObjectIterator;
 
-  KdBVH() {}
+  KdBVH() : builtCost(0) {}
 
   /** Given an iterator range over \a Object references, constructs the BVH.  Requires that bounding_box(Object) return a Volume. */
   template<typename Iter> KdBVH(Iter begin, Iter end) { init(begin, end, 0, 0); } //int is recognized by init as not being an iterator type
@@ -97,6 +161,10 @@ public:
     objects.clear();
     boxes.clear();
     children.clear();
+    objectOrder.clear();
+    refitNodes.clear();
+    refitLevels.clear();
+    builtCost = Scalar(0);
 
     objects.insert(objects.end(), begin, end);
     int n = static_cast<int>(objects.size());
@@ -121,8 +189,67 @@ public:
 
     ObjectList tmp(n);
     tmp.swap(objects);
-    for(int i = 0; i < n; ++i)
+    objectOrder.resize(n);
+    for(int i = 0; i < n; ++i) {
       objects[i] = tmp[objCenters[i].second];
+      objectOrder[i] = objCenters[i].second;
+    }
+
+    //the children of a node always precede it
+    std::vector<int> heights(n - 1, 1);
+    for(int i = 0; i < n - 1; ++i)
+      for(int j = 2 * i; j < 2 * i + 2; ++j)
+        if(children[j] < n - 1)
+          heights[i] = (std::max)(heights[i], heights[children[j]] + 1);
+    internal::bvh_sort_levels(heights, refitNodes, refitLevels);
+    builtCost = cost();
+  }
+
+  /** Given an iterator range over the \a Object references the tree has been built from, in the same order, updates the bounding
+    * boxes of the nodes after the objects moved, without changing the structure of the tree.  The nodes of each level of the tree
+    * are updated in parallel when OpenMP is enabled.  If quality() drops below \a minQuality, the tree is rebuilt.
+    * Requires that bounding_box(Object) return a Volume.
+    * \returns true if the tree has been rebuilt */
+  template<typename Iter> bool refit(Iter begin, Iter end, Scalar minQuality = Scalar(0.5)) { return refit(begin, end, 0, 0, minQuality); }
+
+  /** Given an iterator range over the \a Object references the tree has been built from and an iterator range over their
+    * new bounding boxes, updates the bounding boxes of the nodes, and rebuilds the tree if quality() drops below \a minQuality.
+    * \returns true if the tree has been rebuilt
+    * \sa refit(Iter, Iter, Scalar) */
+  template<typename OIter, typename BIter> bool refit(OIter begin, OIter end, BIter boxBegin, BIter boxEnd, Scalar minQuality = Scalar(0.5))
+  {
+    ObjectList newObjects(begin, end);
+    int n = static_cast<int>(newObjects.size());
+    eigen_assert(n == (int)objects.size() && "refit() requires the objects the tree has been built from");
+
+    VolumeList objBoxes;
+    internal::get_boxes_helper<ObjectList, VolumeList, BIter>()(newObjects, boxBegin, boxEnd, objBoxes);
+
+    if(n < 2) {
+      objects.swap(newObjects);
+      return false;
+    }
+
+    VolumeList sortedBoxes(n);
+    for(int i = 0; i < n; ++i) {
+      objects[i] = newObjects[objectOrder[i]];
+      sortedBoxes[i] = objBoxes[objectOrder[i]];
+    }
+    internal::bvh_refit_levels(refitNodes, refitLevels, Refitter(*this, sortedBoxes));
+
+    if(quality() >= minQuality)
+      return false;
+    init(newObjects.begin(), newObjects.end(), objBoxes.begin(), objBoxes.end());
+    return true;
+  }
+
+  /** \returns the ratio between the estimated cost of a query when the tree has been built and its current cost.  It is 1 after
+    * init() and usually decreases when refit() updates the tree for moving objects.  The cost is the sum of the surface areas of
+    * the nodes relative to the surface area of the root, following the surface area heuristic. */
+  Scalar quality() const
+  {
+    Scalar current = cost();
+    return current > Scalar(0) ? builtCost / current : Scalar(1);
   }
 
   /** \returns the index of the root of the hierarchy */
@@ -168,6 +295,36 @@ public:
   }
 
 private:
+  struct Refitter //recomputes the bounding box of a node from its children
+  {
+    Refitter(KdBVH &t, const VolumeList &b) : tree(t), objBoxes(b) {}
+    void operator()(int index) const
+    {
+      int numBoxes = static_cast<int>(tree.boxes.size());
+      int c1 = tree.children[2 * index], c2 = tree.children[2 * index + 1];
+      const Volume &b1 = c1 < numBoxes ? tree.boxes[c1] : objBoxes[c1 - numBoxes];
+      const Volume &b2 = c2 < numBoxes ? tree.boxes[c2] : objBoxes[c2 - numBoxes];
+      tree.boxes[index] = b1.merged(b2);
+    }
+    KdBVH &tree;
+    const VolumeList &objBoxes;
+  private:
+    Refitter& operator=(const Refitter&);
+  };
+
+  Scalar cost() const
+  {
+    if(boxes.empty())
+      return Scalar(0);
+    Scalar rootArea = internal::bv_half_area(boxes.back());
+    if(!(rootArea > Scalar(0)))
+      return Scalar(0);
+    Scalar sum(0);
+    for(int i = 0; i < (int)boxes.size(); ++i)
+      sum += internal::bv_half_area(boxes[i]);
+    return sum / rootArea;
+  }
+
   typedef internal::vector_int_pair<Scalar, Dim> VIPair;
   typedef std::vector<VIPair, aligned_allocator<VIPair> > VIPairList;
   typedef Matrix<Scalar, Dim, 1> VectorType;
@@ -216,6 +373,9 @@ private:
   std::vector<int> children; //children of x are children[2x] and children[2x+1], indices bigger than boxes.size() index into objects.
   VolumeList boxes;
   ObjectList objects;
+  std::vector<int> objectOrder; //objects[i] is the object objectOrder[i] of the range the tree has been built from
+  std::vector<int> refitNodes, refitLevels; //the nodes sorted by height, see internal::bvh_sort_levels
+  Scalar builtCost;
 };
 
 } // end namespace Eigen
@@ -0,0 +1,485 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SAHBVH_H
+#define EIGEN_SAHBVH_H
+
+namespace Eigen {
+
+namespace internal {
+
+//a node of a SahBVH: either a leaf referencing a range of objects, or an inner node with up to 4 children
+//whose bounding boxes are stored as structure of arrays so that a query is tested against all of them at once
+template<typename Scalar, int Dim>
+struct bvh4_node
+{
+EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  typedef AlignedBox<Scalar, Dim> Volume;
+  typedef Array<Scalar, Dim, 4, RowMajor> Bounds; //row k holds coordinate k of the 4 children
+
+  bvh4_node() : numChildren(0), firstObject(0), numObjects(0)
+  {
+    lower.setConstant(NumTraits<Scalar>::highest()); //unused children are empty boxes
+    upper.setConstant(NumTraits<Scalar>::lowest());
+    children[0] = children[1] = children[2] = children[3] = -1;
+  }
+
+  Volume box;
+  Bounds lower, upper;
+  int children[4];
+  int numChildren;
+  int firstObject, numObjects;
+};
+
+//tells whether the center of an object falls in one of the bins before bin along the axis dim
+template<typename Scalar, int Dim>
+struct sah_bin_predicate
+{
+  typedef Matrix<Scalar, Dim, Dynamic> CenterList;
+  sah_bin_predicate(const CenterList &c, int d, Scalar l, Scalar s, int b) : centers(c), dim(d), low(l), scale(s), bin(b) {}
+  inline bool operator()(int i) const { return int((centers(dim, i) - low) * scale) < bin; }
+  const CenterList &centers;
+  int dim;
+  Scalar low, scale;
+  int bin;
+private:
+  sah_bin_predicate& operator=(const sah_bin_predicate&);
+};
+
+} // end namespace internal
+
+
+/** \class SahBVH
+ *  \brief An optimized bounding volume hierarchy based on AlignedBox
+ *
+ *  \param _Scalar The underlying scalar type of the bounding boxes
+ *  \param _Dim The dimension of the space in which the hierarchy lives
+ *  \param _Object The object type that lives in the hierarchy.  It must have value semantics.  Either bounding_box(_Object) must
+ *                 be defined and return an AlignedBox<_Scalar, _Dim> or bounding boxes must be provided to the tree initializer.
+ *
+ *  This class implements the same traversal mechanism as KdBVH, hence it can be used with BVIntersect and BVMinimize.
+ *  Compared to KdBVH:
+ *   - the tree is built using the surface area heuristic (SAH), evaluated on 16 bins of the object centers along each axis;
+ *   - the nodes have up to 4 children, obtained by splitting the largest child until there are 4 of them, and are stored
+ *     in a flat array along with the structure of arrays bounds of their children;
+ *   - the leaves contain up to 4 objects;
+ *   - when OpenMP is enabled, the subtrees of large hierarchies are built in parallel.
+ *
+ *  In addition, intersectBox() runs a box query with an iterative traversal using a stack bounded by the depth of the tree,
+ *  in which the query box is tested against the 4 children of a node with packet operations.
+ *  Like KdBVH, the tree can be updated for moving objects with refit().
+ */
+template<typename _Scalar, int _Dim, typename _Object> class SahBVH
+{
+public:
+  enum { Dim = _Dim, MaxLeafSize = 4, NumBins = 16 };
+  typedef _Object Object;
+  typedef std::vector<Object, aligned_allocator<Object> > ObjectList;
+  typedef _Scalar Scalar;
+  typedef AlignedBox<Scalar, Dim> Volume;
+  typedef std::vector<Volume, aligned_allocator<Volume> > VolumeList;
+  typedef int Index;
+  typedef const int *VolumeIterator; //the iterators are just pointers into the tree's vectors
+  typedef const Object *ObjectIterator;
+
+  SahBVH() : maxDepth(0), builtCost(0) {}
+
+  /** Given an iterator range over \a Object references, constructs the BVH.  Requires that bounding_box(Object) return a Volume. */
+  template<typename Iter> SahBVH(Iter begin, Iter end) { init(begin, end, 0, 0); } //int is recognized by init as not being an iterator type
+
+  /** Given an iterator range over \a Object references and an iterator range over their bounding boxes, constructs the BVH */
+  template<typename OIter, typename BIter> SahBVH(OIter begin, OIter end, BIter boxBegin, BIter boxEnd) { init(begin, end, boxBegin, boxEnd); }
+
+  /** Given an iterator range over \a Object references, constructs the BVH, overwriting whatever is in there currently.
+    * Requires that bounding_box(Object) return a Volume. */
+  template<typename Iter> void init(Iter begin, Iter end) { init(begin, end, 0, 0); }
+
+  /** Given an iterator range over \a Object references and an iterator range over their bounding boxes,
+    * constructs the BVH, overwriting whatever is in there currently. */
+  template<typename OIter, typename BIter> void init(OIter begin, OIter end, BIter boxBegin, BIter boxEnd)
+  {
+    objects.clear();
+    nodes.clear();
+
+    objects.insert(objects.end(), begin, end);
+    int n = static_cast<int>(objects.size());
+
+    BuildData data;
+    internal::get_boxes_helper<ObjectList, VolumeList, BIter>()(objects, boxBegin, boxEnd, data.boxes);
+    data.centers.resize(Dim, n);
+    data.perm.resize(n);
+    for(int i = 0; i < n; ++i) {
+      data.centers.col(i) = data.boxes[i].center();
+      data.perm[i] = i;
+    }
+
+    int threads = 1;
+#ifdef EIGEN_HAS_OPENMP
+    if(n >= 4096)
+      threads = nbThreads();
+#endif
+
+    //the top of the tree is built serially, the subtrees smaller than taskSize are deferred and built in parallel
+    std::vector<BuildTask> tasks;
+    const int taskSize = (std::max)(n / (4 * threads), 1024);
+    nodes.reserve(2 * (n / MaxLeafSize) + 1);
+    buildNode(data, 0, n, nodes, threads > 1 ? &tasks : 0, taskSize);
+
+    if(!tasks.empty()) {
+      int numTasks = static_cast<int>(tasks.size());
+      std::vector<NodeList> subtrees(numTasks);
+#ifdef EIGEN_HAS_OPENMP
+      Eigen::initParallel();
+      #pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+      for(int t = 0; t < numTasks; ++t)
+        buildNode(data, tasks[t].from, tasks[t].to, subtrees[t], 0, 0);
+
+      for(int t = 0; t < numTasks; ++t) {
+        int offset = static_cast<int>(nodes.size());
+        for(int i = 0; i < (int)subtrees[t].size(); ++i) {
+          nodes.push_back(subtrees[t][i]);
+          for(int c = 0; c < nodes.back().numChildren; ++c)
+            nodes.back().children[c] += offset;
+        }
+        nodes[tasks[t].parent].children[tasks[t].slot] = offset;
+      }
+    }
+
+    ObjectList tmp(objects);
+    for(int i = 0; i < n; ++i)
+      objects[i] = tmp[data.perm[i]];
+    objectOrder.swap(data.perm);
+
+    //the children are always stored after their parent
+    std::vector<int> nodeDepth(nodes.size(), 0);
+    maxDepth = 0;
+    for(int i = 0; i < (int)nodes.size(); ++i)
+      for(int c = 0; c < nodes[i].numChildren; ++c) {
+        nodeDepth[nodes[i].children[c]] = nodeDepth[i] + 1;
+        maxDepth = (std::max)(maxDepth, nodeDepth[i] + 1);
+      }
+
+    std::vector<int> heights(nodes.size(), 1);
+    for(int i = (int)nodes.size() - 1; i >= 0; --i)
+      for(int c = 0; c < nodes[i].numChildren; ++c)
+        heights[i] = (std::max)(heights[i], heights[nodes[i].children[c]] + 1);
+    internal::bvh_sort_levels(heights, refitNodes, refitLevels);
+    builtCost = cost();
+  }
+
+  /** Given an iterator range over the \a Object references the tree has been built from, in the same order, updates the bounding
+    * boxes of the nodes after the objects moved, without changing the structure of the tree.  If quality() drops below
+    * \a minQuality, the tree is rebuilt.  Requires that bounding_box(Object) return a Volume.
+    * \returns true if the tree has been rebuilt
+    * \sa KdBVH::refit() */
+  template<typename Iter> bool refit(Iter begin, Iter end, Scalar minQuality = Scalar(0.5)) { return refit(begin, end, 0, 0, minQuality); }
+
+  /** Given an iterator range over the \a Object references the tree has been built from and an iterator range over their
+    * new bounding boxes, updates the bounding boxes of the nodes, and rebuilds the tree if quality() drops below \a minQuality.
+    * \returns true if the tree has been rebuilt */
+  template<typename OIter, typename BIter> bool refit(OIter begin, OIter end, BIter boxBegin, BIter boxEnd, Scalar minQuality = Scalar(0.5))
+  {
+    ObjectList newObjects(begin, end);
+    int n = static_cast<int>(newObjects.size());
+    eigen_assert(n == (int)objects.size() && "refit() requires the objects the tree has been built from");
+
+    VolumeList objBoxes;
+    internal::get_boxes_helper<ObjectList, VolumeList, BIter>()(newObjects, boxBegin, boxEnd, objBoxes);
+
+    VolumeList sortedBoxes(n);
+    for(int i = 0; i < n; ++i) {
+      objects[i] = newObjects[objectOrder[i]];
+      sortedBoxes[i] = objBoxes[objectOrder[i]];
+    }
+    internal::bvh_refit_levels(refitNodes, refitLevels, Refitter(*this, sortedBoxes));
+
+    if(quality() >= minQuality)
+      return false;
+    init(newObjects.begin(), newObjects.end(), objBoxes.begin(), objBoxes.end());
+    return true;
+  }
+
+  /** \returns the ratio between the estimated cost of a query when the tree has been built and its current cost
+    * \sa KdBVH::quality() */
+  Scalar quality() const
+  {
+    Scalar current = cost();
+    return current > Scalar(0) ? builtCost / current : Scalar(1);
+  }
+
+  /** \returns the index of the root of the hierarchy */
+  inline Index getRootIndex() const { return 0; }
+
+  /** Given an \a index of a node, on exit, \a outVBegin and \a outVEnd range over the indices of the volume children of the node
+    * and \a outOBegin and \a outOEnd range over the object children of the node */
+  EIGEN_STRONG_INLINE void getChildren(Index index, VolumeIterator &outVBegin, VolumeIterator &outVEnd,
+                                       ObjectIterator &outOBegin, ObjectIterator &outOEnd) const
+  {
+    const Node &node = nodes[index];
+    outVBegin = node.children;
+    outVEnd = outVBegin + node.numChildren;
+    if(node.numObjects > 0) {
+      outOBegin = &(objects[node.firstObject]);
+      outOEnd = outOBegin + node.numObjects;
+    }
+    else
+      outOBegin = outOEnd;
+  }
+
+  /** \returns the bounding box of the node at \a index */
+  inline const Volume &getVolume(Index index) const
+  {
+    return nodes[index].box;
+  }
+
+  /** \returns the number of nodes, including the leaves */
+  inline Index numNodes() const { return static_cast<Index>(nodes.size()); }
+
+  /** \returns the maximal depth of a node, the depth of the root being 0 */
+  inline Index depth() const { return maxDepth; }
+
+  /** \returns a bit mask of the children of the node at \a index whose bounding box intersects \a query:
+    * bit \c i is set if the i-th child returned by getChildren() intersects \a query. */
+  inline int childMask(Index index, const Volume &query) const
+  {
+    typedef Array<Scalar, 1, 4> GapType;
+    const Node &node = nodes[index];
+    //the overlap of the boxes along each axis, negative if they do not intersect
+    GapType gap = node.upper.row(0).cwiseMin((query.max)()[0]) - node.lower.row(0).cwiseMax((query.min)()[0]);
+    for(int k = 1; k < Dim; ++k)
+      gap = gap.cwiseMin(node.upper.row(k).cwiseMin((query.max)()[k]) - node.lower.row(k).cwiseMax((query.min)()[k]));
+    return int(gap(0) >= Scalar(0)) | (int(gap(1) >= Scalar(0)) << 1) | (int(gap(2) >= Scalar(0)) << 2) | (int(gap(3) >= Scalar(0)) << 3);
+  }
+
+  /** Calls \c intersector.intersectObject(object) on every object of the leaves whose bounding box intersects \a query,
+    * until it returns true.
+    * \returns true if the query has been terminated by the intersector. */
+  template<typename Intersector>
+  bool intersectBox(const Volume &query, Intersector &intersector) const
+  {
+    if(nodes.empty() || nodes[0].box.intersection(query).isEmpty())
+      return false;
+
+    //each visited node is replaced by at most 4 children
+    const Index stackSize = 3 * maxDepth + 1;
+    ei_declare_aligned_stack_constructed_variable(int, todo, stackSize, 0);
+    Index top = 0;
+    todo[top++] = 0;
+
+    while(top > 0) {
+      const Index index = todo[--top];
+      const Node &node = nodes[index];
+
+      for(int i = 0; i < node.numObjects; ++i)
+        if(intersector.intersectObject(objects[node.firstObject + i]))
+          return true; //intersector said to stop query
+
+      if(node.numChildren > 0) {
+        int mask = childMask(index, query);
+        for(int c = node.numChildren - 1; c >= 0; --c)
+          if(mask & (1 << c))
+            todo[top++] = node.children[c];
+      }
+    }
+    return false;
+  }
+
+private:
+  typedef internal::bvh4_node<Scalar, Dim> Node;
+  typedef std::vector<Node, aligned_allocator<Node> > NodeList;
+  struct BuildData
+  {
+    VolumeList boxes;
+    Matrix<Scalar, Dim, Dynamic> centers;
+    std::vector<int> perm; //the order of the objects in the tree
+  };
+
+  struct BuildTask
+  {
+    BuildTask(int p, int s, int f, int t) : parent(p), slot(s), from(f), to(t) {}
+    int parent, slot, from, to;
+  };
+
+  struct Refitter //recomputes the bounding box of a node and the bounds of its children
+  {
+    Refitter(SahBVH &t, const VolumeList &b) : tree(t), objBoxes(b) {}
+    void operator()(int index) const
+    {
+      Node &node = tree.nodes[index];
+      Volume box;
+      for(int i = 0; i < node.numObjects; ++i)
+        box.extend(objBoxes[node.firstObject + i]);
+      for(int c = 0; c < node.numChildren; ++c) {
+        const Volume &childBox = tree.nodes[node.children[c]].box;
+        node.lower.col(c) = (childBox.min)();
+        node.upper.col(c) = (childBox.max)();
+        box.extend(childBox);
+      }
+      node.box = box;
+    }
+    SahBVH &tree;
+    const VolumeList &objBoxes;
+  private:
+    Refitter& operator=(const Refitter&);
+  };
+
+  static Scalar halfArea(const Volume &box) { return internal::bv_half_area(box); }
+
+  Scalar cost() const
+  {
+    if(nodes.empty())
+      return Scalar(0);
+    Scalar rootArea = halfArea(nodes[0].box);
+    if(!(rootArea > Scalar(0)))
+      return Scalar(0);
+    Scalar sum(0);
+    for(int i = 0; i < (int)nodes.size(); ++i)
+      sum += halfArea(nodes[i].box);
+    return sum / rootArea;
+  }
+
+  static Volume rangeBox(const BuildData &data, int from, int to)
+  {
+    Volume box;
+    for(int i = from; i < to; ++i)
+      box.extend(data.boxes[data.perm[i]]);
+    return box;
+  }
+
+  //Partitions the objects in [from, to) along the binned split of lowest SAH cost, and returns the beginning of the second part.
+  static int split(BuildData &data, int from, int to)
+  {
+    Volume centerBox;
+    for(int i = from; i < to; ++i)
+      centerBox.extend(data.centers.col(data.perm[i]));
+
+    Scalar bestCost = NumTraits<Scalar>::highest();
+    int bestDim = -1, bestBin = 0;
+    Scalar bestScale(0);
+
+    for(int dim = 0; dim < Dim; ++dim) {
+      Scalar extent = (centerBox.max)()[dim] - (centerBox.min)()[dim];
+      if(!(extent > Scalar(0)))
+        continue;
+      Scalar scale = Scalar(NumBins) * (Scalar(1) - NumTraits<Scalar>::epsilon()) / extent;
+      Scalar low = (centerBox.min)()[dim];
+
+      int counts[NumBins];
+      Volume bins[NumBins];
+      for(int b = 0; b < NumBins; ++b)
+        counts[b] = 0;
+      for(int i = from; i < to; ++i) {
+        int b = (std::min)(int((data.centers(dim, data.perm[i]) - low) * scale), int(NumBins) - 1);
+        ++counts[b];
+        bins[b].extend(data.boxes[data.perm[i]]);
+      }
+
+      //sweep from the left, then from the right to evaluate the cost of splitting before each bin
+      Scalar leftArea[NumBins];
+      int leftCount[NumBins];
+      Volume acc;
+      int count = 0;
+      for(int b = 0; b < NumBins - 1; ++b) {
+        acc.extend(bins[b]);
+        count += counts[b];
+        leftArea[b] = halfArea(acc);
+        leftCount[b] = count;
+      }
+      acc.setEmpty();
+      count = 0;
+      for(int b = NumBins - 1; b > 0; --b) {
+        acc.extend(bins[b]);
+        count += counts[b];
+        if(leftCount[b - 1] == 0 || count == 0)
+          continue;
+        Scalar splitCost = leftArea[b - 1] * Scalar(leftCount[b - 1]) + halfArea(acc) * Scalar(count);
+        if(splitCost < bestCost) {
+          bestCost = splitCost;
+          bestDim = dim;
+          bestBin = b;
+          bestScale = scale;
+        }
+      }
+    }
+
+    int mid = from + (to - from) / 2;
+    if(bestDim >= 0) {
+      internal::sah_bin_predicate<Scalar, Dim> pred(data.centers, bestDim, (centerBox.min)()[bestDim], bestScale, bestBin);
+      mid = static_cast<int>(std::partition(data.perm.begin() + from, data.perm.begin() + to, pred) - data.perm.begin());
+      if(mid == from || mid == to) //can only happen because of roundoff errors
+        mid = from + (to - from) / 2;
+    }
+    return mid;
+  }
+
+  //Builds the subtree of the objects in [from, to) at the end of out and returns the index of its root.
+  //If tasks is not null, the children of at most taskSize objects are not built but appended to tasks.
+  static int buildNode(BuildData &data, int from, int to, NodeList &out, std::vector<BuildTask> *tasks, int taskSize)
+  {
+    int index = static_cast<int>(out.size());
+    out.push_back(Node());
+    out[index].box = rangeBox(data, from, to);
+    out[index].firstObject = from;
+
+    if(to - from <= MaxLeafSize) {
+      out[index].numObjects = to - from;
+      return index;
+    }
+
+    //split the child of largest area until there are 4 children
+    int ranges[4][2] = { { from, to } };
+    Scalar areas[4] = { halfArea(out[index].box) };
+    int numChildren = 1;
+    while(numChildren < 4) {
+      int best = -1;
+      for(int c = 0; c < numChildren; ++c)
+        if(ranges[c][1] - ranges[c][0] > MaxLeafSize && (best < 0 || areas[c] > areas[best]))
+          best = c;
+      if(best < 0)
+        break;
+      int mid = split(data, ranges[best][0], ranges[best][1]);
+      ranges[numChildren][0] = mid;
+      ranges[numChildren][1] = ranges[best][1];
+      ranges[best][1] = mid;
+      areas[best] = halfArea(rangeBox(data, ranges[best][0], ranges[best][1]));
+      areas[numChildren] = halfArea(rangeBox(data, ranges[numChildren][0], ranges[numChildren][1]));
+      ++numChildren;
+    }
+
+    for(int c = 0; c < numChildren; ++c) {
+      int child = -1;
+      Volume childBox;
+      int size = ranges[c][1] - ranges[c][0];
+      if(tasks && size > MaxLeafSize && size <= taskSize) {
+        tasks->push_back(BuildTask(index, c, ranges[c][0], ranges[c][1]));
+        childBox = rangeBox(data, ranges[c][0], ranges[c][1]);
+      }
+      else {
+        child = buildNode(data, ranges[c][0], ranges[c][1], out, tasks, taskSize);
+        childBox = out[child].box;
+      }
+      Node &node = out[index];
+      node.children[c] = child;
+      node.lower.col(c) = (childBox.min)();
+      node.upper.col(c) = (childBox.max)();
+    }
+    out[index].numChildren = numChildren;
+    return index;
+  }
+
+  NodeList nodes;
+  ObjectList objects;
+  std::vector<int> objectOrder; //objects[i] is the object objectOrder[i] of the range the tree has been built from
+  std::vector<int> refitNodes, refitLevels; //the nodes sorted by height, see internal::bvh_sort_levels
+  Index maxDepth;
+  Scalar builtCost;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_SAHBVH_H
@@ -0,0 +1,263 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_SVD3X3_H
+#define EIGEN_BATCHED_SVD3X3_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal Runs the batched SVD kernel on the columns of \a matrices.
+  * If \a Polar is false, \a out0, \a out1 and \a out2 receive U, sigma and V respectively,
+  * otherwise \a out0 and \a out1 receive the rotation and the symmetric factors, and \a out2 is unused. */
+template<int Sweeps, bool Polar, typename Scalar>
+void batched_svd3x3_run(const Ref<const Matrix<Scalar,9,Dynamic>, 0, OuterStride<> >& matrices,
+                        Scalar* out0, Scalar* out1, Scalar* out2)
+{
+  typedef typename batched_svd3x3_packet<Scalar>::type Packet;
+  const Index PacketSize = batched_svd3x3_packet<Scalar>::size;
+  const Index n = matrices.cols();
+  const Index stride = matrices.outerStride();
+  const Index rows1 = Polar ? 9 : 3;
+
+  const Index alignedEnd = (n/PacketSize)*PacketSize;
+  for(Index j=0; j<alignedEnd; j+=PacketSize)
+  {
+    Packet A[9], U[9], sigma[3], V[9];
+    batched3x3_load(matrices.data()+j*stride, stride, A);
+    batched_svd3x3_kernel<Sweeps>(A, U, sigma, V);
+    if(Polar)
+    {
+      Packet R[9], S[9];
+      batched_polar3x3_from_svd(U, sigma, V, R, S);
+      batched3x3_store(out0+9*j, 9, R, 9);
+      batched3x3_store(out1+9*j, 9, S, 9);
+    }
+    else
+    {
+      batched3x3_store(out0+9*j, 9, U, 9);
+      batched3x3_store(out1+3*j, 3, sigma, 3);
+      batched3x3_store(out2+9*j, 9, V, 9);
+    }
+  }
+  for(Index j=alignedEnd; j<n; ++j)
+  {
+    Scalar A[9], U[9], sigma[3], V[9];
+    batched3x3_load(matrices.data()+j*stride, stride, A);
+    batched_svd3x3_kernel<Sweeps>(A, U, sigma, V);
+    if(Polar)
+      batched_polar3x3_from_svd(U, sigma, V, out0+9*j, out1+rows1*j);
+    else
+    {
+      batched3x3_store(out0+9*j, 1, U, 9);
+      batched3x3_store(out1+rows1*j, 1, sigma, 3);
+      batched3x3_store(out2+9*j, 1, V, 9);
+    }
+  }
+}
+
+} // end namespace internal
+
+/** \ingroup BatchedSVD_Module
+  *
+  * \class BatchedSVD3x3
+  *
+  * \brief Singular value decompositions of a batch of 3x3 matrices
+  *
+  * \tparam _Scalar the scalar type, i.e., float or double
+  * \tparam _Sweeps the number of Jacobi sweeps of the eigenvalue step. The default is 4 for float and 6 for double.
+  *
+  * This class computes the decompositions \f$ A_i = U_i \Sigma_i V_i^T \f$ of many 3x3 matrices at once.
+  * Unlike JacobiSVD, the algorithm does not have any data dependent branch: it performs a fixed number of
+  * Jacobi rotations on \f$ A_i^T A_i \f$, accumulated as a quaternion, followed by a column
+  * sorting and a Givens QR step. This permits to process one matrix per SIMD lane.
+  *
+  * The factors \f$ U_i \f$ and \f$ V_i \f$ are always proper rotations (determinant +1). As a consequence, the
+  * singular values are sorted as \f$ \sigma_0 \geq \sigma_1 \geq |\sigma_2| \f$ and the last one carries the
+  * sign of the determinant of \f$ A_i \f$. This is the convention expected by most physics and shape matching
+  * algorithms.
+  *
+  * The input matrices are the columns of a 9xN matrix, each of them storing one 3x3 matrix in column-major order.
+  * An array of Matrix3f can thus be processed without copy:
+  * \code
+  * std::vector<Matrix3f> F(n);
+  * BatchedSVD3x3<float> svd(Map<const Matrix<float,9,Dynamic> >(F[0].data(), 9, n));
+  * Matrix3f U0 = svd.matrixU(0);
+  * \endcode
+  *
+  * Since the eigenvalues of \f$ A_i^T A_i \f$ are computed, the relative accuracy of the smallest singular values is
+  * limited by the condition number of \f$ A_i \f$. Use JacobiSVD when the smallest singular values must be accurate.
+  *
+  * \sa BatchedPolarDecomposition3x3, class JacobiSVD
+  */
+template<typename _Scalar, int _Sweeps = internal::batched_svd3x3_sweeps<_Scalar>::value>
+class BatchedSVD3x3
+{
+  public:
+    typedef _Scalar Scalar;
+    enum { Sweeps = _Sweeps };
+    typedef Matrix<Scalar,3,3> Matrix3;
+    typedef Matrix<Scalar,3,1> Vector3;
+    typedef Matrix<Scalar,9,Dynamic> MatricesType;
+    typedef Matrix<Scalar,3,Dynamic> SingularValuesType;
+
+    /** \brief Default constructor
+      *
+      * The decompositions will be computed by calling compute().
+      */
+    BatchedSVD3x3() : m_isInitialized(false) {}
+
+    /** \brief Computes the decompositions of the columns of \a matrices.
+      *
+      * \sa compute()
+      */
+    explicit BatchedSVD3x3(const Ref<const MatricesType, 0, OuterStride<> >& matrices)
+      : m_isInitialized(false)
+    {
+      compute(matrices);
+    }
+
+    /** \brief Computes the decompositions of the 3x3 matrices stored as the columns of \a matrices.
+      *
+      * \returns a reference to *this
+      */
+    BatchedSVD3x3& compute(const Ref<const MatricesType, 0, OuterStride<> >& matrices)
+    {
+      m_matricesU.resize(9, matrices.cols());
+      m_singularValues.resize(3, matrices.cols());
+      m_matricesV.resize(9, matrices.cols());
+      internal::batched_svd3x3_run<Sweeps,false>(matrices, m_matricesU.data(), m_singularValues.data(), m_matricesV.data());
+      m_isInitialized = true;
+      return *this;
+    }
+
+    /** \returns the number of decomposed matrices */
+    Index size() const { return m_matricesU.cols(); }
+
+    /** \returns the 9xN matrix of the left rotations \f$ U_i \f$ stored in column-major order */
+    const MatricesType& matricesU() const
+    {
+      eigen_assert(m_isInitialized && "BatchedSVD3x3 is not initialized.");
+      return m_matricesU;
+    }
+
+    /** \returns the 9xN matrix of the right rotations \f$ V_i \f$ stored in column-major order */
+    const MatricesType& matricesV() const
+    {
+      eigen_assert(m_isInitialized && "BatchedSVD3x3 is not initialized.");
+      return m_matricesV;
+    }
+
+    /** \returns the 3xN matrix of the singular values */
+    const SingularValuesType& singularValues() const
+    {
+      eigen_assert(m_isInitialized && "BatchedSVD3x3 is not initialized.");
+      return m_singularValues;
+    }
+
+    /** \returns the left rotation of the \a i-th matrix */
+    Map<const Matrix3> matrixU(Index i) const { return Map<const Matrix3>(matricesU().col(i).data()); }
+
+    /** \returns the right rotation of the \a i-th matrix */
+    Map<const Matrix3> matrixV(Index i) const { return Map<const Matrix3>(matricesV().col(i).data()); }
+
+  protected:
+    MatricesType m_matricesU;
+    MatricesType m_matricesV;
+    SingularValuesType m_singularValues;
+    bool m_isInitialized;
+};
+
+/** \ingroup BatchedSVD_Module
+  *
+  * \class BatchedPolarDecomposition3x3
+  *
+  * \brief Polar decompositions of a batch of 3x3 matrices
+  *
+  * \tparam _Scalar the scalar type, i.e., float or double
+  * \tparam _Sweeps the number of Jacobi sweeps, see BatchedSVD3x3
+  *
+  * This class computes the decompositions \f$ A_i = R_i S_i \f$ where \f$ R_i \f$ is a rotation (determinant +1)
+  * and \f$ S_i \f$ is symmetric. It relies on the same branch-free kernel as BatchedSVD3x3, with
+  * \f$ R_i = U_i V_i^T \f$ and \f$ S_i = V_i \Sigma_i V_i^T \f$. When \f$ \det(A_i) < 0 \f$, \f$ S_i \f$ is indefinite
+  * and \f$ R_i \f$ is the closest rotation to \f$ A_i \f$, as needed for co-rotational elasticity and shape matching.
+  *
+  * The input and output layouts are the same as for BatchedSVD3x3.
+  *
+  * \sa BatchedSVD3x3
+  */
+template<typename _Scalar, int _Sweeps = internal::batched_svd3x3_sweeps<_Scalar>::value>
+class BatchedPolarDecomposition3x3
+{
+  public:
+    typedef _Scalar Scalar;
+    enum { Sweeps = _Sweeps };
+    typedef Matrix<Scalar,3,3> Matrix3;
+    typedef Matrix<Scalar,9,Dynamic> MatricesType;
+
+    /** \brief Default constructor
+      *
+      * The decompositions will be computed by calling compute().
+      */
+    BatchedPolarDecomposition3x3() : m_isInitialized(false) {}
+
+    /** \brief Computes the decompositions of the columns of \a matrices.
+      *
+      * \sa compute()
+      */
+    explicit BatchedPolarDecomposition3x3(const Ref<const MatricesType, 0, OuterStride<> >& matrices)
+      : m_isInitialized(false)
+    {
+      compute(matrices);
+    }
+
+    /** \brief Computes the decompositions of the 3x3 matrices stored as the columns of \a matrices.
+      *
+      * \returns a reference to *this
+      */
+    BatchedPolarDecomposition3x3& compute(const Ref<const MatricesType, 0, OuterStride<> >& matrices)
+    {
+      m_rotations.resize(9, matrices.cols());
+      m_stretches.resize(9, matrices.cols());
+      internal::batched_svd3x3_run<Sweeps,true>(matrices, m_rotations.data(), m_stretches.data(), static_cast<Scalar*>(0));
+      m_isInitialized = true;
+      return *this;
+    }
+
+    /** \returns the number of decomposed matrices */
+    Index size() const { return m_rotations.cols(); }
+
+    /** \returns the 9xN matrix of the rotations \f$ R_i \f$ stored in column-major order */
+    const MatricesType& rotations() const
+    {
+      eigen_assert(m_isInitialized && "BatchedPolarDecomposition3x3 is not initialized.");
+      return m_rotations;
+    }
+
+    /** \returns the 9xN matrix of the symmetric factors \f$ S_i \f$ stored in column-major order */
+    const MatricesType& stretches() const
+    {
+      eigen_assert(m_isInitialized && "BatchedPolarDecomposition3x3 is not initialized.");
+      return m_stretches;
+    }
+
+    /** \returns the rotation of the \a i-th matrix */
+    Map<const Matrix3> rotation(Index i) const { return Map<const Matrix3>(rotations().col(i).data()); }
+
+    /** \returns the symmetric factor of the \a i-th matrix */
+    Map<const Matrix3> stretch(Index i) const { return Map<const Matrix3>(stretches().col(i).data()); }
+
+  protected:
+    MatricesType m_rotations;
+    MatricesType m_stretches;
+    bool m_isInitialized;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_SVD3X3_H
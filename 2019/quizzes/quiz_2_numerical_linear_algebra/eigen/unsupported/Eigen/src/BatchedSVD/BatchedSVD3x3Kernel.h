@@ -0,0 +1,292 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_BATCHED_SVD3X3_KERNEL_H
+#define EIGEN_BATCHED_SVD3X3_KERNEL_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal
+  * \file BatchedSVD3x3Kernel.h
+  *
+  * Branch-free 3x3 SVD kernel, adapted from:
+  *   A. McAdams, A. Selle, R. Tamstorf, J. Teran, E. Sifakis,
+  *   "Computing the Singular Value Decomposition of 3x3 matrices with minimal branching
+  *   and elementary floating point operations", University of Wisconsin-Madison TR1690, 2011.
+  *
+  * All the functions of this file are written in terms of the generic packet primitives, so that
+  * the very same code processes either one matrix (Packet==Scalar) or one matrix per SIMD lane.
+  * 3x3 matrices are passed as arrays of 9 packets in column-major order.
+  *
+  * Unlike the paper, exact Jacobi rotations are used instead of the approximate ones. They are slightly more
+  * expensive but preserve the quadratic convergence of cyclic Jacobi when singular values are close.
+  */
+
+/** \internal Packet type used to process a batch of 3x3 matrices of scalar type \a Scalar.
+  * Falls back to the scalar type when the comparison and selection primitives are not vectorized. */
+template<typename Scalar>
+struct batched_svd3x3_packet
+{
+  typedef typename packet_traits<Scalar>::type PacketType;
+  enum {
+    Vectorize = packet_traits<Scalar>::Vectorizable && packet_traits<Scalar>::HasCmp
+             && packet_traits<Scalar>::HasSqrt && packet_traits<Scalar>::HasDiv
+  };
+  typedef typename conditional<Vectorize, PacketType, Scalar>::type type;
+  enum { size = Vectorize ? int(packet_traits<Scalar>::size) : 1 };
+};
+
+/** \internal Default number of Jacobi sweeps: four sweeps are enough to reach single precision,
+  * the quadratic convergence of cyclic Jacobi doubles the number of correct digits per sweep. */
+template<typename Scalar> struct batched_svd3x3_sweeps { enum { value = 4 }; };
+template<> struct batched_svd3x3_sweeps<double> { enum { value = 6 }; };
+
+/** \internal Computes the Jacobi rotation annihilating the off-diagonal entry of the symmetric 2x2 matrix
+  * [app apq; apq aqq]. The rotation of angle theta, |theta|<=pi/4, is returned both as (\a c, \a s) = (cos, sin)(theta)
+  * and as the half-angle pair (\a ch, \a sh) = (cos, sin)(theta/2) used to accumulate the rotations as a quaternion. */
+template<typename Packet>
+EIGEN_STRONG_INLINE void svd3x3_jacobi_givens(const Packet& app, const Packet& apq, const Packet& aqq,
+                                              Packet& c, Packet& s, Packet& ch, Packet& sh)
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  const Packet zero = pset1<Packet>(Scalar(0));
+  const Packet one = pset1<Packet>(Scalar(1));
+  const Packet half = pset1<Packet>(Scalar(0.5));
+
+  // t = tan(theta) is the smallest root of t^2 + 2 rho t - 1 = 0 with rho = (app-aqq)/(2 apq),
+  // evaluated without dividing by apq.
+  const Packet diff = psub(app, aqq);
+  const Packet two_apq = padd(apq, apq);
+  const Packet num = pselect(pcmp_lt(diff, zero), pnegate(two_apq), two_apq);
+  const Packet den = padd(pabs(diff), psqrt(padd(pmul(diff,diff), pmul(two_apq,two_apq))));
+  const Packet t = pselect(pcmp_lt(zero, den), pdiv(num, den), zero);
+
+  c = prsqrt(padd(one, pmul(t,t)));
+  s = pmul(t, c);
+  ch = psqrt(pmul(half, padd(one, c)));
+  sh = pdiv(pmul(half, s), ch);
+}
+
+/** \internal Conjugates the symmetric matrix \a S by the Jacobi rotation of the plane (P,Q),
+  * and accumulates the rotation into the quaternion \a q stored as (x,y,z,w). */
+template<int P, int Q, typename Packet>
+EIGEN_STRONG_INLINE void svd3x3_jacobi_conjugation(Packet S[9], Packet q[4])
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  // K is the index of the rotation axis, I and J are such that (K,I,J) is a cyclic permutation
+  enum { K = 3-P-Q, I = (K+1)%3, J = (K+2)%3, Cyclic = (Q-P+3)%3==1 };
+
+  Packet c, s, ch, sh;
+  svd3x3_jacobi_givens(S[P+3*P], S[P+3*Q], S[Q+3*Q], c, s, ch, sh);
+
+  const Packet two = pset1<Packet>(Scalar(2));
+  const Packet cc = pmul(c,c);
+  const Packet ss = pmul(s,s);
+  const Packet cs = pmul(c,s);
+
+  // S <- G^T S G
+  const Packet a = S[P+3*P], b = S[P+3*Q], d = S[Q+3*Q];
+  const Packet spk = S[P+3*K], sqk = S[Q+3*K];
+  const Packet two_csb = pmul(two, pmul(cs,b));
+  S[P+3*P] = padd(padd(pmul(cc,a), two_csb), pmul(ss,d));
+  S[Q+3*Q] = padd(psub(pmul(ss,a), two_csb), pmul(cc,d));
+  S[P+3*Q] = S[Q+3*P] = padd(pmul(psub(cc,ss),b), pmul(cs,psub(d,a)));
+  S[P+3*K] = S[K+3*P] = padd(pmul(c,spk), pmul(s,sqk));
+  S[Q+3*K] = S[K+3*Q] = psub(pmul(c,sqk), pmul(s,spk));
+
+  // q <- q * (ch, t e_K), where t = +/-sh depending on the orientation of the (P,Q) plane
+  const Packet t = Cyclic ? sh : pnegate(sh);
+  const Packet qw = q[3], qk = q[K], qi = q[I], qj = q[J];
+  q[3] = psub(pmul(qw,ch), pmul(t,qk));
+  q[K] = padd(pmul(qw,t), pmul(ch,qk));
+  q[I] = padd(pmul(ch,qi), pmul(t,qj));
+  q[J] = psub(pmul(ch,qj), pmul(t,qi));
+}
+
+/** \internal Swaps the columns \a X and \a Y of \a M where \a mask is set, negating the new column Y
+  * so that the determinant is preserved. */
+template<int X, int Y, typename Packet>
+EIGEN_STRONG_INLINE void svd3x3_cond_neg_swap(const Packet& mask, Packet M[9])
+{
+  for(int i=0; i<3; ++i)
+  {
+    const Packet mx = M[i+3*X];
+    M[i+3*X] = pselect(mask, M[i+3*Y], mx);
+    M[i+3*Y] = pselect(mask, pnegate(mx), M[i+3*Y]);
+  }
+}
+
+/** \internal Sorts the columns of \a B (and accordingly of \a V) by decreasing norms. */
+template<int X, int Y, typename Packet>
+EIGEN_STRONG_INLINE void svd3x3_sort_columns(Packet rho[3], Packet B[9], Packet V[9])
+{
+  const Packet mask = pcmp_lt(rho[X], rho[Y]);
+  svd3x3_cond_neg_swap<X,Y>(mask, B);
+  svd3x3_cond_neg_swap<X,Y>(mask, V);
+  const Packet rx = rho[X];
+  rho[X] = pselect(mask, rho[Y], rx);
+  rho[Y] = pselect(mask, rx, rho[Y]);
+}
+
+/** \internal Applies the Givens rotation of the rows (P,Q) of \a B annihilating B(Q,Col),
+  * and accumulates it into the columns of \a U. */
+template<int P, int Q, int Col, typename Packet>
+EIGEN_STRONG_INLINE void svd3x3_qr_givens(Packet B[9], Packet U[9])
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  const Packet eps = pset1<Packet>(NumTraits<Scalar>::epsilon());
+  const Packet zero = pset1<Packet>(Scalar(0));
+  const Packet a1 = B[P+3*Col], a2 = B[Q+3*Col];
+
+  // half-angle formulation, robust to a1<0 and to vanishing columns
+  const Packet rho = psqrt(padd(pmul(a1,a1), pmul(a2,a2)));
+  Packet sh = pselect(pcmp_lt(eps,rho), a2, zero);
+  Packet ch = padd(pabs(a1), pmax(rho,eps));
+  const Packet neg = pcmp_lt(a1, zero);
+  const Packet tmp = ch;
+  ch = pselect(neg, sh, ch);
+  sh = pselect(neg, tmp, sh);
+  const Packet w = prsqrt(padd(pmul(ch,ch), pmul(sh,sh)));
+  ch = pmul(ch,w);
+  sh = pmul(sh,w);
+
+  const Packet c = psub(pmul(ch,ch), pmul(sh,sh));
+  const Packet s = pmul(pset1<Packet>(Scalar(2)), pmul(ch,sh));
+  for(int j=0; j<3; ++j)
+  {
+    // B <- G^T B
+    const Packet bp = B[P+3*j], bq = B[Q+3*j];
+    B[P+3*j] = padd(pmul(c,bp), pmul(s,bq));
+    B[Q+3*j] = psub(pmul(c,bq), pmul(s,bp));
+    // U <- U G
+    const Packet up = U[j+3*P], uq = U[j+3*Q];
+    U[j+3*P] = padd(pmul(c,up), pmul(s,uq));
+    U[j+3*Q] = psub(pmul(c,uq), pmul(s,up));
+  }
+}
+
+/** \internal Computes A = U diag(sigma) V^T where \a U and \a V are rotations (det=+1) and
+  * sigma(0) >= sigma(1) >= |sigma(2)|. The sign of sigma(2) is the sign of det(A).
+  *
+  * \a A, \a U and \a V are 3x3 column-major matrices of packets.
+  */
+template<int Sweeps, typename Packet>
+EIGEN_STRONG_INLINE void batched_svd3x3_kernel(const Packet A[9], Packet U[9], Packet sigma[3], Packet V[9])
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  const Packet zero = pset1<Packet>(Scalar(0));
+  const Packet one  = pset1<Packet>(Scalar(1));
+  const Packet two  = pset1<Packet>(Scalar(2));
+
+  // Scale the input such that its largest entry is one to prevent under/overflows.
+  Packet scale = pabs(A[0]);
+  for(int k=1; k<9; ++k)
+    scale = pmax(scale, pabs(A[k]));
+  scale = pmax(scale, pset1<Packet>((std::numeric_limits<Scalar>::min)()));
+  const Packet inv_scale = pdiv(one, scale);
+  Packet As[9];
+  for(int k=0; k<9; ++k)
+    As[k] = pmul(A[k], inv_scale);
+
+  // S = A^T A
+  Packet S[9];
+  for(int j=0; j<3; ++j)
+    for(int i=j; i<3; ++i)
+      S[i+3*j] = S[j+3*i] = padd(padd(pmul(As[3*i],As[3*j]), pmul(As[3*i+1],As[3*j+1])), pmul(As[3*i+2],As[3*j+2]));
+
+  // Symmetric eigenvalue problem with a fixed number of cyclic Jacobi sweeps
+  Packet q[4] = { zero, zero, zero, one };
+  for(int sweep=0; sweep<Sweeps; ++sweep)
+  {
+    svd3x3_jacobi_conjugation<0,1>(S, q);
+    svd3x3_jacobi_conjugation<1,2>(S, q);
+    svd3x3_jacobi_conjugation<0,2>(S, q);
+  }
+
+  // V is the rotation matrix of the normalized quaternion
+  const Packet n = prsqrt(padd(padd(pmul(q[0],q[0]), pmul(q[1],q[1])), padd(pmul(q[2],q[2]), pmul(q[3],q[3]))));
+  for(int k=0; k<4; ++k)
+    q[k] = pmul(q[k], n);
+  {
+    const Packet qxx = pmul(q[0],q[0]), qyy = pmul(q[1],q[1]), qzz = pmul(q[2],q[2]);
+    const Packet qxy = pmul(q[0],q[1]), qxz = pmul(q[0],q[2]), qyz = pmul(q[1],q[2]);
+    const Packet qwx = pmul(q[3],q[0]), qwy = pmul(q[3],q[1]), qwz = pmul(q[3],q[2]);
+    V[0] = psub(one, pmul(two, padd(qyy,qzz)));
+    V[1] = pmul(two, padd(qxy,qwz));
+    V[2] = pmul(two, psub(qxz,qwy));
+    V[3] = pmul(two, psub(qxy,qwz));
+    V[4] = psub(one, pmul(two, padd(qxx,qzz)));
+    V[5] = pmul(two, padd(qyz,qwx));
+    V[6] = pmul(two, padd(qxz,qwy));
+    V[7] = pmul(two, psub(qyz,qwx));
+    V[8] = psub(one, pmul(two, padd(qxx,qyy)));
+  }
+
+  // B = A V
+  Packet B[9];
+  for(int j=0; j<3; ++j)
+    for(int i=0; i<3; ++i)
+      B[i+3*j] = padd(padd(pmul(As[i],V[3*j]), pmul(As[i+3],V[3*j+1])), pmul(As[i+6],V[3*j+2]));
+
+  // Sort the columns of B by decreasing norms
+  Packet rho[3];
+  for(int j=0; j<3; ++j)
+    rho[j] = padd(padd(pmul(B[3*j],B[3*j]), pmul(B[3*j+1],B[3*j+1])), pmul(B[3*j+2],B[3*j+2]));
+  svd3x3_sort_columns<0,1>(rho, B, V);
+  svd3x3_sort_columns<0,2>(rho, B, V);
+  svd3x3_sort_columns<1,2>(rho, B, V);
+
+  // QR decomposition of B by Givens rotations: B = U R with R diagonal up to round-off errors
+  for(int k=0; k<9; ++k)
+    U[k] = (k%4==0) ? one : zero;
+  svd3x3_qr_givens<0,1,0>(B, U);
+  svd3x3_qr_givens<0,2,0>(B, U);
+  svd3x3_qr_givens<1,2,1>(B, U);
+
+  sigma[0] = pmul(B[0], scale);
+  sigma[1] = pmul(B[4], scale);
+  sigma[2] = pmul(B[8], scale);
+}
+
+/** \internal Computes the polar decomposition A = R S from the output of batched_svd3x3_kernel,
+  * with R = U V^T a rotation and S = V diag(sigma) V^T symmetric. */
+template<typename Packet>
+EIGEN_STRONG_INLINE void batched_polar3x3_from_svd(const Packet U[9], const Packet sigma[3], const Packet V[9], Packet R[9], Packet S[9])
+{
+  for(int j=0; j<3; ++j)
+  {
+    for(int i=0; i<3; ++i)
+      R[i+3*j] = padd(padd(pmul(U[i],V[j]), pmul(U[i+3],V[j+3])), pmul(U[i+6],V[j+6]));
+    for(int i=j; i<3; ++i)
+      S[i+3*j] = S[j+3*i] = padd(padd(pmul(pmul(V[i],sigma[0]),V[j]), pmul(pmul(V[i+3],sigma[1]),V[j+3])),
+                                 pmul(pmul(V[i+6],sigma[2]),V[j+6]));
+  }
+}
+
+/** \internal Loads \a n 3x3 matrices stored as consecutive columns of \a data (stride \a outerStride
+  * between two matrices) into 9 packets, one matrix per lane. */
+template<typename Packet, typename Scalar>
+EIGEN_STRONG_INLINE void batched3x3_load(const Scalar* data, Index outerStride, Packet M[9])
+{
+  for(int k=0; k<9; ++k)
+    M[k] = pgather<Scalar,Packet>(data+k, outerStride);
+}
+
+template<typename Packet, typename Scalar>
+EIGEN_STRONG_INLINE void batched3x3_store(Scalar* data, Index outerStride, const Packet* M, int rows)
+{
+  for(int k=0; k<rows; ++k)
+    pscatter<Scalar,Packet>(data+k, M[k], outerStride);
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_BATCHED_SVD3X3_KERNEL_H
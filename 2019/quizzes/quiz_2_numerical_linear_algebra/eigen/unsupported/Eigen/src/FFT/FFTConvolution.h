@@ -0,0 +1,283 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_FFT_CONVOLUTION_H
+#define EIGEN_FFT_CONVOLUTION_H
+
+namespace Eigen {
+
+namespace internal {
+
+// smallest power of two not smaller than n and minSize, whose FFTs only use the vectorized radix 2, 4 and 8 butterflies
+inline int fft_fast_size(int n, int minSize)
+{
+  int size = minSize;
+  while (size < n)
+    size *= 2;
+  return size;
+}
+
+inline double fft_log2(double x) { using std::log; return log(x) / log(2.); }
+
+} // end namespace internal
+
+/** \ingroup FFT_Module
+  *
+  * \class FFTConvolution
+  *
+  * \brief Convolution and correlation of real signals and images
+  *
+  * \tparam _Scalar the real scalar type
+  *
+  * This class computes the 1-d convolutions of vectors and the 2-d convolutions of matrices, either directly or with
+  * FFTs. The 2-d transforms run real-to-complex FFTs along the columns, which halves the work of the complex FFTs along
+  * the rows. Signals much longer than the kernel are split into blocks whose convolutions are added (overlap-add), such
+  * that the FFT sizes are only a few times the kernel size. The FFT plans are kept from one call to the next.
+  *
+  * With the \c Automatic method, the direct and the FFT-based convolutions are chosen by comparing their estimated
+  * costs: the direct convolution costs one multiply-add per output coefficient and kernel coefficient, while the FFTs
+  * of size \c M cost about \c 3M \c log2(M) operations. Kernels smaller than about 9x9 coefficients in 2-d, or 100
+  * coefficients in 1-d, are thus convolved directly, and larger ones with FFTs.
+  *
+  * Example:
+  * \code
+  * FFTConvolution<float> conv;
+  * MatrixXf blurred;
+  * conv.convolve(blurred, image, gaussianKernel, FFTConvolution<float>::Same);
+  * \endcode
+  *
+  * \sa FFT
+  */
+template <typename _Scalar>
+class FFTConvolution
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef std::complex<Scalar> Complex;
+    typedef DenseIndex Index;
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+    typedef Matrix<Complex,Dynamic,Dynamic> ComplexMatrixType;
+
+    /** The parts of the full convolution which are returned. */
+    enum Mode {
+      Full,  ///< the full convolution, of size (n+k-1) along each axis for a signal of size n and a kernel of size k
+      Same,  ///< the central part of the full convolution, of the size of the signal
+      Valid  ///< the part of the full convolution computed without the zero padding of the signal, of size (n-k+1)
+    };
+
+    /** The algorithms used to compute the convolutions. */
+    enum Method {
+      Automatic, ///< the cheapest of the two following methods, according to the cost model
+      Direct,    ///< direct summation of the products of the signal and kernel coefficients
+      Fourier    ///< products of the FFTs of the signal and of the kernel
+    };
+
+    explicit FFTConvolution(Method method = Automatic) : m_method(method), m_usedFourier(false)
+    {
+      m_fft.SetFlag(FFT<Scalar>::HalfSpectrum);
+    }
+
+    /** Sets the algorithm used by the next convolutions. */
+    void setMethod(Method method) { m_method = method; }
+
+    /** \returns the algorithm used by the convolutions */
+    Method method() const { return m_method; }
+
+    /** \returns true if the last convolution was computed with FFTs */
+    bool usedFourier() const { return m_usedFourier; }
+
+    /** Computes the convolution \a dst of \a signal by \a kernel. If both are row vectors, the 1-d convolution is
+      * computed along the rows, otherwise along the columns and the rows. */
+    template<typename DstDerived, typename SignalDerived, typename KernelDerived>
+    void convolve(MatrixBase<DstDerived> & dst, const MatrixBase<SignalDerived> & signal, const MatrixBase<KernelDerived> & kernel,
+                  Mode mode = Full)
+    {
+      compute(dst, signal, kernel, mode, false);
+    }
+
+    /** Computes the correlation \a dst of \a signal with \a kernel, that is the convolution of \a signal by \a kernel
+      * reversed along each axis. The coefficients of the \c Valid correlation are the dot products of \a kernel with
+      * the blocks of \a signal of the same size, which are used for template matching. */
+    template<typename DstDerived, typename SignalDerived, typename KernelDerived>
+    void correlate(MatrixBase<DstDerived> & dst, const MatrixBase<SignalDerived> & signal, const MatrixBase<KernelDerived> & kernel,
+                   Mode mode = Full)
+    {
+      compute(dst, signal, kernel, mode, true);
+    }
+
+    /** \returns the FFT object whose plans are reused by the convolutions */
+    FFT<Scalar> & fft() { return m_fft; }
+
+  protected:
+    template<typename DstDerived, typename SignalDerived, typename KernelDerived>
+    void compute(MatrixBase<DstDerived> & dst, const MatrixBase<SignalDerived> & signal, const MatrixBase<KernelDerived> & kernel,
+                 Mode mode, bool correlation)
+    {
+      EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename SignalDerived::Scalar>::value
+                           && internal::is_same<Scalar, typename KernelDerived::Scalar>::value),
+            YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+      eigen_assert(signal.size() > 0 && kernel.size() > 0);
+
+      MatrixType result;
+      // row vectors are processed as columns, such that the real transforms run along them
+      if ( signal.rows() == 1 && kernel.rows() == 1 ) {
+        run(result, signal.transpose(), kernel.transpose(), mode, correlation);
+        dst.derived() = result.transpose();
+      }else{
+        run(result, signal, kernel, mode, correlation);
+        dst.derived() = result;
+      }
+    }
+
+    // the size and the offset of the part of the full convolution returned along an axis
+    static void outputRange(Index n, Index k, Mode mode, Index & offset, Index & size)
+    {
+      switch (mode) {
+        case Same:  offset = k/2; size = n; break;
+        case Valid: offset = k-1; size = (std::max)(n-k+1, Index(0)); break;
+        default:    offset = 0; size = n+k-1; break;
+      }
+    }
+
+    // the FFT size and the length of the blocks of the signal convolved by the overlap-add method along an axis,
+    // the FFT size being at least minSize
+    static void blockSizes(Index n, Index k, int minSize, Index & fftSize, Index & blockSize)
+    {
+      Index fullSize = internal::fft_fast_size(static_cast<int>(n+k-1), minSize);
+      fftSize = internal::fft_fast_size(static_cast<int>((std::max)(4*k, Index(64))), minSize);
+      if ( fullSize <= fftSize ) {
+        fftSize = fullSize;
+        blockSize = n;
+      }else{
+        blockSize = fftSize - k + 1;
+      }
+    }
+
+    void run(MatrixType & result, const Ref<const MatrixType> & x, const Ref<const MatrixType> & k, Mode mode, bool correlation)
+    {
+      Index r0, c0, rows, cols;
+      outputRange(x.rows(), k.rows(), mode, r0, rows);
+      outputRange(x.cols(), k.cols(), mode, c0, cols);
+      result.setZero(rows, cols);
+      m_usedFourier = false;
+      if ( rows == 0 || cols == 0 )
+        return;
+
+      const MatrixType kernel = correlation ? MatrixType(k.reverse()) : MatrixType(k);
+      Index mr, lr, mc, lc;
+      // the real FFTs along the columns need 4 coefficients, while a single column is not transformed along the rows
+      blockSizes(x.rows(), k.rows(), 4, mr, lr);
+      blockSizes(x.cols(), k.cols(), 1, mc, lc);
+
+      m_usedFourier = m_method == Fourier;
+      if ( m_method == Automatic ) {
+        const double directCost = double(rows) * cols * k.size();
+        const double blocks = double((x.rows() + lr - 1) / lr) * double((x.cols() + lc - 1) / lc);
+        // calibrated such that the two costs are about proportional to the run times
+        const double fftCost = 3 * double(mr) * double(mc) * (2 + internal::fft_log2(double(mr) * double(mc)));
+        m_usedFourier = (blocks + 1) * fftCost < directCost;
+      }
+
+      if ( m_usedFourier )
+        fourier(result, x, kernel, r0, c0, mr, lr, mc, lc);
+      else
+        direct(result, x, kernel, r0, c0);
+    }
+
+    // adds the products of each kernel coefficient with the signal, shifted, to the output
+    static void direct(MatrixType & result, const Ref<const MatrixType> & x, const MatrixType & kernel, Index r0, Index c0)
+    {
+      for (Index b = 0; b < kernel.cols(); ++b) {
+        const Index j0 = (std::max)(b, c0), j1 = (std::min)(b + x.cols(), c0 + result.cols());
+        if ( j0 >= j1 )
+          continue;
+        for (Index a = 0; a < kernel.rows(); ++a) {
+          const Index i0 = (std::max)(a, r0), i1 = (std::min)(a + x.rows(), r0 + result.rows());
+          if ( i0 >= i1 )
+            continue;
+          result.block(i0 - r0, j0 - c0, i1 - i0, j1 - j0) += kernel(a,b) * x.block(i0 - a, j0 - b, i1 - i0, j1 - j0);
+        }
+      }
+    }
+
+    // overlap-add convolution of the blocks of lr x lc coefficients of the signal, by FFTs of size mr x mc
+    void fourier(MatrixType & result, const Ref<const MatrixType> & x, const MatrixType & kernel, Index r0, Index c0,
+                 Index mr, Index lr, Index mc, Index lc)
+    {
+      ComplexMatrixType kernelSpectrum, spectrum;
+      MatrixType block;
+      forward(kernelSpectrum, kernel, mr, mc);
+      for (Index bc = 0; bc < x.cols(); bc += lc) {
+        for (Index br = 0; br < x.rows(); br += lr) {
+          const Index h = (std::min)(lr, x.rows() - br), w = (std::min)(lc, x.cols() - bc);
+          // the part of the output overlapped by the full convolution of this block
+          const Index i0 = (std::max)(br, r0), i1 = (std::min)(br + h + kernel.rows() - 1, r0 + result.rows());
+          const Index j0 = (std::max)(bc, c0), j1 = (std::min)(bc + w + kernel.cols() - 1, c0 + result.cols());
+          if ( i0 >= i1 || j0 >= j1 )
+            continue;
+          forward(spectrum, x.block(br, bc, h, w), mr, mc);
+          spectrum.array() *= kernelSpectrum.array();
+          inverse(block, spectrum, mr, mc, i1 - br, j1 - bc);
+          result.block(i0 - r0, j0 - c0, i1 - i0, j1 - j0) += block.block(i0 - br, j0 - bc, i1 - i0, j1 - j0);
+        }
+      }
+    }
+
+    // the half spectrum of the zero padded mr x mc matrix src, stored transposed, as a mc x (mr/2+1) matrix
+    void forward(ComplexMatrixType & spectrum, const Ref<const MatrixType> & src, Index mr, Index mc)
+    {
+      const Index halfSize = mr/2 + 1;
+      m_real.setZero(mr);
+      m_half.resize(halfSize);
+      m_transposed.resize(mc, halfSize);
+      m_transposed.bottomRows(mc - src.cols()).setZero();
+      for (Index j = 0; j < src.cols(); ++j) {
+        m_real.head(src.rows()) = src.col(j);
+        m_fft.fwd(m_half.data(), m_real.data(), mr);
+        m_transposed.row(j) = m_half.transpose();
+      }
+      if ( mc == 1 ) {
+        spectrum = m_transposed;
+        return;
+      }
+      spectrum.resize(mc, halfSize);
+      for (Index f = 0; f < halfSize; ++f)
+        m_fft.fwd(spectrum.col(f).data(), m_transposed.col(f).data(), mc);
+    }
+
+    // the top left rows x cols block of the inverse FFT of the spectrum computed by forward()
+    void inverse(MatrixType & dst, const ComplexMatrixType & spectrum, Index mr, Index mc, Index rows, Index cols)
+    {
+      const Index halfSize = mr/2 + 1;
+      if ( mc == 1 ) {
+        m_transposed = spectrum;
+      }else{
+        m_transposed.resize(mc, halfSize);
+        for (Index f = 0; f < halfSize; ++f)
+          m_fft.inv(m_transposed.col(f).data(), spectrum.col(f).data(), mc);
+      }
+      m_real.resize(mr);
+      m_half.resize(halfSize);
+      dst.resize(rows, cols);
+      for (Index j = 0; j < cols; ++j) {
+        m_half = m_transposed.row(j).transpose();
+        m_fft.inv(m_real.data(), m_half.data(), mr);
+        dst.col(j) = m_real.head(rows);
+      }
+    }
+
+    FFT<Scalar> m_fft;
+    Method m_method;
+    bool m_usedFourier;
+    Matrix<Scalar,Dynamic,1> m_real;
+    Matrix<Complex,Dynamic,1> m_half;
+    ComplexMatrixType m_transposed;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_FFT_CONVOLUTION_H
@@ -19,10 +19,18 @@ struct kiss_cpx_fft
 {
   typedef _Scalar Scalar;
   typedef std::complex<Scalar> Complex;
+  typedef typename packet_traits<Complex>::type Packet;
+  enum { PacketSize = unpacket_traits<Packet>::size };
   std::vector<Complex> m_twiddles;
   std::vector<int> m_stageRadix;
   std::vector<int> m_stageRemainder;
-  std::vector<Complex> m_scratchBuf;
+  // twiddles of the radix 2, 4 and 8 stages, stored contiguously for the vectorized butterflies
+  std::vector<Complex> m_stageTwiddles;
+  std::vector<size_t> m_stageTwiddleOffset;
+  // scratch buffer of the generic butterflies, made of m_scratchSlices slices of the largest generic radix,
+  // such that the threads sharing a plan each write to their own slice
+  mutable std::vector<Complex> m_scratchBuf;
+  int m_scratchSlices;
   bool m_inverse;
 
   inline
@@ -36,14 +44,27 @@ struct kiss_cpx_fft
         m_twiddles[i] = exp( Complex(0,i*phinc) );
     }
 
+  // turns the plan of the transform in the other direction into this one
+  inline
+    void make_conjugate(const kiss_cpx_fft & other)
+    {
+      *this = other;
+      m_inverse = !other.m_inverse;
+      for (size_t i=0;i<m_twiddles.size();++i)
+        m_twiddles[i] = conj(m_twiddles[i]);
+      for (size_t i=0;i<m_stageTwiddles.size();++i)
+        m_stageTwiddles[i] = conj(m_stageTwiddles[i]);
+    }
+
   void factorize(int nfft)
   {
-    //start factoring out 4's, then 2's, then 3,5,7,9,...
+    //start factoring out 8's, then 4's, then 2's, then 3,5,7,9,...
     int n= nfft;
-    int p=4;
+    int p=8;
     do {
       while (n % p) {
         switch (p) {
+          case 8: p = 4; break;
           case 4: p = 2; break;
           case 2: p = 3; break;
           default: p += 2; break;
@@ -54,14 +75,45 @@ struct kiss_cpx_fft
       n /= p;
       m_stageRadix.push_back(p);
       m_stageRemainder.push_back(n);
-      if ( p > 5 )
-        m_scratchBuf.resize(p); // scratchbuf will be needed in bfly_generic
     }while(n>1);
+
+    // the twiddles of the q-th leg of the k-th butterfly of a stage are m_twiddles[q*k*fstride]
+    size_t fstride = 1;
+    m_stageTwiddleOffset.resize(m_stageRadix.size());
+    for (size_t stage=0;stage<m_stageRadix.size();++stage) {
+      int radix = m_stageRadix[stage];
+      int m = m_stageRemainder[stage];
+      m_stageTwiddleOffset[stage] = m_stageTwiddles.size();
+      if (radix==2 || radix==4 || radix==8)
+        for (int q=1;q<radix;++q)
+          for (int k=0;k<m;++k)
+            m_stageTwiddles.push_back(m_twiddles[q*k*fstride]);
+      fstride *= radix;
+    }
+
+    int maxGenericRadix = 0;
+    for (size_t stage=0;stage<m_stageRadix.size();++stage) {
+      int radix = m_stageRadix[stage];
+      if (radix!=2 && radix!=3 && radix!=4 && radix!=5 && radix!=8)
+        maxGenericRadix = (std::max)(maxGenericRadix, radix);
+    }
+    m_scratchSlices = 1;
+#ifdef EIGEN_HAS_OPENMP
+    if (maxGenericRadix > 0)
+      m_scratchSlices = nbThreads();
+#endif
+    m_scratchBuf.resize(size_t(maxGenericRadix) * m_scratchSlices);
+  }
+
+  // \returns the largest number of threads which can share this plan
+  int maxThreads() const
+  {
+    return m_scratchBuf.empty() ? NumTraits<int>::highest() : m_scratchSlices;
   }
 
   template <typename _Src>
     inline
-    void work( int stage,Complex * xout, const _Src * xin, size_t fstride,size_t in_stride)
+    void work( int stage,Complex * xout, const _Src * xin, size_t fstride,size_t in_stride) const
     {
       int p = m_stageRadix[stage];
       int m = m_stageRemainder[stage];
@@ -86,54 +138,120 @@ struct kiss_cpx_fft
       xout=Fout_beg;
 
       // recombine the p smaller DFTs 
+      const Complex * tw = (p==2 || p==4 || p==8) ? &m_stageTwiddles[m_stageTwiddleOffset[stage]] : 0;
       switch (p) {
-        case 2: bfly2(xout,fstride,m); break;
+        case 2: bfly2(xout,tw,m); break;
         case 3: bfly3(xout,fstride,m); break;
-        case 4: bfly4(xout,fstride,m); break;
+        case 4: bfly4(xout,tw,m); break;
         case 5: bfly5(xout,fstride,m); break;
+        case 8: bfly8(xout,tw,m); break;
         default: bfly_generic(xout,fstride,m,p); break;
       }
     }
 
+  // multiplies by -i for the forward transform, and by i for the inverse one
+  template <typename _Packet>
+  EIGEN_STRONG_INLINE
+    _Packet rotate(const _Packet & x) const
+    {
+      return m_inverse ? pcplxflip(pconj(x)) : pconj(pcplxflip(x));
+    }
+
+  // The butterflies of radix 2, 4 and 8 process PacketSize butterflies at once with
+  // _Packet==Packet, and the remaining ones with _Packet==Complex.
+  template <typename _Packet>
+  EIGEN_STRONG_INLINE
+    void bfly2_kernel( Complex * Fout, const Complex * tw, int m, int k) const
+    {
+      _Packet t = pmul(ploadu<_Packet>(Fout+m+k), ploadu<_Packet>(tw+k));
+      _Packet a = ploadu<_Packet>(Fout+k);
+      pstoreu(Fout+m+k, psub(a,t));
+      pstoreu(Fout+k, padd(a,t));
+    }
+
   inline
-    void bfly2( Complex * Fout, const size_t fstride, int m)
+    void bfly2( Complex * Fout, const Complex * tw, int m) const
     {
-      for (int k=0;k<m;++k) {
-        Complex t = Fout[m+k] * m_twiddles[k*fstride];
-        Fout[m+k] = Fout[k] - t;
-        Fout[k] += t;
-      }
+      int k=0;
+      for (;k+PacketSize<=m;k+=PacketSize)
+        bfly2_kernel<Packet>(Fout,tw,m,k);
+      for (;k<m;++k)
+        bfly2_kernel<Complex>(Fout,tw,m,k);
+    }
+
+  template <typename _Packet>
+  EIGEN_STRONG_INLINE
+    void bfly4_kernel( Complex * Fout, const Complex * tw, int m, int k) const
+    {
+      _Packet x0 = ploadu<_Packet>(Fout+k);
+      _Packet x1 = pmul(ploadu<_Packet>(Fout+k+m), ploadu<_Packet>(tw+k));
+      _Packet x2 = pmul(ploadu<_Packet>(Fout+k+2*m), ploadu<_Packet>(tw+m+k));
+      _Packet x3 = pmul(ploadu<_Packet>(Fout+k+3*m), ploadu<_Packet>(tw+2*m+k));
+      _Packet a0 = padd(x0,x2), a1 = psub(x0,x2);
+      _Packet b0 = padd(x1,x3), b1 = rotate(psub(x1,x3));
+      pstoreu(Fout+k, padd(a0,b0));
+      pstoreu(Fout+k+m, padd(a1,b1));
+      pstoreu(Fout+k+2*m, psub(a0,b0));
+      pstoreu(Fout+k+3*m, psub(a1,b1));
     }
 
   inline
-    void bfly4( Complex * Fout, const size_t fstride, const size_t m)
+    void bfly4( Complex * Fout, const Complex * tw, int m) const
     {
-      Complex scratch[6];
-      int negative_if_inverse = m_inverse * -2 +1;
-      for (size_t k=0;k<m;++k) {
-        scratch[0] = Fout[k+m] * m_twiddles[k*fstride];
-        scratch[1] = Fout[k+2*m] * m_twiddles[k*fstride*2];
-        scratch[2] = Fout[k+3*m] * m_twiddles[k*fstride*3];
-        scratch[5] = Fout[k] - scratch[1];
-
-        Fout[k] += scratch[1];
-        scratch[3] = scratch[0] + scratch[2];
-        scratch[4] = scratch[0] - scratch[2];
-        scratch[4] = Complex( scratch[4].imag()*negative_if_inverse , -scratch[4].real()* negative_if_inverse );
-
-        Fout[k+2*m]  = Fout[k] - scratch[3];
-        Fout[k] += scratch[3];
-        Fout[k+m] = scratch[5] + scratch[4];
-        Fout[k+3*m] = scratch[5] - scratch[4];
-      }
+      int k=0;
+      for (;k+PacketSize<=m;k+=PacketSize)
+        bfly4_kernel<Packet>(Fout,tw,m,k);
+      for (;k<m;++k)
+        bfly4_kernel<Complex>(Fout,tw,m,k);
+    }
+
+  template <typename _Packet>
+  EIGEN_STRONG_INLINE
+    void bfly8_kernel( Complex * Fout, const Complex * tw, int m, int k) const
+    {
+      const _Packet sqrt1_2 = pset1<_Packet>(Complex(Scalar(0.707106781186547524400844362104849039L),Scalar(0)));
+      _Packet x[8];
+      x[0] = ploadu<_Packet>(Fout+k);
+      for (int q=1;q<8;++q)
+        x[q] = pmul(ploadu<_Packet>(Fout+k+q*m), ploadu<_Packet>(tw+(q-1)*m+k));
+
+      // two DFTs of size 4 of the even and odd legs
+      _Packet a0 = padd(x[0],x[4]), a1 = psub(x[0],x[4]), a2 = padd(x[2],x[6]), a3 = rotate(psub(x[2],x[6]));
+      _Packet b0 = padd(x[1],x[5]), b1 = psub(x[1],x[5]), b2 = padd(x[3],x[7]), b3 = rotate(psub(x[3],x[7]));
+      _Packet e0 = padd(a0,a2), e1 = padd(a1,a3), e2 = psub(a0,a2), e3 = psub(a1,a3);
+      _Packet o0 = padd(b0,b2), o1 = padd(b1,b3), o2 = psub(b0,b2), o3 = psub(b1,b3);
+
+      // multiply the odd DFT by the twiddles of the eighth roots of unity
+      o1 = pmul(sqrt1_2, padd(o1,rotate(o1)));
+      o2 = rotate(o2);
+      o3 = pmul(sqrt1_2, psub(rotate(o3),o3));
+
+      pstoreu(Fout+k, padd(e0,o0));
+      pstoreu(Fout+k+m, padd(e1,o1));
+      pstoreu(Fout+k+2*m, padd(e2,o2));
+      pstoreu(Fout+k+3*m, padd(e3,o3));
+      pstoreu(Fout+k+4*m, psub(e0,o0));
+      pstoreu(Fout+k+5*m, psub(e1,o1));
+      pstoreu(Fout+k+6*m, psub(e2,o2));
+      pstoreu(Fout+k+7*m, psub(e3,o3));
+    }
+
+  inline
+    void bfly8( Complex * Fout, const Complex * tw, int m) const
+    {
+      int k=0;
+      for (;k+PacketSize<=m;k+=PacketSize)
+        bfly8_kernel<Packet>(Fout,tw,m,k);
+      for (;k<m;++k)
+        bfly8_kernel<Complex>(Fout,tw,m,k);
     }
 
   inline
-    void bfly3( Complex * Fout, const size_t fstride, const size_t m)
+    void bfly3( Complex * Fout, const size_t fstride, const size_t m) const
     {
       size_t k=m;
       const size_t m2 = 2*m;
-      Complex *tw1,*tw2;
+      const Complex *tw1,*tw2;
       Complex scratch[5];
       Complex epi3;
       epi3 = m_twiddles[fstride*m];
@@ -158,13 +276,13 @@ struct kiss_cpx_fft
     }
 
   inline
-    void bfly5( Complex * Fout, const size_t fstride, const size_t m)
+    void bfly5( Complex * Fout, const size_t fstride, const size_t m) const
     {
       Complex *Fout0,*Fout1,*Fout2,*Fout3,*Fout4;
       size_t u;
       Complex scratch[13];
-      Complex * twiddles = &m_twiddles[0];
-      Complex *tw;
+      const Complex * twiddles = &m_twiddles[0];
+      const Complex *tw;
       Complex ya,yb;
       ya = twiddles[fstride*m];
       yb = twiddles[fstride*2*m];
@@ -230,13 +348,17 @@ struct kiss_cpx_fft
         const size_t fstride,
         int m,
         int p
-        )
+        ) const
     {
       int u,k,q1,q;
-      Complex * twiddles = &m_twiddles[0];
+      const Complex * twiddles = &m_twiddles[0];
       Complex t;
       int Norig = static_cast<int>(m_twiddles.size());
-      Complex * scratchbuf = &m_scratchBuf[0];
+      int slice = 0;
+#ifdef EIGEN_HAS_OPENMP
+      slice = omp_get_thread_num() % m_scratchSlices;
+#endif
+      Complex * scratchbuf = &m_scratchBuf[size_t(slice) * (m_scratchBuf.size() / m_scratchSlices)];
 
       for ( u=0; u<m; ++u ) {
         k=u;
@@ -279,22 +401,34 @@ struct kissfft_impl
       get_plan(nfft,false).work(0, dst, src, 1,1);
     }
 
+  // 2-d complex-to-complex, the n0 x n1 array being stored with n1 as the contiguous dimension
   inline
     void fwd2( Complex * dst,const Complex *src,int n0,int n1)
     {
-        EIGEN_UNUSED_VARIABLE(dst);
-        EIGEN_UNUSED_VARIABLE(src);
-        EIGEN_UNUSED_VARIABLE(n0);
-        EIGEN_UNUSED_VARIABLE(n1);
+      int dims[2] = {n0,n1};
+      work_nd(dst,src,dims,2,false);
     }
 
   inline
     void inv2( Complex * dst,const Complex *src,int n0,int n1)
     {
-        EIGEN_UNUSED_VARIABLE(dst);
-        EIGEN_UNUSED_VARIABLE(src);
-        EIGEN_UNUSED_VARIABLE(n0);
-        EIGEN_UNUSED_VARIABLE(n1);
+      int dims[2] = {n0,n1};
+      work_nd(dst,src,dims,2,true);
+    }
+
+  // 3-d complex-to-complex, the n0 x n1 x n2 array being stored with n2 as the contiguous dimension
+  inline
+    void fwd3( Complex * dst,const Complex *src,int n0,int n1,int n2)
+    {
+      int dims[3] = {n0,n1,n2};
+      work_nd(dst,src,dims,3,false);
+    }
+
+  inline
+    void inv3( Complex * dst,const Complex *src,int n0,int n1,int n2)
+    {
+      int dims[3] = {n0,n1,n2};
+      work_nd(dst,src,dims,3,true);
     }
 
   // real-to-complex forward FFT
@@ -388,28 +522,108 @@ struct kissfft_impl
   inline
     PlanData & get_plan(int nfft, bool inverse)
     {
-      // TODO look for PlanKey(nfft, ! inverse) and conjugate the twiddles
-      PlanData & pd = m_plans[ PlanKey(nfft,inverse) ];
-      if ( pd.m_twiddles.size() == 0 ) {
-        pd.make_twiddles(nfft,inverse);
-        pd.factorize(nfft);
+      // the plans are looked up and built in a critical section, such that the threads of a parallel
+      // region of the caller can share this object
+      PlanData * pd;
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp critical (EigenKissfftPlans)
+#endif
+      {
+        pd = &m_plans[ PlanKey(nfft,inverse) ];
+        if ( pd->m_twiddles.size() == 0 ) {
+          typename PlanMap::const_iterator other = m_plans.find( PlanKey(nfft,!inverse) );
+          if ( other != m_plans.end() && other->second.m_twiddles.size() ) {
+            pd->make_conjugate(other->second);
+          }else{
+            pd->make_twiddles(nfft,inverse);
+            pd->factorize(nfft);
+          }
+        }
+      }
+      return *pd;
+    }
+
+  // multi-dimensional transform of a row-major array, computed by 1-d transforms along each axis
+  inline
+    void work_nd( Complex * dst,const Complex *src,const int * dims,int rank,bool inverse)
+    {
+      int inner = 1;
+      for (int axis=rank-1;axis>=0;--axis) {
+        int outer = 1;
+        for (int i=0;i<axis;++i)
+          outer *= dims[i];
+        // the plans are read-only from here, such that the threads can share them
+        work_axis(dst, axis==rank-1 ? src : dst, outer, dims[axis], inner, get_plan(dims[axis],inverse));
+        inner *= dims[axis];
+      }
+    }
+
+  // transforms the outer x inner sequences of length n, separated by inner elements, of the outer x n x inner array src.
+  // The sequences are gathered by blocks of contiguous elements, such that the strided accesses use whole cache lines.
+  inline
+    void work_axis( Complex * dst,const Complex *src,int outer,int n,int inner,const PlanData & plan)
+    {
+      const int blockSize = inner==1 ? 1 : 16;
+      const int blocksPerOuter = (inner + blockSize - 1) / blockSize;
+      const int tasks = outer * blocksPerOuter;
+#ifdef EIGEN_HAS_OPENMP
+      int threads = 1;
+      if ( tasks > 1 && double(outer) * n * inner >= 32768 && omp_get_num_threads() == 1 ) {
+        Eigen::initParallel();
+        threads = (std::min)((std::min)(nbThreads(), tasks), plan.maxThreads());
+      }
+      #pragma omp parallel num_threads(threads)
+#endif
+      {
+        std::vector<Complex> gathered(blockSize * n), transformed(blockSize * n);
+#ifdef EIGEN_HAS_OPENMP
+        #pragma omp for schedule(static)
+#endif
+        for (int task=0;task<tasks;++task) {
+          const int o = task / blocksPerOuter;
+          const int c0 = (task % blocksPerOuter) * blockSize;
+          const int width = (std::min)(blockSize, inner - c0);
+          const Complex * in = src + size_t(o) * n * inner + c0;
+          Complex * out = dst + size_t(o) * n * inner + c0;
+          if ( inner == 1 ) {
+            if ( in == out ) { // the transform is out of place
+              std::copy(in, in + n, gathered.begin());
+              in = &gathered[0];
+            }
+            plan.work(0, out, in, 1, 1);
+            continue;
+          }
+          for (int i=0;i<n;++i)
+            for (int b=0;b<width;++b)
+              gathered[b*n+i] = in[size_t(i)*inner+b];
+          for (int b=0;b<width;++b)
+            plan.work(0, &transformed[b*n], &gathered[b*n], 1, 1);
+          for (int i=0;i<n;++i)
+            for (int b=0;b<width;++b)
+              out[size_t(i)*inner+b] = transformed[b*n+i];
+        }
       }
-      return pd;
     }
 
   inline
     Complex * real_twiddles(int ncfft2)
     {
       using std::acos;
-      std::vector<Complex> & twidref = m_realTwiddles[ncfft2];// creates new if not there
-      if ( (int)twidref.size() != ncfft2 ) {
-        twidref.resize(ncfft2);
-        int ncfft= ncfft2<<1;
-        Scalar pi =  acos( Scalar(-1) );
-        for (int k=1;k<=ncfft2;++k) 
-          twidref[k-1] = exp( Complex(0,-pi * (Scalar(k) / ncfft + Scalar(.5)) ) );
+      std::vector<Complex> * twidref;
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp critical (EigenKissfftPlans)
+#endif
+      {
+        twidref = &m_realTwiddles[ncfft2];// creates new if not there
+        if ( (int)twidref->size() != ncfft2 ) {
+          twidref->resize(ncfft2);
+          int ncfft= ncfft2<<1;
+          Scalar pi =  acos( Scalar(-1) );
+          for (int k=1;k<=ncfft2;++k)
+            (*twidref)[k-1] = exp( Complex(0,-pi * (Scalar(k) / ncfft + Scalar(.5)) ) );
+        }
       }
-      return &twidref[0];
+      return &(*twidref)[0];
     }
 };
 
@@ -0,0 +1,285 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_ITERATIVE_CLOSEST_POINT_H
+#define EIGEN_ITERATIVE_CLOSEST_POINT_H
+
+namespace Eigen {
+
+namespace internal {
+
+// a BVMinimize minimizer looking for the target point closest to a query point,
+// the target points being referenced by their indices in the tree
+template<typename _Scalar, int Dim>
+struct icp_nearest_minimizer
+{
+  typedef _Scalar Scalar;
+  typedef Matrix<Scalar, Dim, 1> VectorType;
+  typedef Matrix<Scalar, Dim, Dynamic> PointsType;
+
+  icp_nearest_minimizer(const PointsType &p, const VectorType &q, Scalar bound) : points(p), query(q), best(bound), index(-1) {}
+
+  Scalar minimumOnVolume(const AlignedBox<Scalar, Dim> &box) { return box.squaredExteriorDistance(query); }
+  Scalar minimumOnObject(int i)
+  {
+    Scalar d = (points.col(i) - query).squaredNorm();
+    if(d < best) {
+      best = d;
+      index = i;
+    }
+    return d;
+  }
+
+  const PointsType &points;
+  const VectorType &query;
+  Scalar best;
+  int index;
+private:
+  icp_nearest_minimizer& operator=(const icp_nearest_minimizer&);
+};
+
+} // end namespace internal
+
+/** \ingroup ICP_Module
+  *
+  * \class IterativeClosestPoint
+  *
+  * \brief Registration of point sets by the iterative closest point algorithm
+  *
+  * \tparam _Scalar the scalar type of the points
+  * \tparam _Dim the dimension of the points
+  *
+  * This class computes the transformation moving a source point set onto a target point set. Each iteration pairs the
+  * source points, moved by the current estimate of the transformation, with their nearest target points, and updates
+  * the estimate by the umeyama() transformation minimizing the distances between the pairs.
+  *
+  * The nearest neighbors are found in a KdBVH of the target points, which is built once by setTarget() such that several
+  * source point sets can be registered onto the same target. When OpenMP is enabled, the nearest neighbor searches run in
+  * parallel, and so does the computation of the covariance matrix in umeyama().
+  *
+  * The following parameters control the iterations:
+  *  - setMaxCorrespondenceDistance() rejects the pairs of points further apart than a given distance;
+  *  - setSubsampling() sets the stride between the source points used by the first iterations. The stride is halved each
+  *    time the iterations converge, such that the first iterations are cheap and the last ones use all the points;
+  *  - setTolerance() sets the relative decrease of the root mean square distance between the pairs, or the change of
+  *    the transformation, below which the iterations are considered to have converged;
+  *  - setMaxIterations() bounds the number of iterations.
+  *
+  * Example:
+  * \code
+  * IterativeClosestPoint<float, 3> icp(target);
+  * icp.setMaxCorrespondenceDistance(0.1f).setSubsampling(16);
+  * Affine3f transform = icp.compute(source).transform();
+  * \endcode
+  *
+  * \sa umeyama(), KdBVH
+  */
+template<typename _Scalar, int _Dim>
+class IterativeClosestPoint
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  typedef _Scalar Scalar;
+  enum { Dim = _Dim };
+  typedef Matrix<Scalar, Dim, 1> VectorType;
+  typedef Matrix<Scalar, Dim, Dynamic> PointsType;
+  typedef Matrix<int, Dynamic, 1> IndicesType;
+  typedef Matrix<Scalar, Dynamic, 1> DistancesType;
+  typedef Transform<Scalar, Dim, Affine> TransformType;
+  typedef KdBVH<Scalar, Dim, int> TreeType;
+
+  /** Default constructor, setTarget() must be called before compute(). */
+  IterativeClosestPoint() { init(); }
+
+  /** Constructs the registration onto the points stored as the columns of \a target. */
+  template<typename Derived>
+  explicit IterativeClosestPoint(const MatrixBase<Derived> &target)
+  {
+    init();
+    setTarget(target);
+  }
+
+  /** Sets the target points, stored as the columns of \a target, and builds the tree searched for the correspondences. */
+  template<typename Derived>
+  IterativeClosestPoint &setTarget(const MatrixBase<Derived> &target)
+  {
+    m_target = target;
+    const int n = static_cast<int>(m_target.cols());
+    typename TreeType::VolumeList boxes;
+    std::vector<int> indices(n);
+    boxes.reserve(n);
+    for(int i = 0; i < n; ++i) {
+      boxes.push_back(typename TreeType::Volume(m_target.col(i)));
+      indices[i] = i;
+    }
+    m_tree.init(indices.begin(), indices.end(), boxes.begin(), boxes.end());
+    return *this;
+  }
+
+  /** Sets the maximal number of iterations (default is 50). */
+  IterativeClosestPoint &setMaxIterations(Index maxIterations) { m_maxIterations = maxIterations; return *this; }
+
+  /** Sets the tolerance of the stopping criterion (default is NumTraits<Scalar>::dummy_precision()). The iterations
+    * stop when the relative decrease of the root mean square error, or the largest change of a coefficient of the
+    * transformation, is below the tolerance. */
+  IterativeClosestPoint &setTolerance(const Scalar &tolerance) { m_tolerance = tolerance; return *this; }
+
+  /** Sets the distance above which a source point and its nearest target point are not paired (default is infinite). */
+  IterativeClosestPoint &setMaxCorrespondenceDistance(const Scalar &distance) { m_maxDistance = distance; return *this; }
+
+  /** Sets the stride between the source points used by the first iterations (default is 1, i.e., all the points).
+    * The stride is halved each time the iterations converge, until all the points are used. */
+  IterativeClosestPoint &setSubsampling(Index stride) { m_subsampling = (std::max)(stride, Index(1)); return *this; }
+
+  /** Sets whether the transformation includes a uniform scaling (default is false, i.e., a rigid transformation). */
+  IterativeClosestPoint &setScaling(bool withScaling) { m_withScaling = withScaling; return *this; }
+
+  /** Computes the transformation moving the points stored as the columns of \a source onto the target points,
+    * starting from the transformation \a initial. */
+  template<typename Derived>
+  IterativeClosestPoint &compute(const MatrixBase<Derived> &source, const TransformType &initial = TransformType::Identity())
+  {
+    EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename Derived::Scalar>::value),
+                        YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+    eigen_assert(source.rows() == m_target.rows());
+
+    const Index n = source.cols();
+    Index stride = m_subsampling;
+    Scalar previousError = NumTraits<Scalar>::infinity();
+    PointsType moved, src, dst;
+    IndicesType nearest;
+    DistancesType distances;
+
+    m_transform = initial;
+    m_iterations = 0;
+    m_inliers = 0;
+    m_error = NumTraits<Scalar>::infinity();
+    m_info = NoConvergence;
+
+    while(m_iterations < m_maxIterations)
+    {
+      ++m_iterations;
+      const Index size = (n + stride - 1) / stride;
+      moved.resize(source.rows(), size);
+      for(Index i = 0; i < size; ++i)
+        moved.col(i) = source.col(i * stride);
+      m_transform.transformPoints(moved, moved);
+      findNearest(moved, nearest, distances);
+
+      m_inliers = (nearest.array() >= 0).count();
+      if(m_inliers <= Dim) {
+        m_info = NumericalIssue; // not enough correspondences to estimate a transformation
+        break;
+      }
+      src.resize(source.rows(), m_inliers);
+      dst.resize(source.rows(), m_inliers);
+      Scalar squaredError(0);
+      for(Index i = 0, j = 0; i < size; ++i) {
+        if(nearest(i) < 0)
+          continue;
+        src.col(j) = moved.col(i);
+        dst.col(j) = m_target.col(nearest(i));
+        squaredError += distances(i);
+        ++j;
+      }
+      m_error = std::sqrt(squaredError / Scalar(m_inliers));
+
+      const TransformType step(umeyama(src, dst, m_withScaling));
+      m_transform = step * m_transform;
+
+      if(m_error >= (Scalar(1) - m_tolerance) * previousError
+         || (step.matrix() - TransformType::MatrixType::Identity()).cwiseAbs().maxCoeff() <= m_tolerance) {
+        if(stride == 1) {
+          m_info = Success;
+          break;
+        }
+        stride = (std::max)(stride / 2, Index(1));
+        previousError = NumTraits<Scalar>::infinity(); // the errors with different strides are not comparable
+      }
+      else
+        previousError = m_error;
+    }
+    return *this;
+  }
+
+  /** Finds the target points closest to the columns of \a points. On output, \a indices are the indices of the nearest
+    * target points, or -1 if they are further than the maximal correspondence distance, and \a squaredDistances are
+    * the squared distances to them. */
+  template<typename Derived>
+  void findNearest(const MatrixBase<Derived> &points, IndicesType &indices, DistancesType &squaredDistances) const
+  {
+    typedef internal::icp_nearest_minimizer<Scalar, Dim> Minimizer;
+    const int n = static_cast<int>(points.cols());
+    const Scalar bound = m_maxDistance == NumTraits<Scalar>::infinity() ? m_maxDistance : m_maxDistance * m_maxDistance;
+    indices.resize(n);
+    squaredDistances.resize(n);
+
+#ifdef EIGEN_HAS_OPENMP
+    int threads = 1;
+    if(n >= 256 && omp_get_num_threads() == 1) {
+      Eigen::initParallel();
+      threads = nbThreads();
+    }
+    #pragma omp parallel for schedule(dynamic, 64) num_threads(threads)
+#endif
+    for(int i = 0; i < n; ++i) {
+      const VectorType query = points.col(i);
+      Minimizer minimizer(m_target, query, bound);
+      internal::minimize_helper(m_tree, minimizer, m_tree.getRootIndex(), bound);
+      indices(i) = minimizer.index;
+      squaredDistances(i) = minimizer.best;
+    }
+  }
+
+  /** \returns the transformation moving the source points onto the target points */
+  const TransformType &transform() const { return m_transform; }
+
+  /** \returns the root mean square distance between the pairs of points of the last iteration */
+  Scalar error() const { return m_error; }
+
+  /** \returns the number of iterations of the last call to compute() */
+  Index iterations() const { return m_iterations; }
+
+  /** \returns the number of pairs of points of the last iteration */
+  Index inliers() const { return m_inliers; }
+
+  /** \returns \c Success if the iterations converged, \c NoConvergence if the maximal number of iterations has been
+    * reached, and \c NumericalIssue if there were not enough pairs of points to estimate the transformation. */
+  ComputationInfo info() const { return m_info; }
+
+protected:
+  void init()
+  {
+    m_maxIterations = 50;
+    m_tolerance = NumTraits<Scalar>::dummy_precision();
+    m_maxDistance = NumTraits<Scalar>::infinity();
+    m_subsampling = 1;
+    m_withScaling = false;
+    m_transform.setIdentity();
+    m_error = NumTraits<Scalar>::infinity();
+    m_iterations = 0;
+    m_inliers = 0;
+    m_info = InvalidInput;
+  }
+
+  TransformType m_transform;
+  PointsType m_target;
+  TreeType m_tree;
+  Index m_maxIterations;
+  Scalar m_tolerance;
+  Scalar m_maxDistance;
+  Index m_subsampling;
+  bool m_withScaling;
+  Scalar m_error;
+  Index m_iterations;
+  Index m_inliers;
+  ComputationInfo m_info;
+};
+
+} // end namespace Eigen
+
+#endif // EIGEN_ITERATIVE_CLOSEST_POINT_H
@@ -0,0 +1,186 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef KRONECKER_OPERATOR_H
+#define KRONECKER_OPERATOR_H
+
+namespace Eigen {
+
+template<typename Lhs, typename Rhs> class KroneckerOperator;
+
+namespace internal {
+
+template<typename _Lhs, typename _Rhs>
+struct traits<KroneckerOperator<_Lhs,_Rhs> >
+{
+  typedef typename remove_all<_Lhs>::type Lhs;
+  typedef typename remove_all<_Rhs>::type Rhs;
+  typedef typename ScalarBinaryOpTraits<typename Lhs::Scalar, typename Rhs::Scalar>::ReturnType Scalar;
+  typedef typename promote_index_type<typename Lhs::StorageIndex, typename Rhs::StorageIndex>::type StorageIndex;
+  // Like any matrix-free operator, it looks like a sparse matrix to the
+  // products and to the iterative solvers.
+  typedef Sparse StorageKind;
+  typedef MatrixXpr XprKind;
+
+  enum {
+    RowsAtCompileTime = size_at_compile_time<traits<Lhs>::RowsAtCompileTime, traits<Rhs>::RowsAtCompileTime>::ret,
+    ColsAtCompileTime = size_at_compile_time<traits<Lhs>::ColsAtCompileTime, traits<Rhs>::ColsAtCompileTime>::ret,
+    MaxRowsAtCompileTime = size_at_compile_time<traits<Lhs>::MaxRowsAtCompileTime, traits<Rhs>::MaxRowsAtCompileTime>::ret,
+    MaxColsAtCompileTime = size_at_compile_time<traits<Lhs>::MaxColsAtCompileTime, traits<Rhs>::MaxColsAtCompileTime>::ret,
+    Flags = NestByRefBit
+  };
+};
+
+} // end namespace internal
+
+/*!
+ * \ingroup KroneckerProduct_Module
+ *
+ * \brief Matrix-free Kronecker tensor product operator
+ *
+ * This class represents \f$ A \otimes B \f$ without ever forming it: only
+ * products with dense vectors and matrices are supported, and they are
+ * computed through the identity
+ * \f[ (A \otimes B)\,\mathrm{vec}(X) = \mathrm{vec}(B X A^T) \f]
+ * as two matrix-matrix products. For factors of size \f$ m \times n \f$ and
+ * \f$ p \times q \f$, the storage is that of the factors instead of
+ * \f$ mp \times nq \f$, and a product costs \f$ O(pq(m+n)) \f$ or
+ * \f$ O(mn(p+q)) \f$ operations instead of \f$ O(mnpq) \f$, the cheapest
+ * order being selected at run time. The factors may be dense or sparse.
+ *
+ * The operator follows the matrix-free conventions of the iterative solvers
+ * and can be used as their matrix type together with IdentityPreconditioner:
+ * \code
+ * KroneckerOperator<MatrixXd,MatrixXd> K = kroneckerOperator(A,B);
+ * ConjugateGradient<KroneckerOperator<MatrixXd,MatrixXd>, Lower|Upper, IdentityPreconditioner> cg(K);
+ * VectorXd x = cg.solve(b);
+ * \endcode
+ * Evaluating products requires the SparseCore module.
+ *
+ * The factors are referenced, not copied, as for KroneckerProduct.
+ *
+ * \tparam Lhs  Type of the left factor \f$ A \f$, a matrix expression.
+ * \tparam Rhs  Type of the right factor \f$ B \f$, a matrix expression.
+ *
+ * \sa kroneckerOperator(), KroneckerProduct
+ */
+template<typename Lhs, typename Rhs>
+class KroneckerOperator : public EigenBase<KroneckerOperator<Lhs,Rhs> >
+{
+  public:
+    typedef internal::traits<KroneckerOperator> Traits;
+    typedef typename Traits::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename Traits::StorageIndex StorageIndex;
+    typedef typename Lhs::Nested LhsNested;
+    typedef typename Rhs::Nested RhsNested;
+    typedef typename internal::remove_all<LhsNested>::type LhsNestedCleaned;
+    typedef typename internal::remove_all<RhsNested>::type RhsNestedCleaned;
+
+    enum {
+      RowsAtCompileTime = Traits::RowsAtCompileTime,
+      ColsAtCompileTime = Traits::ColsAtCompileTime,
+      MaxRowsAtCompileTime = Traits::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = Traits::MaxColsAtCompileTime,
+      IsRowMajor = false
+    };
+
+    /*! \brief Constructor. */
+    KroneckerOperator(const Lhs& A, const Rhs& B)
+      : m_A(A), m_B(B)
+    {}
+
+    inline Index rows() const { return m_A.rows() * m_B.rows(); }
+    inline Index cols() const { return m_A.cols() * m_B.cols(); }
+
+    /*! \returns the left factor \f$ A \f$ */
+    const LhsNestedCleaned& lhs() const { return m_A; }
+    /*! \returns the right factor \f$ B \f$ */
+    const RhsNestedCleaned& rhs() const { return m_B; }
+
+    /*! \returns an expression of the product of \c *this with the dense matrix \a x */
+    template<typename OtherDerived>
+    Product<KroneckerOperator,OtherDerived,AliasFreeProduct> operator*(const MatrixBase<OtherDerived>& x) const
+    {
+      return Product<KroneckerOperator,OtherDerived,AliasFreeProduct>(*this, x.derived());
+    }
+
+    /*! Performs \a dst += \a alpha * \c *this * \a x, one column of \a x at a time. */
+    template<typename Dest, typename OtherDerived>
+    void scaleAndAddTo(Dest& dst, const OtherDerived& x, const Scalar& alpha) const;
+
+  protected:
+    LhsNested m_A;
+    RhsNested m_B;
+};
+
+template<typename Lhs, typename Rhs>
+template<typename Dest, typename OtherDerived>
+void KroneckerOperator<Lhs,Rhs>::scaleAndAddTo(Dest& dst, const OtherDerived& x, const Scalar& alpha) const
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  eigen_assert(x.rows() == cols() && dst.rows() == rows() && dst.cols() == x.cols());
+
+  const Index Ar = m_A.rows(), Ac = m_A.cols(),
+              Br = m_B.rows(), Bc = m_B.cols();
+
+  // B*(X*A^T) or (B*X)*A^T, whichever needs the fewest flops
+  const bool rightFirst = Bc*Ac*Ar + Br*Bc*Ar < Br*Bc*Ac + Br*Ac*Ar;
+
+  MatrixType X(Bc, Ac), T, Y(Br, Ar);
+  for (Index j=0; j < x.cols(); ++j)
+  {
+    VectorType::Map(X.data(), X.size()) = x.col(j);
+    if (rightFirst)
+    {
+      T.noalias() = X * m_A.transpose();
+      Y.noalias() = m_B * T;
+    }
+    else
+    {
+      T.noalias() = m_B * X;
+      Y.noalias() = T * m_A.transpose();
+    }
+    dst.col(j) += alpha * VectorType::Map(Y.data(), Y.size());
+  }
+}
+
+namespace internal {
+
+template<typename Lhs, typename Rhs, typename OtherDerived, int ProductType>
+struct generic_product_impl<KroneckerOperator<Lhs,Rhs>, OtherDerived, SparseShape, DenseShape, ProductType>
+ : generic_product_impl_base<KroneckerOperator<Lhs,Rhs>,OtherDerived,generic_product_impl<KroneckerOperator<Lhs,Rhs>,OtherDerived> >
+{
+  typedef typename Product<KroneckerOperator<Lhs,Rhs>,OtherDerived>::Scalar Scalar;
+
+  template<typename Dest>
+  static void scaleAndAddTo(Dest& dst, const KroneckerOperator<Lhs,Rhs>& lhs, const OtherDerived& rhs, const Scalar& alpha)
+  {
+    lhs.scaleAndAddTo(dst, rhs, alpha);
+  }
+};
+
+} // end namespace internal
+
+/*!
+ * \ingroup KroneckerProduct_Module
+ *
+ * \returns a matrix-free operator acting as the Kronecker tensor product of
+ * \a a and \a b, which can be dense or sparse
+ *
+ * \sa KroneckerOperator, kroneckerProduct()
+ */
+template<typename A, typename B>
+KroneckerOperator<A,B> kroneckerOperator(const EigenBase<A>& a, const EigenBase<B>& b)
+{
+  return KroneckerOperator<A,B>(a.derived(), b.derived());
+}
+
+} // end namespace Eigen
+
+#endif // KRONECKER_OPERATOR_H
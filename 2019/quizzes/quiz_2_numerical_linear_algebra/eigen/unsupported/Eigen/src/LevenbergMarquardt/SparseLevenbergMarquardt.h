@@ -0,0 +1,604 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SPARSE_LEVENBERGMARQUARDT_H
+#define EIGEN_SPARSE_LEVENBERGMARQUARDT_H
+
+namespace Eigen {
+
+/**
+  * \ingroup LevenbergMarquardt_Module
+  * \brief Base class of the functors made of a sum of cost terms, for SparseLevenbergMarquardt
+  *
+  * The residuals are split into cost terms, each term being a small block of residuals depending on a
+  * few inputs only, e.g., the reprojection error of a point in a camera for bundle adjustment. The
+  * terms are declared by addTerm(), usually in the constructor of the functor, which must also define
+  * \code
+  * // evaluates the residuals of the term
+  * int operator()(Index term, const InputType &x, Ref<ValueType> fvec) const;
+  * // evaluates the derivatives of the residuals of the term with respect to its inputs,
+  * // the columns of fjac following the order of the inputs given to addTerm()
+  * int df(Index term, const InputType &x, Ref<JacobianBlockType> fjac) const;
+  * \endcode
+  * returning a negative value to stop the minimization. Both functions may be called concurrently
+  * for different terms.
+  */
+template <typename _Scalar>
+struct BlockSparseFunctor
+{
+  typedef _Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> InputType;
+  typedef Matrix<Scalar,Dynamic,1> ValueType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> JacobianBlockType;
+  typedef Matrix<Index,Dynamic,1> IndicesType;
+  enum {
+    InputsAtCompileTime = Dynamic,
+    ValuesAtCompileTime = Dynamic
+  };
+
+  BlockSparseFunctor(int inputs) : m_inputs(inputs), m_valueOffsets(1, 0), m_inputOffsets(1, 0) {}
+
+  int inputs() const { return m_inputs; }
+  int values() const { return int(m_valueOffsets.back()); }
+
+  /** \returns the number of cost terms */
+  Index terms() const { return Index(m_valueOffsets.size()) - 1; }
+
+  /** \returns the number of residuals of the term \a term */
+  Index termValues(Index term) const { return m_valueOffsets[term + 1] - m_valueOffsets[term]; }
+
+  /** \returns the index of the first residual of the term \a term in the vector of all the residuals */
+  Index termValueOffset(Index term) const { return m_valueOffsets[term]; }
+
+  /** \returns the indices of the inputs the term \a term depends on */
+  Map<const IndicesType> termInputs(Index term) const
+  {
+    return Map<const IndicesType>(&m_inputIndices[0] + m_inputOffsets[term], m_inputOffsets[term + 1] - m_inputOffsets[term]);
+  }
+
+  /** Adds a cost term of \a values residuals, depending on the distinct inputs of indices \a inputIndices.
+    * \returns the index of the term */
+  template<typename Derived>
+  Index addTerm(Index values, const DenseBase<Derived>& inputIndices)
+  {
+    eigen_assert(values > 0 && inputIndices.size() > 0);
+    for (Index i = 0; i < inputIndices.size(); ++i)
+    {
+      eigen_assert(inputIndices[i] >= 0 && inputIndices[i] < m_inputs);
+      eigen_assert((inputIndices.head(i).array() != inputIndices[i]).all() && "the inputs of a term must be distinct");
+      m_inputIndices.push_back(Index(inputIndices[i]));
+    }
+    m_valueOffsets.push_back(m_valueOffsets.back() + values);
+    m_inputOffsets.push_back(Index(m_inputIndices.size()));
+    return terms() - 1;
+  }
+
+  const int m_inputs;
+  //int operator()(Index term, const InputType &x, Ref<ValueType> fvec) const { }
+  // to be defined in the functor
+
+  //int df(Index term, const InputType &x, Ref<JacobianBlockType> fjac) const { }
+  // to be defined in the functor
+
+protected:
+  std::vector<Index> m_valueOffsets, m_inputOffsets, m_inputIndices;
+};
+
+/**
+  * \ingroup LevenbergMarquardt_Module
+  * \brief Performs non linear least squares minimization of a sum of cost terms with a sparse Jacobian
+  *
+  * \tparam _FunctorType the functor, derived from BlockSparseFunctor
+  * \tparam _SolverType the sparse solver of the normal equations, operating on their lower triangular
+  *                     part, e.g., SimplicialLDLT or SimplicialLLT
+  *
+  * Each iteration solves the damped normal equations \f$ (J^T J + \mu D^2) h = -J^T f \f$, where \a D
+  * is the diagonal scaling of the columns of the Jacobian \a J. Unlike LevenbergMarquardt, which
+  * factorizes the whole Jacobian by QR, only the sparse matrix \f$ J^T J \f$ is assembled and
+  * factorized, which suits problems with many residuals such as bundle adjustment.
+  *
+  * The sparsity pattern of \f$ J^T J \f$, the positions where each cost term contributes to it, and the
+  * fill-reducing ordering of the solver are computed once by minimizeInit(), and reused by all the
+  * iterations. The residuals and Jacobian blocks of the cost terms are evaluated in parallel when
+  * OpenMP is enabled.
+  *
+  * The damping parameter \f$ \mu \f$ starts from initialDamping() and is updated from the ratio of the
+  * actual to the predicted reduction of the cost. The convergence tests and the returned status are
+  * those of LevenbergMarquardt.
+  *
+  * \sa BlockSparseFunctor, LevenbergMarquardt
+  */
+template<typename _FunctorType, typename _SolverType = SimplicialLDLT<SparseMatrix<typename _FunctorType::Scalar>, Lower> >
+class SparseLevenbergMarquardt : internal::no_assignment_operator
+{
+  public:
+    typedef _FunctorType FunctorType;
+    typedef _SolverType SolverType;
+    typedef typename FunctorType::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename SolverType::MatrixType HessianType;
+    typedef typename HessianType::StorageIndex StorageIndex;
+    typedef Matrix<Scalar,Dynamic,1> FVectorType;
+    typedef Matrix<Scalar,Dynamic,Dynamic> JacobianBlockType;
+
+    SparseLevenbergMarquardt(FunctorType& functor)
+    : m_functor(functor), m_nfev(0), m_njev(0), m_iter(0), m_fnorm(0), m_gnorm(0), m_par(0), m_nu(2),
+      m_info(InvalidInput)
+    {
+      resetParameters();
+    }
+
+    LevenbergMarquardtSpace::Status minimize(FVectorType &x);
+    LevenbergMarquardtSpace::Status minimizeInit(FVectorType &x);
+    LevenbergMarquardtSpace::Status minimizeOneStep(FVectorType &x);
+
+    /** Sets the default parameters */
+    void resetParameters()
+    {
+      using std::sqrt;
+      m_damping = RealScalar(1e-3);
+      m_maxfev = 400;
+      m_ftol = sqrt(NumTraits<RealScalar>::epsilon());
+      m_xtol = sqrt(NumTraits<RealScalar>::epsilon());
+      m_gtol = 0.;
+    }
+
+    /** Sets the tolerance for the norm of the solution vector*/
+    void setXtol(RealScalar xtol) { m_xtol = xtol; }
+
+    /** Sets the tolerance for the norm of the vector function*/
+    void setFtol(RealScalar ftol) { m_ftol = ftol; }
+
+    /** Sets the tolerance for the norm of the gradient of the error vector*/
+    void setGtol(RealScalar gtol) { m_gtol = gtol; }
+
+    /** Sets the initial damping parameter, relative to the squared norms of the columns of the Jacobian */
+    void setInitialDamping(RealScalar damping) { m_damping = damping; }
+
+    /** Sets the maximum number of function evaluation */
+    void setMaxfev(Index maxfev) { m_maxfev = maxfev; }
+
+    /** \returns the tolerance for the norm of the solution vector */
+    RealScalar xtol() const { return m_xtol; }
+
+    /** \returns the tolerance for the norm of the vector function */
+    RealScalar ftol() const { return m_ftol; }
+
+    /** \returns the tolerance for the norm of the gradient of the error vector */
+    RealScalar gtol() const { return m_gtol; }
+
+    /** \returns the initial damping parameter */
+    RealScalar initialDamping() const { return m_damping; }
+
+    /** \returns the maximum number of function evaluation */
+    Index maxfev() const { return m_maxfev; }
+
+    /** \returns the scaling of the columns of the Jacobian */
+    const FVectorType& diag() const { return m_diag; }
+
+    /** \returns the number of iterations performed */
+    Index iterations() const { return m_iter; }
+
+    /** \returns the number of functions evaluation */
+    Index nfev() const { return m_nfev; }
+
+    /** \returns the number of jacobian evaluation */
+    Index njev() const { return m_njev; }
+
+    /** \returns the norm of current vector function */
+    RealScalar fnorm() const { return m_fnorm; }
+
+    /** \returns the norm of the gradient of the error */
+    RealScalar gnorm() const { return m_gnorm; }
+
+    /** \returns the LevenbergMarquardt parameter */
+    RealScalar lm_param() const { return m_par; }
+
+    /** \returns the current vector function */
+    const FVectorType& fvec() const { return m_fvec; }
+
+    /** \returns the lower triangular part of the damped normal matrix of the last iteration */
+    const HessianType& hessian() const { return m_hessian; }
+
+    /**
+     * \brief Reports whether the minimization was successful
+     * \returns \c Success if the minimization was succesful,
+     *         \c NumericalIssue if the damped normal equations could not be factorized,
+     *         \c NoConvergence if the minimization did not converge after
+     *          the maximum number of function evaluation allowed
+     *          \c InvalidInput if the input is invalid
+     */
+    ComputationInfo info() const { return m_info; }
+
+  protected:
+    void analyzePattern();
+    int evaluate(const FVectorType &x, FVectorType &fvec) const;
+    int evaluateJacobian(const FVectorType &x);
+    void assemble();
+    int threads() const;
+
+    FunctorType &m_functor;
+    SolverType m_solver;
+    HessianType m_hessian;              // lower triangular part of J^T J
+    std::vector<StorageIndex> m_termOrder;        // inputs of each term sorted by index
+    std::vector<StorageIndex> m_pairPositions;    // positions of the contributions of each term in m_hessian
+    std::vector<Index> m_pairOffsets, m_blockOffsets;
+    std::vector<StorageIndex> m_diagPositions;
+    std::vector<Scalar> m_blocks;       // Jacobian blocks of the terms, column-major
+    FVectorType m_fvec, m_gradient, m_hessianDiag, m_diag;
+    FVectorType m_wa1, m_wa2, m_wa4;
+    JacobianBlockType m_gram;
+    Index n;
+    Index m;
+    Index m_nfev;
+    Index m_njev;
+    Index m_maxfev;
+    Index m_iter;
+    RealScalar m_fnorm;
+    RealScalar m_gnorm;
+    RealScalar m_ftol;
+    RealScalar m_xtol;
+    RealScalar m_gtol;
+    RealScalar m_damping;
+    RealScalar m_par;
+    RealScalar m_nu;
+    ComputationInfo m_info;
+};
+
+template<typename FunctorType, typename SolverType>
+LevenbergMarquardtSpace::Status
+SparseLevenbergMarquardt<FunctorType,SolverType>::minimize(FVectorType &x)
+{
+  LevenbergMarquardtSpace::Status status = minimizeInit(x);
+  if (status==LevenbergMarquardtSpace::ImproperInputParameters || status==LevenbergMarquardtSpace::UserAsked)
+    return status;
+  do {
+    status = minimizeOneStep(x);
+  } while (status==LevenbergMarquardtSpace::Running);
+  return status;
+}
+
+template<typename FunctorType, typename SolverType>
+LevenbergMarquardtSpace::Status
+SparseLevenbergMarquardt<FunctorType,SolverType>::minimizeInit(FVectorType &x)
+{
+  n = x.size();
+  m = m_functor.values();
+  m_nfev = 0;
+  m_njev = 0;
+  m_iter = 0;
+
+  if (n <= 0 || n != m_functor.inputs() || m_functor.terms() == 0 || m_ftol < 0. || m_xtol < 0. || m_gtol < 0.
+      || m_maxfev <= 0 || m_damping <= 0.)
+  {
+    m_info = InvalidInput;
+    return LevenbergMarquardtSpace::ImproperInputParameters;
+  }
+
+  m_fvec.resize(m);
+  m_wa4.resize(m);
+  m_diag.resize(n);
+  analyzePattern();
+  m_solver.analyzePattern(m_hessian);
+
+  m_nfev = 1;
+  if (evaluate(x, m_fvec) < 0)
+    return LevenbergMarquardtSpace::UserAsked;
+  m_fnorm = m_fvec.stableNorm();
+
+  m_par = 0.;
+  m_nu = 2.;
+  m_iter = 1;
+  m_info = Success;
+  return LevenbergMarquardtSpace::NotStarted;
+}
+
+template<typename FunctorType, typename SolverType>
+LevenbergMarquardtSpace::Status
+SparseLevenbergMarquardt<FunctorType,SolverType>::minimizeOneStep(FVectorType &x)
+{
+  using std::abs;
+  using std::sqrt;
+  eigen_assert(x.size()==n); // check the caller is not cheating us
+
+  /* evaluate the jacobian blocks and assemble the normal equations. */
+  if (evaluateJacobian(x) < 0)
+    return LevenbergMarquardtSpace::UserAsked;
+  ++m_njev;
+  assemble();
+
+  /* scale according to the norms of the columns of the jacobian, which only increase. */
+  for (Index j = 0; j < n; ++j)
+  {
+    const RealScalar colnorm = sqrt(numext::real(m_hessianDiag[j]));
+    m_diag[j] = m_iter == 1 ? (colnorm == 0. ? RealScalar(1) : colnorm) : (std::max)(RealScalar(m_diag[j]), colnorm);
+  }
+
+  /* compute the norm of the scaled gradient. */
+  m_gnorm = 0.;
+  if (m_fnorm != 0.)
+    for (Index j = 0; j < n; ++j)
+      if (m_hessianDiag[j] != Scalar(0))
+        m_gnorm = (std::max)(m_gnorm, RealScalar(abs(m_gradient[j]) / (m_fnorm * sqrt(numext::real(m_hessianDiag[j])))));
+
+  /* test for convergence of the gradient norm. */
+  if (m_gnorm <= m_gtol) {
+    m_info = Success;
+    return LevenbergMarquardtSpace::CosinusTooSmall;
+  }
+
+  if (m_iter == 1)
+    m_par = m_damping;
+  const RealScalar xnorm = m_diag.cwiseProduct(x).stableNorm();
+
+  RealScalar ratio;
+  do {
+    /* solve the damped normal equations. */
+    Scalar* values = m_hessian.valuePtr();
+    for (Index j = 0; j < n; ++j)
+      values[m_diagPositions[j]] = m_hessianDiag[j] + m_par * numext::abs2(m_diag[j]);
+    m_solver.factorize(m_hessian);
+    if (m_solver.info() != Success)
+    {
+      if (!(m_par < NumTraits<RealScalar>::highest()))
+      {
+        m_info = NumericalIssue;
+        return LevenbergMarquardtSpace::ImproperInputParameters;
+      }
+      m_par *= m_nu;
+      m_nu *= 2;
+      ratio = 0.;
+      continue;
+    }
+    m_wa1 = -m_solver.solve(m_gradient);
+    m_wa2 = x + m_wa1;
+    const RealScalar pnorm = m_diag.cwiseProduct(m_wa1).stableNorm();
+
+    /* evaluate the function at x + p and calculate its norm. */
+    if (evaluate(m_wa2, m_wa4) < 0)
+      return LevenbergMarquardtSpace::UserAsked;
+    ++m_nfev;
+    const RealScalar fnorm1 = m_wa4.stableNorm();
+
+    /* compute the scaled actual and predicted reductions, the latter being */
+    /* the decrease of the linear model m_par |D p|^2 - g^T p, as in minpack. */
+    RealScalar actred = -1.;
+    if (RealScalar(.1) * fnorm1 < m_fnorm)
+      actred = 1. - numext::abs2(fnorm1 / m_fnorm);
+    const RealScalar prered = (m_par * numext::abs2(pnorm) - numext::real(m_gradient.dot(m_wa1))) / numext::abs2(m_fnorm);
+    ratio = prered != 0. ? actred / prered : RealScalar(0);
+
+    /* update the damping parameter. */
+    if (ratio >= RealScalar(1e-4)) {
+      /* successful iteration. update x, m_fvec, and their norms. */
+      x = m_wa2;
+      m_fvec = m_wa4;
+      m_fnorm = fnorm1;
+      m_par *= (std::max)(RealScalar(1) / RealScalar(3), RealScalar(1) - numext::abs2(RealScalar(2) * ratio - RealScalar(1)) * (RealScalar(2) * ratio - RealScalar(1)));
+      m_nu = 2.;
+      ++m_iter;
+    } else {
+      m_par *= m_nu;
+      m_nu *= 2;
+    }
+
+    /* tests for convergence. */
+    const bool reduction = abs(actred) <= m_ftol && prered <= m_ftol && RealScalar(.5) * ratio <= 1.;
+    const bool error = pnorm <= m_xtol * xnorm;
+    if (reduction && error)
+    {
+      m_info = Success;
+      return LevenbergMarquardtSpace::RelativeErrorAndReductionTooSmall;
+    }
+    if (reduction)
+    {
+      m_info = Success;
+      return LevenbergMarquardtSpace::RelativeReductionTooSmall;
+    }
+    if (error)
+    {
+      m_info = Success;
+      return LevenbergMarquardtSpace::RelativeErrorTooSmall;
+    }
+
+    /* tests for termination and stringent tolerances. */
+    if (m_nfev >= m_maxfev)
+    {
+      m_info = NoConvergence;
+      return LevenbergMarquardtSpace::TooManyFunctionEvaluation;
+    }
+    if (abs(actred) <= NumTraits<RealScalar>::epsilon() && prered <= NumTraits<RealScalar>::epsilon() && RealScalar(.5) * ratio <= 1.)
+    {
+      m_info = Success;
+      return LevenbergMarquardtSpace::FtolTooSmall;
+    }
+    if (pnorm <= NumTraits<RealScalar>::epsilon() * xnorm)
+    {
+      m_info = Success;
+      return LevenbergMarquardtSpace::XtolTooSmall;
+    }
+  } while (ratio < RealScalar(1e-4));
+
+  return LevenbergMarquardtSpace::Running;
+}
+
+template<typename FunctorType, typename SolverType>
+void SparseLevenbergMarquardt<FunctorType,SolverType>::analyzePattern()
+{
+  const Index terms = m_functor.terms();
+
+  /* list the terms depending on each input. */
+  std::vector<Index> inputTermOffsets(n + 1, 0), inputTerms;
+  for (Index t = 0; t < terms; ++t)
+  {
+    const Map<const typename FunctorType::IndicesType> inputs = m_functor.termInputs(t);
+    for (Index a = 0; a < inputs.size(); ++a)
+      ++inputTermOffsets[inputs[a] + 1];
+  }
+  for (Index j = 0; j < n; ++j)
+    inputTermOffsets[j + 1] += inputTermOffsets[j];
+  inputTerms.resize(inputTermOffsets[n]);
+  {
+    std::vector<Index> next(inputTermOffsets.begin(), inputTermOffsets.end() - 1);
+    for (Index t = 0; t < terms; ++t)
+    {
+      const Map<const typename FunctorType::IndicesType> inputs = m_functor.termInputs(t);
+      for (Index a = 0; a < inputs.size(); ++a)
+        inputTerms[next[inputs[a]]++] = t;
+    }
+  }
+
+  /* the pattern of the lower triangular part of J^T J, column by column, the diagonal being always */
+  /* stored for the damping. */
+  std::vector<StorageIndex> innerIndices, rows;
+  std::vector<Index> marker(n, -1), outerIndices(n + 1, 0);
+  m_diagPositions.resize(n);
+  for (Index j = 0; j < n; ++j)
+  {
+    rows.assign(1, StorageIndex(j));
+    marker[j] = j;
+    for (Index k = inputTermOffsets[j]; k < inputTermOffsets[j + 1]; ++k)
+    {
+      const Map<const typename FunctorType::IndicesType> inputs = m_functor.termInputs(inputTerms[k]);
+      for (Index a = 0; a < inputs.size(); ++a)
+        if (inputs[a] > j && marker[inputs[a]] != j)
+        {
+          marker[inputs[a]] = j;
+          rows.push_back(StorageIndex(inputs[a]));
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    m_diagPositions[j] = StorageIndex(innerIndices.size());
+    innerIndices.insert(innerIndices.end(), rows.begin(), rows.end());
+    outerIndices[j + 1] = Index(innerIndices.size());
+  }
+  m_hessian.resize(n, n);
+  m_hessian.resizeNonZeros(Index(innerIndices.size()));
+  for (Index j = 0; j <= n; ++j)
+    m_hessian.outerIndexPtr()[j] = StorageIndex(outerIndices[j]);
+  std::copy(innerIndices.begin(), innerIndices.end(), m_hessian.innerIndexPtr());
+
+  /* the positions of the contributions of each term, for its inputs sorted by index. */
+  m_termOrder.clear();
+  m_pairPositions.clear();
+  m_pairOffsets.assign(1, 0);
+  m_blockOffsets.assign(1, 0);
+  Index maxInputs = 0;
+  for (Index t = 0; t < terms; ++t)
+  {
+    const Map<const typename FunctorType::IndicesType> inputs = m_functor.termInputs(t);
+    const Index k = inputs.size();
+    maxInputs = (std::max)(maxInputs, k);
+    const size_t first = m_termOrder.size();
+    for (Index a = 0; a < k; ++a)
+      m_termOrder.push_back(StorageIndex(a));
+    StorageIndex* order = &m_termOrder[first];
+    for (Index a = 1; a < k; ++a)
+      for (Index b = a; b > 0 && inputs[order[b - 1]] > inputs[order[b]]; --b)
+        std::swap(order[b - 1], order[b]);
+    for (Index b = 0; b < k; ++b)
+    {
+      const Index col = inputs[order[b]];
+      const StorageIndex* begin = m_hessian.innerIndexPtr() + outerIndices[col];
+      const StorageIndex* end = m_hessian.innerIndexPtr() + outerIndices[col + 1];
+      for (Index a = b; a < k; ++a)
+        m_pairPositions.push_back(StorageIndex(std::lower_bound(begin, end, StorageIndex(inputs[order[a]])) - m_hessian.innerIndexPtr()));
+    }
+    m_pairOffsets.push_back(Index(m_pairPositions.size()));
+    m_blockOffsets.push_back(m_blockOffsets.back() + k * m_functor.termValues(t));
+  }
+  m_blocks.resize(m_blockOffsets.back());
+  m_gram.resize(maxInputs, maxInputs);
+}
+
+template<typename FunctorType, typename SolverType>
+int SparseLevenbergMarquardt<FunctorType,SolverType>::threads() const
+{
+#ifdef EIGEN_HAS_OPENMP
+  if (m_functor.terms() >= 64 && omp_get_num_threads() == 1)
+  {
+    Eigen::initParallel();
+    return nbThreads();
+  }
+#endif
+  return 1;
+}
+
+template<typename FunctorType, typename SolverType>
+int SparseLevenbergMarquardt<FunctorType,SolverType>::evaluate(const FVectorType &x, FVectorType &fvec) const
+{
+  const Index terms = m_functor.terms();
+  int status = 0;
+#ifdef EIGEN_HAS_OPENMP
+  const int nthreads = threads();
+  #pragma omp parallel for schedule(dynamic, 64) num_threads(nthreads)
+#endif
+  for (Index t = 0; t < terms; ++t)
+  {
+    if (m_functor(t, x, fvec.segment(m_functor.termValueOffset(t), m_functor.termValues(t))) < 0)
+    {
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp critical
+#endif
+      status = -1;
+    }
+  }
+  return status;
+}
+
+template<typename FunctorType, typename SolverType>
+int SparseLevenbergMarquardt<FunctorType,SolverType>::evaluateJacobian(const FVectorType &x)
+{
+  const Index terms = m_functor.terms();
+  int status = 0;
+#ifdef EIGEN_HAS_OPENMP
+  const int nthreads = threads();
+  #pragma omp parallel for schedule(dynamic, 64) num_threads(nthreads)
+#endif
+  for (Index t = 0; t < terms; ++t)
+  {
+    Map<JacobianBlockType> block(&m_blocks[0] + m_blockOffsets[t], m_functor.termValues(t), m_functor.termInputs(t).size());
+    if (m_functor.df(t, x, block) < 0)
+    {
+#ifdef EIGEN_HAS_OPENMP
+      #pragma omp critical
+#endif
+      status = -1;
+    }
+  }
+  return status;
+}
+
+template<typename FunctorType, typename SolverType>
+void SparseLevenbergMarquardt<FunctorType,SolverType>::assemble()
+{
+  Map<Matrix<Scalar,Dynamic,1> >(m_hessian.valuePtr(), m_hessian.nonZeros()).setZero();
+  m_gradient.setZero(n);
+  Scalar* values = m_hessian.valuePtr();
+  const StorageIndex* order = &m_termOrder[0];
+  for (Index t = 0; t < m_functor.terms(); ++t)
+  {
+    const Map<const typename FunctorType::IndicesType> inputs = m_functor.termInputs(t);
+    const Index k = inputs.size(), rows = m_functor.termValues(t);
+    const Map<const JacobianBlockType> block(&m_blocks[0] + m_blockOffsets[t], rows, k);
+    m_gram.topLeftCorner(k, k).noalias() = block.adjoint() * block;
+    const StorageIndex* positions = &m_pairPositions[0] + m_pairOffsets[t];
+    for (Index b = 0; b < k; ++b)
+      for (Index a = b; a < k; ++a)
+        values[*positions++] += m_gram(order[a], order[b]);
+    for (Index a = 0; a < k; ++a)
+      m_gradient[inputs[a]] += block.col(a).dot(m_fvec.segment(m_functor.termValueOffset(t), rows));
+    order += k;
+  }
+  m_hessianDiag.resize(n);
+  for (Index j = 0; j < n; ++j)
+    m_hessianDiag[j] = values[m_diagPositions[j]];
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_SPARSE_LEVENBERGMARQUARDT_H
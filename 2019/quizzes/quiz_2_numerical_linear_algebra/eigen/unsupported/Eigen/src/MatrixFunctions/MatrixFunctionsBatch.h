@@ -0,0 +1,658 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MATRIX_FUNCTIONS_BATCH
+#define EIGEN_MATRIX_FUNCTIONS_BATCH
+
+namespace Eigen {
+
+namespace internal {
+
+/*****************************************************
+*** Batched exponential and logarithm of small     ***
+*** square matrices                                ***
+*****************************************************/
+
+// Pade approximants of a fixed degree for each scalar type, with the largest 1-norms for which they are accurate,
+// see matrix_exp_computeUV and matrix_log_compute_big.
+template<typename Scalar> struct matrix_function_batch_traits;
+
+template<> struct matrix_function_batch_traits<float>
+{
+  enum { ExpDegree = 7, LogDegree = 5 };
+  static float expMaxNorm() { return 3.925724783138660f; }
+  static float logMaxNorm() { return 5.3149729967117310e-1f; }
+  static const float* logNodes()
+  {
+    static const float nodes[] = { 0.0469100770306680036011865608503035f, 0.2307653449471584544818427896498956f,
+      0.5000000000000000000000000000000000f, 0.7692346550528415455181572103501044f, 0.9530899229693319963988134391496965f };
+    return nodes;
+  }
+  static const float* logWeights()
+  {
+    static const float weights[] = { 0.1184634425280945437571320203599587f, 0.2393143352496832340206457574178191f,
+      0.2844444444444444444444444444444444f, 0.2393143352496832340206457574178191f, 0.1184634425280945437571320203599587f };
+    return weights;
+  }
+};
+
+template<> struct matrix_function_batch_traits<double>
+{
+  enum { ExpDegree = 13, LogDegree = 7 };
+  static double expMaxNorm() { return 5.371920351148152; }
+  static double logMaxNorm() { return 2.6429608311114350e-1; }
+  static const double* logNodes()
+  {
+    static const double nodes[] = { 0.0254460438286207377369051579760744, 0.1292344072003027800680676133596058,
+      0.2970774243113014165466967939615193, 0.5000000000000000000000000000000000, 0.7029225756886985834533032060384807,
+      0.8707655927996972199319323866403942, 0.9745539561713792622630948420239256 };
+    return nodes;
+  }
+  static const double* logWeights()
+  {
+    static const double weights[] = { 0.0647424830844348466353057163395410, 0.1398526957446383339507338857118898,
+      0.1909150252525594724751848877444876, 0.2089795918367346938775510204081633, 0.1909150252525594724751848877444876,
+      0.1398526957446383339507338857118898, 0.0647424830844348466353057163395410 };
+    return weights;
+  }
+};
+
+// The Size x Size matrices of a block are stored as the rows of a row-major array, the coefficient (i,k) of the
+// matrices being the row i+k*Size. Each row operation thus processes the same coefficient of all the matrices
+// of the block, and the per-matrix decisions (number of squarings or square roots, pivots) are lane selections.
+template<typename Scalar, int Size>
+struct matrix_function_batch
+{
+  enum { BlockSize = 64, Entries = Size*Size };
+  typedef matrix_function_batch_traits<Scalar> Traits;
+  typedef Array<Scalar,Entries,Dynamic,RowMajor,Entries,BlockSize> MatBlock;
+  typedef Array<Scalar,1,Dynamic,RowMajor,1,BlockSize> RowType;
+  typedef Array<bool,1,Dynamic,RowMajor,1,BlockSize> MaskType;
+
+  static Index at(Index i, Index k) { return i + k*Size; }
+
+  static void setIdentity(MatBlock& a, Index n)
+  {
+    a.setZero(Entries, n);
+    for(Index i = 0; i < Size; ++i)
+      a.row(at(i,i)).setOnes();
+  }
+
+  // res = a * b, res must not alias the arguments
+  static void product(const MatBlock& a, const MatBlock& b, MatBlock& res)
+  {
+    res.resize(Entries, a.cols());
+    for(Index i = 0; i < Size; ++i)
+      for(Index k = 0; k < Size; ++k)
+      {
+        res.row(at(i,k)) = a.row(at(i,0)) * b.row(at(0,k));
+        for(Index m = 1; m < Size; ++m)
+          res.row(at(i,k)) += a.row(at(i,m)) * b.row(at(m,k));
+      }
+  }
+
+  // res = a - I
+  static void identityDifference(const MatBlock& a, MatBlock& res)
+  {
+    res = a;
+    for(Index i = 0; i < Size; ++i)
+      res.row(at(i,i)) -= Scalar(1);
+  }
+
+  // res = ||a||_1
+  static void norm1(const MatBlock& a, RowType& res)
+  {
+    RowType sum;
+    for(Index k = 0; k < Size; ++k)
+    {
+      sum = a.row(at(0,k)).abs();
+      for(Index i = 1; i < Size; ++i)
+        sum += a.row(at(i,k)).abs();
+      if(k==0)
+        res = sum;
+      else
+        res = (res.max)(sum);
+    }
+  }
+
+  static void swapRows(const MaskType& mask, MatBlock& a, Index i, Index j, Index from)
+  {
+    RowType tmp;
+    for(Index k = from; k < Size; ++k)
+    {
+      tmp = a.row(at(i,k));
+      a.row(at(i,k)) = mask.select(a.row(at(j,k)), tmp);
+      a.row(at(j,k)) = mask.select(tmp, a.row(at(j,k)));
+    }
+  }
+
+  // Solves a x = b in place of b by Gaussian elimination with partial pivoting, a being overwritten.
+  // The pivots are chosen per matrix by conditional swaps.
+  static void solve(MatBlock& a, MatBlock& b)
+  {
+    MaskType larger;
+    RowType inv, factor;
+    for(Index k = 0; k < Size; ++k)
+    {
+      for(Index i = k+1; i < Size; ++i)
+      {
+        larger = a.row(at(i,k)).abs() > a.row(at(k,k)).abs();
+        swapRows(larger, a, k, i, k);
+        swapRows(larger, b, k, i, 0);
+      }
+      inv = a.row(at(k,k)).inverse();
+      for(Index i = k+1; i < Size; ++i)
+      {
+        factor = a.row(at(i,k)) * inv;
+        for(Index j = k+1; j < Size; ++j)
+          a.row(at(i,j)) -= factor * a.row(at(k,j));
+        for(Index j = 0; j < Size; ++j)
+          b.row(at(i,j)) -= factor * b.row(at(k,j));
+      }
+    }
+    for(Index k = Size-1; k >= 0; --k)
+    {
+      inv = a.row(at(k,k)).inverse();
+      for(Index j = 0; j < Size; ++j)
+      {
+        for(Index m = k+1; m < Size; ++m)
+          b.row(at(k,j)) -= a.row(at(k,m)) * b.row(at(m,j));
+        b.row(at(k,j)) *= inv;
+      }
+    }
+  }
+
+  // res = 2^e for each lane
+  static void pow2(const RowType& e, RowType& res)
+  {
+    res.resize(1, e.cols());
+    for(Index j = 0; j < e.cols(); ++j)
+      res(j) = std::ldexp(Scalar(1), int(e(j)));
+  }
+
+  // U and V of the (7,7)-Pade approximant of exp(a), see matrix_exp_pade7()
+  static void pade7(const MatBlock& a, MatBlock& U, MatBlock& V)
+  {
+    const Scalar b[] = {17297280.L, 8648640.L, 1995840.L, 277200.L, 25200.L, 1512.L, 56.L, 1.L};
+    MatBlock A2, A4, A6, tmp;
+    product(a, a, A2);
+    product(A2, A2, A4);
+    product(A4, A2, A6);
+    tmp = b[7] * A6 + b[5] * A4 + b[3] * A2;
+    V = b[6] * A6 + b[4] * A4 + b[2] * A2;
+    for(Index i = 0; i < Size; ++i)
+    {
+      tmp.row(at(i,i)) += b[1];
+      V.row(at(i,i)) += b[0];
+    }
+    product(a, tmp, U);
+  }
+
+  // U and V of the (13,13)-Pade approximant of exp(a), see matrix_exp_pade13()
+  static void pade13(const MatBlock& a, MatBlock& U, MatBlock& V)
+  {
+    const Scalar b[] = {64764752532480000.L, 32382376266240000.L, 7771770303897600.L,
+                        1187353796428800.L, 129060195264000.L, 10559470521600.L, 670442572800.L,
+                        33522128640.L, 1323241920.L, 40840800.L, 960960.L, 16380.L, 182.L, 1.L};
+    MatBlock A2, A4, A6, tmp, tmp2;
+    product(a, a, A2);
+    product(A2, A2, A4);
+    product(A4, A2, A6);
+    tmp2 = b[13] * A6 + b[11] * A4 + b[9] * A2;
+    product(A6, tmp2, tmp);
+    tmp += b[7] * A6 + b[5] * A4 + b[3] * A2;
+    for(Index i = 0; i < Size; ++i)
+      tmp.row(at(i,i)) += b[1];
+    product(a, tmp, U);
+    tmp2 = b[12] * A6 + b[10] * A4 + b[8] * A2;
+    product(A6, tmp2, V);
+    V += b[6] * A6 + b[4] * A4 + b[2] * A2;
+    for(Index i = 0; i < Size; ++i)
+      V.row(at(i,i)) += b[0];
+  }
+
+  // res = exp(a) by scaling and squaring, the number of squarings being chosen per matrix as in
+  // matrix_exp_computeUV, and the block being squared until its largest number of squarings.
+  static void exp(const MatBlock& a, MatBlock& res)
+  {
+    const Index n = a.cols();
+    RowType norm, squarings(1,n), scale;
+    norm1(a, norm);
+    for(Index j = 0; j < n; ++j)
+    {
+      int s;
+      std::frexp(norm(j) / Traits::expMaxNorm(), &s);
+      squarings(j) = Scalar(numext::maxi(s, 0));
+    }
+    pow2(-squarings, scale);
+    MatBlock A = a.rowwise() * scale, U, V, denom;
+    if(Traits::ExpDegree==13)
+      pade13(A, U, V);
+    else
+      pade7(A, U, V);
+    res = V + U;
+    denom = V - U;
+    solve(denom, res);
+
+    const int maxSquarings = int(squarings.maxCoeff());
+    MaskType mask;
+    for(int k = 0; k < maxSquarings; ++k)
+    {
+      product(res, res, A);
+      mask = squarings > Scalar(k);
+      for(Index i = 0; i < Entries; ++i)
+        res.row(i) = mask.select(A.row(i), res.row(i));
+    }
+  }
+
+  // res = sqrt(a) by the Denman-Beavers iteration, for the lanes of mask
+  static void sqrt(const MatBlock& a, const MaskType& mask, MatBlock& res)
+  {
+    const Index n = a.cols();
+    const Scalar tol = Scalar(Size) * NumTraits<Scalar>::epsilon();
+    MatBlock Y = a, Z, Yinv, Zinv, tmp;
+    setIdentity(Z, n);
+    MaskType active = mask;
+    RowType change, norm;
+    for(int iter = 0; iter < 64 && active.any(); ++iter)
+    {
+      setIdentity(Yinv, n);
+      tmp = Y;
+      solve(tmp, Yinv);
+      setIdentity(Zinv, n);
+      tmp = Z;
+      solve(tmp, Zinv);
+      tmp = Scalar(0.5) * (Y + Zinv);
+      Z = Scalar(0.5) * (Z + Yinv);
+      norm1(tmp - Y, change);
+      norm1(tmp, norm);
+      Y = tmp;
+      active = active && (change > tol * norm);
+    }
+    res = Y;
+  }
+
+  // res = log(a) by inverse scaling and squaring, as matrix_log_compute_big but without the Schur form and
+  // with a Pade approximant of fixed degree.
+  static void log(const MatBlock& a, MatBlock& res)
+  {
+    const Index n = a.cols();
+    MatBlock T = a, root, M;
+    RowType norm, roots = RowType::Zero(1,n), scale;
+    MaskType mask;
+    for(int k = 0; k < 64; ++k)
+    {
+      identityDifference(T, M);
+      norm1(M, norm);
+      mask = norm > Traits::logMaxNorm();
+      if(!mask.any())
+        break;
+      sqrt(T, mask, root);
+      for(Index i = 0; i < Entries; ++i)
+        T.row(i) = mask.select(root.row(i), T.row(i));
+      roots += mask.template cast<Scalar>();
+    }
+
+    // log(T) = sum_k w_k (I + x_k (T-I))^-1 (T-I)
+    identityDifference(T, M);
+    res.setZero(Entries, n);
+    for(int k = 0; k < Traits::LogDegree; ++k)
+    {
+      MatBlock lhs = Traits::logNodes()[k] * M, rhs = M;
+      for(Index i = 0; i < Size; ++i)
+        lhs.row(at(i,i)) += Scalar(1);
+      solve(lhs, rhs);
+      res += Traits::logWeights()[k] * rhs;
+    }
+    pow2(roots, scale);
+    res.rowwise() *= scale;
+  }
+};
+
+template<int Size, typename ArgType, typename ResultType>
+void matrix_function_batch_run(bool logarithm, const ArgType& arg, ResultType& res)
+{
+  typedef matrix_function_batch<typename ArgType::Scalar, Size> Impl;
+  typename Impl::MatBlock a, r;
+  const Index size = arg.cols();
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    a = arg.middleCols(j,n).array();
+    if(logarithm)
+      Impl::log(a, r);
+    else
+      Impl::exp(a, r);
+    res.middleCols(j,n) = r.matrix();
+  }
+}
+
+template<typename ArgType, typename ResultType>
+void matrix_function_batch_dispatch(bool logarithm, const MatrixBase<ArgType>& arg, const MatrixBase<ResultType>& result)
+{
+  typedef typename ArgType::Scalar Scalar;
+  EIGEN_STATIC_ASSERT((is_same<Scalar,float>::value || is_same<Scalar,double>::value), THIS_TYPE_IS_NOT_SUPPORTED)
+  EIGEN_STATIC_ASSERT((is_same<Scalar,typename ResultType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  ResultType& res = result.const_cast_derived();
+  res.resize(arg.rows(), arg.cols());
+  switch(arg.rows())
+  {
+    case 4:  matrix_function_batch_run<2>(logarithm, arg.derived(), res); break;
+    case 9:  matrix_function_batch_run<3>(logarithm, arg.derived(), res); break;
+    case 16: matrix_function_batch_run<4>(logarithm, arg.derived(), res); break;
+    default: eigen_assert(false && "the matrices must be 2x2, 3x3 or 4x4 matrices stored as the columns of a 4xN, 9xN or 16xN matrix");
+  }
+}
+
+/*****************************************************
+*** Batched exponential and logarithm maps of      ***
+*** SO(3) and SE(3)                                ***
+*****************************************************/
+
+// The rotation vectors, rotations and rigid transformations of a block are stored as the rows of row-major
+// arrays, a rotation R being stored as the rows i+3*k for R(i,k), and the translation t of a rigid transformation
+// as the rows 9+i after its rotation.
+template<typename Scalar>
+struct lie_group_batch
+{
+  enum { BlockSize = 128 };
+  typedef Array<Scalar,3,Dynamic,RowMajor,3,BlockSize> VecBlock;
+  typedef Array<Scalar,6,Dynamic,RowMajor,6,BlockSize> TwistBlock;
+  typedef Array<Scalar,12,Dynamic,RowMajor,12,BlockSize> TransformBlock;
+  typedef Array<Scalar,1,Dynamic,RowMajor,1,BlockSize> RowType;
+  typedef Array<bool,1,Dynamic,RowMajor,1,BlockSize> MaskType;
+
+  // res = a x b
+  template<typename A, typename B>
+  static void cross(const A& a, const B& b, VecBlock& res)
+  {
+    res.resize(3, a.cols());
+    res.row(0) = a.row(1) * b.row(2) - a.row(2) * b.row(1);
+    res.row(1) = a.row(2) * b.row(0) - a.row(0) * b.row(2);
+    res.row(2) = a.row(0) * b.row(1) - a.row(1) * b.row(0);
+  }
+
+  // sum_k c[k] x^k
+  static void horner(const Scalar* c, int count, const RowType& x, RowType& res)
+  {
+    res = RowType::Constant(1, x.cols(), c[count-1]);
+    for(int k = count-2; k >= 0; --k)
+      res = res * x + c[k];
+  }
+
+  // R = exp([w]x) = I + A [w]x + B [w]x^2 with A = sin(theta)/theta and B = (1-cos(theta))/theta^2, which are
+  // computed from sinc(theta/2) without cancellation. Also returns theta^2, A and B.
+  template<typename W, typename R>
+  static void so3Exp(const W& w, R& res, RowType& theta2, RowType& A, RowType& B)
+  {
+    theta2 = w.row(0).square() + w.row(1).square() + w.row(2).square();
+    const RowType half = Scalar(0.5) * theta2.sqrt();
+    const RowType sinc = (half == Scalar(0)).select(RowType::Ones(1, w.cols()), half.sin() / half);
+    A = sinc * half.cos();
+    B = Scalar(0.5) * sinc.square();
+
+    RowType offDiag;
+    for(Index i = 0; i < 3; ++i)
+    {
+      res.row(4*i) = Scalar(1) - B * (theta2 - w.row(i).square());
+      const Index j = (i+1) % 3, k = (i+2) % 3;
+      offDiag = B * w.row(i) * w.row(j);
+      res.row(i + 3*j) = offDiag - A * w.row(k);
+      res.row(j + 3*i) = offDiag + A * w.row(k);
+    }
+  }
+
+  // w such that exp([w]x) = R, with the angle in [0, pi]. Near pi, the axis is taken from the symmetric part of R.
+  template<typename R>
+  static void so3Log(const R& rot, VecBlock& w)
+  {
+    const Index n = rot.cols();
+    VecBlock u(3,n), axis[3];
+    for(Index i = 0; i < 3; ++i)
+    {
+      const Index j = (i+1) % 3, k = (i+2) % 3;
+      u.row(i) = Scalar(0.5) * (rot.row(k + 3*j) - rot.row(j + 3*k));
+    }
+    RowType c = Scalar(0.5) * (rot.row(0) + rot.row(4) + rot.row(8) - Scalar(1));
+    c = (c.max)(Scalar(-1));
+    c = (c.min)(Scalar(1));
+    const RowType s = (u.row(0).square() + u.row(1).square() + u.row(2).square()).sqrt();
+    // theta = atan2(s, c)
+    const RowType theta = (c >= s).select((s / c).atan(), Scalar(0.5*EIGEN_PI) - (c / s).atan());
+
+    // near pi, a a^T = (R + R^T)/2 - c I) / (1 - c), using the largest diagonal coefficient, with the sign of u
+    const RowType invOneMinusC = (Scalar(1) - c).inverse();
+    RowType diag[3], dot;
+    for(Index i = 0; i < 3; ++i)
+      diag[i] = (((rot.row(4*i) - c) * invOneMinusC).max)(Scalar(0));
+    for(Index i = 0; i < 3; ++i)
+    {
+      const RowType ai = diag[i].sqrt();
+      const RowType scale = Scalar(0.5) * invOneMinusC / ai;
+      axis[i].resize(3, n);
+      for(Index j = 0; j < 3; ++j)
+        axis[i].row(j) = j==i ? ai : RowType(scale * (rot.row(i + 3*j) + rot.row(j + 3*i)));
+    }
+    const MaskType first = diag[0] >= diag[1] && diag[0] >= diag[2], second = diag[1] >= diag[2];
+    for(Index j = 0; j < 3; ++j)
+      axis[0].row(j) = first.select(axis[0].row(j), second.select(axis[1].row(j), axis[2].row(j)));
+    dot = (axis[0] * u).colwise().sum();
+    const RowType nearPi = (dot < Scalar(0)).select(-theta, theta);
+    const RowType scale = (s == Scalar(0)).select(RowType::Ones(1,n), theta / s);
+
+    w.resize(3, n);
+    for(Index j = 0; j < 3; ++j)
+      w.row(j) = (c < Scalar(0)).select(nearPi * axis[0].row(j), scale * u.row(j));
+  }
+
+  // The rotation of exp(xi) is exp([w]x) and its translation V v with V = I + B [w]x + C [w]x^2, and
+  // C = (theta - sin(theta))/theta^3, which is evaluated by its Taylor series for small angles.
+  static void se3Exp(const TwistBlock& xi, TransformBlock& res)
+  {
+    static const Scalar taylor[] = { Scalar(1)/Scalar(6), Scalar(-1)/Scalar(120), Scalar(1)/Scalar(5040),
+      Scalar(-1)/Scalar(362880), Scalar(1)/Scalar(39916800), Scalar(-1)/Scalar(6227020800.), Scalar(1)/Scalar(1307674368000.) };
+    RowType theta2, A, B, C;
+    res.resize(12, xi.cols());
+    so3Exp(xi.template topRows<3>(), res, theta2, A, B);
+    horner(taylor, 7, theta2, C);
+    C = (theta2 < Scalar(0.25)).select(C, (Scalar(1) - A) / theta2);
+    VecBlock wv, wwv;
+    cross(xi.template topRows<3>(), xi.template bottomRows<3>(), wv);
+    cross(xi.template topRows<3>(), wv, wwv);
+    res.template bottomRows<3>() = xi.template bottomRows<3>() + wv.rowwise() * B + wwv.rowwise() * C;
+  }
+
+  // The inverse of V is I - [w]x / 2 + D [w]x^2 with D = (1 - h cot(h)) / theta^2 and h = theta/2, which
+  // is evaluated by its Taylor series for small angles.
+  static void se3Log(const TransformBlock& transform, TwistBlock& res)
+  {
+    static const Scalar taylor[] = { Scalar(1)/Scalar(12), Scalar(1)/Scalar(180), Scalar(1)/Scalar(1890),
+      Scalar(1)/Scalar(18900), Scalar(1)/Scalar(187110), Scalar(1382)/Scalar(2554051500.), Scalar(1)/Scalar(18243225) };
+    VecBlock w, wt, wwt;
+    so3Log(transform.template topRows<9>(), w);
+    const RowType h2 = Scalar(0.25) * (w.row(0).square() + w.row(1).square() + w.row(2).square());
+    const RowType h = h2.sqrt();
+    RowType D;
+    horner(taylor, 7, h2, D);
+    D = (h2 < Scalar(0.1)).select(D, (Scalar(1) - h * h.cos() / h.sin()) / (Scalar(4) * h2));
+    cross(w, transform.template bottomRows<3>(), wt);
+    cross(w, wt, wwt);
+    res.resize(6, transform.cols());
+    res.template topRows<3>() = w;
+    res.template bottomRows<3>() = transform.template bottomRows<3>() - Scalar(0.5) * wt + wwt.rowwise() * D;
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup MatrixFunctions_Module
+  *
+  * \name Batched matrix exponentials and logarithms
+  *
+  * The following functions compute the exponential and logarithm of sets of small matrices, and the
+  * exponential and logarithm maps of the rotation group SO(3) and the rigid transformation group SE(3).
+  * Each matrix or group element is a column of the arguments, the coefficients of a matrix being stored in
+  * column-major order. An array of fixed-size matrices can therefore be processed through a Map:
+  * \code
+  * std::vector<Matrix3f> m(n);
+  * Map<Matrix<float,9,Dynamic> > ms(m[0].data(), 9, n);
+  * \endcode
+  *
+  * The columns are processed by blocks transposed to a structure of arrays layout, such that each SIMD
+  * instruction operates on several matrices, and the decisions made per matrix, such as the number of
+  * squarings, are lane selections. The result can be the same as the argument. Only \c float and \c double
+  * are supported.
+  *
+  * @{
+  */
+
+/** Computes the exponentials of the 2x2, 3x3 or 4x4 matrices stored as the columns of a 4 x N, 9 x N or 16 x N
+  * matrix.
+  *
+  * As MatrixBase::exp(), this uses scaling and squaring with a Pad&eacute; approximant, of degree 13 for double and
+  * 7 for float. The number of squarings is chosen for each matrix from its 1-norm.
+  *
+  * \sa \ref matrixbase_exp "MatrixBase::exp()" */
+template<typename ArgType, typename ResultType>
+void batchMatrixExp(const MatrixBase<ArgType>& arg, const MatrixBase<ResultType>& result)
+{
+  internal::matrix_function_batch_dispatch(false, arg, result);
+}
+
+/** Computes the principal logarithms of the 2x2, 3x3 or 4x4 matrices stored as the columns of a 4 x N, 9 x N
+  * or 16 x N matrix. The matrices must not have eigenvalues on the closed negative real axis.
+  *
+  * The logarithms are computed by inverse scaling and squaring: square roots are taken by the Denman-Beavers
+  * iteration until each matrix is close enough to the identity for a Pad&eacute; approximant, of degree 7 for double
+  * and 5 for float. Unlike MatrixBase::log(), the matrices are not reduced to their Schur forms.
+  *
+  * \sa \ref matrixbase_log "MatrixBase::log()" */
+template<typename ArgType, typename ResultType>
+void batchMatrixLog(const MatrixBase<ArgType>& arg, const MatrixBase<ResultType>& result)
+{
+  internal::matrix_function_batch_dispatch(true, arg, result);
+}
+
+/** Computes the rotation matrices \f$ \exp([\omega]_\times) \f$ of the rotation vectors \f$ \omega \f$ stored as the
+  * columns of a 3 x N matrix. The rotation matrices are stored as the columns of a 9 x N matrix.
+  *
+  * This is Rodrigues' formula, with the same result as AngleAxis::toRotationMatrix() for the angle
+  * \f$ \|\omega\| \f$ about the axis \f$ \omega/\|\omega\| \f$.
+  *
+  * \sa batchSO3Log() */
+template<typename ArgType, typename ResultType>
+void batchSO3Exp(const MatrixBase<ArgType>& rotationVectors, const MatrixBase<ResultType>& result)
+{
+  typedef typename ArgType::Scalar Scalar;
+  typedef internal::lie_group_batch<Scalar> Impl;
+  EIGEN_STATIC_ASSERT((internal::is_same<Scalar,typename ResultType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(rotationVectors.rows()==3);
+  ResultType& res = result.const_cast_derived();
+  const Index size = rotationVectors.cols();
+  res.resize(9, size);
+  typename Impl::VecBlock w;
+  Array<Scalar,9,Dynamic,RowMajor,9,Impl::BlockSize> rot;
+  typename Impl::RowType theta2, A, B;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    w = rotationVectors.middleCols(j,n).array();
+    rot.resize(9, n);
+    Impl::so3Exp(w, rot, theta2, A, B);
+    res.middleCols(j,n) = rot.matrix();
+  }
+}
+
+/** Computes the rotation vectors \f$ \omega \f$, of norm at most \f$ \pi \f$, such that \f$ \exp([\omega]_\times) \f$
+  * are the rotation matrices stored as the columns of a 9 x N matrix. The rotation vectors are stored as the
+  * columns of a 3 x N matrix.
+  *
+  * The angle is computed from both the trace and the skew-symmetric part of the rotation, and for angles larger
+  * than \f$ \pi/2 \f$ the axis is computed from the symmetric part, so that the result is accurate up to \f$ \pi \f$.
+  *
+  * \sa batchSO3Exp() */
+template<typename ArgType, typename ResultType>
+void batchSO3Log(const MatrixBase<ArgType>& rotations, const MatrixBase<ResultType>& result)
+{
+  typedef typename ArgType::Scalar Scalar;
+  typedef internal::lie_group_batch<Scalar> Impl;
+  EIGEN_STATIC_ASSERT((internal::is_same<Scalar,typename ResultType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(rotations.rows()==9);
+  ResultType& res = result.const_cast_derived();
+  const Index size = rotations.cols();
+  res.resize(3, size);
+  typename Impl::VecBlock w;
+  Array<Scalar,9,Dynamic,RowMajor,9,Impl::BlockSize> rot;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    rot = rotations.middleCols(j,n).array();
+    Impl::so3Log(rot, w);
+    res.middleCols(j,n) = w.matrix();
+  }
+}
+
+/** Computes the rigid transformations \f$ \exp(\hat\xi) \f$ of the twists \f$ \xi = (\omega, v) \f$ stored as the
+  * columns of a 6 x N matrix, the rotation vector \f$ \omega \f$ first. The transformations are stored as the columns
+  * of a 12 x N matrix, each one being the top 3 x 4 part \f$ [R\ t] \f$ of the 4 x 4 homogeneous matrix in
+  * column-major order, which is also the storage of Transform<Scalar,3,AffineCompact>.
+  *
+  * \sa batchSE3Log(), batchSO3Exp() */
+template<typename ArgType, typename ResultType>
+void batchSE3Exp(const MatrixBase<ArgType>& twists, const MatrixBase<ResultType>& result)
+{
+  typedef internal::lie_group_batch<typename ArgType::Scalar> Impl;
+  EIGEN_STATIC_ASSERT((internal::is_same<typename ArgType::Scalar,typename ResultType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(twists.rows()==6);
+  ResultType& res = result.const_cast_derived();
+  const Index size = twists.cols();
+  res.resize(12, size);
+  typename Impl::TwistBlock xi;
+  typename Impl::TransformBlock transform;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    xi = twists.middleCols(j,n).array();
+    Impl::se3Exp(xi, transform);
+    res.middleCols(j,n) = transform.matrix();
+  }
+}
+
+/** Computes the twists \f$ \xi = (\omega, v) \f$, with \f$ \|\omega\| \le \pi \f$, of the rigid transformations stored
+  * as the columns of a 12 x N matrix as in batchSE3Exp(). The twists are stored as the columns of a 6 x N matrix.
+  *
+  * \sa batchSE3Exp(), batchSO3Log() */
+template<typename ArgType, typename ResultType>
+void batchSE3Log(const MatrixBase<ArgType>& transforms, const MatrixBase<ResultType>& result)
+{
+  typedef internal::lie_group_batch<typename ArgType::Scalar> Impl;
+  EIGEN_STATIC_ASSERT((internal::is_same<typename ArgType::Scalar,typename ResultType::Scalar>::value),
+                      YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(transforms.rows()==12);
+  ResultType& res = result.const_cast_derived();
+  const Index size = transforms.cols();
+  res.resize(6, size);
+  typename Impl::TwistBlock xi;
+  typename Impl::TransformBlock transform;
+  for(Index j = 0; j < size; j += Impl::BlockSize)
+  {
+    const Index n = numext::mini<Index>(Impl::BlockSize, size-j);
+    transform = transforms.middleCols(j,n).array();
+    Impl::se3Log(transform, xi);
+    res.middleCols(j,n) = xi.matrix();
+  }
+}
+
+/** @} */
+
+} // end namespace Eigen
+
+#endif // EIGEN_MATRIX_FUNCTIONS_BATCH
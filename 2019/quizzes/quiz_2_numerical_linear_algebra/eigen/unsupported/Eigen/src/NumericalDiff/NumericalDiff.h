@@ -21,6 +21,50 @@ enum NumericalDiffMode {
 };
 
 
+namespace internal {
+
+template<typename Derived, typename PatternType>
+void numericaldiff_init_jacobian(DenseBase<Derived>& jac, const PatternType& pattern)
+{
+    jac.derived().setZero(pattern.rows(), pattern.cols());
+}
+
+template<typename Derived, typename PatternType>
+void numericaldiff_init_jacobian(SparseMatrixBase<Derived>& jac, const PatternType& pattern)
+{
+    jac.derived() = pattern;
+}
+
+// The columns of a dense Jacobian are written directly, each by a single thread.
+template<typename Derived, typename ValueType, typename Scalar, typename Triplets>
+void numericaldiff_set_column(DenseBase<Derived>& jac, Index j, const ValueType& diff, const Scalar& h, Triplets&)
+{
+    jac.col(j) = diff/h;
+}
+
+// The columns of a sparse Jacobian cannot be inserted concurrently, their nonzeros are
+// collected by each thread and then assembled by numericaldiff_set_from_triplets().
+template<typename Derived, typename ValueType, typename Scalar, typename Triplets>
+void numericaldiff_set_column(SparseMatrixBase<Derived>&, Index j, const ValueType& diff, const Scalar& h, Triplets& triplets)
+{
+    for (Index i = 0; i < diff.size(); ++i)
+        if (diff[i] != Scalar(0))
+            triplets.push_back(typename Triplets::value_type(i, j, diff[i]/h));
+}
+
+template<typename Derived, typename Triplets>
+void numericaldiff_set_from_triplets(DenseBase<Derived>&, const Triplets&)
+{
+}
+
+template<typename Derived, typename Triplets>
+void numericaldiff_set_from_triplets(SparseMatrixBase<Derived>& jac, const Triplets& triplets)
+{
+    jac.derived().setFromTriplets(triplets.begin(), triplets.end());
+}
+
+} // end namespace internal
+
 /**
   * This class allows you to add a method df() to your functor, which will 
   * use numerical differentiation to compute an approximate of the
@@ -31,6 +75,16 @@ enum NumericalDiffMode {
   * http://en.wikipedia.org/wiki/Numerical_differentiation
   *
   * Currently only "Forward" and "Central" scheme are implemented.
+  *
+  * When the sparsity pattern of the Jacobian is known, setSparsityPattern()
+  * groups the columns which have no nonzero row in common, so that all the
+  * columns of a group are perturbed at once and recovered from a single
+  * evaluation (Curtis-Powell-Reid compression). The Jacobian type of the
+  * functor can also be a SparseMatrix, which then receives the pattern.
+  *
+  * When OpenMP is enabled, setThreads() evaluates the perturbed inputs in
+  * parallel, in which case the functor must support concurrent calls to
+  * its operator().
   */
 template<typename _Functor, NumericalDiffMode mode=Forward>
 class NumericalDiff : public _Functor
@@ -41,46 +95,116 @@ public:
     typedef typename Functor::InputType InputType;
     typedef typename Functor::ValueType ValueType;
     typedef typename Functor::JacobianType JacobianType;
+    typedef SparseMatrix<Scalar> PatternType;
 
-    NumericalDiff(Scalar _epsfcn=0.) : Functor(), epsfcn(_epsfcn) {}
-    NumericalDiff(const Functor& f, Scalar _epsfcn=0.) : Functor(f), epsfcn(_epsfcn) {}
+    NumericalDiff(Scalar _epsfcn=0.) : Functor(), epsfcn(_epsfcn), m_threads(1) {}
+    NumericalDiff(const Functor& f, Scalar _epsfcn=0.) : Functor(f), epsfcn(_epsfcn), m_threads(1) {}
 
     // forward constructors
     template<typename T0>
-        NumericalDiff(const T0& a0) : Functor(a0), epsfcn(0) {}
+        NumericalDiff(const T0& a0) : Functor(a0), epsfcn(0), m_threads(1) {}
     template<typename T0, typename T1>
-        NumericalDiff(const T0& a0, const T1& a1) : Functor(a0, a1), epsfcn(0) {}
+        NumericalDiff(const T0& a0, const T1& a1) : Functor(a0, a1), epsfcn(0), m_threads(1) {}
     template<typename T0, typename T1, typename T2>
-        NumericalDiff(const T0& a0, const T1& a1, const T2& a2) : Functor(a0, a1, a2), epsfcn(0) {}
+        NumericalDiff(const T0& a0, const T1& a1, const T2& a2) : Functor(a0, a1, a2), epsfcn(0), m_threads(1) {}
 
     enum {
         InputsAtCompileTime = Functor::InputsAtCompileTime,
         ValuesAtCompileTime = Functor::ValuesAtCompileTime
     };
 
+    /**
+      * Sets the number of threads evaluating the perturbed inputs, 0 meaning
+      * Eigen::nbThreads(). The default, 1, calls the functor sequentially.
+      * This has no effect unless OpenMP is enabled.
+      */
+    void setThreads(int threads) { eigen_assert(threads >= 0); m_threads = threads; }
+
+    /** \returns the number of threads set by setThreads() */
+    int threads() const { return m_threads; }
+
+    /**
+      * Sets the sparsity pattern of the Jacobian, the nonzero coefficients of
+      * \a pattern, and groups its columns so that those of a group have no
+      * nonzero row in common. Every group then costs a single evaluation of the
+      * functor (two in Central mode) instead of one per column.
+      */
+    template<typename Derived>
+    void setSparsityPattern(const SparseMatrixBase<Derived>& pattern)
+    {
+        m_pattern = pattern.derived().template cast<Scalar>();
+        m_pattern.makeCompressed();
+        const Index n = m_pattern.cols();
+        const SparseMatrix<Scalar,RowMajor,typename PatternType::StorageIndex> rows = m_pattern;
+
+        // greedy coloring of the column intersection graph, largest columns first
+        std::vector<std::pair<Index,Index> > order(n);
+        for (Index j = 0; j < n; ++j)
+            order[j] = std::make_pair(-Index(m_pattern.col(j).nonZeros()), j);
+        std::sort(order.begin(), order.end());
+        std::vector<Index> colors(n, -1), forbidden;
+        for (Index k = 0; k < n; ++k) {
+            const Index j = order[k].second;
+            for (typename PatternType::InnerIterator it(m_pattern, j); it; ++it)
+                for (typename SparseMatrix<Scalar,RowMajor,typename PatternType::StorageIndex>::InnerIterator jt(rows, it.row()); jt; ++jt)
+                    if (colors[jt.col()] >= 0)
+                        forbidden[colors[jt.col()]] = j;
+            Index c = 0;
+            while (c < Index(forbidden.size()) && forbidden[c] == j)
+                ++c;
+            if (c == Index(forbidden.size()))
+                forbidden.push_back(-1);
+            colors[j] = c;
+        }
+
+        m_groupOffsets.assign(forbidden.size() + 1, 0);
+        for (Index j = 0; j < n; ++j)
+            ++m_groupOffsets[colors[j] + 1];
+        for (size_t c = 0; c < forbidden.size(); ++c)
+            m_groupOffsets[c + 1] += m_groupOffsets[c];
+        m_groupColumns.resize(n);
+        std::vector<Index> next(m_groupOffsets.begin(), m_groupOffsets.end() - 1);
+        for (Index j = 0; j < n; ++j)
+            m_groupColumns[next[colors[j]]++] = j;
+    }
+
+    /** Discards the sparsity pattern, every column being computed separately */
+    void clearSparsityPattern()
+    {
+        m_pattern.resize(0, 0);
+        m_groupOffsets.clear();
+        m_groupColumns.clear();
+    }
+
+    /** \returns the number of groups of columns computed together, or -1 if
+      * no sparsity pattern is set */
+    Index groups() const { return m_groupOffsets.empty() ? Index(-1) : Index(m_groupOffsets.size()) - 1; }
+
     /**
       * return the number of evaluation of functor
      */
     int df(const InputType& _x, JacobianType &jac) const
     {
         using std::sqrt;
-        using std::abs;
-        /* Local variables */
-        Scalar h;
-        int nfev=0;
-        const typename InputType::Index n = _x.size();
+        const Index n = _x.size();
         const Scalar eps = sqrt(((std::max)(epsfcn,NumTraits<Scalar>::epsilon() )));
-        ValueType val1, val2;
-        InputType x = _x;
-        // TODO : we should do this only if the size is not already known
-        val1.resize(Functor::values());
-        val2.resize(Functor::values());
+        const bool compressed = !m_groupOffsets.empty();
+        const Index groups = compressed ? Index(m_groupOffsets.size()) - 1 : n;
+        ValueType val0;
+        eigen_assert(!compressed || (m_pattern.rows() == Functor::values() && m_pattern.cols() == n));
+
+        if (compressed)
+            internal::numericaldiff_init_jacobian(jac, m_pattern);
+        else
+            jac.resize(Functor::values(), n);
+        std::vector<Triplet<Scalar,Index> > triplets;
 
         // initialization
         switch(mode) {
             case Forward:
                 // compute f(x)
-                Functor::operator()(x, val1); nfev++;
+                val0.resize(Functor::values());
+                Functor::operator()(_x, val0);
                 break;
             case Central:
                 // do nothing
@@ -90,35 +214,74 @@ public:
         };
 
         // Function Body
-        for (int j = 0; j < n; ++j) {
-            h = eps * abs(x[j]);
-            if (h == 0.) {
-                h = eps;
+#ifdef EIGEN_HAS_OPENMP
+        int threads = 1;
+        if (m_threads != 1 && groups > 1 && omp_get_num_threads() == 1) {
+            Eigen::initParallel();
+            threads = m_threads > 0 ? m_threads : nbThreads();
+        }
+        #pragma omp parallel num_threads(threads)
+#endif
+        {
+            ValueType val1, val2;
+            InputType x = _x;
+            std::vector<Triplet<Scalar,Index> > threadTriplets;
+            val1.resize(Functor::values());
+            val2.resize(Functor::values());
+#ifdef EIGEN_HAS_OPENMP
+            #pragma omp for schedule(dynamic)
+#endif
+            for (Index g = 0; g < groups; ++g) {
+                const Index* begin = compressed ? &m_groupColumns[0] + m_groupOffsets[g] : &g;
+                const Index* end = compressed ? &m_groupColumns[0] + m_groupOffsets[g + 1] : &g + 1;
+                for (const Index* j = begin; j != end; ++j)
+                    x[*j] += step(_x[*j], eps);
+                Functor::operator()(x, val2);
+                switch(mode) {
+                    case Forward:
+                        val2 -= val0;
+                        break;
+                    case Central:
+                        for (const Index* j = begin; j != end; ++j)
+                            x[*j] -= 2*step(_x[*j], eps);
+                        Functor::operator()(x, val1);
+                        val2 -= val1;
+                        break;
+                    default:
+                        eigen_assert(false);
+                };
+                for (const Index* j = begin; j != end; ++j) {
+                    x[*j] = _x[*j];
+                    const Scalar h = mode == Central ? 2*step(_x[*j], eps) : step(_x[*j], eps);
+                    if (compressed) {
+                        for (typename PatternType::InnerIterator it(m_pattern, *j); it; ++it)
+                            jac.coeffRef(it.row(), *j) = val2[it.row()]/h;
+                    }
+                    else
+                        internal::numericaldiff_set_column(jac, *j, val2, h, threadTriplets);
+                }
             }
-            switch(mode) {
-                case Forward:
-                    x[j] += h;
-                    Functor::operator()(x, val2);
-                    nfev++;
-                    x[j] = _x[j];
-                    jac.col(j) = (val2-val1)/h;
-                    break;
-                case Central:
-                    x[j] += h;
-                    Functor::operator()(x, val2); nfev++;
-                    x[j] -= 2*h;
-                    Functor::operator()(x, val1); nfev++;
-                    x[j] = _x[j];
-                    jac.col(j) = (val2-val1)/(2*h);
-                    break;
-                default:
-                    eigen_assert(false);
-            };
+#ifdef EIGEN_HAS_OPENMP
+            #pragma omp critical
+#endif
+            triplets.insert(triplets.end(), threadTriplets.begin(), threadTriplets.end());
         }
-        return nfev;
+        if (!compressed)
+            internal::numericaldiff_set_from_triplets(jac, triplets);
+        return int(mode == Central ? 2*groups : groups + 1);
     }
 private:
+    static Scalar step(const Scalar& xj, const Scalar& eps)
+    {
+        using std::abs;
+        const Scalar h = eps * abs(xj);
+        return h == 0. ? eps : h;
+    }
+
     Scalar epsfcn;
+    int m_threads;
+    PatternType m_pattern;
+    std::vector<Index> m_groupOffsets, m_groupColumns;
 
     NumericalDiff& operator=(const NumericalDiff&);
 };
@@ -0,0 +1,264 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_POLYNOMIAL_REAL_ROOTS_H
+#define EIGEN_POLYNOMIAL_REAL_ROOTS_H
+
+namespace Eigen {
+
+namespace internal {
+
+// The closed-form solvers work on blocks of polynomials stored as arrays of lanes, one array per
+// coefficient of the monic polynomials, so that every operation is vectorized across the block.
+// Missing roots are set to +infinity.
+template<typename Scalar>
+struct poly_real_roots_impl
+{
+  enum { Lanes = 16 };
+  typedef Array<Scalar,Lanes,1> LaneArray;
+
+  static LaneArray infinity() { return LaneArray::Constant(NumTraits<Scalar>::infinity()); }
+
+  static LaneArray cbrt(const LaneArray& x)
+  {
+    return x.sign() * x.abs().pow(Scalar(1)/Scalar(3));
+  }
+
+  // x^2 + c[1] x + c[0]
+  static void quadratic(const LaneArray* c, LaneArray* r)
+  {
+    const LaneArray disc = c[1].square() - Scalar(4)*c[0];
+    const LaneArray sq = (disc.max)(Scalar(0)).sqrt();
+    const LaneArray q = Scalar(-0.5) * (c[1] + (c[1] < Scalar(0)).select(-sq, sq));
+    r[0] = (disc < Scalar(0)).select(infinity(), q);
+    r[1] = (disc < Scalar(0)).select(infinity(), (q != Scalar(0)).select(c[0] / q, Scalar(0)));
+  }
+
+  // x^3 + c[2] x^2 + c[1] x + c[0], through the depressed cubic t^3 + p t + q with x = t - c[2]/3
+  static void cubic(const LaneArray* c, LaneArray* r)
+  {
+    const Scalar third = Scalar(1)/Scalar(3);
+    const LaneArray shift = c[2] * third;
+    const LaneArray p = c[1] - c[2] * shift;
+    const LaneArray h = Scalar(0.5) * (c[0] - c[1] * shift) + shift.cube();
+    const LaneArray disc = h.square() + (p * third).cube();
+
+    // one real root, Cardano's formula avoiding cancellations
+    const LaneArray a = -h.sign() * cbrt(h.abs() + (disc.max)(Scalar(0)).sqrt());
+    const LaneArray t = a + (a != Scalar(0)).select(-p * third / a, Scalar(0));
+
+    // three real roots, trigonometric solution
+    const LaneArray rho = ((-p * third).max)(Scalar(0)).sqrt();
+    const LaneArray cosine = (rho != Scalar(0)).select(-h / rho.cube(), Scalar(0));
+    const LaneArray phi = (((cosine.max)(Scalar(-1))).min)(Scalar(1)).acos() * third;
+    const Scalar angle = Scalar(2) * Scalar(EIGEN_PI) * third;
+
+    r[0] = (disc > Scalar(0)).select(t, Scalar(2) * rho * phi.cos()) - shift;
+    r[1] = (disc > Scalar(0)).select(infinity(), Scalar(2) * rho * (phi - angle).cos() - shift);
+    r[2] = (disc > Scalar(0)).select(infinity(), Scalar(2) * rho * (phi + angle).cos() - shift);
+  }
+
+  // x^4 + c[3] x^3 + c[2] x^2 + c[1] x + c[0], through Ferrari's method on the depressed quartic
+  // y^4 + p y^2 + q y + s with x = y - c[3]/4
+  static void quartic(const LaneArray* c, LaneArray* r)
+  {
+    const LaneArray shift = Scalar(0.25) * c[3];
+    const LaneArray shift2 = shift.square();
+    const LaneArray p = c[2] - Scalar(6) * shift2;
+    const LaneArray q = c[1] - Scalar(2) * shift * c[2] + Scalar(8) * shift * shift2;
+    const LaneArray s = c[0] - shift * c[1] + shift2 * c[2] - Scalar(3) * shift2.square();
+
+    // the largest root m of the resolvent cubic m^3 + p m^2 + (p^2/4 - s) m - q^2/8, which is nonnegative,
+    // splits the quartic into y^2 -+ sqrt(2m) y + p/2 + m +- q/(2 sqrt(2m))
+    LaneArray resolvent[3], m[3];
+    resolvent[0] = Scalar(-0.125) * q.square();
+    resolvent[1] = Scalar(0.25) * p.square() - s;
+    resolvent[2] = p;
+    cubic(resolvent, m);
+    polish(resolvent, 3, m, 3);
+    LaneArray largest = m[0];
+    for (int k = 1; k < 3; ++k)
+      largest = (m[k] < infinity()).select((largest.max)(m[k]), largest);
+    largest = (largest.max)(Scalar(0));
+
+    const LaneArray w = (Scalar(2) * largest).sqrt();
+    const LaneArray scale = p.abs() + s.abs().sqrt();
+    const Array<bool,Lanes,1> split = w > NumTraits<Scalar>::epsilon() * scale;
+    LaneArray quad[2], y[4];
+    quad[1] = -w;
+    quad[0] = Scalar(0.5) * p + largest + split.select(Scalar(0.5) * q / w, Scalar(0));
+    quadratic(quad, y);
+    quad[1] = w;
+    quad[0] = Scalar(0.5) * p + largest - split.select(Scalar(0.5) * q / w, Scalar(0));
+    quadratic(quad, y + 2);
+
+    // y^4 + p y^2 + s, for vanishing q
+    LaneArray z[2];
+    quad[1] = p;
+    quad[0] = s;
+    quadratic(quad, z);
+    for (int k = 0; k < 2; ++k)
+    {
+      const LaneArray root = (z[k] >= Scalar(0) && z[k] < infinity()).select((z[k].max)(Scalar(0)).sqrt(), infinity());
+      y[2*k] = split.select(y[2*k], root);
+      y[2*k+1] = split.select(y[2*k+1], (root < infinity()).select(-root, infinity()));
+    }
+
+    for (int k = 0; k < 4; ++k)
+      r[k] = (y[k] < infinity()).select(y[k] - shift, infinity());
+  }
+
+  // Newton iterations on the monic polynomial of degree deg, keeping the iterates which decrease |p|
+  static void polish(const LaneArray* c, int deg, LaneArray* r, int count)
+  {
+    for (int k = 0; k < count; ++k)
+    {
+      const Array<bool,Lanes,1> valid = r[k] < infinity();
+      LaneArray x = valid.select(r[k], Scalar(0)), fx, dfx;
+      eval(c, deg, x, fx, dfx);
+      for (int it = 0; it < 2; ++it)
+      {
+        const LaneArray next = (dfx != Scalar(0)).select(x - fx / dfx, x);
+        LaneArray fnext, dfnext;
+        eval(c, deg, next, fnext, dfnext);
+        const Array<bool,Lanes,1> better = fnext.abs() < fx.abs();
+        x = better.select(next, x);
+        fx = better.select(fnext, fx);
+        dfx = better.select(dfnext, dfx);
+      }
+      r[k] = valid.select(x, r[k]);
+    }
+  }
+
+  static void eval(const LaneArray* c, int deg, const LaneArray& x, LaneArray& fx, LaneArray& dfx)
+  {
+    fx = x + c[deg-1];
+    dfx = LaneArray::Ones();
+    for (int i = deg-2; i >= 0; --i)
+    {
+      dfx = dfx * x + fx;
+      fx = fx * x + c[i];
+    }
+  }
+
+  // sorts the roots of each lane, the missing ones last, by odd-even transposition
+  static void sort(LaneArray* r, int count)
+  {
+    for (int pass = 0; pass < count; ++pass)
+      for (int k = pass % 2; k + 1 < count; k += 2)
+      {
+        const LaneArray lo = (r[k].min)(r[k+1]);
+        r[k+1] = (r[k].max)(r[k+1]);
+        r[k] = lo;
+      }
+  }
+
+  static void run(const LaneArray* c, int deg, LaneArray* r)
+  {
+    switch (deg)
+    {
+      case 1: r[0] = -c[0]; return;
+      case 2: quadratic(c, r); break;
+      case 3: cubic(c, r); break;
+      case 4: quartic(c, r); break;
+      default: eigen_assert(false && "poly_real_roots: the degree must be at most 4");
+    }
+    polish(c, deg, r, deg);
+    sort(r, deg);
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup Polynomials_Module
+ * Computes the real roots of a batch of polynomials of degree at most 4 with closed-form formulas.
+ *
+ * \param[in] polys : the coefficients of the polynomials, one polynomial per column ordered by
+ *  degrees i.e. polys(i,j) is the coefficient of degree i of the j-th polynomial. The degree is
+ *  polys.rows()-1, between 1 and 4, and it is lowered for the polynomials whose leading
+ *  coefficients vanish.
+ * \param[out] roots : a polys.rows()-1 by polys.cols() matrix whose j-th column receives the real
+ *  roots of the j-th polynomial sorted in increasing order, followed by NaN.
+ * \param[out] counts : the numbers of real roots, counted with their multiplicities.
+ *
+ * The polynomials are solved by blocks, each operation being vectorized across the polynomials of a
+ * block: the quadratic formula, Cardano's or the trigonometric formula for cubics, Ferrari's method
+ * for quartics, followed by two Newton iterations on every root. Unlike PolynomialSolver, this
+ * does not allocate, and the accuracy is comparable for simple roots. As for any method, a root
+ * of multiplicity \a k is only accurate to about \f$ \epsilon^{1/k} \f$, and may be lost or
+ * split when the rounding errors turn it into a pair of complex roots.
+ *
+ * \sa PolynomialSolver
+ */
+template<typename Polynomials, typename Roots, typename Counts>
+void poly_real_roots( const MatrixBase<Polynomials>& polys, const MatrixBase<Roots>& roots_, const MatrixBase<Counts>& counts_ )
+{
+  typedef typename Polynomials::Scalar Scalar;
+  typedef internal::poly_real_roots_impl<Scalar> Impl;
+  typedef typename Impl::LaneArray LaneArray;
+  typedef typename Counts::Scalar CountType;
+  const Index lanes = Impl::Lanes;
+  const int deg = int(polys.rows()) - 1;
+  const Index n = polys.cols();
+  Roots& roots = roots_.const_cast_derived();
+  Counts& counts = counts_.const_cast_derived();
+  eigen_assert(deg >= 0 && deg <= 4);
+  roots.resize(deg, n);
+  counts.resize(n);
+  if (deg == 0)
+  {
+    counts.setZero();
+    return;
+  }
+
+  LaneArray c[4], r[4];
+  for (Index j0 = 0; j0 < n; j0 += lanes)
+  {
+    const Index size = (std::min)(lanes, n - j0);
+    // the monic polynomials, the missing lanes of the last block and the polynomials of lower degree
+    // being replaced by x^deg
+    Array<bool,Impl::Lanes,1> lower;
+    for (Index l = 0; l < lanes; ++l)
+    {
+      const Index j = j0 + l;
+      const Scalar lead = l < size ? Scalar(polys(deg, j)) : Scalar(1);
+      lower[l] = l < size && !(lead != Scalar(0) && (numext::isfinite)(Scalar(Scalar(1) / lead)));
+      const bool monomial = l >= size || lower[l];
+      for (int i = 0; i < deg; ++i)
+        c[i][l] = monomial ? Scalar(0) : Scalar(polys(i, j) / lead);
+    }
+    Impl::run(c, deg, r);
+    for (Index l = 0; l < size; ++l)
+    {
+      const Index j = j0 + l;
+      if (lower[l])
+      {
+        // a plain vector, so that the recursion does not nest block expressions
+        const Matrix<Scalar,Dynamic,1,0,4,1> lowerPoly = polys.col(j).head(deg);
+        Matrix<Scalar,Dynamic,Dynamic,0,4,4> lowerRoots;
+        Matrix<CountType,Dynamic,1,0,4,1> lowerCount;
+        poly_real_roots(lowerPoly, lowerRoots, lowerCount);
+        counts[j] = lowerCount[0];
+        roots.col(j).head(deg-1) = lowerRoots;
+        roots(deg-1, j) = std::numeric_limits<Scalar>::quiet_NaN();
+        continue;
+      }
+      CountType count = 0;
+      for (int k = 0; k < deg; ++k)
+      {
+        const bool real = r[k][l] < NumTraits<Scalar>::infinity();
+        roots(k, j) = real ? r[k][l] : std::numeric_limits<Scalar>::quiet_NaN();
+        count += real ? 1 : 0;
+      }
+      counts[j] = count;
+    }
+  }
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_POLYNOMIAL_REAL_ROOTS_H
@@ -119,6 +119,27 @@ zeta(const Eigen::ArrayBase<DerivedX>& x, const Eigen::ArrayBase<DerivedQ>& q)
   );
 }
 
+/** \cpp11 \returns an expression of the coefficient-wise ndtri(\a p) to the given array.
+  *
+  * It returns the inverse of the cumulative distribution function of the standard normal distribution,
+  * that is the value \c x such that the area under the Gaussian density from minus infinity to \c x is \a p.
+  *
+  * \param p must be in [0,1], ndtri(0) is minus infinity and ndtri(1) is plus infinity
+  *
+  * \note This function supports only float and double scalar types in c++11 mode. To support other scalar types,
+  * the user has to provide implementations of ndtri(T) for any scalar type T to be supported.
+  *
+  * \sa Eigen::erf(), Eigen::erfc()
+  */
+template<typename Derived>
+inline const Eigen::CwiseUnaryOp<Eigen::internal::scalar_ndtri_op<typename Derived::Scalar>, const Derived>
+ndtri(const Eigen::ArrayBase<Derived>& p)
+{
+  return Eigen::CwiseUnaryOp<Eigen::internal::scalar_ndtri_op<typename Derived::Scalar>, const Derived>(
+    p.derived()
+  );
+}
+
 } // end namespace Eigen
 
 #endif // EIGEN_SPECIALFUNCTIONS_ARRAYAPI_H
@@ -104,7 +104,7 @@ template<typename Scalar> struct scalar_lgamma_op {
   EIGEN_DEVICE_FUNC inline const Scalar operator() (const Scalar& a) const {
     using numext::lgamma; return lgamma(a);
   }
-  typedef typename packet_traits<Scalar>::type Packet;
+  template<typename Packet>
   EIGEN_DEVICE_FUNC inline Packet packetOp(const Packet& a) const { return internal::plgamma(a); }
 };
 template<typename Scalar>
@@ -126,7 +126,7 @@ template<typename Scalar> struct scalar_digamma_op {
   EIGEN_DEVICE_FUNC inline const Scalar operator() (const Scalar& a) const {
     using numext::digamma; return digamma(a);
   }
-  typedef typename packet_traits<Scalar>::type Packet;
+  template<typename Packet>
   EIGEN_DEVICE_FUNC inline Packet packetOp(const Packet& a) const { return internal::pdigamma(a); }
 };
 template<typename Scalar>
@@ -193,7 +193,7 @@ template<typename Scalar> struct scalar_erf_op {
   EIGEN_DEVICE_FUNC inline const Scalar operator() (const Scalar& a) const {
     using numext::erf; return erf(a);
   }
-  typedef typename packet_traits<Scalar>::type Packet;
+  template<typename Packet>
   EIGEN_DEVICE_FUNC inline Packet packetOp(const Packet& a) const { return internal::perf(a); }
 };
 template<typename Scalar>
@@ -216,7 +216,7 @@ template<typename Scalar> struct scalar_erfc_op {
   EIGEN_DEVICE_FUNC inline const Scalar operator() (const Scalar& a) const {
     using numext::erfc; return erfc(a);
   }
-  typedef typename packet_traits<Scalar>::type Packet;
+  template<typename Packet>
   EIGEN_DEVICE_FUNC inline Packet packetOp(const Packet& a) const { return internal::perfc(a); }
 };
 template<typename Scalar>
@@ -229,6 +229,29 @@ struct functor_traits<scalar_erfc_op<Scalar> >
   };
 };
 
+/** \internal
+ * \brief Template functor to compute the inverse of the standard normal
+ * cumulative distribution function of a scalar
+ * \sa class CwiseUnaryOp, Eigen::ndtri()
+ */
+template<typename Scalar> struct scalar_ndtri_op {
+  EIGEN_EMPTY_STRUCT_CTOR(scalar_ndtri_op)
+  EIGEN_DEVICE_FUNC inline const Scalar operator() (const Scalar& a) const {
+    using numext::ndtri; return ndtri(a);
+  }
+  template<typename Packet>
+  EIGEN_DEVICE_FUNC inline Packet packetOp(const Packet& a) const { return internal::pndtri(a); }
+};
+template<typename Scalar>
+struct functor_traits<scalar_ndtri_op<Scalar> >
+{
+  enum {
+    // Guesstimate
+    Cost = 10 * NumTraits<Scalar>::MulCost + 5 * NumTraits<Scalar>::AddCost,
+    PacketAccess = packet_traits<Scalar>::HasNdtri
+  };
+};
+
 } // end namespace internal
 
 } // end namespace Eigen
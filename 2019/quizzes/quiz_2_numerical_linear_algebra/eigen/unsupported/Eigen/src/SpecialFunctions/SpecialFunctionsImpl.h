@@ -397,6 +397,95 @@ struct erfc_impl<double> {
 };
 #endif  // EIGEN_HAS_C99_MATH
 
+/***************************************************************************
+* Implementation of ndtri, requires C++11/C99                              *
+****************************************************************************/
+
+template <typename Scalar>
+struct ndtri_impl {
+  EIGEN_DEVICE_FUNC
+  static EIGEN_STRONG_INLINE Scalar run(const Scalar) {
+    EIGEN_STATIC_ASSERT((internal::is_same<Scalar, Scalar>::value == false),
+                        THIS_TYPE_IS_NOT_SUPPORTED);
+    return Scalar(0);
+  }
+};
+
+template <typename Scalar>
+struct ndtri_retval {
+  typedef Scalar type;
+};
+
+#if EIGEN_HAS_C99_MATH
+/* ndtri(p) is the argument x for which the area under the standard normal
+ * density from -inf to x equals p.
+ *
+ * The rational approximations of P. J. Acklam have a relative error below
+ * 1.15e-9; one step of Halley's method on erfc brings the result to full
+ * double precision. The upper half is mirrored onto the lower one, where
+ * 1-p is exact and erfc does not cancel.
+ */
+template <>
+struct ndtri_impl<double> {
+  EIGEN_DEVICE_FUNC
+  static double run(const double p) {
+    const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                        -2.759285104469687e+02, 1.383577518672690e+02,
+                        -3.066479806614716e+01, 2.506628277459239e+00};
+    const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                        -1.556989798598866e+02, 6.680131188771972e+01,
+                        -1.328068155288572e+01, 1.0};
+    const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                        -2.400758277161838e+00, -2.549732539343734e+00,
+                        4.374664141464968e+00, 2.938163982698783e+00};
+    const double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+                        2.445134137142996e+00, 3.754408661907416e+00, 1.0};
+    const double p_low = 0.02425;
+
+    if ((numext::isnan)(p) || p < 0.0 || p > 1.0) {
+      return NumTraits<double>::quiet_NaN();
+    }
+    if (p == 0.0) {
+      return -NumTraits<double>::infinity();
+    }
+    if (p == 1.0) {
+      return NumTraits<double>::infinity();
+    }
+    if (p > 0.5) {
+      return -run(1.0 - p);
+    }
+
+    double x;
+    if (p < p_low) {
+      const double q = numext::sqrt(-2.0 * numext::log(p));
+      x = cephes::polevl<double, 5>::run(q, c) /
+          cephes::polevl<double, 4>::run(q, d);
+    } else {
+      const double q = p - 0.5;
+      const double r = q * q;
+      x = q * cephes::polevl<double, 5>::run(r, a) /
+          cephes::polevl<double, 5>::run(r, b);
+    }
+
+    // exp(x*x/2) overflows below, where x is already as accurate as p
+    if (x > -37.0) {
+      const double e = 0.5 * erfc_impl<double>::run(-x / 1.41421356237309504880) - p;
+      const double u = e * 2.50662827463100050242 * numext::exp(0.5 * x * x);
+      x = x - u / (1.0 + 0.5 * x * u);
+    }
+    return x;
+  }
+};
+
+template <>
+struct ndtri_impl<float> {
+  EIGEN_DEVICE_FUNC
+  static EIGEN_STRONG_INLINE float run(const float p) {
+    return static_cast<float>(ndtri_impl<double>::run(p));
+  }
+};
+#endif  // EIGEN_HAS_C99_MATH
+
 /**************************************************************************************************************
  * Implementation of igammac (complemented incomplete gamma integral), based on Cephes but requires C++11/C99 *
  **************************************************************************************************************/
@@ -1539,6 +1628,12 @@ EIGEN_DEVICE_FUNC inline EIGEN_MATHFUNC_RETVAL(erfc, Scalar)
   return EIGEN_MATHFUNC_IMPL(erfc, Scalar)::run(x);
 }
 
+template <typename Scalar>
+EIGEN_DEVICE_FUNC inline EIGEN_MATHFUNC_RETVAL(ndtri, Scalar)
+    ndtri(const Scalar& p) {
+  return EIGEN_MATHFUNC_IMPL(ndtri, Scalar)::run(p);
+}
+
 template <typename Scalar>
 EIGEN_DEVICE_FUNC inline EIGEN_MATHFUNC_RETVAL(igamma, Scalar)
     igamma(const Scalar& a, const Scalar& x) {
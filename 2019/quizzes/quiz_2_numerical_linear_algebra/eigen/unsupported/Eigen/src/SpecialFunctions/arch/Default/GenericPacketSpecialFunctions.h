@@ -0,0 +1,310 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GENERIC_PACKET_SPECIAL_FUNCTIONS_H
+#define EIGEN_GENERIC_PACKET_SPECIAL_FUNCTIONS_H
+
+namespace Eigen {
+
+namespace internal {
+
+/* Branch-free single precision kernels shared by the SSE and AVX packet
+ * specializations of perf, perfc, plgamma, pdigamma and pndtri.
+ *
+ * Every lane evaluates all the pieces of the approximation and the result
+ * is picked with pselect, so these only rely on the basic arithmetic,
+ * comparison, plog, pexp and psqrt packet primitives. The error bounds
+ * quoted below were measured against double precision references on
+ * 2^22 samples per range; subnormal inputs of plog are flushed to the
+ * smallest normal float which limits the accuracy in the extreme tails.
+ */
+
+/** \internal \returns the polynomial with the \a N coefficients \a c, highest degree first, at \a x */
+template<typename Packet, int N>
+EIGEN_STRONG_INLINE Packet ppolevl_float(const Packet& x, const float (&c)[N])
+{
+  Packet r = pset1<Packet>(c[0]);
+  for(int i=1; i<N; ++i)
+    r = pmadd(r, x, pset1<Packet>(c[i]));
+  return r;
+}
+
+/** \internal Reduces \a a >= 0 to r = a - round(a) and computes s = sin(pi*|r|) and c = cos(pi*|r|).
+  * Arguments above 2^23 are integers and give r = 0. \returns r */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet psincospi_reduced_float(const Packet& a, Packet& s, Packet& c)
+{
+  // Taylor series of sin(z)/z and cos(z) in z^2, exact to float precision on [0,pi/4]
+  static const float sin_coeffs[] = { 2.7557319223985890653e-06f, -1.9841269841269841270e-04f,
+                                      8.3333333333333333333e-03f, -1.6666666666666666667e-01f, 1.f };
+  static const float cos_coeffs[] = { -2.7557319223985890653e-07f, 2.4801587301587301587e-05f,
+                                      -1.3888888888888888889e-03f, 4.1666666666666666667e-02f, -0.5f, 1.f };
+  const Packet two23 = pset1<Packet>(8388608.f);
+  const Packet n = pselect(pcmp_lt(a, two23), psub(padd(a, two23), two23), a);
+  const Packet r = psub(a, n);
+  // sin(pi*t) = cos(pi*(1/2-t)) folds |r| into [0,1/4]
+  const Packet t = pabs(r);
+  const Packet fold = pcmp_lt(pset1<Packet>(0.25f), t);
+  const Packet z = pmul(pset1<Packet>(float(EIGEN_PI)), pselect(fold, psub(pset1<Packet>(0.5f), t), t));
+  const Packet z2 = pmul(z, z);
+  const Packet sz = pmul(z, ppolevl_float(z2, sin_coeffs));
+  const Packet cz = ppolevl_float(z2, cos_coeffs);
+  s = pselect(fold, cz, sz);
+  c = pselect(fold, sz, cz);
+  return r;
+}
+
+/** \internal \returns erf(x) for |x| < 1 as x*P(x^2) */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet perf_small_float(const Packet& x)
+{
+  // Minimax fit of erf(x)/x on [0,1] in x^2
+  static const float coeffs[] = { 7.85384709055530239483e-05f, -8.01018930510166895175e-04f,
+                                  5.18832719392939675848e-03f, -2.68538116764346811875e-02f,
+                                  1.12835851424268227610e-01f, -3.76126258236882656194e-01f,
+                                  1.12837916572663178648e+00f };
+  return pmul(x, ppolevl_float(pmul(x, x), coeffs));
+}
+
+/** \internal \returns erfc(x) for x >= 1/2 as exp(-x^2)*g(x) */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet perfc_large_float(const Packet& x)
+{
+  // Minimax fits of exp(x^2)*erfc(x) in x-3/4 on [1/2,1], and of x*exp(x^2)*erfc(x)
+  // in 1/x on [1,2] and [2,9.43]
+  static const float coeffs0[] = { 2.47621224184939910616e-03f, -6.18496857371460130930e-03f,
+                                   1.42882197511957667112e-02f, -3.18909943106292383916e-02f,
+                                   6.67905305936748801575e-02f, -1.29836170714699553717e-01f,
+                                   2.30958132013299318215e-01f, -3.67972691147790934653e-01f,
+                                   5.06937650291880243132e-01f };
+  static const float coeffs1[] = { 1.37340424601904544209e-02f, -8.42809714755014146686e-02f,
+                                   2.07899013469688626743e-01f, -2.26637891293334135990e-01f,
+                                   -1.44444906904723393229e-02f, 3.55148201248386370476e-01f,
+                                   -4.10001601111866788182e-01f, 2.38549143588443769817e-02f,
+                                   5.62312359438386336833e-01f };
+  static const float coeffs2[] = { -2.69444576713447845137e-01f, 4.56491853748751611792e-01f,
+                                   6.39874203270165691304e-02f, -7.31201792383402455718e-01f,
+                                   6.50240323937200756510e-01f, -4.14133378312419973160e-02f,
+                                   -2.77586397119691785857e-01f, -2.70919866141755187583e-04f,
+                                   5.64196485244135918151e-01f };
+  // clears the 12 low mantissa bits
+  static const union { unsigned int i; float f; } hi_mask = { 0xfffff000u };
+
+  const Packet one = pset1<Packet>(1.f);
+  const Packet xc = pmin(x, pset1<Packet>(10.5f));
+  const Packet u = pdiv(one, xc);
+  const Packet lower = pcmp_lt(xc, one);
+  const Packet upper = pcmp_le(pset1<Packet>(2.f), xc);
+  const Packet v = pselect(lower, psub(xc, pset1<Packet>(0.75f)), u);
+  Packet g = pzero(x);
+  for(int i=0; i<9; ++i)
+    g = pmadd(g, v, pselect(lower, pset1<Packet>(coeffs0[i]),
+                            pselect(upper, pset1<Packet>(coeffs2[i]), pset1<Packet>(coeffs1[i]))));
+  // exp(-x^2) from the split x = xh + xl with xh*xh exact, so that the
+  // rounding of x^2 does not show up in the result. Beyond x = 9 it is
+  // scaled by exp(16) to stay in the range of pexp until the result is
+  // subnormal.
+  const Packet xh = pand(xc, pset1<Packet>(hi_mask.f));
+  const Packet xl = psub(xc, xh);
+  const Packet scaled = pcmp_lt(pset1<Packet>(9.f), xc);
+  const Packet xh2 = psub(pmul(xh, xh), pand(scaled, pset1<Packet>(16.f)));
+  const Packet e = pmul(pexp(pnegate(xh2)), pexp(pnegate(pmul(xl, padd(xc, xh)))));
+  const Packet r = pmul(pmul(e, g), pselect(lower, one, u));
+  return pselect(scaled, pmul(r, pset1<Packet>(1.12535174719259114916e-07f)), r);
+}
+
+/** \internal \returns erf(\a x) for float packets.
+  * The maximal error is 3 ulp. */
+template<typename Packet>
+Packet perf_float(const Packet& x)
+{
+  const Packet one = pset1<Packet>(1.f);
+  const Packet ax = pabs(x);
+  Packet large = psub(one, perfc_large_float(pmax(ax, one)));
+  large = pselect(pcmp_lt(x, pzero(x)), pnegate(large), large);
+  const Packet r = pselect(pcmp_lt(ax, one), perf_small_float(x), large);
+  return pselect(pcmp_eq(x, x), r, x);
+}
+
+/** \internal \returns erfc(\a x) for float packets.
+  * The maximal error is 5 ulp down to the subnormal range reached at x = 9.2,
+  * 8 ulp when pexp is built with FMA; subnormal results are within 1 ulp of FLT_MIN. */
+template<typename Packet>
+Packet perfc_float(const Packet& x)
+{
+  const Packet one = pset1<Packet>(1.f);
+  const Packet ax = pabs(x);
+  const Packet half = pset1<Packet>(0.5f);
+  Packet large = perfc_large_float(pmax(ax, half));
+  large = pselect(pcmp_lt(x, pzero(x)), psub(pset1<Packet>(2.f), large), large);
+  const Packet r = pselect(pcmp_lt(ax, half), psub(one, perf_small_float(x)), large);
+  return pselect(pcmp_eq(x, x), r, x);
+}
+
+/** \internal \returns lgamma(\a y) for y > 0 */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet plgamma_positive_float(const Packet& y)
+{
+  // Minimax fit of lgamma(2+t)/t on [-1/2,1/2]
+  static const float coeffs[] = { 1.22360948693494781599e-04f, -2.53619065700096800595e-04f,
+                                  5.01518456725822789663e-04f, -1.18595909047451334408e-03f,
+                                  2.89173235492537885124e-03f, -7.38615866920727986391e-03f,
+                                  2.05807344209941932652e-02f, -6.73522822470870940017e-02f,
+                                  3.22467034688050916585e-01f, 4.22784335006521426703e-01f };
+  const Packet one = pset1<Packet>(1.f);
+  const Packet half = pset1<Packet>(0.5f);
+  const Packet eight = pset1<Packet>(8.f);
+
+  // y < 8: move the argument to 2+t with |t| <= 1/2 through lgamma(y+1) = lgamma(y) + log(y).
+  // Below 1.5 the shifted argument is y+1 or y+2 and t is formed from y directly to keep its low bits.
+  const Packet below_half = pcmp_lt(y, half);
+  const Packet below_one_half = pcmp_lt(y, pset1<Packet>(1.5f));
+  Packet w = pmin(y, eight);
+  Packet num = one;
+  for(int i=0; i<6; ++i)
+  {
+    const Packet down = pcmp_le(pset1<Packet>(2.5f), w);
+    w = pselect(down, psub(w, one), w);
+    num = pselect(down, pmul(num, w), num);
+  }
+  Packet t = pselect(below_half, y, pselect(below_one_half, psub(y, one), psub(w, pset1<Packet>(2.f))));
+  const Packet den = pselect(below_half, pmul(y, padd(y, one)), y);
+  // only one of num and den differs from one
+  Packet logq = plog(pselect(below_one_half, den, num));
+  logq = pselect(below_one_half, pnegate(logq), logq);
+  const Packet small = padd(pmul(t, ppolevl_float(t, coeffs)), logq);
+
+  // y >= 8: Stirling's series
+  const Packet yl = pmax(y, eight);
+  const Packet inv = pdiv(one, yl);
+  const Packet inv2 = pmul(inv, inv);
+  const Packet corr = pmul(inv, psub(pset1<Packet>(1.f/12.f), pmul(inv2, psub(pset1<Packet>(1.f/360.f),
+                                                                                    pmul(inv2, pset1<Packet>(1.f/1260.f))))));
+  const Packet large = padd(pmul(psub(yl, half), psub(plog(yl), one)),
+                            padd(pset1<Packet>(0.41893853320467274178f), corr));
+
+  return pselect(pcmp_lt(y, eight), small, large);
+}
+
+/** \internal \returns lgamma(\a x) for float packets.
+  * The maximal error is 3 ulp relative to max(1,|lgamma(x)|) for x > 0. Negative
+  * arguments go through the reflection formula and lose up to 13 ulp on the same scale
+  * next to the poles, where its two terms cancel. Poles and infinities give +inf. */
+template<typename Packet>
+Packet plgamma_float(const Packet& x)
+{
+  const Packet inf = pset1<Packet>(NumTraits<float>::infinity());
+  const Packet ax = pabs(x);
+  const Packet neg = pcmp_lt(x, pzero(x));
+  const Packet lpos = plgamma_positive_float(ax);
+  // lgamma(x) = log(pi/|x*sin(pi*x)|) - lgamma(-x), where -x is exact unlike 1-x
+  Packet s, c;
+  const Packet r = psincospi_reduced_float(ax, s, c);
+  const Packet lneg = psub(plog(pdiv(pset1<Packet>(float(EIGEN_PI)), pmul(ax, s))), lpos);
+  Packet res = pselect(neg, lneg, lpos);
+  // lgamma(x) = -log|x| + O(x) near 0
+  res = pselect(pcmp_lt(ax, pset1<Packet>(5.9604644775390625e-08f)), pnegate(plog(ax)), res);
+  const Packet pole = pand(neg, por(pcmp_eq(r, pzero(r)), pcmp_le(x, pset1<Packet>(-8388608.f))));
+  res = pselect(por(pole, pcmp_eq(ax, inf)), inf, res);
+  return pselect(pcmp_eq(x, x), res, x);
+}
+
+/** \internal \returns digamma(\a x) for float packets.
+  * The maximal error is 4 ulp relative to max(1,|digamma(x)|) for x > 0 and 10 ulp for
+  * negative arguments, where pi*cot(pi*x) cancels against digamma(1-x). Non-positive
+  * integers give +inf like the scalar version. */
+template<typename Packet>
+Packet pdigamma_float(const Packet& x)
+{
+  // Asymptotic series of digamma in 1/x^2, the coefficients of the scalar float version
+  static const float coeffs[] = { -4.16666666666666666667e-03f, 3.96825396825396825397e-03f,
+                                  -8.33333333333333333333e-03f, 8.33333333333333333333e-02f };
+  const Packet zero = pzero(x);
+  const Packet one = pset1<Packet>(1.f);
+  const Packet ten = pset1<Packet>(10.f);
+  const Packet inf = pset1<Packet>(NumTraits<float>::infinity());
+  const Packet neg = pcmp_le(x, zero);
+  Packet y = pselect(neg, psub(one, x), x);
+
+  // digamma(y) = digamma(y+1) - 1/y until y >= 10. The terms decrease, so the
+  // rounding errors of the sum are recovered exactly in comp.
+  Packet sum = zero;
+  Packet comp = zero;
+  for(int i=0; i<10; ++i)
+  {
+    const Packet up = pcmp_lt(y, ten);
+    const Packet term = pselect(up, pdiv(one, y), zero);
+    const Packet next = padd(sum, term);
+    comp = padd(comp, padd(psub(sum, next), term));
+    sum = next;
+    y = pselect(up, padd(y, one), y);
+  }
+  const Packet inv = pdiv(one, y);
+  const Packet z = pmul(inv, inv);
+  Packet res = psub(psub(plog(y), sum),
+                    padd(padd(pmul(pset1<Packet>(0.5f), inv), pmul(z, ppolevl_float(z, coeffs))), comp));
+
+  // digamma(x) = digamma(1-x) - pi/tan(pi*x)
+  Packet s, c;
+  const Packet r = psincospi_reduced_float(pabs(x), s, c);
+  const Packet sr = pselect(pcmp_lt(r, zero), pnegate(s), s);
+  res = pselect(neg, padd(res, pdiv(pmul(pset1<Packet>(float(EIGEN_PI)), c), sr)), res);
+  const Packet pole = pand(neg, por(pcmp_eq(r, zero), pcmp_le(x, pset1<Packet>(-8388608.f))));
+  res = pselect(por(pole, pcmp_eq(x, inf)), inf, res);
+  return pselect(pcmp_eq(x, x), res, x);
+}
+
+/** \internal \returns ndtri(\a p) for float packets as sqrt(2)*erfinv(2p-1), following the
+  * erfinv approximation of M. Giles: erfinv(x)/x is a polynomial in w = -log(1-x^2) for w < 5 and
+  * in sqrt(w) beyond. Here 1-x^2 = 4p(1-p) is formed from p so that the tails keep full precision.
+  * The maximal error is 7 ulp for p in [2^-126,1-2^-24]. ndtri(0) = -inf, ndtri(1) = +inf and p
+  * outside [0,1] gives NaN. */
+template<typename Packet>
+Packet pndtri_float(const Packet& p)
+{
+  // Minimax fits of erfinv(x)/x in w-2.5 on [0,5], and in sqrt(w)-3 on [5,16] and [16,88]
+  static const float coeffs0[] = { 2.85339910146888254111e-08f, 3.43725995469205087491e-07f,
+                                   -3.52884996023900337472e-06f, -4.39676967149181607059e-06f,
+                                   2.18602158675931347182e-04f, -1.25370755125124897129e-03f,
+                                   -4.17770770463232366735e-03f, 2.46640726148855582011e-01f,
+                                   1.50140942156983023194e+00f };
+  static const float coeffs1[] = { -2.05011140274155527579e-04f, 1.04359611334048982158e-04f,
+                                   1.35591582666922133293e-03f, -3.67704727037287807850e-03f,
+                                   5.73647317428851372711e-03f, -7.62140216697315464468e-03f,
+                                   9.43935538228144977661e-03f, 1.00167402604257207185e+00f,
+                                   2.83297690619604900127e+00f };
+  static const float coeffs2[] = { 2.51721409393987830140e-08f, -8.69477962300377986307e-07f,
+                                   1.32099753798653242010e-05f, -1.16739339420439791861e-04f,
+                                   6.67603387407691842603e-04f, -2.55867023470861150627e-03f,
+                                   5.89793753914780389812e-03f, 1.00321628498635738794e+00f,
+                                   2.83266493909778974570e+00f };
+  const Packet zero = pzero(p);
+  const Packet one = pset1<Packet>(1.f);
+  const Packet inf = pset1<Packet>(NumTraits<float>::infinity());
+
+  const Packet w = pnegate(plog(pmul(pset1<Packet>(4.f), pmul(p, psub(one, p)))));
+  const Packet central = pcmp_lt(w, pset1<Packet>(5.f));
+  const Packet far = pcmp_le(pset1<Packet>(16.f), w);
+  const Packet t = pselect(central, psub(w, pset1<Packet>(2.5f)), psub(psqrt(pmax(w, zero)), pset1<Packet>(3.f)));
+  Packet h = zero;
+  for(int i=0; i<9; ++i)
+    h = pmadd(h, t, pselect(central, pset1<Packet>(coeffs0[i]),
+                            pselect(far, pset1<Packet>(coeffs2[i]), pset1<Packet>(coeffs1[i]))));
+  const Packet x = psub(padd(p, p), one);
+  Packet res = pmul(pset1<Packet>(1.41421356237309504880f), pmul(x, h));
+
+  res = pselect(pcmp_eq(p, zero), pnegate(inf), res);
+  res = pselect(pcmp_eq(p, one), inf, res);
+  const Packet valid = pand(pcmp_le(zero, p), pcmp_le(p, one));
+  return pselect(valid, res, pset1<Packet>(NumTraits<float>::quiet_NaN()));
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_GENERIC_PACKET_SPECIAL_FUNCTIONS_H
@@ -0,0 +1,25 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_SSE_SPECIALFUNCTIONS_H
+#define EIGEN_SSE_SPECIALFUNCTIONS_H
+
+namespace Eigen {
+
+namespace internal {
+
+template<> EIGEN_STRONG_INLINE Packet4f perf<Packet4f>(const Packet4f& a) { return perf_float(a); }
+template<> EIGEN_STRONG_INLINE Packet4f perfc<Packet4f>(const Packet4f& a) { return perfc_float(a); }
+template<> EIGEN_STRONG_INLINE Packet4f plgamma<Packet4f>(const Packet4f& a) { return plgamma_float(a); }
+template<> EIGEN_STRONG_INLINE Packet4f pdigamma<Packet4f>(const Packet4f& a) { return pdigamma_float(a); }
+template<> EIGEN_STRONG_INLINE Packet4f pndtri<Packet4f>(const Packet4f& a) { return pndtri_float(a); }
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_SSE_SPECIALFUNCTIONS_H
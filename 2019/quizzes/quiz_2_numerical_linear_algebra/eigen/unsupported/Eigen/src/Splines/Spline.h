@@ -10,6 +10,8 @@
 #ifndef EIGEN_SPLINE_H
 #define EIGEN_SPLINE_H
 
+#include <vector>
+
 #include "SplineFwd.h"
 
 namespace Eigen
@@ -135,6 +137,36 @@ namespace Eigen
     typename SplineTraits<Spline,DerivativeOrder>::DerivativeType
       derivatives(Scalar u, DenseIndex order = DerivativeOrder) const;
 
+    /**
+     * \brief Evaluation of the spline at several sites.
+     *
+     * The sites may be given in any order, but sorted sites are evaluated
+     * faster since their spans are searched incrementally. The sites falling
+     * into the same knot span are evaluated together, such that the basis
+     * functions are computed for several sites per SIMD instruction.
+     *
+     * \param u Vector of the parameters at which the spline is evaluated.
+     * \param points On output, the Dimension x u.size() array of the spline values.
+     **/
+    template <typename ParameterDerived, typename ResultDerived>
+    void evaluate(const DenseBase<ParameterDerived>& u, const DenseBase<ResultDerived>& points) const;
+
+    /**
+     * \brief Evaluation of spline derivatives of up-to given order at several sites.
+     *
+     * The derivatives of all orders are computed in the same pass over the
+     * sites, as in evaluate(). On output, the columns
+     * \c k*u.size() to \c (k+1)*u.size()-1 of \a ders are the derivatives of
+     * order \c k at the sites \a u, for \c k ranging between 0 and
+     * \c min(order,degree()).
+     *
+     * \param u Vector of the parameters at which the spline derivatives are evaluated.
+     * \param order The order up to which the derivatives are computed.
+     * \param ders On output, the Dimension x ((min(order,degree())+1)*u.size()) array of the derivatives.
+     **/
+    template <typename ParameterDerived, typename ResultDerived>
+    void derivatives(const DenseBase<ParameterDerived>& u, DenseIndex order, const DenseBase<ResultDerived>& ders) const;
+
     /**
      * \brief Computes the non-zero basis functions at the given site.
      *
@@ -356,6 +388,158 @@ namespace Eigen
     return res;
   }
 
+  /* --------------------------------------------------------------------------------------------- */
+
+  namespace internal
+  {
+    template <typename SplineType>
+    struct spline_batch
+    {
+      typedef typename SplineType::Scalar Scalar;
+      typedef typename SplineType::KnotVectorType KnotVectorType;
+      enum { Dimension = SplineType::Dimension };
+      enum { BlockSize = 128 };
+      typedef Array<Scalar,Dynamic,Dynamic,RowMajor> BasisTable;
+      typedef Array<Scalar,1,Dynamic,RowMajor,1,BlockSize> RowType;
+      typedef Array<Scalar,Dimension,Dynamic,RowMajor,Dimension,BlockSize> Block;
+      typedef Array<Scalar,Dimension,Dynamic> LocalControlPoints;
+
+      template <typename ParameterType, typename ResultType>
+      static void run(const SplineType& spline, const ParameterType& u, DenseIndex order, ResultType& res)
+      {
+        const KnotVectorType& U = spline.knots();
+        const DenseIndex p = spline.degree();
+        const DenseIndex n = (std::min)(p, order);
+        const DenseIndex size = u.size();
+        res.resize(static_cast<DenseIndex>(Dimension), (n+1)*size);
+        if (size == 0) return;
+
+        // Find the spans, incrementally from the previous one when the sites are sorted...
+        std::vector<DenseIndex> spans(size), sites(size);
+        bool sorted = true;
+        for (DenseIndex i=1; i<size && sorted; ++i)
+          sorted = !(u(i) < u(i-1));
+        if (sorted)
+        {
+          const DenseIndex last = U.size()-p-2;
+          DenseIndex s = -1;
+          for (DenseIndex i=0; i<size; ++i)
+          {
+            if (u(i) <= U(0))
+              spans[i] = p;
+            else if (s < 0)
+              spans[i] = s = SplineType::Span(u(i), p, U);
+            else
+            {
+              while (s < last && U(s+1) <= u(i)) ++s;
+              spans[i] = s;
+            }
+            sites[i] = i;
+          }
+        }
+        else
+        {
+          // ... and otherwise by bisection, followed by a counting sort of the sites by span.
+          std::vector<DenseIndex> first(U.size()+1, 0);
+          for (DenseIndex i=0; i<size; ++i)
+          {
+            spans[i] = SplineType::Span(u(i), p, U);
+            ++first[spans[i]+1];
+          }
+          for (size_t s=1; s<first.size(); ++s)
+            first[s] += first[s-1];
+          for (DenseIndex i=0; i<size; ++i)
+            sites[first[spans[i]]++] = i;
+        }
+
+        // The basis functions of degree q are stored in the rows q*(q+1)/2 to q*(q+1)/2+q
+        // of the table, and the sites falling into the same span in its columns.
+        BasisTable N((p+1)*(p+2)/2, static_cast<DenseIndex>(BlockSize));
+        BasisTable inv(p+1, p+2);
+        LocalControlPoints Q(static_cast<DenseIndex>(Dimension), (n+1)*(p+1));
+        RowType x;
+        Block values;
+        DenseIndex cached = -1;
+        for (DenseIndex i=0; i<size; )
+        {
+          const DenseIndex s = spans[sites[i]];
+          DenseIndex b = 1;
+          while (i+b<size && b<BlockSize && spans[sites[i+b]]==s) ++b;
+
+          if (s != cached)
+          {
+            // The inverses of the knot differences and the control points of the derivative
+            // curves (NURBS book, Eq. 3.8) only depend on the span.
+            for (DenseIndex q=1; q<=p; ++q)
+              for (DenseIndex r=0; r<=q+1; ++r)
+                inv(q,r) = (r==0 || r>q) ? Scalar(0) : Scalar(1)/(U(s+r)-U(s-q+r));
+            Q.leftCols(p+1) = spline.ctrls().middleCols(s-p, p+1);
+            for (DenseIndex k=1; k<=n; ++k)
+              for (DenseIndex r=0; r<=p-k; ++r)
+                Q.col(k*(p+1)+r) = Scalar(p-k+1)/(U(s+r+1)-U(s-p+r+k))
+                                 * (Q.col((k-1)*(p+1)+r+1) - Q.col((k-1)*(p+1)+r));
+            cached = s;
+          }
+
+          x.resize(b);
+          for (DenseIndex c=0; c<b; ++c)
+            x(c) = u(sites[i+c]);
+
+          // Cox-de Boor recursion, vectorized over the sites
+          N.row(0).head(b).setOnes();
+          for (DenseIndex q=1; q<=p; ++q)
+          {
+            const DenseIndex prev = (q-1)*q/2, cur = q*(q+1)/2;
+            for (DenseIndex r=0; r<=q; ++r)
+            {
+              if (r == 0)
+                N.row(cur).head(b) = (U(s+1)-x) * inv(q,1) * N.row(prev).head(b);
+              else if (r == q)
+                N.row(cur+r).head(b) = (x-U(s)) * inv(q,q) * N.row(prev+r-1).head(b);
+              else
+                N.row(cur+r).head(b) = (x-U(s-q+r)) * inv(q,r) * N.row(prev+r-1).head(b)
+                                     + (U(s+r+1)-x) * inv(q,r+1) * N.row(prev+r).head(b);
+            }
+          }
+
+          // The derivative of order k combines the basis functions of degree p-k.
+          for (DenseIndex k=0; k<=n; ++k)
+          {
+            const DenseIndex q = p-k, row = q*(q+1)/2;
+            values.resize(static_cast<DenseIndex>(Dimension), b);
+            for (DenseIndex d=0; d<Dimension; ++d)
+            {
+              values.row(d) = Q(d,k*(p+1)) * N.row(row).head(b);
+              for (DenseIndex r=1; r<=q; ++r)
+                values.row(d) += Q(d,k*(p+1)+r) * N.row(row+r).head(b);
+            }
+            if (sorted)
+              res.middleCols(k*size+i, b) = values;
+            else
+              for (DenseIndex c=0; c<b; ++c)
+                res.col(k*size+sites[i+c]) = values.col(c);
+          }
+          i += b;
+        }
+      }
+    };
+  }
+
+  template <typename _Scalar, int _Dim, int _Degree>
+  template <typename ParameterDerived, typename ResultDerived>
+  void Spline<_Scalar, _Dim, _Degree>::evaluate(const DenseBase<ParameterDerived>& u, const DenseBase<ResultDerived>& points) const
+  {
+    derivatives(u, 0, points);
+  }
+
+  template <typename _Scalar, int _Dim, int _Degree>
+  template <typename ParameterDerived, typename ResultDerived>
+  void Spline<_Scalar, _Dim, _Degree>::derivatives(const DenseBase<ParameterDerived>& u, DenseIndex order, const DenseBase<ResultDerived>& ders) const
+  {
+    EIGEN_STATIC_ASSERT_VECTOR_ONLY(ParameterDerived)
+    internal::spline_batch<Spline>::run(*this, u.derived(), order, ders.const_cast_derived());
+  }
+
   template <typename _Scalar, int _Dim, int _Degree>
   typename SplineTraits< Spline<_Scalar, _Dim, _Degree> >::BasisVectorType
     Spline<_Scalar, _Dim, _Degree>::basisFunctions(Scalar u) const
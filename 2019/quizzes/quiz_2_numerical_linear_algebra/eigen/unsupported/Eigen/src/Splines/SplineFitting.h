@@ -22,6 +22,208 @@
 
 namespace Eigen
 {
+  namespace internal
+  {
+    /**
+     * \internal
+     * Rows of a matrix having at most width consecutive non-zeros each, as the
+     * collocation matrices of splines whose rows hold the degree+1 non-zero basis
+     * functions at a parameter. The non-zeros of the row i start at the column first[i].
+     **/
+    template <typename Scalar>
+    struct spline_band_rows
+    {
+      typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> ValuesType;
+
+      spline_band_rows(DenseIndex rows, DenseIndex width) : values(ValuesType::Zero(rows,width)), first(rows,0) {}
+
+      DenseIndex rows() const { return values.rows(); }
+      DenseIndex lower() const
+      {
+        DenseIndex kl = 0;
+        for (DenseIndex i=0; i<rows(); ++i)
+          kl = (std::max)(kl, i-first[i]);
+        return kl;
+      }
+      DenseIndex upper() const
+      {
+        DenseIndex ku = 0;
+        for (DenseIndex i=0; i<rows(); ++i)
+          ku = (std::max)(ku, first[i]+values.cols()-1-i);
+        return ku;
+      }
+
+      ValuesType values;
+      std::vector<DenseIndex> first;
+    };
+
+    /**
+     * \internal
+     * LU factorization with partial pivoting of a square band matrix with kl sub- and
+     * ku super-diagonals, stored as in LAPACK's gbtrf: the coefficient (i,j) is at
+     * (kl+ku+i-j,j) of the band, whose first kl rows receive the fill-in of the row
+     * interchanges. The factorization costs O(n*kl*(kl+ku)) operations.
+     **/
+    template <typename Scalar>
+    class spline_band_lu
+    {
+    public:
+      typedef Matrix<Scalar,Dynamic,Dynamic> BandType;
+
+      explicit spline_band_lu(const spline_band_rows<Scalar>& A)
+      : m_kl(A.lower()), m_ku(A.upper()), m_pivots(A.rows()), m_singular(false)
+      {
+        const DenseIndex n = A.rows(), kv = m_kl+m_ku;
+        m_band.setZero(2*m_kl+m_ku+1, n);
+        for (DenseIndex i=0; i<n; ++i)
+          for (DenseIndex k=0; k<A.values.cols(); ++k)
+          {
+            const DenseIndex j = A.first[i]+k;
+            if (j>=0 && j<n)
+              m_band(kv+i-j,j) = A.values(i,k);
+          }
+
+        DenseIndex ju = 0; // last column touched by the row interchanges
+        for (DenseIndex j=0; j<n; ++j)
+        {
+          const DenseIndex km = (std::min)(m_kl, n-1-j);
+          DenseIndex jp;
+          const Scalar pivot = m_band.col(j).segment(kv,km+1).cwiseAbs().maxCoeff(&jp);
+          m_pivots[j] = j+jp;
+          if (pivot == Scalar(0))
+          {
+            m_singular = true;
+            continue;
+          }
+          ju = (std::max)(ju, (std::min)(j+m_ku+jp, n-1));
+          if (jp != 0)
+            for (DenseIndex c=j; c<=ju; ++c)
+              std::swap(m_band(kv+j-c,c), m_band(kv+j+jp-c,c));
+          if (km == 0)
+            continue;
+          m_band.col(j).segment(kv+1,km) /= m_band(kv,j);
+          for (DenseIndex c=j+1; c<=ju; ++c)
+            m_band.col(c).segment(kv+j+1-c,km) -= m_band(kv+j-c,c) * m_band.col(j).segment(kv+1,km);
+        }
+      }
+
+      /** Whether a zero pivot was met, in which case the solutions are meaningless. */
+      bool singular() const { return m_singular; }
+
+      /** Solves A X = B in place, the rows of B being the equations. */
+      template <typename RhsType>
+      void solveInPlace(RhsType& b) const
+      {
+        const DenseIndex n = m_band.cols(), kv = m_kl+m_ku;
+        for (DenseIndex j=0; j<n; ++j)
+        {
+          const DenseIndex km = (std::min)(m_kl, n-1-j);
+          if (m_pivots[j] != j)
+            b.row(j).swap(b.row(m_pivots[j]));
+          if (km > 0)
+            b.middleRows(j+1,km) -= m_band.col(j).segment(kv+1,km) * b.row(j);
+        }
+        for (DenseIndex j=n-1; j>=0; --j)
+        {
+          b.row(j) /= m_band(kv,j);
+          const DenseIndex ku = (std::min)(kv, j);
+          if (ku > 0)
+            b.middleRows(j-ku,ku) -= m_band.col(j).segment(kv-ku,ku) * b.row(j);
+        }
+      }
+
+    private:
+      DenseIndex m_kl, m_ku;
+      BandType m_band;
+      std::vector<DenseIndex> m_pivots;
+      bool m_singular;
+    };
+
+    /**
+     * \internal
+     * QR factorization of a least-squares problem whose rows have at most width
+     * consecutive non-zeros, such as the fitting of a spline to data points. The rows
+     * are added one at a time, by non-decreasing first non-zero such that there is no
+     * fill-in, and eliminated by Givens rotations into the upper
+     * triangular factor R, which has width-1 super-diagonals and is stored row-wise:
+     * the coefficient (i,j) is at (i,j-i) of the band. This costs O(width^2) operations
+     * per row and does not square the condition number as the normal equations would.
+     *
+     * \sa P. Dierckx, Curve and Surface Fitting with Splines, 1993
+     **/
+    template <typename Scalar>
+    class spline_band_qr
+    {
+    public:
+      typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> BandType;
+      typedef Matrix<Scalar,Dynamic,Dynamic> RhsType;
+      typedef Matrix<Scalar,1,Dynamic> RowType;
+
+      spline_band_qr(DenseIndex cols, DenseIndex width, DenseIndex rhsCols)
+      : m_R(BandType::Zero(cols,width)), m_z(RhsType::Zero(cols,rhsCols)), m_h(width), m_y(rhsCols), m_residual(0), m_first(0) {}
+
+      /** Adds the row whose non-zeros h start at the column first, with the right-hand side y.
+        * The first column must not be smaller than the one of the previous row. */
+      template <typename HType, typename YType>
+      void addRow(DenseIndex first, const HType& h, const YType& y)
+      {
+        eigen_assert(first >= m_first && first < m_R.rows());
+        m_first = first;
+        const DenseIndex width = m_R.cols();
+        m_h.setZero();
+        m_h.head(h.size()) = h;
+        m_y = y;
+        for (DenseIndex k=0; k<width; ++k)
+        {
+          const Scalar piv = m_h(k);
+          if (piv == Scalar(0))
+            continue;
+          const DenseIndex j = first+k;
+          const Scalar r = numext::hypot(m_R(j,0), piv);
+          const Scalar c = m_R(j,0)/r, s = piv/r;
+          m_R(j,0) = r;
+          for (DenseIndex i=k+1; i<width; ++i)
+          {
+            const Scalar t = m_R(j,i-k);
+            m_R(j,i-k) = c*t + s*m_h(i);
+            m_h(i) = c*m_h(i) - s*t;
+          }
+          const RowType t = m_z.row(j);
+          m_z.row(j) = c*t + s*m_y;
+          m_y = c*m_y - s*t;
+        }
+        m_residual += m_y.squaredNorm();
+      }
+
+      /** The sum of the squared residuals of the least-squares solution. */
+      Scalar residual() const { return m_residual; }
+
+      /** Computes the least-squares solution x, the rows of x being the unknowns. */
+      ComputationInfo solve(RhsType& x) const
+      {
+        const DenseIndex n = m_R.rows(), width = m_R.cols();
+        x = m_z;
+        for (DenseIndex j=n-1; j>=0; --j)
+        {
+          if (m_R(j,0) == Scalar(0))
+            return NumericalIssue;
+          const DenseIndex w = (std::min)(width-1, n-1-j);
+          if (w > 0)
+            x.row(j) -= m_R.row(j).segment(1,w) * x.middleRows(j+1,w);
+          x.row(j) /= m_R(j,0);
+        }
+        return Success;
+      }
+
+    private:
+      BandType m_R;
+      RhsType m_z;
+      RowType m_h, m_y;
+      Scalar m_residual;
+      DenseIndex m_first;
+    };
+  }
+
   /**
    * \brief Computes knot averages.
    * \ingroup Splines_Module
@@ -53,6 +255,46 @@ namespace Eigen
     knots.segment(knots.size()-degree-1,degree+1) = KnotVectorType::Ones(degree+1);
   }
 
+  /**
+   * \brief Computes the knots of an approximating spline.
+   * \ingroup Splines_Module
+   *
+   * The internal knots are placed such that every knot span contains at least
+   * one parameter, which guarantees that the least-squares system of the
+   * approximation is positive definite. With \f$n+1\f$ parameters and
+   * \f$h+1\f$ control points, they are computed as
+   * \f{align*}
+   *  u_{p+j} & = (1-\alpha)\bar{u}_{i-1} + \alpha\bar{u}_i \quad\quad j=1,\hdots,h-p
+   * \f}
+   * where \f$d=\frac{n+1}{h-p+1}\f$, \f$i=\lfloor jd\rfloor\f$ and \f$\alpha=jd-i\f$.
+   * The end knots are the first and last parameters, repeated \f$p+1\f$ times.
+   *
+   * \param[in] parameters The non-decreasing parameters of the data points.
+   * \param[in] degree The spline degree.
+   * \param[in] numCtrls The number of control points of the approximating spline.
+   * \param[out] knots The output knot vector.
+   *
+   * \sa Les Piegl and Wayne Tiller, The NURBS book (2nd ed.), 1997, 9.4.1 Least Squares Curve Approximation
+   **/
+  template <typename KnotVectorType>
+  void ApproximationKnots(const KnotVectorType& parameters, DenseIndex degree, DenseIndex numCtrls, KnotVectorType& knots)
+  {
+    typedef typename KnotVectorType::Scalar Scalar;
+    eigen_assert(numCtrls > degree && numCtrls <= parameters.size());
+
+    knots.resize(numCtrls+degree+1);
+    knots.segment(0,degree+1).setConstant(parameters(0));
+    knots.segment(numCtrls,degree+1).setConstant(parameters(parameters.size()-1));
+
+    const Scalar d = Scalar(parameters.size()) / Scalar(numCtrls-degree);
+    for (DenseIndex j=1; j<numCtrls-degree; ++j)
+    {
+      const DenseIndex i = static_cast<DenseIndex>(j*d);
+      const Scalar alpha = j*d - Scalar(i);
+      knots(degree+j) = (Scalar(1)-alpha)*parameters(i-1) + alpha*parameters(i);
+    }
+  }
+
   /**
    * \brief Computes knot averages when derivative constraints are present.
    * Note that this is a technical interpretation of the referenced article
@@ -238,6 +480,61 @@ namespace Eigen
     template <typename PointArrayType>
     static SplineType Interpolate(const PointArrayType& pts, DenseIndex degree, const KnotVectorType& knot_parameters);
 
+    /**
+     * \brief Fits an approximating spline to the given data points by least squares.
+     *
+     * The control points minimize the sum of the squared distances between the
+     * data points and the spline at their parameters, plus \a smoothing times the
+     * sum of the squared second differences of the control points, which damps
+     * the oscillations of the spline. The knots are computed by ApproximationKnots().
+     *
+     * The least-squares problem is banded and solved by Givens rotations, one
+     * data point at a time, such that the fitting costs O(n*degree^2) operations
+     * and O(numCtrls*degree) memory for n data points.
+     *
+     * \param pts The points to approximate.
+     * \param degree The degree of the approximating spline.
+     * \param numCtrls The number of control points, between degree+1 and the number of points.
+     * \param smoothing The non-negative weight of the smoothing penalty.
+     *
+     * \returns A spline approximating the provided points.
+     **/
+    template <typename PointArrayType>
+    static SplineType Approximate(const PointArrayType& pts, DenseIndex degree, DenseIndex numCtrls,
+                                  typename SplineType::Scalar smoothing = typename SplineType::Scalar(0));
+
+    /**
+     * \brief Fits an approximating spline to the given data points by least squares.
+     *
+     * \param pts The points to approximate.
+     * \param degree The degree of the approximating spline.
+     * \param numCtrls The number of control points, between degree+1 and the number of points.
+     * \param smoothing The non-negative weight of the smoothing penalty.
+     * \param knot_parameters The non-decreasing parameters of the points.
+     *
+     * \returns A spline approximating the provided points.
+     **/
+    template <typename PointArrayType>
+    static SplineType Approximate(const PointArrayType& pts, DenseIndex degree, DenseIndex numCtrls,
+                                  typename SplineType::Scalar smoothing, const KnotVectorType& knot_parameters);
+
+    /**
+     * \brief Assembles the sparse collocation matrix of a spline.
+     *
+     * The row i of the matrix holds the values at \a parameters(i) of the basis
+     * functions of the spline of degree \a degree defined by \a knots, of which at
+     * most degree+1 are non-zero. This allows to solve fitting problems with
+     * additional constraints with the solvers of the Sparse module, which must be
+     * included beforehand.
+     *
+     * \param parameters The parameters at which the basis functions are evaluated.
+     * \param degree The spline degree.
+     * \param knots The spline knot vector.
+     * \param A The output sparse matrix, e.g. a SparseMatrix<Scalar,RowMajor>.
+     **/
+    template <typename SparseMatrixType>
+    static void CollocationMatrix(const KnotVectorType& parameters, DenseIndex degree, const KnotVectorType& knots, SparseMatrixType& A);
+
     /**
      * \brief Fits an interpolating spline to the given data points and
      * derivatives.
@@ -297,22 +594,23 @@ namespace Eigen
     KnotVectorType knots;
     KnotAveraging(knot_parameters, degree, knots);
 
+    // The collocation matrix is banded, each row holding degree+1 basis functions.
     DenseIndex n = pts.cols();
-    MatrixType A = MatrixType::Zero(n,n);
+    internal::spline_band_rows<Scalar> A(n, degree+1);
     for (DenseIndex i=1; i<n-1; ++i)
     {
       const DenseIndex span = SplineType::Span(knot_parameters[i], degree, knots);
-
-      // The segment call should somehow be told the spline order at compile time.
-      A.row(i).segment(span-degree, degree+1) = SplineType::BasisFunctions(knot_parameters[i], degree, knots);
+      A.first[i] = span-degree;
+      A.values.row(i) = SplineType::BasisFunctions(knot_parameters[i], degree, knots);
     }
-    A(0,0) = 1.0;
-    A(n-1,n-1) = 1.0;
-
-    HouseholderQR<MatrixType> qr(A);
+    A.values(0,0) = Scalar(1);
+    A.first[n-1] = n-1-degree;
+    A.values(n-1,degree) = Scalar(1);
 
-    // Here, we are creating a temporary due to an Eigen issue.
-    ControlPointVectorType ctrls = qr.solve(MatrixType(pts.transpose())).transpose();
+    const internal::spline_band_lu<Scalar> lu(A);
+    MatrixType b = pts.transpose();
+    lu.solveInPlace(b);
+    ControlPointVectorType ctrls = b.transpose();
 
     return SplineType(knots, ctrls);
   }
@@ -346,8 +644,8 @@ namespace Eigen
 
     KnotAveragingWithDerivatives(parameters, degree, derivativeIndices, knots);
     
-    // fill matrix
-    MatrixType A = MatrixType::Zero(n, n);
+    // fill the banded matrix
+    internal::spline_band_rows<Scalar> A(n, degree + 1);
 
     // Use these dimensions for quicker populating, then transpose for solving.
     MatrixType b(points.rows(), n);
@@ -358,7 +656,7 @@ namespace Eigen
     // End derivatives.
     if (derivativeIndices[0] == 0)
     {
-      A.template block<1, 2>(1, 0) << -1, 1;
+      A.values.template block<1, 2>(1, 0) << -1, 1;
       
       Scalar y = (knots(degree + 1) - knots(0)) / degree;
       b.col(1) = y*derivatives.col(0);
@@ -373,7 +671,8 @@ namespace Eigen
     }
     if (derivativeIndices[derivatives.cols() - 1] == points.cols() - 1)
     {
-      A.template block<1, 2>(n - 2, n - 2) << -1, 1;
+      A.first[n - 2] = n - 1 - degree;
+      A.values.template block<1, 2>(n - 2, degree - 1) << -1, 1;
 
       Scalar y = (knots(knots.size() - 1) - knots(knots.size() - (degree + 2))) / degree;
       b.col(b.cols() - 2) = y*derivatives.col(derivatives.cols() - 1);
@@ -387,7 +686,8 @@ namespace Eigen
 
       if (derivativeIndices[derivativeIndex] == i)
       {
-        A.block(row, span - degree, 2, degree + 1)
+        A.first[row] = A.first[row + 1] = span - degree;
+        A.values.middleRows(row, 2)
           = SplineType::BasisFunctionDerivatives(parameters[i], 1, degree, knots);
 
         b.col(row++) = points.col(i);
@@ -395,18 +695,21 @@ namespace Eigen
       }
       else
       {
-        A.row(row++).segment(span - degree, degree + 1)
-          = SplineType::BasisFunctions(parameters[i], degree, knots);
+        A.first[row] = span - degree;
+        A.values.row(row++) = SplineType::BasisFunctions(parameters[i], degree, knots);
       }
     }
     b.col(0) = points.col(0);
     b.col(b.cols() - 1) = points.col(points.cols() - 1);
-    A(0,0) = 1;
-    A(n - 1, n - 1) = 1;
+    A.values(0, 0) = 1;
+    A.first[n - 1] = n - 1 - degree;
+    A.values(n - 1, degree) = 1;
     
     // Solve
-    FullPivLU<MatrixType> lu(A);
-    ControlPointVectorType controlPoints = lu.solve(MatrixType(b.transpose())).transpose();
+    const internal::spline_band_lu<Scalar> lu(A);
+    MatrixType x = b.transpose();
+    lu.solveInPlace(x);
+    ControlPointVectorType controlPoints = x.transpose();
 
     SplineType spline(knots, controlPoints);
     
@@ -425,6 +728,87 @@ namespace Eigen
     ChordLengths(points, parameters);
     return InterpolateWithDerivatives(points, derivatives, derivativeIndices, degree, parameters);
   }
+
+  template <typename SplineType>
+  template <typename PointArrayType>
+  SplineType SplineFitting<SplineType>::Approximate(const PointArrayType& pts, DenseIndex degree, DenseIndex numCtrls,
+                                                    typename SplineType::Scalar smoothing, const KnotVectorType& knot_parameters)
+  {
+    typedef typename SplineType::Scalar Scalar;
+    typedef typename SplineType::ControlPointVectorType ControlPointVectorType;
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+    eigen_assert(smoothing >= Scalar(0));
+
+    KnotVectorType knots;
+    ApproximationKnots(knot_parameters, degree, numCtrls, knots);
+
+    // The rows of the collocation matrix, of bandwidth degree+1, and of the smoothing
+    // penalty, the second differences of the control points, are eliminated one at a
+    // time, ordered by their first non-zero.
+    internal::spline_band_qr<Scalar> qr(numCtrls, (std::max)(degree+1, DenseIndex(3)), pts.rows());
+    const Scalar w = numext::sqrt(smoothing);
+    const Matrix<Scalar,1,3> D(w, Scalar(-2)*w, w);
+    const MatrixType zero = MatrixType::Zero(1, pts.rows());
+    DenseIndex penalty = smoothing > Scalar(0) ? 0 : numCtrls;
+    for (DenseIndex i=0; i<pts.cols(); ++i)
+    {
+      const DenseIndex first = SplineType::Span(knot_parameters[i], degree, knots) - degree;
+      for (; penalty<=first && penalty+2<numCtrls; ++penalty)
+        qr.addRow(penalty, D, zero);
+      qr.addRow(first, SplineType::BasisFunctions(knot_parameters[i], degree, knots).matrix(), pts.col(i).matrix().transpose());
+    }
+    for (; penalty+2<numCtrls; ++penalty)
+      qr.addRow(penalty, D, zero);
+
+    MatrixType x;
+    const ComputationInfo info = qr.solve(x);
+    EIGEN_UNUSED_VARIABLE(info);
+    eigen_assert(info == Success && "the parameters must be non-decreasing with a non-empty range");
+    ControlPointVectorType ctrls = x.transpose();
+
+    return SplineType(knots, ctrls);
+  }
+
+  template <typename SplineType>
+  template <typename PointArrayType>
+  SplineType SplineFitting<SplineType>::Approximate(const PointArrayType& pts, DenseIndex degree, DenseIndex numCtrls,
+                                                    typename SplineType::Scalar smoothing)
+  {
+    KnotVectorType chord_lengths; // knot parameters
+    ChordLengths(pts, chord_lengths);
+    return Approximate(pts, degree, numCtrls, smoothing, chord_lengths);
+  }
+
+  template <typename SplineType>
+  template <typename SparseMatrixType>
+  void SplineFitting<SplineType>::CollocationMatrix(const KnotVectorType& parameters, DenseIndex degree,
+                                                    const KnotVectorType& knots, SparseMatrixType& A)
+  {
+    typedef typename SparseMatrixType::StorageIndex StorageIndex;
+    typedef Matrix<StorageIndex,Dynamic,1> SizesType;
+    const DenseIndex rows = parameters.size(), cols = knots.size()-degree-1;
+
+    std::vector<DenseIndex> spans(rows);
+    SizesType sizes = SizesType::Constant(SparseMatrixType::IsRowMajor ? rows : cols, StorageIndex(degree+1));
+    for (DenseIndex i=0; i<rows; ++i)
+      spans[i] = SplineType::Span(parameters[i], degree, knots);
+    if (!SparseMatrixType::IsRowMajor)
+    {
+      sizes.setZero();
+      for (DenseIndex i=0; i<rows; ++i)
+        sizes.segment(spans[i]-degree, degree+1).array() += StorageIndex(1);
+    }
+
+    A.resize(rows, cols);
+    A.reserve(sizes);
+    for (DenseIndex i=0; i<rows; ++i)
+    {
+      const typename SplineType::BasisVectorType basis = SplineType::BasisFunctions(parameters[i], degree, knots);
+      for (DenseIndex k=0; k<=degree; ++k)
+        A.insert(i, spans[i]-degree+k) = basis(k);
+    }
+    A.makeCompressed();
+  }
 }
 
 #endif // EIGEN_SPLINE_FITTING_H
@@ -89,7 +89,7 @@ struct BallPointStuff //this class provides functions to be both an intersector
 };
 
 
-template<int Dim>
+template<int Dim, template<typename, int, typename> class BVH = KdBVH>
 struct TreeTest
 {
   typedef Matrix<double, Dim, 1> VectorType;
@@ -104,7 +104,7 @@ struct TreeTest
     for(int i = 0; i < 500; ++i) {
         b.push_back(BallType(VectorType::Random(), 0.5 * internal::random(0., 1.)));
     }
-    KdBVH<double, Dim, BallType> tree(b.begin(), b.end());
+    BVH<double, Dim, BallType> tree(b.begin(), b.end());
 
     VectorType pt = VectorType::Random();
     BallPointStuff<Dim> i1(pt), i2(pt);
@@ -123,7 +123,7 @@ struct TreeTest
     for(int i = 0; i < 500; ++i) {
         b.push_back(BallType(VectorType::Random(), 0.01 * internal::random(0., 1.)));
     }
-    KdBVH<double, Dim, BallType> tree(b.begin(), b.end());
+    BVH<double, Dim, BallType> tree(b.begin(), b.end());
 
     VectorType pt = VectorType::Random();
     BallPointStuff<Dim> i1(pt), i2(pt);
@@ -149,8 +149,8 @@ struct TreeTest
             v.push_back(VectorType::Random());
     }
 
-    KdBVH<double, Dim, BallType> tree(b.begin(), b.end());
-    KdBVH<double, Dim, VectorType> vTree(v.begin(), v.end());
+    BVH<double, Dim, BallType> tree(b.begin(), b.end());
+    BVH<double, Dim, VectorType> vTree(v.begin(), v.end());
 
     BallPointStuff<Dim> i1, i2;
 
@@ -174,8 +174,8 @@ struct TreeTest
             v.push_back(VectorType::Random());
     }
 
-    KdBVH<double, Dim, BallType> tree(b.begin(), b.end());
-    KdBVH<double, Dim, VectorType> vTree(v.begin(), v.end());
+    BVH<double, Dim, BallType> tree(b.begin(), b.end());
+    BVH<double, Dim, VectorType> vTree(v.begin(), v.end());
 
     BallPointStuff<Dim> i1, i2;
 
@@ -189,6 +189,103 @@ struct TreeTest
 
     VERIFY_IS_APPROX(m1, m2);
   }
+
+  void testRefit(int n)
+  {
+    BallTypeList b;
+    VectorTypeList v;
+    for(int i = 0; i < n; ++i) {
+      b.push_back(BallType(VectorType::Random(), 0.05 * internal::random(0., 1.)));
+      v.push_back(VectorType::Random());
+    }
+    BVH<double, Dim, BallType> tree(b.begin(), b.end());
+    BVH<double, Dim, VectorType> vTree(v.begin(), v.end());
+    VERIFY_IS_APPROX(tree.quality(), 1.);
+
+    //small motions keep the structure of the tree
+    for(int i = 0; i < n; ++i) {
+      b[i].center += 0.01 * VectorType::Random();
+      v[i] += 0.01 * VectorType::Random();
+    }
+    VERIFY(!tree.refit(b.begin(), b.end(), 0.));
+    VERIFY(!vTree.refit(v.begin(), v.end(), 0.));
+
+    BallPointStuff<Dim> i1, i2;
+    for(int i = 0; i < n; ++i)
+      for(int j = 0; j < n; ++j)
+        i1.intersectObjectObject(b[i], v[j]);
+    BVIntersect(tree, vTree, i2);
+    VERIFY(i1.count == i2.count);
+
+    VectorType pt = VectorType::Random();
+    BallPointStuff<Dim> p1(pt), p2(pt);
+    for(int i = 0; i < n; ++i)
+      p1.intersectObject(b[i]);
+    BVIntersect(tree, p2);
+    VERIFY(p1.count == p2.count);
+
+    //shuffling the objects degrades the tree, until it is rebuilt
+    std::random_shuffle(v.begin(), v.end());
+    VERIFY(!vTree.refit(v.begin(), v.end(), 0.));
+    if(n > 100)
+      VERIFY(vTree.quality() < 0.5);
+    VERIFY(vTree.refit(v.begin(), v.end(), 1.01));
+    VERIFY_IS_APPROX(vTree.quality(), 1.);
+
+    BallPointStuff<Dim> i3;
+    BVIntersect(tree, vTree, i3);
+    VERIFY(i1.count == i3.count);
+  }
+
+  void testIntersectBox(int n)
+  {
+    BallTypeList b;
+    for(int i = 0; i < n; ++i)
+      b.push_back(BallType(VectorType::Random(), 0.05 * internal::random(0., 1.)));
+    // many identical objects cannot be split by the SAH
+    for(int i = 0; i < 20; ++i)
+      b.push_back(BallType(VectorType::Zero(), 0.01));
+    SahBVH<double, Dim, BallType> tree(b.begin(), b.end());
+    VERIFY(tree.depth() < tree.numNodes());
+
+    BoxType query(VectorType::Random());
+    query.extend(VectorType::Random());
+    BoxCounter counter(query), ref(query);
+    for(int i = 0; i < (int)b.size(); ++i)
+      ref.intersectObject(b[i]);
+    VERIFY(!tree.intersectBox(query, counter));
+    VERIFY(counter.count == ref.count);
+    VERIFY(counter.calls <= ref.calls);
+
+    // the generic algorithms use the same tree
+    BoxCounter generic(query);
+    BVIntersect(tree, generic);
+    VERIFY(generic.count == ref.count);
+
+    // trees with less than 2 objects
+    SahBVH<double, Dim, BallType> empty(b.begin(), b.begin()), single(b.begin(), b.begin() + 1);
+    BoxCounter c0(query), c1(query);
+    VERIFY(!empty.intersectBox(query, c0));
+    VERIFY(c0.calls == 0);
+    single.intersectBox(bounding_box(b[0]), c1);
+    VERIFY(c1.calls == 1);
+  }
+
+  // counts the balls whose bounding box intersects the query box
+  struct BoxCounter
+  {
+    BoxCounter(const BoxType &q) : query(q), calls(0), count(0) {}
+    bool intersectVolume(const BoxType &r) { return !r.intersection(query).isEmpty(); }
+    bool intersectObject(const BallType &b) {
+      ++calls;
+      if(!bounding_box(b).intersection(query).isEmpty())
+        ++count;
+      return false; //continue
+    }
+    BoxType query;
+    int calls;
+    int count;
+  };
 };
 
 
@@ -201,6 +298,7 @@ void test_BVH()
     CALL_SUBTEST(test2.testMinimize1());
     CALL_SUBTEST(test2.testIntersect2());
     CALL_SUBTEST(test2.testMinimize2());
+    CALL_SUBTEST(test2.testRefit(internal::random(2, 500)));
 #endif
 
 #ifdef EIGEN_TEST_PART_2
@@ -209,6 +307,8 @@ void test_BVH()
     CALL_SUBTEST(test3.testMinimize1());
     CALL_SUBTEST(test3.testIntersect2());
     CALL_SUBTEST(test3.testMinimize2());
+    CALL_SUBTEST(test3.testRefit(internal::random(2, 500)));
+    CALL_SUBTEST(test3.testRefit(internal::random(5000, 6000)));
 #endif
 
 #ifdef EIGEN_TEST_PART_3
@@ -218,5 +318,27 @@ void test_BVH()
     CALL_SUBTEST(test4.testIntersect2());
     CALL_SUBTEST(test4.testMinimize2());
 #endif
+
+#ifdef EIGEN_TEST_PART_4
+    TreeTest<2, SahBVH> test2;
+    CALL_SUBTEST(test2.testIntersect1());
+    CALL_SUBTEST(test2.testMinimize1());
+    CALL_SUBTEST(test2.testIntersect2());
+    CALL_SUBTEST(test2.testMinimize2());
+    CALL_SUBTEST(test2.testIntersectBox(internal::random(10, 1000)));
+    CALL_SUBTEST(test2.testRefit(internal::random(2, 500)));
+#endif
+
+#ifdef EIGEN_TEST_PART_5
+    TreeTest<3, SahBVH> test3;
+    CALL_SUBTEST(test3.testIntersect1());
+    CALL_SUBTEST(test3.testMinimize1());
+    CALL_SUBTEST(test3.testIntersect2());
+    CALL_SUBTEST(test3.testMinimize2());
+    CALL_SUBTEST(test3.testIntersectBox(internal::random(10, 1000)));
+    CALL_SUBTEST(test3.testIntersectBox(internal::random(5000, 20000)));
+    CALL_SUBTEST(test3.testRefit(internal::random(2, 500)));
+    CALL_SUBTEST(test3.testRefit(internal::random(5000, 6000)));
+#endif
   }
 }
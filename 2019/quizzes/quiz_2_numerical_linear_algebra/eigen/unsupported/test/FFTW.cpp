@@ -177,36 +177,91 @@ void test_complex(int nfft)
   test_complex_generic<StdVectorContainer,T>(nfft);
   test_complex_generic<EigenVectorContainer,T>(nfft);
 }
-/*
-template <typename T,int nrows,int ncols>
-void test_complex2d()
+template <typename T>
+void test_complex2d(int nrows,int ncols)
 {
     typedef typename Eigen::FFT<T>::Complex Complex;
+    typedef Eigen::Matrix<Complex,Dynamic,Dynamic> ComplexMatrix;
+    typedef Eigen::Map<Eigen::Matrix<Complex,Dynamic,1> > Flat;
     FFT<T> fft;
-    Eigen::Matrix<Complex,nrows,ncols> src,src2,dst,dst2;
+    ComplexMatrix src(nrows,ncols),src2(nrows,ncols),dst(nrows,ncols),dst2(nrows,ncols);
 
-    src = Eigen::Matrix<Complex,nrows,ncols>::Random();
-    //src =  Eigen::Matrix<Complex,nrows,ncols>::Identity();
+    src = ComplexMatrix::Random(nrows,ncols);
 
     for (int k=0;k<ncols;k++) {
-        Eigen::Matrix<Complex,nrows,1> tmpOut;
+        Eigen::Matrix<Complex,Dynamic,1> tmpOut;
         fft.fwd( tmpOut,src.col(k) );
         dst2.col(k) = tmpOut;
     }
 
     for (int k=0;k<nrows;k++) {
-        Eigen::Matrix<Complex,1,ncols> tmpOut;
+        Eigen::Matrix<Complex,1,Dynamic> tmpOut;
         fft.fwd( tmpOut,  dst2.row(k) );
         dst2.row(k) = tmpOut;
     }
 
     fft.fwd2(dst.data(),src.data(),ncols,nrows);
     fft.inv2(src2.data(),dst.data(),ncols,nrows);
-    VERIFY( (src-src2).norm() < test_precision<T>() );
-    VERIFY( (dst-dst2).norm() < test_precision<T>() );
+    VERIFY( T(dif_rmse(Flat(src.data(),src.size()),Flat(src2.data(),src2.size()))) < test_precision<T>() );
+    VERIFY( T(dif_rmse(Flat(dst.data(),dst.size()),Flat(dst2.data(),dst2.size()))) < test_precision<T>() );
+
+    // in place
+    src2 = src;
+    fft.fwd2(src2.data(),src2.data(),ncols,nrows);
+    VERIFY( T(dif_rmse(Flat(src2.data(),src2.size()),Flat(dst2.data(),dst2.size()))) < test_precision<T>() );
+}
+
+#ifndef EIGEN_FFTW_DEFAULT
+template <typename T>
+void test_complex3d(int n0,int n1,int n2)
+{
+    typedef typename Eigen::FFT<T>::Complex Complex;
+    typedef Eigen::Matrix<Complex,Dynamic,Dynamic> ComplexMatrix;
+    typedef Eigen::Map<Eigen::Matrix<Complex,Dynamic,1> > Flat;
+    FFT<T> fft;
+    // column k of the matrices is the slice k of the n0 x n1 x n2 array
+    ComplexMatrix src(n1*n2,n0),src2(n1*n2,n0),dst(n1*n2,n0),dst2(n1*n2,n0);
+    src = ComplexMatrix::Random(n1*n2,n0);
+
+    for (int k=0;k<n0;k++)
+        fft.fwd2(dst2.col(k).data(),src.col(k).data(),n1,n2);
+    for (int k=0;k<n1*n2;k++) {
+        Eigen::Matrix<Complex,1,Dynamic> tmpOut;
+        fft.fwd( tmpOut,  dst2.row(k) );
+        dst2.row(k) = tmpOut;
+    }
+
+    fft.fwd3(dst.data(),src.data(),n0,n1,n2);
+    fft.inv3(src2.data(),dst.data(),n0,n1,n2);
+    VERIFY( T(dif_rmse(Flat(src.data(),src.size()),Flat(src2.data(),src2.size()))) < test_precision<T>() );
+    VERIFY( T(dif_rmse(Flat(dst.data(),dst.size()),Flat(dst2.data(),dst2.size()))) < test_precision<T>() );
 }
-*/
+#endif
 
+#if defined(EIGEN_HAS_OPENMP) && !defined(EIGEN_FFTW_DEFAULT)
+template <typename T>
+void test_shared_plans()
+{
+    typedef typename Eigen::FFT<T>::Complex Complex;
+    typedef Eigen::Matrix<Complex,Dynamic,1> ComplexVector;
+    const int sizes[4] = {2*3*4*5*7, 8*8*8*2, 11*13, 5*32};
+    const int count = 32;
+    std::vector<ComplexVector> src(count), dst(count), ref(count);
+    FFT<T> fft, refFft;
+    for (int k=0;k<count;++k) {
+        src[k] = ComplexVector::Random(sizes[k%4]);
+        dst[k].resize(sizes[k%4]);
+        refFft.fwd(ref[k], src[k]);
+    }
+
+    // the threads create the plans of the shared object concurrently
+    #pragma omp parallel for num_threads(4)
+    for (int k=0;k<count;++k)
+        fft.fwd(dst[k].data(), src[k].data(), sizes[k%4]);
+    for (int k=0;k<count;++k)
+        VERIFY( T((dst[k]-ref[k]).norm() / ref[k].norm()) < test_precision<T>() );
+}
+#endif
 
 void test_return_by_value(int len)
 {
@@ -228,10 +283,20 @@ void test_return_by_value(int len)
 void test_FFTW()
 {
   CALL_SUBTEST( test_return_by_value(32) );
-  //CALL_SUBTEST( ( test_complex2d<float,4,8> () ) ); CALL_SUBTEST( ( test_complex2d<double,4,8> () ) );
-  //CALL_SUBTEST( ( test_complex2d<long double,4,8> () ) );
+  CALL_SUBTEST( ( test_complex2d<float>(4,8) ) ); CALL_SUBTEST( ( test_complex2d<double>(4,8) ) );
+  CALL_SUBTEST( ( test_complex2d<float>(3*8,5*7) ) ); CALL_SUBTEST( ( test_complex2d<double>(3*8,5*7) ) );
+  CALL_SUBTEST( ( test_complex2d<float>(256,200) ) ); CALL_SUBTEST( ( test_complex2d<double>(256,200) ) );
+  CALL_SUBTEST( ( test_complex2d<float>(2*7*11,13*17) ) ); CALL_SUBTEST( ( test_complex2d<double>(2*7*11,13*17) ) );
+#ifndef EIGEN_FFTW_DEFAULT
+  CALL_SUBTEST( ( test_complex3d<float>(4,6,8) ) ); CALL_SUBTEST( ( test_complex3d<double>(4,6,8) ) );
+  CALL_SUBTEST( ( test_complex3d<float>(40,32,30) ) ); CALL_SUBTEST( ( test_complex3d<double>(40,32,30) ) );
+#endif
+#if defined(EIGEN_HAS_OPENMP) && !defined(EIGEN_FFTW_DEFAULT)
+  CALL_SUBTEST( test_shared_plans<float>() ); CALL_SUBTEST( test_shared_plans<double>() );
+#endif
   CALL_SUBTEST( test_complex<float>(32) ); CALL_SUBTEST( test_complex<double>(32) ); 
   CALL_SUBTEST( test_complex<float>(256) ); CALL_SUBTEST( test_complex<double>(256) ); 
+  CALL_SUBTEST( test_complex<float>(8*8*8*2) ); CALL_SUBTEST( test_complex<double>(8*8*8*2) ); 
   CALL_SUBTEST( test_complex<float>(3*8) ); CALL_SUBTEST( test_complex<double>(3*8) ); 
   CALL_SUBTEST( test_complex<float>(5*32) ); CALL_SUBTEST( test_complex<double>(5*32) ); 
   CALL_SUBTEST( test_complex<float>(2*3*4) ); CALL_SUBTEST( test_complex<double>(2*3*4) ); 
@@ -107,8 +107,106 @@ void test_central()
     VERIFY_IS_APPROX(jac, actual_jac);
 }
 
+// the residuals of a discretized boundary value problem, with a tridiagonal Jacobian
+template<typename _JacobianType>
+struct banded_functor : Functor<double>
+{
+    typedef _JacobianType JacobianType;
+    banded_functor(int n) : Functor<double>(n,n) {}
+    int operator()(const VectorXd &x, VectorXd &fvec) const
+    {
+        const int n = inputs();
+        for (int i = 0; i < n; i++)
+            fvec[i] = (3-2*x[i])*x[i] + 1 - (i>0 ? x[i-1] : 0.) - 2*(i<n-1 ? x[i+1] : 0.) + exp(x[i]/4);
+        return 0;
+    }
+    template<typename Pattern>
+    static void pattern(int n, Pattern &pattern)
+    {
+        std::vector<Triplet<double> > triplets;
+        for (int i = 0; i < n; i++)
+            for (int j = (std::max)(i-1,0); j <= (std::min)(i+1,n-1); j++)
+                triplets.push_back(Triplet<double>(i,j,1.));
+        pattern.resize(n,n);
+        pattern.setFromTriplets(triplets.begin(), triplets.end());
+    }
+    void actual_df(const VectorXd &x, MatrixXd &fjac) const
+    {
+        const int n = inputs();
+        fjac.setZero(n,n);
+        for (int i = 0; i < n; i++) {
+            fjac(i,i) = 3-4*x[i] + exp(x[i]/4)/4;
+            if (i>0) fjac(i,i-1) = -1;
+            if (i<n-1) fjac(i,i+1) = -2;
+        }
+    }
+};
+
+template<NumericalDiffMode mode>
+void test_sparsity_pattern()
+{
+    const int n = 50;
+    // the steps are relative to the entries, which are kept away from zero for accurate differences
+    VectorXd x = VectorXd::Random(n) + VectorXd::Constant(n, 2.);
+    MatrixXd actual_jac, jac, plain_jac(n,n);
+    SparseMatrix<double> pattern;
+    banded_functor<MatrixXd>::pattern(n, pattern);
+
+    NumericalDiff<banded_functor<MatrixXd>, mode> numDiff(n);
+    numDiff.actual_df(x, actual_jac);
+    VERIFY_IS_EQUAL(numDiff.groups(), -1);
+    VERIFY_IS_EQUAL(numDiff.df(x, plain_jac), mode==Central ? 2*n : n+1);
+
+    // a tridiagonal Jacobian needs 3 evaluations
+    numDiff.setSparsityPattern(pattern);
+    VERIFY_IS_EQUAL(numDiff.groups(), 3);
+    VERIFY_IS_EQUAL(numDiff.df(x, jac), mode==Central ? 6 : 4);
+    VERIFY_IS_APPROX(jac, plain_jac);
+    VERIFY_IS_APPROX(jac, actual_jac);
+
+    // parallel evaluation of the groups
+    numDiff.setThreads(0);
+    jac.setRandom();
+    numDiff.df(x, jac);
+    VERIFY_IS_APPROX(jac, plain_jac);
+
+    // sparse Jacobian
+    NumericalDiff<banded_functor<SparseMatrix<double> >, mode> sparseDiff(n);
+    SparseMatrix<double> sparse_jac;
+    sparseDiff.setSparsityPattern(pattern);
+    sparseDiff.df(x, sparse_jac);
+    VERIFY_IS_EQUAL(sparse_jac.nonZeros(), pattern.nonZeros());
+    VERIFY_IS_APPROX(MatrixXd(sparse_jac), plain_jac);
+
+    // sparse Jacobian without pattern, the columns being computed by several threads
+    SparseMatrix<double> unsized_sparse_jac;
+    sparseDiff.clearSparsityPattern();
+    sparseDiff.setThreads(0);
+    sparseDiff.df(x, unsized_sparse_jac);
+    VERIFY_IS_EQUAL(unsized_sparse_jac.rows(), n);
+    VERIFY_IS_EQUAL(unsized_sparse_jac.cols(), n);
+    VERIFY_IS_APPROX(MatrixXd(unsized_sparse_jac), plain_jac);
+    MatrixXd unsized_jac;
+    numDiff.clearSparsityPattern();
+    numDiff.df(x, unsized_jac);
+    VERIFY_IS_APPROX(unsized_jac, plain_jac);
+
+    // dense pattern: one group per column
+    numDiff.setSparsityPattern(MatrixXd::Ones(n,n).sparseView());
+    VERIFY_IS_EQUAL(numDiff.groups(), n);
+    numDiff.df(x, jac);
+    VERIFY_IS_APPROX(jac, plain_jac);
+
+    numDiff.clearSparsityPattern();
+    numDiff.setThreads(1);
+    numDiff.df(x, jac);
+    VERIFY_IS_EQUAL(jac, plain_jac);
+}
+
 void test_NumericalDiff()
 {
     CALL_SUBTEST(test_forward());
     CALL_SUBTEST(test_central());
+    CALL_SUBTEST(test_sparsity_pattern<Forward>());
+    CALL_SUBTEST(test_sparsity_pattern<Central>());
 }
@@ -7,6 +7,7 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#define EIGEN_RUNTIME_NO_MALLOC
 #include "main.h"
 #include <unsupported/Eigen/AutoDiff>
 
@@ -211,6 +212,99 @@ template<typename Func> void forward_jacobian(const Func& f)
     VERIFY_IS_APPROX(j, jref);
 }
 
+/* Test functor with more inputs than the derivatives differentiated per evaluation,
+ * v_i = atan2(x_i, 2 + x_{i+1}^2) + sum_j sin((i+1) x_j) x_{j+1}, the indices of x being taken modulo n. */
+template<typename _Scalar, int NX=Dynamic, int NY=Dynamic>
+struct TestFuncChain
+{
+  typedef _Scalar Scalar;
+  enum {
+    InputsAtCompileTime = NX,
+    ValuesAtCompileTime = NY
+  };
+  typedef Matrix<Scalar,InputsAtCompileTime,1> InputType;
+  typedef Matrix<Scalar,ValuesAtCompileTime,1> ValueType;
+  typedef Matrix<Scalar,ValuesAtCompileTime,InputsAtCompileTime> JacobianType;
+
+  int m_inputs, m_values;
+
+  TestFuncChain() : m_inputs(InputsAtCompileTime), m_values(ValuesAtCompileTime) {}
+  TestFuncChain(int inputs, int values) : m_inputs(inputs), m_values(values) {}
+
+  int inputs() const { return m_inputs; }
+  int values() const { return m_values; }
+
+  template<typename T>
+  void operator() (const Matrix<T,InputsAtCompileTime,1>& x, Matrix<T,ValuesAtCompileTime,1>* _v) const
+  {
+    using std::sin;
+    using std::atan2;
+    Matrix<T,ValuesAtCompileTime,1>& v = *_v;
+    const int n = inputs();
+    for (int i=0; i<values(); ++i)
+    {
+      const T& b = x[(i+1)%n];
+      T s = atan2(x[i%n], T(2) + b*b);
+      for (int j=0; j<n; ++j)
+        s += sin(x[j] * Scalar(i+1)) * x[(j+1)%n];
+      v[i] = s;
+    }
+  }
+
+  void operator() (const InputType& x, ValueType* v, JacobianType* _j) const
+  {
+    using std::sin;
+    using std::cos;
+    (*this)(x, v);
+
+    if(_j)
+    {
+      JacobianType& j = *_j;
+      const int n = inputs();
+      j.setZero();
+      for (int i=0; i<values(); ++i)
+      {
+        const int a = i%n, b = (i+1)%n;
+        const Scalar y = x[a], z = 2 + x[b]*x[b], r = y*y + z*z, c = Scalar(i+1);
+        j(i,a) += z / r;
+        j(i,b) -= y / r * 2 * x[b];
+        for (int k=0; k<n; ++k)
+        {
+          j(i,k) += c * cos(c * x[k]) * x[(k+1)%n];
+          j(i,(k+1)%n) += sin(c * x[k]);
+        }
+      }
+    }
+  }
+};
+
+template<int MaxSeeds, typename Func> void forward_jacobian_bounded(const Func& f)
+{
+    typename Func::InputType x = Func::InputType::Random(f.inputs());
+    typename Func::ValueType y(f.values()), yref(f.values());
+    typename Func::JacobianType j(f.values(),f.inputs()), jref(f.values(),f.inputs());
+
+    f(x,&yref,&jref);
+
+    typedef AutoDiffJacobian<Func,MaxSeeds> AutoJacobian;
+    VERIFY(AutoJacobian::DerivativeType::MaxRowsAtCompileTime <= MaxSeeds);
+    AutoJacobian autoj(f);
+    j.setConstant(-1);
+    autoj(x, &y, &j);
+    VERIFY_IS_APPROX(y, yref);
+    VERIFY_IS_APPROX(j, jref);
+
+    // the derivatives of fixed-size inputs and values are stored in place
+    if (Func::InputsAtCompileTime!=Dynamic && Func::ValuesAtCompileTime!=Dynamic)
+    {
+      j.setConstant(-1);
+      internal::set_is_malloc_allowed(false);
+      autoj(x, &y, &j);
+      internal::set_is_malloc_allowed(true);
+      VERIFY_IS_APPROX(j, jref);
+    }
+}
+
 // TODO also check actual derivatives!
 template <int>
 void test_autodiff_scalar()
@@ -247,6 +341,17 @@ void test_autodiff_jacobian()
   CALL_SUBTEST(( forward_jacobian(TestFunc1<double,3,2>()) ));
   CALL_SUBTEST(( forward_jacobian(TestFunc1<double,3,3>()) ));
   CALL_SUBTEST(( forward_jacobian(TestFunc1<double>(3,3)) ));
+  CALL_SUBTEST(( forward_jacobian(TestFuncChain<double>(10,4)) ));
+
+  // derivatives with a bounded number of coefficients, possibly with several evaluations
+  CALL_SUBTEST(( forward_jacobian_bounded<2>(TestFunc1<double,3,3>()) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<3>(TestFunc1<double,3,3>()) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<2>(TestFunc1<double>(3,2)) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<4>(TestFuncChain<double,10,4>()) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<32>(TestFuncChain<double,10,4>()) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<32>(TestFuncChain<float,32,6>()) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<8>(TestFuncChain<double>(internal::random<int>(1,40),5)) ));
+  CALL_SUBTEST(( forward_jacobian_bounded<32>(TestFuncChain<double>(internal::random<int>(1,40),5)) ));
 #if EIGEN_HAS_VARIADIC_TEMPLATES
   CALL_SUBTEST(( forward_jacobian_cpp11(integratorFunctor<double>(10)) ));
 #endif
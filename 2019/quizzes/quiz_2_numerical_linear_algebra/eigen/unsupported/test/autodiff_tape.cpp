@@ -0,0 +1,284 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/AutoDiff>
+
+// a function using all the operations supported by both AutoDiffScalar and AutoDiffTapeScalar
+template<typename T>
+T energy(const Matrix<T,Dynamic,1>& x)
+{
+  using std::sin; using std::cos; using std::tan; using std::exp; using std::log; using std::sqrt;
+  using std::asin; using std::acos; using std::sinh; using std::cosh; using std::tanh; using std::atan2;
+  using std::abs; using std::pow;
+  typedef typename NumTraits<T>::Literal L;
+  T e(0);
+  for (Index i = 0; i + 1 < x.size(); ++i)
+  {
+    const T& a = x[i];
+    const T& b = x[i+1];
+    e += sin(a) * exp(b) * L(0.1) + sqrt(L(1) + a * a) + log(L(2) + b) / (L(2) + a * a);
+    e += atan2(a, b + L(3)) + tanh(a - b) + cos(b) * L(2) - abs(a) * b;
+    e += pow(abs2(a) + L(1), L(1.5)) + (max)(a, b) - (min)(T(a * b), a);
+    e += asin(a * L(0.5)) + acos(b * L(0.5)) + sinh(a) * cosh(b) + tan(a * L(0.3)) - L(1) / (L(3) + b);
+  }
+  e += (x.array() - L(0.5)).matrix().squaredNorm();
+  return e;
+}
+
+template<typename T>
+void residuals(const Matrix<T,Dynamic,1>& x, Matrix<T,Dynamic,1>& r)
+{
+  using std::sin; using std::exp;
+  typedef typename NumTraits<T>::Literal L;
+  r.resize(x.size() + 1);
+  for (Index i = 0; i < x.size(); ++i)
+    r[i] = sin(x[i]) * x[(i + 1) % x.size()] + exp(x[i] * L(0.5));
+  r[x.size()] = x.sum() * L(3);
+}
+
+// a function computed by scalars, and by arrays recording its operations as array operations
+template<typename T>
+T array_energy(const Matrix<T,Dynamic,1>& x)
+{
+  using std::sin; using std::exp; using std::sqrt; using std::tanh; using std::pow;
+  typedef typename NumTraits<T>::Literal L;
+  const Index n = x.size();
+  const T t = x[0] * L(2);
+  T e(0), squared_norm(0);
+  for (Index i = 0; i < n; ++i)
+  {
+    const L c = L(i) / L(n);
+    if (i + 1 < n)
+      e += abs2(x[i+1] - x[i]);
+    e += sin(x[i]) * exp(x[i] * L(0.1)) + x[i] * x[n-1-i];
+    e += sqrt(L(1) + abs2(x[i])) / (L(2) + tanh(x[i])) + (x[i] - c) * c;
+    e += x[i] * t + (max)(x[i], x[n-1-i]) - (min)(x[i], T(c)) + pow(abs2(x[i]) + L(1), L(1.5));
+    squared_norm += x[i] * x[i];
+  }
+  return e + sqrt(squared_norm) + abs2(x[0]) * abs2(x[n-1]);
+}
+
+template<typename Scalar>
+AutoDiffTapeScalar<Scalar> array_energy(AutoDiffTape<Scalar>& tape, const typename AutoDiffTape<Scalar>::ActiveVector& x)
+{
+  typedef AutoDiffTapeArray<Scalar> ActiveArray;
+  const Index n = x.size();
+  typename ActiveArray::ValueType values(n);
+  for (Index i = 0; i < n; ++i)
+    values[i] = Scalar(i) / Scalar(n);
+  const ActiveArray a = tape.array(x), r = tape.array(x.reverse()), c(values);
+  const AutoDiffTapeScalar<Scalar> t = x[0] * Scalar(2);
+  const ActiveArray y = abs2(a);
+  AutoDiffTapeScalar<Scalar> e = (a.tail(n - 1) - a.head(n - 1)).squaredNorm();
+  e += (sin(a) * exp(a * Scalar(0.1))).sum() + a.dot(r);
+  e += (sqrt(Scalar(1) + y) / (Scalar(2) + tanh(a))).sum() + (a - c).dot(c);
+  e += (a * t + (a.max)(r) - (a.min)(c) + pow(y + Scalar(1), Scalar(1.5))).sum();
+  return e + a.norm() + y[0] * y[n-1];
+}
+
+template<typename Scalar> void tape_gradient(Index n)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef AutoDiffScalar<VectorType> ForwardScalar;
+  typedef AutoDiffTape<Scalar> Tape;
+  typedef typename Tape::ActiveScalar ActiveScalar;
+
+  VectorType x = VectorType::Random(n);
+  Matrix<ForwardScalar,Dynamic,1> fx(n);
+  for (Index i = 0; i < n; ++i)
+    fx[i] = ForwardScalar(x[i], n, i);
+  const ForwardScalar fe = energy(fx);
+
+  Tape tape;
+  typename Tape::ActiveVector ax = tape.variables(x);
+  const ActiveScalar e = energy(ax);
+  VERIFY_IS_EQUAL(tape.inputs(), n);
+  VERIFY_IS_APPROX(e.value(), fe.value());
+  VERIFY_IS_APPROX(tape.value(e), fe.value());
+
+  VectorType grad;
+  tape.gradient(e, grad);
+  VERIFY_IS_EQUAL(grad.size(), n);
+  VERIFY_IS_APPROX(grad, fe.derivatives());
+
+  // replay the operations with other inputs, the control flow being fixed for the comparisons of min and max
+  VectorType y = VectorType::Random(n);
+  for (Index i = 0; i < n; ++i)
+    fx[i] = ForwardScalar(y[i], n, i);
+  const ForwardScalar fe2 = energy(fx);
+  tape.replay(y);
+  VERIFY_IS_APPROX(tape.value(e), fe2.value());
+  tape.gradient(e, grad);
+  VERIFY_IS_APPROX(grad, fe2.derivatives());
+
+  // recording again from a checkpoint reuses the inputs, and rewinding recomputes the operations
+  // before the checkpoint with the input values it stores
+  const typename Tape::Checkpoint cp = tape.checkpoint();
+  VERIFY_IS_EQUAL(cp.size, tape.size());
+  tape.replay(x);
+  const ActiveScalar e2 = energy(ax) * Scalar(2);
+  VERIFY(tape.size() > cp.size);
+  tape.gradient(e2, grad);
+  VERIFY_IS_APPROX(grad, Scalar(2) * fe.derivatives());
+  tape.rewind(cp);
+  VERIFY_IS_EQUAL(tape.size(), cp.size);
+  VERIFY_IS_EQUAL(tape.inputs(), n);
+  VERIFY_IS_APPROX(tape.value(e), fe2.value());
+  tape.gradient(e, grad);
+  VERIFY_IS_APPROX(grad, fe2.derivatives());
+
+  // constants have no derivatives
+  tape.gradient(ActiveScalar(Scalar(3)), grad);
+  VERIFY_IS_EQUAL(grad.size(), n);
+  VERIFY(grad.isZero());
+
+  tape.clear();
+  VERIFY_IS_EQUAL(tape.size(), 0);
+  VERIFY_IS_EQUAL(tape.inputs(), 0);
+}
+
+template<typename Scalar> void tape_jacobian(Index n)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef AutoDiffScalar<VectorType> ForwardScalar;
+  typedef AutoDiffTape<Scalar> Tape;
+
+  VectorType x = VectorType::Random(n);
+  Matrix<ForwardScalar,Dynamic,1> fx(n), fr;
+  for (Index i = 0; i < n; ++i)
+    fx[i] = ForwardScalar(x[i], n, i);
+  residuals(fx, fr);
+  MatrixType ref(fr.size(), n);
+  for (Index i = 0; i < fr.size(); ++i)
+    ref.row(i) = fr[i].derivatives().transpose();
+
+  Tape tape(100);
+  typename Tape::ActiveVector ax = tape.variables(x), r;
+  residuals(ax, r);
+  MatrixType jac;
+  tape.jacobian(r, jac);
+  VERIFY_IS_EQUAL(jac.rows(), r.size());
+  VERIFY_IS_EQUAL(jac.cols(), n);
+  VERIFY_IS_APPROX(jac, ref);
+
+  // each row is the gradient of the corresponding output
+  VectorType grad;
+  for (Index i = 0; i < r.size(); ++i)
+  {
+    tape.gradient(r[i], grad);
+    VERIFY_IS_APPROX(grad.transpose(), jac.row(i));
+  }
+}
+
+template<typename Scalar> void tape_arrays(Index n)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef AutoDiffScalar<VectorType> ForwardScalar;
+  typedef AutoDiffTape<Scalar> Tape;
+  typedef typename Tape::ActiveScalar ActiveScalar;
+  typedef typename Tape::ActiveArray ActiveArray;
+
+  VectorType x = VectorType::Random(n), y = VectorType::Random(n);
+  Matrix<ForwardScalar,Dynamic,1> fx(n), fy(n);
+  for (Index i = 0; i < n; ++i)
+  {
+    fx[i] = ForwardScalar(x[i], n, i);
+    fy[i] = ForwardScalar(y[i], n, i);
+  }
+  const ForwardScalar fe = array_energy(fx), fe2 = array_energy(fy);
+
+  Tape tape;
+  typename Tape::ActiveVector ax = tape.variables(x);
+  const ActiveScalar e = array_energy(tape, ax);
+  VERIFY_IS_APPROX(e.value(), fe.value());
+  VectorType grad;
+  tape.gradient(e, grad);
+  VERIFY_IS_APPROX(grad, fe.derivatives());
+
+  // the array operations are replayed and recomputed from a checkpoint as well
+  const typename Tape::Checkpoint cp = tape.checkpoint();
+  tape.replay(y);
+  VERIFY_IS_APPROX(tape.value(e), fe2.value());
+  tape.gradient(e, grad);
+  VERIFY_IS_APPROX(grad, fe2.derivatives());
+  tape.rewind(cp);
+  VERIFY_IS_APPROX(tape.value(e), fe.value());
+  tape.gradient(e, grad);
+  VERIFY_IS_APPROX(grad, fe.derivatives());
+
+  // the Jacobian of the coefficients of an array, z_i = sin(x_i) x_{n-1-i} + x_i sum(x)
+  tape.clear();
+  ax = tape.variables(x);
+  const ActiveArray a = tape.array(ax);
+  const ActiveArray z = sin(a) * tape.array(ax.reverse()) + a * a.sum();
+  typename Tape::ActiveVector az(n);
+  for (Index i = 0; i < n; ++i)
+    az[i] = z[i];
+  MatrixType jac, ref = MatrixType::Zero(n, n);
+  VectorType value(n);
+  for (Index i = 0; i < n; ++i)
+  {
+    value[i] = std::sin(x[i]) * x[n-1-i] + x[i] * x.sum();
+    ref.row(i).setConstant(x[i]);
+    ref(i, i) += std::cos(x[i]) * x[n-1-i] + x.sum();
+    ref(i, n-1-i) += std::sin(x[i]);
+  }
+  VERIFY_IS_APPROX(VectorType(tape.value(z).matrix()), value);
+  tape.jacobian(az, jac);
+  VERIFY_IS_APPROX(jac, ref);
+  for (Index i = 0; i < n; ++i)
+  {
+    tape.gradient(z[i], grad);
+    VERIFY_IS_APPROX(grad.transpose(), jac.row(i));
+  }
+}
+
+template<typename Scalar> void tape_binary_functions()
+{
+  typedef AutoDiffTape<Scalar> Tape;
+  typedef typename Tape::ActiveScalar ActiveScalar;
+  using std::pow; using std::log; using std::atan;
+
+  Tape tape;
+  const Scalar a = internal::random<Scalar>(Scalar(0.5), Scalar(2)), b = internal::random<Scalar>(Scalar(-1), Scalar(1));
+  const ActiveScalar x = tape.variable(a), y = tape.variable(b);
+  const ActiveScalar f = pow(x, y) + atan(x * y) - Scalar(2) / x + (x - y) / (y + Scalar(3)) - (-x);
+  Matrix<Scalar,2,1> grad, ref;
+  ref << b * pow(a, b - 1) + b / (1 + a * a * b * b) + 2 / (a * a) + 1 / (b + 3) + 1,
+         pow(a, b) * log(a) + a / (1 + a * a * b * b) - (a + 3) / ((b + 3) * (b + 3));
+  tape.gradient(f, grad);
+  VERIFY_IS_APPROX(grad, ref);
+
+  ActiveScalar g = x;
+  g *= y;
+  g += x;
+  g -= Scalar(1);
+  g /= y + Scalar(2);
+  tape.gradient(g, grad);
+  ref << (b + 1) / (b + 2), (a * (b + 2) - (a * b + a - 1)) / ((b + 2) * (b + 2));
+  VERIFY_IS_APPROX(grad, ref);
+  VERIFY(x > y || x <= y);
+}
+
+void test_autodiff_tape()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( tape_gradient<double>(internal::random<Index>(1,50)) ));
+    CALL_SUBTEST_1(( tape_jacobian<double>(internal::random<Index>(1,50)) ));
+    CALL_SUBTEST_1(( tape_arrays<double>(internal::random<Index>(1,50)) ));
+    CALL_SUBTEST_1(( tape_binary_functions<double>() ));
+    CALL_SUBTEST_2(( tape_gradient<float>(internal::random<Index>(1,20)) ));
+    CALL_SUBTEST_2(( tape_jacobian<float>(internal::random<Index>(1,20)) ));
+    CALL_SUBTEST_2(( tape_arrays<float>(internal::random<Index>(1,20)) ));
+    CALL_SUBTEST_2(( tape_binary_functions<float>() ));
+  }
+  CALL_SUBTEST_1(( tape_gradient<double>(2000) ));
+  CALL_SUBTEST_1(( tape_arrays<double>(2000) ));
+}
@@ -0,0 +1,119 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/SVD>
+#include <Eigen/Eigenvalues>
+#include <unsupported/Eigen/BatchedSVD>
+
+template<typename Scalar>
+Matrix<Scalar,9,Dynamic> batched_svd_test_matrices(Index n)
+{
+  typedef Matrix<Scalar,3,3> Matrix3;
+  Matrix<Scalar,9,Dynamic> m(9,n);
+  for(Index j=0; j<n; ++j)
+  {
+    Map<Matrix3> A(m.col(j).data());
+    switch(j%6)
+    {
+      case 0: A.setRandom(); break;
+      // rank deficient
+      case 1: A.setRandom(); A.col(2) = A.col(0) - A.col(1); break;
+      // repeated singular values
+      case 2: A = Matrix3::Identity() * internal::random<Scalar>(Scalar(0.5),Scalar(2)); break;
+      // negative determinant
+      case 3: A.setRandom(); A.row(0) = -A.row(0); if(A.determinant()>0) A.col(1) = -A.col(1); break;
+      // badly scaled
+      case 4: A.setRandom(); A *= Scalar(1e-5); break;
+      // zero matrix
+      default: A.setZero();
+    }
+  }
+  return m;
+}
+
+template<typename Scalar> void batched_svd3x3(Index n)
+{
+  typedef Matrix<Scalar,3,3> Matrix3;
+  typedef Matrix<Scalar,3,1> Vector3;
+  const Scalar tol = test_precision<Scalar>();
+
+  Matrix<Scalar,9,Dynamic> m = batched_svd_test_matrices<Scalar>(n);
+  BatchedSVD3x3<Scalar> svd(m);
+  VERIFY_IS_EQUAL(svd.size(), n);
+
+  for(Index j=0; j<n; ++j)
+  {
+    Map<const Matrix3> A(m.col(j).data());
+    Matrix3 U = svd.matrixU(j), V = svd.matrixV(j);
+    Vector3 sigma = svd.singularValues().col(j);
+    Scalar norm = (std::max)(A.norm(), (std::numeric_limits<Scalar>::min)());
+
+    VERIFY_IS_APPROX(U.transpose()*U, Matrix3::Identity());
+    VERIFY_IS_APPROX(V.transpose()*V, Matrix3::Identity());
+    VERIFY_IS_APPROX(U.determinant(), Scalar(1));
+    VERIFY_IS_APPROX(V.determinant(), Scalar(1));
+    VERIFY((A - U*sigma.asDiagonal()*V.transpose()).norm() <= tol*norm);
+
+    VERIFY(sigma(0) >= sigma(1) - tol*norm);
+    VERIFY(sigma(1) >= numext::abs(sigma(2)) - tol*norm);
+    VERIFY(sigma(2) * A.determinant() >= -tol*norm*norm*norm);
+
+    Vector3 ref = JacobiSVD<Matrix3>(A).singularValues();
+    VERIFY((sigma.cwiseAbs() - ref).norm() <= tol*norm);
+  }
+
+  // mapped and strided inputs
+  std::vector<Matrix3> v(n);
+  for(Index j=0; j<n; ++j)
+    v[j] = Map<const Matrix3>(m.col(j).data());
+  BatchedSVD3x3<Scalar> svd2(Map<const Matrix<Scalar,9,Dynamic> >(v[0].data(), 9, n));
+  VERIFY_IS_APPROX(svd2.singularValues(), svd.singularValues());
+
+  Matrix<Scalar,Dynamic,Dynamic> padded(12, n);
+  padded.template topRows<9>() = m;
+  BatchedSVD3x3<Scalar> svd3(Map<const Matrix<Scalar,9,Dynamic>, 0, OuterStride<> >(padded.data(), 9, n, OuterStride<>(12)));
+  VERIFY_IS_APPROX(svd3.singularValues(), svd.singularValues());
+}
+
+template<typename Scalar> void batched_polar3x3(Index n)
+{
+  typedef Matrix<Scalar,3,3> Matrix3;
+  const Scalar tol = test_precision<Scalar>();
+
+  Matrix<Scalar,9,Dynamic> m = batched_svd_test_matrices<Scalar>(n);
+  BatchedPolarDecomposition3x3<Scalar> polar(m);
+  VERIFY_IS_EQUAL(polar.size(), n);
+
+  for(Index j=0; j<n; ++j)
+  {
+    Map<const Matrix3> A(m.col(j).data());
+    Matrix3 R = polar.rotation(j), S = polar.stretch(j);
+    Scalar norm = (std::max)(A.norm(), (std::numeric_limits<Scalar>::min)());
+
+    VERIFY_IS_APPROX(R.transpose()*R, Matrix3::Identity());
+    VERIFY_IS_APPROX(R.determinant(), Scalar(1));
+    VERIFY_IS_EQUAL(S, S.transpose());
+    VERIFY((A - R*S).norm() <= tol*norm);
+    if(A.determinant() > tol*norm*norm*norm)
+      VERIFY(SelfAdjointEigenSolver<Matrix3>(S).eigenvalues().minCoeff() >= -tol*norm);
+  }
+}
+
+void test_batched_svd()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    Index n = internal::random<Index>(1,200);
+    CALL_SUBTEST_1( batched_svd3x3<float>(n) );
+    CALL_SUBTEST_1( batched_polar3x3<float>(n) );
+    CALL_SUBTEST_2( batched_svd3x3<double>(n) );
+    CALL_SUBTEST_2( batched_polar3x3<double>(n) );
+  }
+  // non vectorized tails only
+  CALL_SUBTEST_1( batched_svd3x3<float>(3) );
+  CALL_SUBTEST_2( batched_svd3x3<double>(1) );
+}
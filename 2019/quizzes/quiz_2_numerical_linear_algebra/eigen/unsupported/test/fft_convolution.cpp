@@ -0,0 +1,136 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/FFT>
+#include <set>
+
+#if !defined(EIGEN_FFTW_DEFAULT) && !defined(EIGEN_MKL_DEFAULT)
+// gives access to the sizes of the plans of a kissfft object
+template<typename Scalar>
+struct kissfft_plan_sizes : internal::kissfft_impl<Scalar>
+{
+  static std::set<int> get(const internal::kissfft_impl<Scalar> & impl)
+  {
+    std::set<int> sizes;
+    const typename kissfft_plan_sizes::PlanMap & plans = impl.*(&kissfft_plan_sizes::m_plans);
+    for (typename kissfft_plan_sizes::PlanMap::const_iterator it = plans.begin(); it != plans.end(); ++it)
+      sizes.insert(it->first >> 1);
+    return sizes;
+  }
+};
+#endif
+
+template<typename MatrixType>
+MatrixType reference_convolution(const MatrixType & x, const MatrixType & k, int mode, bool correlation)
+{
+  typedef FFTConvolution<typename MatrixType::Scalar> Convolution;
+  const Index rows = x.rows() + k.rows() - 1, cols = x.cols() + k.cols() - 1;
+  MatrixType full = MatrixType::Zero(rows, cols);
+  for (Index j = 0; j < x.cols(); ++j)
+    for (Index i = 0; i < x.rows(); ++i)
+      for (Index b = 0; b < k.cols(); ++b)
+        for (Index a = 0; a < k.rows(); ++a)
+          full(i + a, j + b) += x(i, j) * (correlation ? k(k.rows() - 1 - a, k.cols() - 1 - b) : k(a, b));
+  if (mode == Convolution::Same)
+    return full.block(k.rows() / 2, k.cols() / 2, x.rows(), x.cols());
+  if (mode == Convolution::Valid)
+    return full.block(k.rows() - 1, k.cols() - 1, (std::max)(x.rows() - k.rows() + 1, Index(0)),
+                      (std::max)(x.cols() - k.cols() + 1, Index(0)));
+  return full;
+}
+
+template<typename Scalar> void fft_convolution(Index rows, Index cols, Index krows, Index kcols)
+{
+  typedef FFTConvolution<Scalar> Convolution;
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  const Scalar tol = test_precision<Scalar>() * Scalar(10);
+
+  MatrixType x = MatrixType::Random(rows, cols), k = MatrixType::Random(krows, kcols), result;
+  Convolution conv;
+  for (int mode = Convolution::Full; mode <= Convolution::Valid; ++mode) {
+    for (int c = 0; c < 2; ++c) {
+      const MatrixType ref = reference_convolution(x, k, mode, c == 1);
+      const Scalar scale = ref.size() > 0 ? (std::max)(Scalar(1), ref.cwiseAbs().maxCoeff()) : Scalar(1);
+      for (int method = Convolution::Automatic; method <= Convolution::Fourier; ++method) {
+        conv.setMethod(typename Convolution::Method(method));
+        if (c == 1)
+          conv.correlate(result, x, k, typename Convolution::Mode(mode));
+        else
+          conv.convolve(result, x, k, typename Convolution::Mode(mode));
+        VERIFY_IS_EQUAL(result.rows(), ref.rows());
+        VERIFY_IS_EQUAL(result.cols(), ref.cols());
+        if (ref.size() > 0)
+          VERIFY((result - ref).cwiseAbs().maxCoeff() <= tol * scale);
+        if (method != Convolution::Automatic && ref.size() > 0)
+          VERIFY_IS_EQUAL(conv.usedFourier(), method == Convolution::Fourier);
+      }
+    }
+  }
+}
+
+template<typename Scalar> void fft_convolution_vectors(Index n, Index kn)
+{
+  typedef FFTConvolution<Scalar> Convolution;
+  typedef Matrix<Scalar, Dynamic, 1> VectorType;
+  typedef Matrix<Scalar, 1, Dynamic> RowVectorType;
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  const Scalar tol = test_precision<Scalar>() * Scalar(10);
+
+  VectorType x = VectorType::Random(n), k = VectorType::Random(kn), result;
+  RowVectorType rowResult;
+  const MatrixType ref = reference_convolution(MatrixType(x), MatrixType(k), Convolution::Same, false);
+  const Scalar scale = (std::max)(Scalar(1), ref.cwiseAbs().maxCoeff());
+
+  Convolution conv(Convolution::Fourier);
+  conv.convolve(result, x, k, Convolution::Same);
+  VERIFY_IS_EQUAL(result.size(), n);
+  VERIFY((result - ref.col(0)).cwiseAbs().maxCoeff() <= tol * scale);
+
+  // row vectors are convolved along the rows
+  conv.convolve(rowResult, x.transpose(), k.transpose(), Convolution::Same);
+  VERIFY_IS_EQUAL(rowResult.size(), n);
+  VERIFY((rowResult - ref.col(0).transpose()).cwiseAbs().maxCoeff() <= tol * scale);
+
+#if !defined(EIGEN_FFTW_DEFAULT) && !defined(EIGEN_MKL_DEFAULT)
+  // the single column is not transformed along the rows, such that the only plans are the ones of the real FFTs
+  const std::set<int> sizes = kissfft_plan_sizes<Scalar>::get(conv.fft().impl());
+  VERIFY_IS_EQUAL(sizes.size(), std::size_t(1));
+  VERIFY(*sizes.begin() >= 32);
+#endif
+}
+
+template<typename Scalar> void fft_convolution_cost_model()
+{
+  typedef FFTConvolution<Scalar> Convolution;
+  typedef Matrix<Scalar, Dynamic, Dynamic> MatrixType;
+  MatrixType image = MatrixType::Random(256, 256), result;
+  Convolution conv;
+  conv.convolve(result, image, MatrixType::Random(3, 3), Convolution::Same);
+  VERIFY(!conv.usedFourier());
+  conv.convolve(result, image, MatrixType::Random(31, 31), Convolution::Same);
+  VERIFY(conv.usedFourier());
+}
+
+void test_fft_convolution()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( fft_convolution<float>(internal::random<Index>(1,40), internal::random<Index>(1,40),
+                                            internal::random<Index>(1,10), internal::random<Index>(1,10)) ));
+    CALL_SUBTEST_2(( fft_convolution<double>(internal::random<Index>(1,40), internal::random<Index>(1,40),
+                                             internal::random<Index>(1,10), internal::random<Index>(1,10)) ));
+    // blocks of the overlap-add method
+    CALL_SUBTEST_2(( fft_convolution<double>(internal::random<Index>(100,200), internal::random<Index>(1,3),
+                                             internal::random<Index>(1,5), 1) ));
+    CALL_SUBTEST_3(( fft_convolution_vectors<float>(internal::random<Index>(1,2000), internal::random<Index>(1,50)) ));
+    CALL_SUBTEST_3(( fft_convolution_vectors<double>(internal::random<Index>(1,2000), internal::random<Index>(1,50)) ));
+  }
+  // kernels larger than the signal
+  CALL_SUBTEST_1(( fft_convolution<float>(3, 5, 7, 9) ));
+  CALL_SUBTEST_2(( fft_convolution<double>(64, 64, 31, 31) ));
+  CALL_SUBTEST_1(( fft_convolution_cost_model<float>() ));
+}
@@ -0,0 +1,114 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <unsupported/Eigen/ICP>
+
+template<typename Scalar, int Dim>
+Transform<Scalar, Dim, Affine> icp_small_motion()
+{
+  typedef Matrix<Scalar, Dim, 1> VectorType;
+  typedef Matrix<Scalar, Dim, Dim> MatrixType;
+  // a rotation by a small angle in a random plane, followed by a small translation
+  MatrixType R = MatrixType::Identity();
+  VectorType u = VectorType::Random().normalized(), v = VectorType::Random();
+  v = (v - v.dot(u) * u).normalized();
+  const Scalar angle = internal::random<Scalar>(Scalar(-0.1), Scalar(0.1));
+  R += (std::sin(angle) * (v * u.transpose() - u * v.transpose()) + (std::cos(angle) - Scalar(1)) * (u * u.transpose() + v * v.transpose()));
+  Transform<Scalar, Dim, Affine> t;
+  t.linear() = R;
+  t.translation() = Scalar(0.02) * VectorType::Random();
+  return t;
+}
+
+template<typename Scalar, int Dim> void icp_nearest(Index n)
+{
+  typedef IterativeClosestPoint<Scalar, Dim> ICP;
+  typedef typename ICP::PointsType PointsType;
+
+  PointsType target = PointsType::Random(Dim, n), queries = PointsType::Random(Dim, 2 * n);
+  const Scalar maxDistance = Scalar(0.2);
+  ICP icp(target);
+  icp.setMaxCorrespondenceDistance(maxDistance);
+
+  typename ICP::IndicesType indices;
+  typename ICP::DistancesType distances;
+  icp.findNearest(queries, indices, distances);
+  VERIFY_IS_EQUAL(indices.size(), queries.cols());
+
+  for(Index i = 0; i < queries.cols(); ++i) {
+    Index best;
+    const Scalar d = (target.colwise() - queries.col(i)).colwise().squaredNorm().minCoeff(&best);
+    if(d >= maxDistance * maxDistance) {
+      VERIFY_IS_EQUAL(indices(i), -1);
+      continue;
+    }
+    VERIFY(indices(i) >= 0);
+    // ties may be broken differently
+    VERIFY_IS_APPROX(distances(i), d);
+    VERIFY_IS_APPROX(distances(i), (target.col(indices(i)) - queries.col(i)).squaredNorm());
+  }
+}
+
+template<typename Scalar, int Dim> void icp_registration(Index n)
+{
+  typedef IterativeClosestPoint<Scalar, Dim> ICP;
+  typedef typename ICP::PointsType PointsType;
+  typedef typename ICP::TransformType TransformType;
+  const Scalar tol = test_precision<Scalar>() * Scalar(10);
+
+  PointsType target = PointsType::Random(Dim, n), source(Dim, n);
+  const TransformType motion = icp_small_motion<Scalar, Dim>();
+  motion.inverse().transformPoints(target, source);
+
+  ICP icp(target);
+  icp.compute(source);
+  VERIFY_IS_EQUAL(icp.info(), Success);
+  VERIFY_IS_EQUAL(icp.inliers(), n);
+  VERIFY(icp.error() <= tol);
+  VERIFY((icp.transform().matrix() - motion.matrix()).norm() <= tol);
+
+  // coarse to fine subsampling with outlier rejection
+  icp.setSubsampling(8).setMaxCorrespondenceDistance(Scalar(0.5)).compute(source);
+  VERIFY_IS_EQUAL(icp.info(), Success);
+  VERIFY_IS_EQUAL(icp.inliers(), n);
+  VERIFY((icp.transform().matrix() - motion.matrix()).norm() <= tol);
+
+  // the last iteration from the exact transformation has no error
+  icp.setSubsampling(1).compute(source, motion);
+  VERIFY_IS_EQUAL(icp.info(), Success);
+  VERIFY(icp.iterations() <= 2);
+
+  // source points corrupted by outliers which are rejected
+  PointsType corrupted = source;
+  const Index outliers = n / 10;
+  for(Index i = 0; i < outliers; ++i)
+    corrupted.col(i).setConstant(Scalar(10));
+  icp.compute(corrupted);
+  VERIFY_IS_EQUAL(icp.info(), Success);
+  VERIFY_IS_EQUAL(icp.inliers(), n - outliers);
+  VERIFY((icp.transform().matrix() - motion.matrix()).norm() <= tol);
+
+  // no correspondence at all
+  icp.setMaxCorrespondenceDistance(Scalar(1)).compute(PointsType::Constant(Dim, n, Scalar(10)));
+  VERIFY_IS_EQUAL(icp.info(), NumericalIssue);
+
+  icp.setMaxIterations(1).setMaxCorrespondenceDistance(NumTraits<Scalar>::infinity()).compute(source);
+  VERIFY_IS_EQUAL(icp.iterations(), 1);
+  VERIFY_IS_EQUAL(icp.info(), NoConvergence);
+}
+
+void test_icp()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( icp_nearest<float, 3>(internal::random<Index>(1, 1000)) ));
+    CALL_SUBTEST_1(( icp_registration<float, 3>(internal::random<Index>(200, 1000)) ));
+    CALL_SUBTEST_2(( icp_nearest<double, 2>(internal::random<Index>(1, 1000)) ));
+    CALL_SUBTEST_2(( icp_registration<double, 2>(internal::random<Index>(200, 1000)) ));
+    CALL_SUBTEST_3(( icp_registration<double, 3>(internal::random<Index>(2000, 5000)) ));
+  }
+}
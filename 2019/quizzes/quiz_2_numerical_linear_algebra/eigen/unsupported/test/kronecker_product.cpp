@@ -82,6 +82,53 @@ void check_sparse_kronecker_product(const MatrixType& ab)
   VERIFY_IS_APPROX(ab.coeff(8,9), -0.15);
 }
 
+template<typename MatrixA, typename MatrixB>
+void check_kronecker_operator(const MatrixA& A, const MatrixB& B)
+{
+  typedef typename MatrixA::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+  typedef Matrix<Scalar,Dynamic,1> DenseVector;
+
+  KroneckerOperator<MatrixA,MatrixB> K = kroneckerOperator(A,B);
+  DenseMatrix KD = kroneckerProduct(DenseMatrix(A),DenseMatrix(B));
+  VERIFY_IS_EQUAL(K.rows(), KD.rows());
+  VERIFY_IS_EQUAL(K.cols(), KD.cols());
+
+  DenseVector x = DenseVector::Random(K.cols()), y;
+  y = K * x;
+  VERIFY_IS_APPROX(y, KD * x);
+  y.noalias() += K * x;
+  VERIFY_IS_APPROX(y, Scalar(2) * (KD * x));
+
+  DenseMatrix X = DenseMatrix::Random(K.cols(), 3), Y(K.rows()+2, 5);
+  Y.setZero();
+  Y.block(1,1,K.rows(),3) = K * X;
+  VERIFY_IS_APPROX(Y.block(1,1,K.rows(),3), KD * X);
+}
+
+void check_kronecker_operator_solve()
+{
+  // SPD factors give an SPD Kronecker product
+  int m = internal::random<int>(1,12), n = internal::random<int>(1,12);
+  MatrixXd A = MatrixXd::Random(m,m), B = MatrixXd::Random(n,n);
+  A = A * A.transpose() + MatrixXd::Identity(m,m) * m;
+  B = B * B.transpose() + MatrixXd::Identity(n,n) * n;
+  KroneckerOperator<MatrixXd,MatrixXd> K = kroneckerOperator(A,B);
+  MatrixXd KD = kroneckerProduct(A,B);
+  VectorXd b = VectorXd::Random(m*n), x;
+
+  ConjugateGradient<KroneckerOperator<MatrixXd,MatrixXd>, Lower|Upper, IdentityPreconditioner> cg(K);
+  cg.setTolerance(1e-12);
+  x = cg.solve(b);
+  VERIFY_IS_EQUAL(cg.info(), Success);
+  VERIFY_IS_APPROX(KD * x, b);
+
+  BiCGSTAB<KroneckerOperator<MatrixXd,MatrixXd>, IdentityPreconditioner> bicg(K);
+  bicg.setTolerance(1e-12);
+  x = bicg.solve(b);
+  VERIFY_IS_EQUAL(bicg.info(), Success);
+  VERIFY_IS_APPROX(KD * x, b);
+}
 
 void test_kronecker_product()
 {
@@ -229,6 +276,23 @@ void test_kronecker_product()
     dC = kroneckerProduct(2*dA,dB);
     VERIFY_IS_APPROX(MatrixXf(sC2),dC);
   }
+
+  for(int i = 0; i < g_repeat; i++)
+  {
+    int ra = Eigen::internal::random<int>(1,20);
+    int ca = Eigen::internal::random<int>(1,20);
+    int rb = Eigen::internal::random<int>(1,20);
+    int cb = Eigen::internal::random<int>(1,20);
+    MatrixXd dA = MatrixXd::Random(ra,ca), dB = MatrixXd::Random(rb,cb);
+    SparseMatrix<double> sA(ra,ca), sB(rb,cb);
+    initSparse(0.3, dA, sA);
+    initSparse(0.3, dB, sB);
+    CALL_SUBTEST(check_kronecker_operator(dA, dB));
+    CALL_SUBTEST(check_kronecker_operator(sA, dB));
+    CALL_SUBTEST(check_kronecker_operator(dA, sB));
+    CALL_SUBTEST(check_kronecker_operator(Matrix3f::Random().eval(), Matrix2f::Random().eval()));
+    CALL_SUBTEST(check_kronecker_operator_solve());
+  }
 }
 
 #endif
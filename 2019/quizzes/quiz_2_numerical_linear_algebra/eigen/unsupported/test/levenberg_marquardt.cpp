@@ -1445,6 +1445,161 @@ void testNistEckerle4(void)
   VERIFY_IS_APPROX(x[2], 4.5154121844E+02);
 }
 
+struct misra1a_block_functor : BlockSparseFunctor<double>
+{
+    misra1a_block_functor(void) : BlockSparseFunctor<double>(2)
+    {
+        for(int i=0; i<14; i++)
+            addTerm(1, Vector2i(1, 0));
+    }
+    int operator()(Index term, const VectorXd &b, Ref<VectorXd> fvec) const
+    {
+        const double x = misra1a_functor::m_x[term];
+        fvec[0] = b[0]*(1.-exp(-b[1]*x)) - misra1a_functor::m_y[term];
+        return 0;
+    }
+    int df(Index term, const VectorXd &b, Ref<MatrixXd> fjac) const
+    {
+        // the columns follow the order of the inputs given to addTerm()
+        const double x = misra1a_functor::m_x[term];
+        fjac(0,0) = b[0]*x*exp(-b[1]*x);
+        fjac(0,1) = 1.-exp(-b[1]*x);
+        return 0;
+    }
+};
+
+void testSparseNistMisra1a(void)
+{
+  VectorXd x(2);
+  misra1a_block_functor functor;
+  VERIFY_IS_EQUAL(functor.values(), 14);
+  VERIFY_IS_EQUAL(functor.terms(), 14);
+  SparseLevenbergMarquardt<misra1a_block_functor> lm(functor);
+
+  x<< 500., 0.0001;
+  lm.minimize(x);
+  VERIFY_IS_EQUAL(lm.info(), Success);
+  VERIFY_IS_APPROX(lm.fvec().squaredNorm(), 1.2455138894E-01);
+  VERIFY_IS_APPROX(x[0], 2.3894212918E+02);
+  VERIFY_IS_APPROX(x[1], 5.5015643181E-04);
+
+  x<< 250., 0.0005;
+  lm.minimize(x);
+  VERIFY_IS_EQUAL(lm.info(), Success);
+  VERIFY_IS_APPROX(lm.fvec().squaredNorm(), 1.2455138894E-01);
+  VERIFY_IS_APPROX(x[0], 2.3894212918E+02);
+  VERIFY_IS_APPROX(x[1], 5.5015643181E-04);
+}
+
+// A small bundle adjustment like problem: the observation of the point k, an angle p_k, in the
+// camera c, a similarity z_c = a_c + i b_c, is conj(z_c) exp(i p_k), the first camera being fixed.
+struct bundle_functor : BlockSparseFunctor<double>
+{
+    bundle_functor(int cameras, int points, const VectorXd &truth, double noise)
+      : BlockSparseFunctor<double>(2*cameras+points), m_cameras(cameras)
+    {
+        addTerm(2, Vector2i(0, 1));
+        m_observations.push_back(truth.head<2>());
+        for(int k=0; k<points; k++)
+            for(int c=0; c<cameras; c++)
+                if(c==k%cameras || internal::random<int>(0,2)==0) {
+                    // the point first, to check the inputs need not be sorted
+                    addTerm(2, Vector3i(2*cameras+k, 2*c, 2*c+1));
+                    m_observations.push_back(observe(truth, k, c) + noise*Vector2d::Random());
+                }
+    }
+    Vector2d observe(const VectorXd &x, int k, int c) const
+    {
+        const double a = x[2*c], b = x[2*c+1], p = x[2*m_cameras+k];
+        return Vector2d(a*cos(p) + b*sin(p), a*sin(p) - b*cos(p));
+    }
+    int operator()(Index term, const VectorXd &x, Ref<VectorXd> fvec) const
+    {
+        if(term==0)
+            fvec = x.head<2>() - m_observations[0];
+        else {
+            Map<const IndicesType> inputs = termInputs(term);
+            fvec = observe(x, int(inputs[0]) - 2*m_cameras, int(inputs[1])/2) - m_observations[term];
+        }
+        return 0;
+    }
+    int df(Index term, const VectorXd &x, Ref<MatrixXd> fjac) const
+    {
+        if(term==0)
+            fjac.setIdentity();
+        else {
+            Map<const IndicesType> inputs = termInputs(term);
+            const double p = x[inputs[0]], a = x[inputs[1]], b = x[inputs[2]];
+            fjac << -a*sin(p) + b*cos(p), cos(p),  sin(p),
+                     a*cos(p) + b*sin(p), sin(p), -cos(p);
+        }
+        return 0;
+    }
+    int m_cameras;
+    std::vector<Vector2d, aligned_allocator<Vector2d> > m_observations;
+};
+
+// the same problem with a dense Jacobian
+struct bundle_dense_functor : DenseFunctor<double>
+{
+    bundle_dense_functor(const bundle_functor &sparse) : DenseFunctor<double>(sparse.inputs(), sparse.values()), m_sparse(sparse) {}
+    int operator()(const VectorXd &x, VectorXd &fvec)
+    {
+        for(Index t=0; t<m_sparse.terms(); t++)
+            m_sparse(t, x, fvec.segment(m_sparse.termValueOffset(t), m_sparse.termValues(t)));
+        return 0;
+    }
+    int df(const VectorXd &x, MatrixXd &fjac)
+    {
+        fjac.setZero();
+        for(Index t=0; t<m_sparse.terms(); t++) {
+            Map<const bundle_functor::IndicesType> inputs = m_sparse.termInputs(t);
+            MatrixXd block(m_sparse.termValues(t), inputs.size());
+            m_sparse.df(t, x, block);
+            for(Index a=0; a<inputs.size(); a++)
+                fjac.col(inputs[a]).segment(m_sparse.termValueOffset(t), block.rows()) = block.col(a);
+        }
+        return 0;
+    }
+    const bundle_functor &m_sparse;
+};
+
+template<typename SolverType>
+void testSparseBundle(int cameras, int points)
+{
+  const int n = 2*cameras+points;
+  const VectorXd truth = VectorXd::Random(n) + (VectorXd(n) << VectorXd::Constant(2*cameras, 2.), VectorXd::Zero(points)).finished();
+
+  // exact observations: the minimum is the truth
+  bundle_functor exact(cameras, points, truth, 0.);
+  VectorXd x = truth + 0.1*VectorXd::Random(n);
+  SparseLevenbergMarquardt<bundle_functor, SolverType> lm(exact);
+  lm.minimize(x);
+  VERIFY_IS_EQUAL(lm.info(), Success);
+  VERIFY(lm.fnorm() < 1e-8);
+  VERIFY_IS_APPROX(x, truth);
+  VERIFY_IS_EQUAL(lm.hessian().rows(), n);
+  VERIFY(lm.hessian().nonZeros() < n*(n+1)/2);
+
+  // noisy observations: same minimum as the dense solver
+  bundle_functor noisy(cameras, points, truth, 0.01);
+  x = truth;
+  SparseLevenbergMarquardt<bundle_functor, SolverType> sparse(noisy);
+  sparse.setXtol(1e-12);
+  sparse.setFtol(1e-12);
+  sparse.minimize(x);
+  VERIFY_IS_EQUAL(sparse.info(), Success);
+
+  VectorXd y = truth;
+  bundle_dense_functor dense_functor(noisy);
+  LevenbergMarquardt<bundle_dense_functor> dense(dense_functor);
+  dense.setXtol(1e-12);
+  dense.setFtol(1e-12);
+  dense.minimize(y);
+  VERIFY_IS_APPROX(sparse.fnorm(), dense.fnorm());
+  VERIFY_IS_APPROX(x, y);
+}
+
 void test_levenberg_marquardt()
 {
     // Tests using the examples provided by (c)minpack
@@ -1474,4 +1629,9 @@ void test_levenberg_marquardt()
     CALL_SUBTEST(testNistThurber());
     CALL_SUBTEST(testNistRat43());
     CALL_SUBTEST(testNistEckerle4());
+
+    // Block-sparse Jacobians
+    CALL_SUBTEST(testSparseNistMisra1a());
+    CALL_SUBTEST(( testSparseBundle<SimplicialLDLT<SparseMatrix<double>, Lower> >(3, 20) ));
+    CALL_SUBTEST(( testSparseBundle<SimplicialLLT<SparseMatrix<double>, Lower> >(4, 300) ));
 }
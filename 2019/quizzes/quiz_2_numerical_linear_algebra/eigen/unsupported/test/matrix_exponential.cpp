@@ -119,6 +119,101 @@ void randomTest(const MatrixType& m, double tol)
   }
 }
 
+template<typename T, int Size>
+void testBatchExpLog(double tol)
+{
+  typedef Matrix<T,Size,Size> MatrixType;
+  typedef Matrix<T,Dynamic,Dynamic> BatchType;
+  const Index n = internal::random<Index>(1,200);
+  BatchType args(Size*Size, n), exps, logs;
+  for (Index j=0; j<n; j++)
+  {
+    // a few matrices need squarings, and many need square roots for the logarithm
+    T scale = internal::random<T>(0,2);
+    if (j%10==0) scale = T(1e-4);
+    MatrixType m = scale * MatrixType::Random();
+    Map<MatrixType>(args.col(j).data()) = m;
+  }
+
+  batchMatrixExp(args, exps);
+  for (Index j=0; j<n; j++)
+  {
+    MatrixType m = Map<MatrixType>(args.col(j).data());
+    VERIFY(Map<MatrixType>(exps.col(j).data()).isApprox(m.exp(), static_cast<T>(tol)));
+  }
+
+  batchMatrixLog(exps, logs);
+  for (Index j=0; j<n; j++)
+  {
+    MatrixType m = Map<MatrixType>(exps.col(j).data());
+    MatrixType l = Map<MatrixType>(logs.col(j).data());
+    VERIFY(l.exp().isApprox(m, static_cast<T>(tol)));
+    // the logarithm of a matrix near the identity is only accurate to the absolute rounding errors
+    VERIFY_IS_APPROX_OR_LESS_THAN((l - m.log()).norm(), static_cast<T>(tol));
+  }
+
+  // in place
+  BatchType copy = args;
+  batchMatrixExp(copy, copy);
+  VERIFY_IS_EQUAL(copy, exps);
+}
+
+template <typename T>
+Matrix<T,3,3> skew(const Matrix<T,3,1>& w)
+{
+  Matrix<T,3,3> res;
+  res << 0, -w(2), w(1),
+         w(2), 0, -w(0),
+         -w(1), w(0), 0;
+  return res;
+}
+
+template<typename T>
+void testBatchLieGroups(double tol)
+{
+  typedef Matrix<T,3,1> Vector3;
+  typedef Matrix<T,3,3> Matrix3;
+  typedef Matrix<T,3,4> Matrix34;
+  typedef Matrix<T,4,4> Matrix4;
+  typedef Matrix<T,Dynamic,Dynamic> BatchType;
+  const Index n = internal::random<Index>(8,300);
+  BatchType twists(6, n), rotations, rotationVectors, transforms, logs;
+  for (Index j=0; j<n; j++)
+  {
+    Vector3 axis = Vector3::Random().normalized();
+    T angle = internal::random<T>(0, T(EIGEN_PI));
+    switch (j%8)
+    {
+      case 0: angle = 0; break;
+      case 1: angle = T(1e-7); break;
+      case 2: angle = T(1e-2); break;
+      case 3: angle = T(EIGEN_PI) - T(1e-3); break;
+      default: break;
+    }
+    twists.col(j) << angle * axis, Vector3::Random();
+  }
+
+  batchSO3Exp(twists.topRows(3), rotations);
+  batchSE3Exp(twists, transforms);
+  for (Index j=0; j<n; j++)
+  {
+    Matrix4 hat = Matrix4::Zero();
+    hat.template topLeftCorner<3,3>() = skew<T>(twists.col(j).template head<3>());
+    hat.template topRightCorner<3,1>() = twists.col(j).template tail<3>();
+    Matrix4 expected = hat.exp();
+    VERIFY(Map<Matrix3>(rotations.col(j).data()).isApprox(expected.template topLeftCorner<3,3>(), static_cast<T>(tol)));
+    VERIFY(Map<Matrix34>(transforms.col(j).data()).isApprox(expected.template topRows<3>(), static_cast<T>(tol)));
+  }
+
+  batchSO3Log(rotations, rotationVectors);
+  batchSE3Log(transforms, logs);
+  for (Index j=0; j<n; j++)
+  {
+    VERIFY_IS_APPROX_OR_LESS_THAN((rotationVectors.col(j) - twists.col(j).template head<3>()).norm(), static_cast<T>(tol));
+    VERIFY_IS_APPROX_OR_LESS_THAN((logs.col(j) - twists.col(j)).norm(), static_cast<T>(tol) * (1 + twists.col(j).norm()));
+  }
+}
+
 void test_matrix_exponential()
 {
   CALL_SUBTEST_2(test2dRotation<double>(1e-13));
@@ -138,4 +233,12 @@ void test_matrix_exponential()
   CALL_SUBTEST_1(randomTest(Matrix4f(), 1e-4));
   CALL_SUBTEST_6(randomTest(MatrixXf(8,8), 1e-4));
   CALL_SUBTEST_9(randomTest(Matrix<long double,Dynamic,Dynamic>(7,7), 1e-13));
+  CALL_SUBTEST_10((testBatchExpLog<float,2>(1e-4)));
+  CALL_SUBTEST_10((testBatchExpLog<float,3>(1e-4)));
+  CALL_SUBTEST_10((testBatchExpLog<float,4>(1e-4)));
+  CALL_SUBTEST_10(testBatchLieGroups<float>(1e-4));
+  CALL_SUBTEST_11((testBatchExpLog<double,2>(1e-12)));
+  CALL_SUBTEST_11((testBatchExpLog<double,3>(1e-12)));
+  CALL_SUBTEST_11((testBatchExpLog<double,4>(1e-12)));
+  CALL_SUBTEST_11(testBatchLieGroups<double>(1e-12));
 }
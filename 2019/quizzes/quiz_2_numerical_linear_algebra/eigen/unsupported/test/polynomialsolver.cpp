@@ -192,6 +192,108 @@ void polynomialsolver(int deg)
       realRoots );
 }
 
+template<typename _Scalar, int _Deg>
+void poly_real_roots_batch(Index n)
+{
+  typedef Matrix<_Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<_Scalar,Dynamic,1>       VectorType;
+
+  // random polynomials with separated roots, the real roots in [-1,1]
+  MatrixType polys(_Deg+1, n), expected(_Deg, n), roots;
+  VectorXi expectedCounts(n), counts;
+  for(Index j=0; j<n; ++j)
+  {
+    const int pairs = internal::random<int>(0,_Deg/2);
+    const int reals = _Deg - 2*pairs;
+    VectorType poly = VectorType::Ones(1);
+    for(int k=0; k<reals; ++k)
+    {
+      expected(k,j) = _Scalar(-1) + (_Scalar(k) + internal::random<_Scalar>(0.2,0.8)) * _Scalar(2) / _Scalar(reals);
+      VectorType next = VectorType::Zero(poly.size()+1);
+      next.tail(poly.size()) += poly;
+      next.head(poly.size()) -= expected(k,j) * poly;
+      poly = next;
+    }
+    for(int k=0; k<pairs; ++k)
+    {
+      const _Scalar re = internal::random<_Scalar>(-1,1), im = internal::random<_Scalar>(0.2,1);
+      VectorType next = VectorType::Zero(poly.size()+2);
+      next.tail(poly.size()) += poly;
+      next.segment(1,poly.size()) -= _Scalar(2)*re * poly;
+      next.head(poly.size()) += (re*re + im*im) * poly;
+      poly = next;
+    }
+    polys.col(j) = internal::random<_Scalar>(0.5,2) * (internal::random<bool>() ? _Scalar(1) : _Scalar(-1)) * poly;
+    expectedCounts[j] = reals;
+  }
+
+  poly_real_roots(polys, roots, counts);
+  VERIFY_IS_EQUAL(roots.rows(), Index(_Deg));
+  VERIFY_IS_EQUAL(roots.cols(), n);
+  VERIFY_IS_EQUAL(counts, expectedCounts);
+
+  // as accurate as the companion matrix
+  PolynomialSolver<_Scalar,_Deg> psolve;
+  std::vector<_Scalar> realRoots;
+  for(Index j=0; j<n; ++j)
+  {
+    const int count = counts[j];
+    psolve.compute(polys.col(j));
+    psolve.realRoots(realRoots, _Scalar(1e-3));
+    std::sort(realRoots.begin(), realRoots.end());
+    _Scalar error(0), companionError(0);
+    for(int k=0; k<count; ++k)
+    {
+      error = (std::max)(error, abs(roots(k,j) - expected(k,j)));
+      if(Index(realRoots.size()) == count)
+        companionError = (std::max)(companionError, abs(realRoots[k] - expected(k,j)));
+    }
+    VERIFY(error <= (std::max)(_Scalar(4)*companionError, _Scalar(64)*NumTraits<_Scalar>::epsilon()));
+    VERIFY(roots.col(j).tail(_Deg-count).array().isNaN().all());
+  }
+}
+
+template<typename _Scalar>
+void poly_real_roots_special_cases()
+{
+  typedef Matrix<_Scalar,Dynamic,Dynamic> MatrixType;
+  const _Scalar nan = std::numeric_limits<_Scalar>::quiet_NaN();
+  MatrixType polys(5,6), roots, expected(4,6);
+  VectorXi counts, expectedCounts(6);
+  polys.col(0) << 4, 0, -5, 0, 1;       // (x^2-1)(x^2-4), no cubic term after the shift
+  expected.col(0) << -2, -1, 1, 2;
+  polys.col(1) << 1, 0, 0, 0, 1;        // x^4+1
+  expected.col(1) << nan, nan, nan, nan;
+  polys.col(2) << 6, -5, -2, 1, 0;      // the cubic (x+2)(x-1)(x-3)
+  expected.col(2) << -2, 1, 3, nan;
+  polys.col(3) << 3, -2, 0, 0, 0;       // the line 3-2x
+  expected.col(3) << 1.5, nan, nan, nan;
+  polys.col(4) << 0, 0, 0, 0, 0;
+  expected.col(4) << nan, nan, nan, nan;
+  polys.col(5) << -6, 7, 0, -1, 0;      // -(x-1)(x-2)(x+3)
+  expected.col(5) << -3, 1, 2, nan;
+  expectedCounts << 4, 0, 3, 1, 0, 3;
+
+  poly_real_roots(polys, roots, counts);
+  VERIFY_IS_EQUAL(counts, expectedCounts);
+  for(Index j=0; j<polys.cols(); ++j)
+    for(int k=0; k<4; ++k)
+    {
+      if(k < counts[j])
+        VERIFY_IS_APPROX(roots(k,j), expected(k,j));
+      else
+        VERIFY((numext::isnan)(roots(k,j)));
+    }
+
+  // a double root is found to about sqrt(epsilon)
+  Matrix<_Scalar,3,1> poly(1, -2, 1);
+  Matrix<_Scalar,2,1> doubleRoots;
+  Matrix<int,1,1> count = Matrix<int,1,1>::Constant(-1);
+  poly_real_roots(poly, doubleRoots, count);
+  VERIFY_IS_EQUAL(count[0], 2);
+  VERIFY((doubleRoots.array() - _Scalar(1)).abs().maxCoeff() <= _Scalar(16)*sqrt(NumTraits<_Scalar>::epsilon()));
+}
+
 void test_polynomialsolver()
 {
   for(int i = 0; i < g_repeat; i++)
@@ -212,5 +314,14 @@ void test_polynomialsolver()
             internal::random<int>(9,13)
             )) );
     CALL_SUBTEST_11((polynomialsolver<float,Dynamic>(1)) );
+
+    CALL_SUBTEST_12((poly_real_roots_batch<float,2>(internal::random<Index>(1,200))) );
+    CALL_SUBTEST_12((poly_real_roots_batch<float,3>(internal::random<Index>(1,200))) );
+    CALL_SUBTEST_12((poly_real_roots_batch<float,4>(internal::random<Index>(1,200))) );
+    CALL_SUBTEST_13((poly_real_roots_batch<double,2>(internal::random<Index>(1,200))) );
+    CALL_SUBTEST_13((poly_real_roots_batch<double,3>(internal::random<Index>(1,200))) );
+    CALL_SUBTEST_13((poly_real_roots_batch<double,4>(internal::random<Index>(1,200))) );
   }
+  CALL_SUBTEST_12((poly_real_roots_special_cases<float>()) );
+  CALL_SUBTEST_13((poly_real_roots_special_cases<double>()) );
 }
@@ -176,6 +176,21 @@ template<typename ArrayType> void array_special_functions()
   }
 #endif
 
+#if EIGEN_HAS_C99_MATH
+  // Check the inverse of the normal cdf against scipy.special.ndtri
+  {
+    ArrayType p(9), res(9), ref(9);
+    p << 0.5, 0.975, 0.025, 0.1, 0.8, 1e-10, 0, 1, -0.5;
+    ref << 0, 1.959963984540054, -1.959963984540054, -1.2815515655446004, 0.8416212335729143,
+           -6.361340902404056, -plusinf, plusinf, nan;
+    CALL_SUBTEST( verify_component_wise(ref, ref); );
+    CALL_SUBTEST( res = ndtri(p); verify_component_wise(res, ref); );
+    // erfc(-ndtri(p)/sqrt(2))/2 == p
+    ArrayType q = ArrayType::Random(rows,cols).abs() * Scalar(0.98) + Scalar(0.01);
+    VERIFY_IS_APPROX(Scalar(0.5) * (-ndtri(q) / Scalar(std::sqrt(2.0))).erfc(), q);
+  }
+#endif
+
 #if EIGEN_HAS_C99_MATH
   {
     // Inputs and ground truth generated with scipy via:
@@ -338,8 +353,104 @@ template<typename ArrayType> void array_special_functions()
 #endif
 }
 
+#if EIGEN_HAS_C99_MATH
+// \returns the largest error of \a res in units of the float ulp of max(|ref|,floor)
+double max_ulp_error(const ArrayXf& res, const ArrayXd& ref, double floor)
+{
+  double err = 0;
+  for(Index i=0; i<res.size(); ++i)
+  {
+    if(!(numext::isfinite)(ref(i)))
+      continue;
+    int e;
+    std::frexp((std::max)(std::abs(ref(i)), floor), &e);
+    err = (std::max)(err, std::abs(double(res(i)) - ref(i)) / std::ldexp(1.0, e-24));
+  }
+  return err;
+}
+
+ArrayXf uniform_samples(Index n, float lo, float hi)
+{
+  return lo + (hi - lo) * (ArrayXf::Random(n) + 1.f) * 0.5f;
+}
+
+ArrayXf log_samples(Index n, float lo, float hi)
+{
+  return (std::log(lo) + (std::log(hi) - std::log(lo)) * (ArrayXf::Random(n) + 1.f) * 0.5f).exp();
+}
+
+// The float results go through the packet path when it is vectorized; check them
+// against double precision evaluations with the error bounds documented there.
+void packet_special_functions_accuracy()
+{
+  const Index n = 4096;
+  const double tiny = (std::numeric_limits<float>::min)();
+  ArrayXf x, p;
+  ArrayXd ref;
+
+  x = uniform_samples(n, -5.f, 5.f);
+  ref = x.cast<double>().erf();
+  VERIFY(max_ulp_error(x.erf(), ref, tiny) <= 3);
+
+  x = uniform_samples(n, -5.f, 9.2f);
+  ref = x.cast<double>().erfc();
+  VERIFY(max_ulp_error(x.erfc(), ref, tiny) <= 8);
+
+  x = uniform_samples(n, 0.f, 10.f);
+  ref = x.cast<double>().lgamma();
+  VERIFY(max_ulp_error(x.lgamma(), ref, 1) <= 3);
+  x = log_samples(n, 1e-30f, 1e30f);
+  ref = x.cast<double>().lgamma();
+  VERIFY(max_ulp_error(x.lgamma(), ref, 1) <= 3);
+  x = uniform_samples(n, -10.f, 0.f);
+  ref = x.cast<double>().lgamma();
+  VERIFY(max_ulp_error(x.lgamma(), ref, 1) <= 13);
+
+  x = uniform_samples(n, 0.f, 20.f);
+  ref = x.cast<double>().digamma();
+  VERIFY(max_ulp_error(x.digamma(), ref, 1) <= 4);
+  x = log_samples(n, 1e-30f, 1e30f);
+  ref = x.cast<double>().digamma();
+  VERIFY(max_ulp_error(x.digamma(), ref, 1) <= 4);
+  x = uniform_samples(n, -10.f, 0.f);
+  ref = x.cast<double>().digamma();
+  VERIFY(max_ulp_error(x.digamma(), ref, 1) <= 10);
+
+  p = uniform_samples(n, 0.f, 1.f);
+  ref = ndtri(p.cast<double>());
+  VERIFY(max_ulp_error(ndtri(p), ref, tiny) <= 7);
+  p = log_samples(n, 1e-37f, 0.5f);
+  ref = ndtri(p.cast<double>());
+  VERIFY(max_ulp_error(ndtri(p), ref, tiny) <= 7);
+  // upper tail: the reference is evaluated at the float values of 1-p, which are exact in double
+  p = 1.f - log_samples(n, 1e-7f, 0.5f);
+  ref = ndtri(p.cast<double>());
+  VERIFY((p < 1.f).all());
+  VERIFY(max_ulp_error(ndtri(p), ref, tiny) <= 7);
+
+  // special values
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  ArrayXf s(7), res(7), expected(7);
+  s << 0, -2, inf, -inf, nan, 1, 0.5f;
+  expected << 0, -0.9953222650189527f, 1, -1, nan, 0.8427007929497149f, 0.5204998778130465f;
+  res = s.erf();        verify_component_wise(res, expected);
+  expected << 1, 1.9953222650189528f, 0, 2, nan, 0.15729920705028513f, 0.4795001221869535f;
+  res = s.erfc();       verify_component_wise(res, expected);
+  expected << inf, inf, inf, inf, nan, 0, 0.5723649429247001f;
+  res = s.lgamma();     verify_component_wise(res, expected);
+  expected << inf, inf, inf, inf, nan, -0.5772156649015329f, -1.9635100260214235f;
+  res = s.digamma();    verify_component_wise(res, expected);
+  expected << -inf, nan, nan, nan, nan, inf, 0;
+  res = ndtri(s);       verify_component_wise(res, expected);
+}
+#endif  // EIGEN_HAS_C99_MATH
+
 void test_special_functions()
 {
   CALL_SUBTEST_1(array_special_functions<ArrayXf>());
   CALL_SUBTEST_2(array_special_functions<ArrayXd>());
+#if EIGEN_HAS_C99_MATH
+  CALL_SUBTEST_3(packet_special_functions_accuracy());
+#endif
 }
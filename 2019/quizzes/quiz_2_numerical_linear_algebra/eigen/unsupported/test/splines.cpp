@@ -9,6 +9,7 @@
 
 #include "main.h"
 
+#include <Eigen/SparseCore>
 #include <unsupported/Eigen/Splines>
 
 namespace Eigen {
@@ -268,6 +269,127 @@ void check_global_interpolation_with_derivatives2d()
   }
 }
 
+/* compares the batched evaluation against the evaluation of the sites one by one */
+template <typename SplineType>
+void check_batch_evaluation(const SplineType& spline)
+{
+  typedef typename SplineType::KnotVectorType KnotVectorType;
+  const DenseIndex p = spline.degree();
+  const double lo = spline.knots()(0), hi = spline.knots()(spline.knots().size()-1);
+
+  // dense sites with many per span, including the breaks
+  const DenseIndex size = internal::random<DenseIndex>(1,1000);
+  KnotVectorType u(size + spline.knots().size());
+  u << (KnotVectorType::Random(size) + 1.0) * (hi - lo) / 2.0 + lo, spline.knots();
+  for (int sorted = 0; sorted < 2; ++sorted)
+  {
+    if (sorted)
+      std::sort(u.data(), u.data() + u.size());
+
+    ArrayXXd points;
+    spline.evaluate(u, points);
+    VERIFY_IS_EQUAL(points.cols(), u.size());
+    for (DenseIndex i=0; i<u.size(); ++i)
+      VERIFY( (points.col(i).matrix() - spline(u(i)).matrix()).norm() < 1e-12 );
+
+    const DenseIndex order = p + 1;
+    MatrixXd ders;
+    spline.derivatives(u, order, ders);
+    VERIFY_IS_EQUAL(ders.cols(), (p+1)*u.size());
+    for (DenseIndex i=0; i<u.size(); ++i)
+    {
+      const ArrayXXd ref = spline.derivatives(u(i), order);
+      const double scale = (std::max)(1.0, ref.abs().maxCoeff());
+      for (DenseIndex k=0; k<=p; ++k)
+        VERIFY( (ders.col(k*u.size()+i) - ref.col(k).matrix()).norm() < 1e-10 * scale );
+    }
+  }
+
+  ArrayXXd empty;
+  spline.evaluate(KnotVectorType(), empty);
+  VERIFY_IS_EQUAL(empty.cols(), 0);
+}
+
+void check_batch_evaluation_splines()
+{
+  check_batch_evaluation(spline3d());
+  check_batch_evaluation(closed_spline2d());
+
+  const ArrayXXd points = ArrayXXd::Random(2, 50);
+  for (DenseIndex degree=1; degree<=5; ++degree)
+    check_batch_evaluation(SplineFitting<Spline2d>::Interpolate(points, degree));
+}
+
+void check_approximation2d()
+{
+  typedef Spline2d::KnotVectorType KnotVectorType;
+  typedef Spline2d::ControlPointVectorType ControlPointVectorType;
+
+  const DenseIndex numPoints = internal::random<DenseIndex>(20,500);
+  const DenseIndex degree = internal::random<DenseIndex>(1,5);
+  const DenseIndex numCtrls = internal::random<DenseIndex>(degree+1, (std::max)(degree+1, numPoints/4));
+  const double smoothing = internal::random<double>(0.0,1.0);
+
+  const ControlPointVectorType points = ControlPointVectorType::Random(2,numPoints);
+  KnotVectorType parameters;
+  ChordLengths(points, parameters);
+
+  // compare against the dense solution of the normal equations
+  const Spline2d spline = SplineFitting<Spline2d>::Approximate(points, degree, numCtrls, smoothing);
+  VERIFY_IS_EQUAL(spline.ctrls().cols(), numCtrls);
+  VERIFY_IS_EQUAL(spline.degree(), degree);
+
+  SparseMatrix<double,RowMajor> N;
+  SplineFitting<Spline2d>::CollocationMatrix(parameters, degree, spline.knots(), N);
+  VERIFY_IS_EQUAL(N.rows(), numPoints);
+  VERIFY_IS_EQUAL(N.cols(), numCtrls);
+  SparseMatrix<double> Ncols;
+  SplineFitting<Spline2d>::CollocationMatrix(parameters, degree, spline.knots(), Ncols);
+  VERIFY_IS_APPROX(MatrixXd(Ncols), MatrixXd(N));
+
+  MatrixXd D = MatrixXd::Zero((std::max)(numCtrls-2, DenseIndex(0)), numCtrls);
+  for (DenseIndex j=0; j<D.rows(); ++j)
+    D.row(j).segment(j,3) << 1, -2, 1;
+  const MatrixXd dense = N.toDense();
+  const MatrixXd normal = dense.transpose()*dense + smoothing*D.transpose()*D;
+  const MatrixXd ref = normal.ldlt().solve(dense.transpose()*points.matrix().transpose());
+  VERIFY( (spline.ctrls().matrix().transpose() - ref).norm() < 1e-8 * (std::max)(1.0, ref.norm()) );
+
+  // polynomials of the spline degree are reproduced without smoothing
+  KnotVectorType u = KnotVectorType::LinSpaced(numPoints, -1.0, 2.0);
+  ControlPointVectorType curve(2, numPoints);
+  curve.row(0) = u;
+  curve.row(1) = u.pow(double(degree)) - 0.5*u;
+  const Spline2d fit = SplineFitting<Spline2d>::Approximate(curve, degree, numCtrls, 0.0, u);
+  for (DenseIndex i=0; i<numPoints; ++i)
+    VERIFY( (fit(u(i)) - curve.col(i)).matrix().norm() < 1e-9 );
+}
+
+void check_large_interpolation2d()
+{
+  typedef Spline2d::PointType PointType;
+  typedef Spline2d::KnotVectorType KnotVectorType;
+  typedef Spline2d::ControlPointVectorType ControlPointVectorType;
+
+  // the banded solvers handle sizes out of reach of dense factorizations
+  const DenseIndex numPoints = 20000;
+  const ControlPointVectorType points = ControlPointVectorType::Random(2,numPoints);
+  KnotVectorType chord_lengths;
+  Eigen::ChordLengths(points, chord_lengths);
+
+  const Spline2d spline = SplineFitting<Spline2d>::Interpolate(points,3);
+  for (Eigen::DenseIndex i=0; i<numPoints; i+=97)
+  {
+    PointType pt = spline( chord_lengths(i) );
+    PointType ref = points.col(i);
+    VERIFY( (pt - ref).matrix().norm() < 1e-10 );
+  }
+
+  const Spline2d approximation = SplineFitting<Spline2d>::Approximate(points, 3, numPoints/10, 1e-3);
+  VERIFY_IS_EQUAL(approximation.ctrls().cols(), numPoints/10);
+  VERIFY( (approximation.ctrls().abs() <= 2.0).all() );
+}
+
 void test_splines()
 {
   for (int i = 0; i < g_repeat; ++i)
@@ -277,5 +399,8 @@ void test_splines()
     CALL_SUBTEST( eval_closed_spline2d() );
     CALL_SUBTEST( check_global_interpolation2d() );
     CALL_SUBTEST( check_global_interpolation_with_derivatives2d() );
+    CALL_SUBTEST( check_batch_evaluation_splines() );
+    CALL_SUBTEST( check_approximation2d() );
   }
+  CALL_SUBTEST( check_large_interpolation2d() );
 }